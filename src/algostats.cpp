@@ -0,0 +1,195 @@
+// Copyright (c) 2026 The Globaltoken Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <algostats.h>
+
+#include <chain.h>
+#include <chainparams.h>
+#include <pow.h>
+#include <primitives/block.h>
+#include <validation.h>
+
+#include <algorithm>
+
+CAlgoStatsTracker algostatstracker;
+
+CAlgoStatsTracker::CAlgoStatsTracker() : pindexTip(nullptr), pindexHeader(nullptr)
+{
+    for (AlgoWindow& window : windows) {
+        window.nLastDiffRet = -1;
+        window.nNextDiffRet = -1;
+    }
+}
+
+void CAlgoStatsTracker::FillWindow(AlgoWindow& window)
+{
+    AssertLockHeld(cs);
+    const Consensus::Params& params = Params().GetConsensus();
+    while (!window.entries.empty() && window.entries.size() <= (size_t)ALGO_STATS_WINDOW) {
+        const CBlockIndex* pindexPrev = GetPrevBlockIndexForAlgo(window.entries.back().pindex, params);
+        if (pindexPrev == nullptr)
+            break;
+        window.entries.push_back(WindowEntry{pindexPrev, GetBlockProofBase(*pindexPrev)});
+    }
+}
+
+void CAlgoStatsTracker::UpdateRetarget(AlgoWindow& window, uint8_t algo)
+{
+    AssertLockHeld(cs);
+    if (window.entries.empty()) {
+        window.nLastDiffRet = -1;
+        window.nNextDiffRet = -1;
+        return;
+    }
+    const Consensus::Params& params = Params().GetConsensus();
+    const CBlockIndex* pindexAlgo = window.entries.front().pindex;
+    window.nLastDiffRet = CalculateDiffRetargetingBlock(pindexAlgo, RETARGETING_LAST, algo, params);
+    window.nNextDiffRet = CalculateDiffRetargetingBlock(pindexAlgo, RETARGETING_NEXT, algo, params);
+}
+
+void CAlgoStatsTracker::ResetWindow(AlgoWindow& window, const CBlockIndex* pindexAlgo, uint8_t algo)
+{
+    AssertLockHeld(cs);
+    window.entries.clear();
+    if (pindexAlgo != nullptr)
+        window.entries.push_back(WindowEntry{pindexAlgo, GetBlockProofBase(*pindexAlgo)});
+    FillWindow(window);
+    UpdateRetarget(window, algo);
+}
+
+void CAlgoStatsTracker::Reset(const CBlockIndex* pindexNew, const CBlockIndex* pindexHeaderNew)
+{
+    LOCK(cs);
+    pindexTip = pindexNew;
+    pindexHeader = pindexHeaderNew;
+    for (int algo = 0; algo < NUM_ALGOS_IMPL; algo++)
+        ResetWindow(windows[algo], pindexNew ? pindexNew->GetLastAncestorForAlgo(algo) : nullptr, algo);
+}
+
+void CAlgoStatsTracker::InitializeCurrentBlockTip()
+{
+    LOCK(cs_main);
+    Reset(chainActive.Tip(), pindexBestHeader);
+}
+
+const CBlockIndex* CAlgoStatsTracker::GetTip() const
+{
+    LOCK(cs);
+    return pindexTip;
+}
+
+bool CAlgoStatsTracker::GetChainStats(AlgoChainStats& stats) const
+{
+    LOCK(cs);
+    if (pindexTip == nullptr)
+        return false;
+
+    const Consensus::Params& params = Params().GetConsensus();
+    stats.pindexTip = pindexTip;
+    stats.nHeaders = std::max(pindexHeader ? pindexHeader->nHeight : -1, pindexTip->nHeight);
+    for (int algo = 0; algo < NUM_ALGOS_IMPL; algo++) {
+        const AlgoWindow& window = windows[algo];
+        AlgoStats& algostats = stats.algos[algo];
+        if (window.entries.empty() || !IsAlgoPathAllowed(pindexTip, window.entries.front().pindex, algo)) {
+            algostats.pindexLast = nullptr;
+            algostats.nLastDiffRet = params.fPowNoRetargeting ? 0 : -1;
+            algostats.nNextDiffRet = params.fPowNoRetargeting ? 0 : pindexTip->nHeight;
+            continue;
+        }
+        algostats.pindexLast = window.entries.front().pindex;
+        algostats.nLastDiffRet = window.nLastDiffRet;
+        // The next retarget height was computed with the newest block of the algo as tip,
+        // non-negative results are relative to the tip.
+        if (window.nNextDiffRet >= 0 && !params.fPowNoRetargeting)
+            algostats.nNextDiffRet = window.nNextDiffRet - algostats.pindexLast->nHeight + pindexTip->nHeight;
+        else
+            algostats.nNextDiffRet = window.nNextDiffRet;
+    }
+    return true;
+}
+
+bool CAlgoStatsTracker::GetNetworkHashPS(uint8_t algo, int nLookup, const CBlockIndex* pindexTipExpected, double& dHashPS) const
+{
+    LOCK(cs);
+    if (pindexTip == nullptr || pindexTip != pindexTipExpected || algo >= NUM_ALGOS_IMPL || nLookup > ALGO_STATS_WINDOW)
+        return false;
+
+    const AlgoWindow& window = windows[algo];
+    dHashPS = 0;
+    if (window.entries.empty() || !IsAlgoPathAllowed(pindexTip, window.entries.front().pindex, algo))
+        return true;
+
+    arith_uint256 totalAlgoWork;
+    int64_t minTime = window.entries.front().pindex->GetBlockTime();
+    int64_t maxTime = minTime;
+    size_t nEntries = std::min(window.entries.size(), (size_t)std::max(nLookup, 0) + 1);
+    for (size_t i = 0; i < nEntries; i++) {
+        totalAlgoWork += window.entries[i].nWork;
+        int64_t time = window.entries[i].pindex->GetBlockTime();
+        minTime = std::min(time, minTime);
+        maxTime = std::max(time, maxTime);
+    }
+
+    // In case there's a situation where minTime == maxTime, we don't want a divide by zero exception.
+    if (minTime != maxTime)
+        dHashPS = totalAlgoWork.getdouble() / (maxTime - minTime);
+    return true;
+}
+
+void CAlgoStatsTracker::NotifyHeaderTip(const CBlockIndex *pindexNew, bool fInitialDownload)
+{
+    LOCK(cs);
+    pindexHeader = pindexNew;
+}
+
+void CAlgoStatsTracker::BlockConnected(const std::shared_ptr<const CBlock>& pblock, const CBlockIndex *pindex, const std::vector<CTransactionRef>& vtxConflicted)
+{
+    LOCK(cs);
+    if (pindexTip == nullptr || pindex->pprev != pindexTip) {
+        // Notifications for blocks that are already part of the tracked chain, e.g. queued
+        // before InitializeCurrentBlockTip, are ignored.
+        if (pindexTip != nullptr && pindexTip->GetAncestor(pindex->nHeight) == pindex)
+            return;
+        Reset(pindex, pindexHeader);
+        return;
+    }
+
+    const Consensus::Params& params = Params().GetConsensus();
+    const uint8_t algo = pindex->GetAlgo();
+    AlgoWindow& window = windows[algo];
+    const CBlockIndex* pindexPrevAlgo = GetPrevBlockIndexForAlgo(pindex, params);
+    pindexTip = pindex;
+    if (window.entries.empty() || pindexPrevAlgo != window.entries.front().pindex) {
+        ResetWindow(window, pindex, algo);
+        return;
+    }
+
+    window.entries.push_front(WindowEntry{pindex, GetBlockProofBase(*pindex)});
+    if (window.entries.size() > (size_t)ALGO_STATS_WINDOW + 1)
+        window.entries.pop_back();
+    // The last retarget only moves if this block changed the difficulty.
+    if (params.fPowNoRetargeting || !IsAlgoPathAllowed(pindex, pindex, algo))
+        window.nLastDiffRet = CalculateDiffRetargetingBlock(pindex, RETARGETING_LAST, algo, params);
+    else if (pindex->nBits != pindexPrevAlgo->nBits)
+        window.nLastDiffRet = pindex->nHeight;
+    window.nNextDiffRet = CalculateDiffRetargetingBlock(pindex, RETARGETING_NEXT, algo, params);
+}
+
+void CAlgoStatsTracker::BlockDisconnected(const std::shared_ptr<const CBlock>& pblock)
+{
+    LOCK(cs);
+    if (pindexTip == nullptr || pblock->GetHash() != pindexTip->GetBlockHash())
+        return;
+
+    const uint8_t algo = pindexTip->GetAlgo();
+    AlgoWindow& window = windows[algo];
+    if (!window.entries.empty() && window.entries.front().pindex == pindexTip) {
+        window.entries.pop_front();
+        FillWindow(window);
+        UpdateRetarget(window, algo);
+    } else {
+        ResetWindow(window, pindexTip->pprev ? pindexTip->pprev->GetLastAncestorForAlgo(algo) : nullptr, algo);
+    }
+    pindexTip = pindexTip->pprev;
+}
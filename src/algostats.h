@@ -0,0 +1,110 @@
+// Copyright (c) 2026 The Globaltoken Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_ALGOSTATS_H
+#define BITCOIN_ALGOSTATS_H
+
+#include <arith_uint256.h>
+#include <globaltoken/powalgorithm.h>
+#include <sync.h>
+#include <validationinterface.h>
+
+#include <array>
+#include <deque>
+
+class CBlockIndex;
+
+/** Number of previous blocks of an algo kept by CAlgoStatsTracker for hashrate estimates */
+static const int ALGO_STATS_WINDOW = 120;
+
+/** Statistics of one algo at the tip tracked by CAlgoStatsTracker */
+struct AlgoStats
+{
+    //! Last block of the algo, nullptr if the algo has no block (or is not allowed yet)
+    const CBlockIndex* pindexLast;
+    //! Same as CalculateDiffRetargetingBlock(tip, RETARGETING_LAST/RETARGETING_NEXT, algo)
+    int nLastDiffRet;
+    int nNextDiffRet;
+};
+
+/** Statistics of all algos at the tip tracked by CAlgoStatsTracker */
+struct AlgoChainStats
+{
+    const CBlockIndex* pindexTip;
+    //! Height of the best known header, at least the height of the tip
+    int nHeaders;
+    std::array<AlgoStats, NUM_ALGOS_IMPL> algos;
+};
+
+/**
+ * Keeps per-algo statistics of the active chain up to date as blocks are
+ * connected and disconnected, so getalgoinfo and getnetworkhashps do not
+ * have to walk the chain under cs_main.
+ *
+ * For every algo a window of its last ALGO_STATS_WINDOW + 1 blocks is kept
+ * together with their work, and the retarget heights of the newest block.
+ * Connecting a block only updates the window of its own algo. The tracker
+ * follows the validation interface queue, so it may lag behind chainActive;
+ * callers that need the current tip call SyncWithValidationInterfaceQueue
+ * first or compare the returned tip.
+ */
+class CAlgoStatsTracker : public CValidationInterface
+{
+private:
+    struct WindowEntry
+    {
+        const CBlockIndex* pindex;
+        arith_uint256 nWork;
+    };
+
+    struct AlgoWindow
+    {
+        //! Newest block first, linked by GetPrevBlockIndexForAlgo
+        std::deque<WindowEntry> entries;
+        //! CalculateDiffRetargetingBlock(newest block, RETARGETING_LAST/RETARGETING_NEXT, algo)
+        int nLastDiffRet;
+        int nNextDiffRet;
+    };
+
+    mutable CCriticalSection cs;
+    const CBlockIndex* pindexTip;
+    const CBlockIndex* pindexHeader;
+    std::array<AlgoWindow, NUM_ALGOS_IMPL> windows;
+
+    void ResetWindow(AlgoWindow& window, const CBlockIndex* pindexAlgo, uint8_t algo);
+    void FillWindow(AlgoWindow& window);
+    void UpdateRetarget(AlgoWindow& window, uint8_t algo);
+
+public:
+    CAlgoStatsTracker();
+
+    /** Rebuild all windows for the given chain tip. Requires cs_main. */
+    void InitializeCurrentBlockTip();
+
+    /** Rebuild all windows for pindexNew and pindexHeaderNew. */
+    void Reset(const CBlockIndex* pindexNew, const CBlockIndex* pindexHeaderNew);
+
+    /** The tip the statistics refer to, nullptr if no tip has been tracked yet. */
+    const CBlockIndex* GetTip() const;
+
+    /** Copy the statistics at the tracked tip, false if no tip has been tracked yet. */
+    bool GetChainStats(AlgoChainStats& stats) const;
+
+    /**
+     * Estimate the network hashes per second of an algo at pindexTipExpected, like
+     * CalculateAlgoHashrate(*pindexTipExpected, algo, nLookup). Returns false if the
+     * tracked tip is a different block or nLookup exceeds ALGO_STATS_WINDOW.
+     */
+    bool GetNetworkHashPS(uint8_t algo, int nLookup, const CBlockIndex* pindexTipExpected, double& dHashPS) const;
+
+protected:
+    // CValidationInterface
+    void NotifyHeaderTip(const CBlockIndex *pindexNew, bool fInitialDownload) override;
+    void BlockConnected(const std::shared_ptr<const CBlock>& pblock, const CBlockIndex *pindex, const std::vector<CTransactionRef>& vtxConflicted) override;
+    void BlockDisconnected(const std::shared_ptr<const CBlock>& pblock) override;
+};
+
+extern CAlgoStatsTracker algostatstracker;
+
+#endif // BITCOIN_ALGOSTATS_H
@@ -0,0 +1,97 @@
+// Copyright (c) 2026 The Globaltoken Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <auxpowcache.h>
+
+#include <auxpow.h>
+#include <clientversion.h>
+#include <memusage.h>
+#include <streams.h>
+
+CAuxPowCache auxpowcache;
+
+CAuxPowCache::CAuxPowCache(size_t nMaxUsageIn) : nMaxUsage(nMaxUsageIn), nUsage(0), nHits(0), nMisses(0)
+{
+}
+
+size_t CAuxPowCache::EntryUsage(const std::vector<unsigned char>& payload)
+{
+    // list node + hash table node + payload
+    return memusage::MallocUsage(sizeof(list_type::value_type) + 2 * sizeof(void*)) +
+           memusage::MallocUsage(sizeof(std::pair<const uint256, list_type::iterator>) + sizeof(void*)) +
+           memusage::DynamicUsage(payload);
+}
+
+void CAuxPowCache::Trim()
+{
+    AssertLockHeld(cs);
+    while (nUsage > nMaxUsage && !lruEntries.empty()) {
+        nUsage -= EntryUsage(lruEntries.back().second);
+        mapEntries.erase(lruEntries.back().first);
+        lruEntries.pop_back();
+    }
+}
+
+void CAuxPowCache::SetMaxUsage(size_t nMaxUsageIn)
+{
+    LOCK(cs);
+    nMaxUsage = nMaxUsageIn;
+    Trim();
+}
+
+bool CAuxPowCache::Get(const uint256& hash, boost::shared_ptr<CAuxPow>& auxpow)
+{
+    std::vector<unsigned char> payload;
+    {
+        LOCK(cs);
+        auto it = mapEntries.find(hash);
+        if (it == mapEntries.end()) {
+            nMisses++;
+            return false;
+        }
+        nHits++;
+        lruEntries.splice(lruEntries.begin(), lruEntries, it->second);
+        payload = it->second->second;
+    }
+
+    CDataStream ss(payload, SER_DISK, CLIENT_VERSION);
+    auxpow.reset(new CAuxPow());
+    ss >> *auxpow;
+    return true;
+}
+
+void CAuxPowCache::Add(const uint256& hash, const CAuxPow& auxpow)
+{
+    CDataStream ss(SER_DISK, CLIENT_VERSION);
+    ss << auxpow;
+    std::vector<unsigned char> payload(ss.begin(), ss.end());
+
+    LOCK(cs);
+    if (nMaxUsage == 0 || mapEntries.count(hash))
+        return;
+    nUsage += EntryUsage(payload);
+    lruEntries.emplace_front(hash, std::move(payload));
+    mapEntries.emplace(hash, lruEntries.begin());
+    Trim();
+}
+
+void CAuxPowCache::Clear()
+{
+    LOCK(cs);
+    lruEntries.clear();
+    mapEntries.clear();
+    nUsage = 0;
+}
+
+AuxPowCacheStats CAuxPowCache::GetStats() const
+{
+    LOCK(cs);
+    AuxPowCacheStats stats;
+    stats.nEntries = mapEntries.size();
+    stats.nUsage = nUsage;
+    stats.nMaxUsage = nMaxUsage;
+    stats.nHits = nHits;
+    stats.nMisses = nMisses;
+    return stats;
+}
@@ -0,0 +1,85 @@
+// Copyright (c) 2026 The Globaltoken Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_AUXPOWCACHE_H
+#define BITCOIN_AUXPOWCACHE_H
+
+#include <sync.h>
+#include <uint256.h>
+
+#include <list>
+#include <stdint.h>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+
+class CAuxPow;
+
+/** Default for -auxpowcache, maximum memory used by cached auxpow payloads (MiB) */
+static const int64_t DEFAULT_AUXPOW_CACHE_SIZE = 32;
+/** Maximum for -auxpowcache (MiB) */
+static const int64_t MAX_AUXPOW_CACHE_SIZE = 16384;
+
+/** Hit and miss counters of a CAuxPowCache */
+struct AuxPowCacheStats
+{
+    size_t nEntries;
+    size_t nUsage;
+    size_t nMaxUsage;
+    uint64_t nHits;
+    uint64_t nMisses;
+};
+
+/**
+ * Size-bounded LRU cache of serialized CAuxPow payloads, keyed by block hash.
+ *
+ * CBlockIndex does not keep the auxpow of merge-mined blocks in memory, so
+ * CBlockIndex::GetBlockHeader has to read it from disk. Serving headers to
+ * peers, RPC and REST does this for every merge-mined header. Only auxpows
+ * whose proof-of-work has been verified are added to the cache.
+ */
+class CAuxPowCache
+{
+private:
+    struct EntryHasher
+    {
+        size_t operator()(const uint256& hash) const { return hash.GetCheapHash(); }
+    };
+
+    typedef std::list<std::pair<uint256, std::vector<unsigned char> > > list_type;
+
+    mutable CCriticalSection cs;
+    //! Entries ordered from most to least recently used
+    list_type lruEntries;
+    std::unordered_map<uint256, list_type::iterator, EntryHasher> mapEntries;
+    size_t nMaxUsage;
+    size_t nUsage;
+    uint64_t nHits;
+    uint64_t nMisses;
+
+    static size_t EntryUsage(const std::vector<unsigned char>& payload);
+    void Trim();
+
+public:
+    explicit CAuxPowCache(size_t nMaxUsageIn = DEFAULT_AUXPOW_CACHE_SIZE << 20);
+
+    /** Change the memory limit, evicting entries if necessary. */
+    void SetMaxUsage(size_t nMaxUsageIn);
+
+    /** Look up the auxpow of a block, returns false if it is not cached. */
+    bool Get(const uint256& hash, boost::shared_ptr<CAuxPow>& auxpow);
+
+    /** Add the verified auxpow of a block. */
+    void Add(const uint256& hash, const CAuxPow& auxpow);
+
+    void Clear();
+
+    AuxPowCacheStats GetStats() const;
+};
+
+extern CAuxPowCache auxpowcache;
+
+#endif // BITCOIN_AUXPOWCACHE_H
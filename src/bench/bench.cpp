@@ -12,38 +12,115 @@
 #include <regex>
 #include <numeric>
 
-void benchmark::ConsolePrinter::header()
-{
-    std::cout << "# Benchmark, evals, iterations, total, min, max, median" << std::endl;
-}
+namespace {
+struct Summary {
+    double total = 0;
+    double min = 0;
+    double max = 0;
+    double median = 0;
+};
 
-void benchmark::ConsolePrinter::result(const State& state)
+Summary Summarize(const benchmark::State& state)
 {
     auto results = state.m_elapsed_results;
     std::sort(results.begin(), results.end());
 
-    double total = state.m_num_iters * std::accumulate(results.begin(), results.end(), 0.0);
-
-    double front = 0;
-    double back = 0;
-    double median = 0;
+    Summary summary;
+    summary.total = state.m_num_iters * std::accumulate(results.begin(), results.end(), 0.0);
 
     if (!results.empty()) {
-        front = results.front();
-        back = results.back();
+        summary.min = results.front();
+        summary.max = results.back();
 
         size_t mid = results.size() / 2;
-        median = results[mid];
+        summary.median = results[mid];
         if (0 == results.size() % 2) {
-            median = (results[mid] + results[mid + 1]) / 2;
+            summary.median = (results[mid - 1] + results[mid]) / 2;
         }
     }
+    return summary;
+}
+
+std::string JsonEscape(const std::string& str)
+{
+    std::string escaped;
+    for (char c : str) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+        }
+        escaped += c;
+    }
+    return escaped;
+}
+} // namespace
+
+void benchmark::ConsolePrinter::header()
+{
+    std::cout << "# Benchmark, evals, iterations, total, min, max, median" << std::endl;
+}
+
+void benchmark::ConsolePrinter::result(const State& state)
+{
+    const Summary summary = Summarize(state);
 
     std::cout << std::setprecision(6);
-    std::cout << state.m_name << ", " << state.m_num_evals << ", " << state.m_num_iters << ", " << total << ", " << front << ", " << back << ", " << median << std::endl;
+    std::cout << state.m_name << ", " << state.m_num_evals << ", " << state.m_num_iters << ", " << summary.total << ", " << summary.min << ", " << summary.max << ", " << summary.median << std::endl;
 }
 
 void benchmark::ConsolePrinter::footer() {}
+
+benchmark::JsonPrinter::JsonPrinter(std::string version) : m_version(version), m_first_result(true)
+{
+}
+
+void benchmark::JsonPrinter::header()
+{
+    std::cout << "{" << std::endl
+              << "  \"version\": \"" << JsonEscape(m_version) << "\"," << std::endl
+              << "  \"benchmarks\": [";
+    m_first_result = true;
+}
+
+void benchmark::JsonPrinter::result(const State& state)
+{
+    const Summary summary = Summarize(state);
+
+    std::cout << (m_first_result ? "" : ",") << std::endl << std::setprecision(6)
+              << "    { \"name\": \"" << JsonEscape(state.m_name) << "\", \"evals\": " << state.m_num_evals
+              << ", \"iterations\": " << state.m_num_iters << ", \"total\": " << summary.total
+              << ", \"min\": " << summary.min << ", \"max\": " << summary.max << ", \"median\": " << summary.median
+              << ", \"results\": [";
+    const char* prefix = "";
+    for (const auto& e : state.m_elapsed_results) {
+        std::cout << prefix << e;
+        prefix = ", ";
+    }
+    std::cout << "] }";
+    m_first_result = false;
+}
+
+void benchmark::JsonPrinter::footer()
+{
+    std::cout << std::endl
+              << "  ]" << std::endl
+              << "}" << std::endl;
+}
+
+void benchmark::CsvPrinter::header()
+{
+    std::cout << "name,evals,iterations,total,min,max,median" << std::endl;
+}
+
+void benchmark::CsvPrinter::result(const State& state)
+{
+    const Summary summary = Summarize(state);
+
+    std::cout << std::setprecision(6);
+    std::cout << state.m_name << "," << state.m_num_evals << "," << state.m_num_iters << "," << summary.total << "," << summary.min << "," << summary.max << "," << summary.median << std::endl;
+}
+
+void benchmark::CsvPrinter::footer() {}
+
 benchmark::PlotlyPrinter::PlotlyPrinter(std::string plotly_url, int64_t width, int64_t height)
     : m_plotly_url(plotly_url), m_width(width), m_height(height)
 {
@@ -116,6 +116,29 @@ public:
     void footer();
 };
 
+// machine-readable report of min, max, median and all evaluations, to track results across releases.
+class JsonPrinter : public Printer
+{
+public:
+    explicit JsonPrinter(std::string version);
+    void header();
+    void result(const State& state);
+    void footer();
+
+private:
+    std::string m_version;
+    bool m_first_result;
+};
+
+// one line per benchmark with min, max, median, for spreadsheets and plotting scripts.
+class CsvPrinter : public Printer
+{
+public:
+    void header();
+    void result(const State& state);
+    void footer();
+};
+
 // creates box plot with plotly.js
 class PlotlyPrinter : public Printer
 {
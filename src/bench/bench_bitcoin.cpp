@@ -4,6 +4,11 @@
 
 #include <bench/bench.h>
 
+#include <clientversion.h>
+#include <crypto/algos/hashlib/multihash_lanes.h>
+#include <crypto/algos/powkernels.h>
+#include <crypto/algos/scratchpad.h>
+#include <globaltoken/powalgorithm.h>
 #include <crypto/sha256.h>
 #include <key.h>
 #include <validation.h>
@@ -34,7 +39,7 @@ main(int argc, char** argv)
                   << HelpMessageOpt("-evals=<n>", strprintf(_("Number of measurement evaluations to perform. (default: %u)"), DEFAULT_BENCH_EVALUATIONS))
                   << HelpMessageOpt("-filter=<regex>", strprintf(_("Regular expression filter to select benchmark by name (default: %s)"), DEFAULT_BENCH_FILTER))
                   << HelpMessageOpt("-scaling=<n>", strprintf(_("Scaling factor for benchmark's runtime (default: %u)"), DEFAULT_BENCH_SCALING))
-                  << HelpMessageOpt("-printer=(console|plot)", strprintf(_("Choose printer format. console: print data to console. plot: Print results as HTML graph (default: %s)"), DEFAULT_BENCH_PRINTER))
+                  << HelpMessageOpt("-printer=(console|plot|json|csv)", strprintf(_("Choose printer format. console: print data to console. plot: Print results as HTML graph. json, csv: Print results in a machine-readable format (default: %s)"), DEFAULT_BENCH_PRINTER))
                   << HelpMessageOpt("-plot-plotlyurl=<uri>", strprintf(_("URL to use for plotly.js (default: %s)"), DEFAULT_PLOT_PLOTLYURL))
                   << HelpMessageOpt("-plot-width=<x>", strprintf(_("Plot width in pixel (default: %u)"), DEFAULT_PLOT_WIDTH))
                   << HelpMessageOpt("-plot-height=<x>", strprintf(_("Plot height in pixel (default: %u)"), DEFAULT_PLOT_HEIGHT));
@@ -43,6 +48,9 @@ main(int argc, char** argv)
     }
 
     SHA256AutoDetect();
+    Hash512AutoDetect();
+    PowKernelsAutoDetect();
+    PowScratchpadInit(GetMaxAlgoScratchpadSize(), DEFAULT_POW_HUGEPAGES);
     RandomInit();
     ECC_Start();
     SetupEnvironment();
@@ -63,6 +71,10 @@ main(int argc, char** argv)
             gArgs.GetArg("-plot-plotlyurl", DEFAULT_PLOT_PLOTLYURL),
             gArgs.GetArg("-plot-width", DEFAULT_PLOT_WIDTH),
             gArgs.GetArg("-plot-height", DEFAULT_PLOT_HEIGHT)));
+    } else if ("json" == printer_arg) {
+        printer.reset(new benchmark::JsonPrinter(FormatFullVersion()));
+    } else if ("csv" == printer_arg) {
+        printer.reset(new benchmark::CsvPrinter());
     }
 
     benchmark::BenchRunner::RunAll(*printer, evaluations, scaling_factor, regex_filter, is_list_only);
@@ -0,0 +1,21 @@
+// Copyright (c) 2026 The Globaltoken Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef GLOBALTOKEN_BENCH_POW_H
+#define GLOBALTOKEN_BENCH_POW_H
+
+#include <primitives/block.h>
+
+#include <stdint.h>
+
+class CChainParams;
+
+/**
+ * A header as mined with the given algo after the last hardfork, 80 bytes or
+ * 140 bytes with a solution of the right width for the equihash based algos.
+ * Headers of different seeds differ in all hashed fields.
+ */
+CBlockHeader CreatePoWBenchHeader(uint8_t nAlgo, const CChainParams& chainParams, uint32_t nSeed);
+
+#endif // GLOBALTOKEN_BENCH_POW_H
@@ -0,0 +1,198 @@
+// Copyright (c) 2026 The Globaltoken Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+
+#include <arith_uint256.h>
+#include <auxpow.h>
+#include <bench/pow.h>
+#include <chain.h>
+#include <chainparams.h>
+#include <consensus/merkle.h>
+#include <crypto/algos/equihash/equihash.h>
+#include <globaltoken/multihasher.h>
+#include <hash.h>
+#include <pow.h>
+#include <primitives/block.h>
+#include <script/script.h>
+#include <streams.h>
+#include <utilstrencodings.h>
+#include <versionbits.h>
+
+#include <algorithm>
+#include <assert.h>
+#include <functional>
+#include <vector>
+
+namespace {
+
+/** Blocks of all algos mined one after another, with the index the retarget code walks */
+struct PoWBenchChain
+{
+    std::vector<CBlockHeader> headers;
+    std::vector<uint256> hashes;
+    std::vector<CBlockIndex> indexes;
+
+    PoWBenchChain(const CChainParams& chainParams, const std::vector<uint8_t>& vAlgos, size_t nBlocks)
+    {
+        headers.reserve(nBlocks);
+        hashes.reserve(nBlocks);
+        indexes.reserve(nBlocks);
+        for (size_t i = 0; i < nBlocks; i++) {
+            // The algos come in a fixed but irregular order, as on the real chain
+            CBlockHeader header = CreatePoWBenchHeader(vAlgos[(i * 7 + i / vAlgos.size()) % vAlgos.size()], chainParams, i);
+            if (i > 0)
+                header.hashPrevBlock = hashes.back();
+            headers.push_back(header);
+            hashes.push_back(header.GetHash());
+
+            indexes.emplace_back(header);
+            CBlockIndex& index = indexes.back();
+            index.phashBlock = &hashes.back();
+            index.pprev = i > 0 ? &indexes[i - 1] : nullptr;
+            index.nHeight = i;
+            index.BuildSkip();
+            index.BuildAlgoSkip(chainParams.GetConsensus());
+        }
+    }
+};
+
+std::vector<uint8_t> AllAlgos(bool fEquihash)
+{
+    std::vector<uint8_t> vAlgos;
+    for (uint8_t nAlgo = 0; nAlgo < NUM_ALGOS_IMPL; nAlgo++) {
+        if (fEquihash || !IsEquihashBasedAlgo(nAlgo))
+            vAlgos.push_back(nAlgo);
+    }
+    return vAlgos;
+}
+
+} // namespace
+
+// Retarget of every algo at the tip of a chain long enough for the averaging window
+static void GetNextWorkRequiredV3AllAlgos(benchmark::State& state)
+{
+    const auto chainParams = CreateChainParams(CBaseChainParams::MAIN);
+    const Consensus::Params& consensus = chainParams->GetConsensus();
+    const PoWBenchChain chain(*chainParams, AllAlgos(true), 10 * NUM_ALGOS * consensus.nAveragingInterval);
+    const CBlockIndex* pindexTip = &chain.indexes.back();
+    const CBlockHeader header = CreatePoWBenchHeader(ALGO_SHA256D, *chainParams, chain.indexes.size());
+
+    while (state.KeepRunning()) {
+        for (uint8_t nAlgo = 0; nAlgo < NUM_ALGOS_IMPL; nAlgo++)
+            GetNextWorkRequiredV3(pindexTip, &header, consensus, nAlgo);
+    }
+}
+
+// What a node does for each header it is sent: check its target against the retarget and hash it,
+// one header per iteration in the order of the chain, so every algo weighs in with its share of blocks.
+// The equihash based algos are left out, their solutions cannot be mined for a whole chain here.
+static void PoWCheckHeaderChain(benchmark::State& state)
+{
+    const auto chainParams = CreateChainParams(CBaseChainParams::MAIN);
+    const Consensus::Params& consensus = chainParams->GetConsensus();
+    const PoWBenchChain chain(*chainParams, AllAlgos(false), 4 * NUM_ALGOS * consensus.nAveragingInterval);
+    const int nHashVersion = LoadMultiHasherVersionFlags(true);
+
+    size_t i = NUM_ALGOS * consensus.nAveragingInterval;
+    while (state.KeepRunning()) {
+        const CBlockHeader& header = chain.headers[i];
+        const uint8_t nAlgo = header.GetAlgo();
+        GetNextWorkRequiredV3(&chain.indexes[i - 1], &header, consensus, nAlgo);
+        CheckProofOfWork(header.GetPoWHash(nAlgo, SER_GETHASH, nHashVersion), header.nBits, consensus, nAlgo);
+        if (++i == chain.headers.size())
+            i = NUM_ALGOS * consensus.nAveragingInterval;
+    }
+}
+
+// Solution check of a header mined with mars (equihash 96,5), the only equihash
+// parameters of the chain a solution can be found for quickly enough here
+static void CheckEquihashSolutionMars(benchmark::State& state)
+{
+    const auto chainParams = CreateChainParams(CBaseChainParams::MAIN);
+    const unsigned int n = chainParams->GetEquihashAlgoN(ALGO_MARS);
+    const unsigned int k = chainParams->GetEquihashAlgoK(ALGO_MARS);
+    CBlockHeader header = CreatePoWBenchHeader(ALGO_MARS, *chainParams, 0);
+
+    crypto_generichash_blake2b_state eh_state;
+    EhInitialiseState(n, k, eh_state, GetEquihashBasedDefaultPersonalize(ALGO_MARS));
+    CEquihashInput I{header.GetEquihashBlockHeader()};
+    CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+    ss << I;
+    crypto_generichash_blake2b_update(&eh_state, (unsigned char*)&ss[0], ss.size());
+    for (;;) {
+        crypto_generichash_blake2b_state curr_state = eh_state;
+        crypto_generichash_blake2b_update(&curr_state, header.nBigNonce.begin(), header.nBigNonce.size());
+        std::function<bool(std::vector<unsigned char>)> validBlock = [&header](std::vector<unsigned char> soln) {
+            header.nSolution = soln;
+            return true;
+        };
+        if (EhBasicSolveUncancellable(n, k, curr_state, validBlock))
+            break;
+        header.nBigNonce = ArithToUint256(UintToArith256(header.nBigNonce) + 1);
+    }
+    assert(CheckEquihashSolution(&header, *chainParams));
+
+    while (state.KeepRunning()) {
+        CheckEquihashSolution(&header, *chainParams);
+    }
+}
+
+// Merkle branches of an auxpow from a parent block of 2000 transactions merge-mining 16 chains
+static void AuxPowCheck(benchmark::State& state)
+{
+    const auto chainParams = CreateChainParams(CBaseChainParams::MAIN);
+    const Consensus::Params& consensus = chainParams->GetConsensus();
+    const uint256 hashAuxBlock = CreatePoWBenchHeader(ALGO_SHA256D, *chainParams, 0).GetHash();
+
+    const unsigned int nChainMerkleHeight = 4;
+    const uint32_t nMergedMiningNonce = 7;
+    std::vector<uint256> vChainMerkleBranch;
+    for (uint32_t i = 0; i < nChainMerkleHeight; i++)
+        vChainMerkleBranch.push_back(Hash(BEGIN(i), END(i)));
+    const int nChainIndex = CAuxPow::getExpectedIndex(nMergedMiningNonce, consensus.nAuxpowChainId, nChainMerkleHeight);
+    const uint256 hashChainRoot = CAuxPow::CheckMerkleBranch(hashAuxBlock, vChainMerkleBranch, nChainIndex);
+
+    std::vector<unsigned char> vchCommitment(pchMergedMiningHeader, pchMergedMiningHeader + sizeof(pchMergedMiningHeader));
+    std::vector<unsigned char> vchChainRoot(hashChainRoot.begin(), hashChainRoot.end());
+    std::reverse(vchChainRoot.begin(), vchChainRoot.end());
+    vchCommitment.insert(vchCommitment.end(), vchChainRoot.begin(), vchChainRoot.end());
+    for (uint32_t nValue : {uint32_t(1) << nChainMerkleHeight, nMergedMiningNonce}) {
+        for (int i = 0; i < 4; i++)
+            vchCommitment.push_back((nValue >> (8 * i)) & 0xff);
+    }
+
+    CBlock parent;
+    parent.SetBaseVersion(VERSIONBITS_TOP_BITS, 0);
+    for (int i = 0; i < 2000; i++) {
+        CMutableTransaction mtx;
+        mtx.vin.resize(1);
+        if (i == 0) {
+            mtx.vin[0].prevout.SetNull();
+            mtx.vin[0].scriptSig = CScript() << 2809 << 2013 << vchCommitment;
+        } else {
+            mtx.vin[0].prevout.hash = Hash(BEGIN(i), END(i));
+        }
+        mtx.vout.resize(1);
+        parent.vtx.push_back(MakeTransactionRef(std::move(mtx)));
+    }
+    parent.hashMerkleRoot = BlockMerkleRoot(parent);
+
+    CAuxPow auxpow(parent.vtx[0]);
+    auxpow.nVersion = 0;
+    auxpow.coinbaseTx.InitMerkleBranch(parent, 0);
+    auxpow.vChainMerkleBranch = vChainMerkleBranch;
+    auxpow.nChainIndex = nChainIndex;
+    auxpow.defaultparentBlock = parent.GetDefaultBlockHeader();
+    assert(auxpow.check(hashAuxBlock, consensus.nAuxpowChainId, consensus, ALGO_SHA256D));
+
+    while (state.KeepRunning()) {
+        auxpow.check(hashAuxBlock, consensus.nAuxpowChainId, consensus, ALGO_SHA256D);
+    }
+}
+
+BENCHMARK(GetNextWorkRequiredV3AllAlgos, 50);
+BENCHMARK(PoWCheckHeaderChain, 600);
+BENCHMARK(CheckEquihashSolutionMars, 60000);
+BENCHMARK(AuxPowCheck, 60000);
@@ -0,0 +1,86 @@
+// Copyright (c) 2026 The Globaltoken Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+
+#include <bench/pow.h>
+#include <chainparams.h>
+#include <globaltoken/multihasher.h>
+#include <globaltoken/powalgorithm.h>
+#include <hash.h>
+#include <primitives/block.h>
+#include <utilstrencodings.h>
+#include <versionbits.h>
+
+#include <algorithm>
+
+/** Rough scratchpad throughput of the memory-hard algos, each hash runs several passes over its scratchpad */
+static const size_t POW_HASH_SCRATCHPAD_BYTES_PER_SECOND = 1000 * 1000 * 1000;
+
+CBlockHeader CreatePoWBenchHeader(uint8_t nAlgo, const CChainParams& chainParams, uint32_t nSeed)
+{
+    const Consensus::Params& consensus = chainParams.GetConsensus();
+
+    CBlockHeader header;
+    header.SetBaseVersion(VERSIONBITS_TOP_BITS, consensus.nAuxpowChainId);
+    header.SetAlgo(nAlgo);
+    header.hashPrevBlock = Hash(BEGIN(nSeed), END(nSeed));
+    header.hashMerkleRoot = Hash(header.hashPrevBlock.begin(), header.hashPrevBlock.end());
+    header.nTime = consensus.Hardfork3.GetActivationTime() + nSeed * consensus.nPowTargetSpacing;
+    header.nBits = consensus.aPOWAlgos[nAlgo].GetArithPowLimit().GetCompact();
+    header.nNonce = nSeed;
+    if (IsEquihashBasedAlgo(nAlgo)) {
+        // 140 bytes and the solution, which the SHA256d PoW hash of these algos covers
+        header.hashReserved = Hash(header.hashMerkleRoot.begin(), header.hashMerkleRoot.end());
+        header.nBigNonce = Hash(header.hashReserved.begin(), header.hashReserved.end());
+        header.nSolution.assign(chainParams.EquihashSolutionWidth(nAlgo), 0x5a);
+    }
+    return header;
+}
+
+/** Iterations that take about a second, the scratchpad size is the best hint of the cost of a memory-hard hash. */
+static uint64_t PoWHashItersForOneSecond(uint8_t nAlgo)
+{
+    const CAlgoInfo& info = GetAlgoInfo(nAlgo);
+    switch (info.memoryClass) {
+    case ALGO_MEMORY_LIGHT:
+        return 50000;
+    case ALGO_MEMORY_EQUIHASH:
+        return 150000;
+    case ALGO_MEMORY_HARD:
+        break;
+    }
+    if (info.nScratchpadSize == 0) // scrypt and neoscrypt keep their 128 KiB scratchpad on the stack
+        return 4000;
+    return std::max<uint64_t>(1, POW_HASH_SCRATCHPAD_BYTES_PER_SECOND / info.nScratchpadSize);
+}
+
+static void PoWHash(benchmark::State& state, uint8_t nAlgo)
+{
+    const auto chainParams = CreateChainParams(CBaseChainParams::MAIN);
+    CBlockHeader header = CreatePoWBenchHeader(nAlgo, *chainParams, 0);
+    const int nHashVersion = LoadMultiHasherVersionFlags(true);
+    const bool fEquihash = IsEquihashBasedAlgo(nAlgo);
+
+    while (state.KeepRunning()) {
+        header.GetPoWHash(nAlgo, SER_GETHASH, nHashVersion);
+        if (fEquihash)
+            header.nBigNonce = ArithToUint256(UintToArith256(header.nBigNonce) + 1);
+        else
+            header.nNonce++;
+    }
+}
+
+/** Registers PoWHash_<algo> for every implemented algo, so new algos are measured without touching this file. */
+static bool RegisterPoWHashBenchmarks()
+{
+    for (uint8_t nAlgo = 0; nAlgo < NUM_ALGOS_IMPL; nAlgo++) {
+        benchmark::BenchRunner("PoWHash_" + GetAlgoName(nAlgo),
+            [nAlgo](benchmark::State& state) { PoWHash(state, nAlgo); },
+            PoWHashItersForOneSecond(nAlgo));
+    }
+    return true;
+}
+
+static const bool fPoWHashBenchmarks = RegisterPoWHashBenchmarks();
@@ -4,34 +4,66 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <chain.h>
+#include <auxpowcache.h>
 #include <bignum.h>
+#include <equihashstore.h>
 #include <globaltoken/hardfork.h>
+#include <util.h>
 #include <validation.h>
 
 CBlockHeader CBlockIndex::GetBlockHeader(const Consensus::Params& consensusParams) const
 {
     CBlockHeader block;
     block.nVersion       = nVersion;
-    /* The CBlockIndex object's block header is missing the auxpow.
-       So if this is an auxpow block, read it from disk instead.  We only
-       have to read the actual *header*, not the full block.  */
-    if (block.IsAuxpow())
-    {
-        ReadBlockHeaderFromDisk(block, this, consensusParams);
-        return block;
-    }
     if (pprev)
         block.hashPrevBlock = pprev->GetBlockHash();
     block.hashMerkleRoot = hashMerkleRoot;
-    block.hashReserved   = hashReserved;
     block.nTime          = nTime;
     block.nBits          = nBits;
     block.nNonce         = nNonce;
-    block.nBigNonce      = nBigNonce;
-    block.nSolution      = nSolution;
+    if (IsEquihashBasedAlgo(GetAlgo()))
+    {
+        // A header without its solution would be relayed as invalid proof-of-work
+        CEquihashFields fields;
+        if (!equihashstore.Get(GetBlockHash(), fields))
+            throw std::runtime_error(strprintf("%s: equihash fields of %s not found", __func__, GetBlockHash().ToString()));
+        block.hashReserved = fields.hashReserved;
+        block.nBigNonce    = fields.nBigNonce;
+        block.nSolution    = std::move(fields.nSolution);
+    }
+    /* The CBlockIndex object's block header is missing the auxpow.
+       So if this is an auxpow block, take it from the auxpow cache or
+       read it from disk instead.  We only have to read the actual
+       *header*, not the full block.  */
+    if (block.IsAuxpow())
+    {
+        if (auxpowcache.Get(GetBlockHash(), block.auxpow))
+        {
+            block.fAuxPowChecked = true;
+            return block;
+        }
+        ReadBlockHeaderFromDisk(block, this, consensusParams);
+        if (block.fAuxPowChecked && block.auxpow)
+            auxpowcache.Add(GetBlockHash(), *block.auxpow);
+    }
     return block;
 }
 
+CDiskBlockIndex::CDiskBlockIndex(const CBlockIndex* pindex) : CBlockIndex(*pindex)
+{
+    hashPrev = (pprev ? pprev->GetBlockHash() : uint256());
+    if (IsEquihashBasedAlgo(GetAlgo()))
+    {
+        // Writing the entry without its solution would corrupt the block tree database
+        CEquihashFields fields;
+        if (!equihashstore.Get(pindex->GetBlockHash(), fields))
+            throw std::runtime_error(strprintf("%s: equihash fields of %s not found", __func__, pindex->GetBlockHash().ToString()));
+        hashReserved = fields.hashReserved;
+        nBigNonce    = fields.nBigNonce;
+        nSolution    = std::move(fields.nSolution);
+    }
+}
+
 /**
  * CChain implementation
  */
@@ -145,6 +177,42 @@ void CBlockIndex::BuildSkip()
         pskip = pprev->GetAncestor(GetSkipHeight(nHeight));
 }
 
+const CBlockIndex* CBlockIndex::GetLastAncestorForAlgo(uint8_t algo) const
+{
+    if (algo >= NUM_ALGOS_IMPL)
+        return nullptr;
+
+    // At most ALGO_TABLE_INTERVAL steps back, the algo table of a block answers the lookup.
+    const CBlockIndex* pindexWalk = this;
+    while (pindexWalk != nullptr && pindexWalk->GetAlgo() != algo) {
+        if (pindexWalk->pAlgoTable)
+            return (*pindexWalk->pAlgoTable)[algo];
+        pindexWalk = pindexWalk->pprev;
+    }
+    return pindexWalk;
+}
+
+CBlockIndex* CBlockIndex::GetLastAncestorForAlgo(uint8_t algo)
+{
+    return const_cast<CBlockIndex*>(static_cast<const CBlockIndex*>(this)->GetLastAncestorForAlgo(algo));
+}
+
+void CBlockIndex::BuildAlgoSkip(const Consensus::Params& params)
+{
+    pprevAlgo = pprev ? pprev->GetLastAncestorForAlgo(GetAlgo()) : nullptr;
+    nLastPreHF1Height = params.Hardfork1.IsActivated(nTime) ? (pprev ? pprev->nLastPreHF1Height : -1) : nHeight;
+    nLastPreHF2Height = params.Hardfork2.IsActivated(nTime) ? (pprev ? pprev->nLastPreHF2Height : -1) : nHeight;
+
+    pAlgoTable.reset();
+    if (nHeight % ALGO_TABLE_INTERVAL == 0) {
+        std::shared_ptr<std::array<CBlockIndex*, NUM_ALGOS_IMPL> > table = std::make_shared<std::array<CBlockIndex*, NUM_ALGOS_IMPL> >();
+        for (int algo = 0; algo < NUM_ALGOS_IMPL; algo++)
+            (*table)[algo] = GetLastAncestorForAlgo(algo);
+        pAlgoTable = table;
+    }
+    fAlgoSkipBuilt = true;
+}
+
 arith_uint256 GetBlockProofBase(const CBlockIndex& block)
 {
     arith_uint256 bnTarget;
@@ -178,7 +246,7 @@ double CalculateAlgoHashrate(const CBlockIndex& block, int algo, int lookup, con
     int64_t maxTime = minTime;
     for (int i = 0; i < lookup; i++) 
     {
-        pPreviousAlgoBlock = GetLastBlockIndexForAlgo(pLastAlgoBlock->pprev, algo, params);
+        pPreviousAlgoBlock = GetPrevBlockIndexForAlgo(pLastAlgoBlock, params);
         if(pPreviousAlgoBlock == nullptr)
         {
             break;
@@ -204,6 +272,20 @@ double CalculateAlgoHashrate(const CBlockIndex& block, int algo, int lookup, con
 
 arith_uint256 GetPrevWorkForAlgoWithDecay(const CBlockIndex& block, int algo, const Consensus::Params& params)
 {
+    if (block.fAlgoSkipBuilt && algo < NUM_ALGOS_IMPL)
+    {
+        const CBlockIndex* pindexAlgo = block.GetLastAncestorForAlgo(algo);
+        if (pindexAlgo == nullptr)
+            return arith_uint256(0);
+        int nDistance = block.nHeight - pindexAlgo->nHeight;
+        if (nDistance > 100 || (algo != ALGO_SHA256D && block.nLastPreHF1Height >= pindexAlgo->nHeight))
+            return arith_uint256(0);
+        arith_uint256 nWork = GetBlockProofBase(*pindexAlgo);
+        nWork *= (100 - nDistance);
+        nWork /= 100;
+        return nWork;
+    }
+
     int nDistance = 0;
     arith_uint256 nWork;
     const CBlockIndex* pindex = &block;
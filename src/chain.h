@@ -13,9 +13,15 @@
 #include <tinyformat.h>
 #include <uint256.h>
 #include <chainparams.h>
+#include <equihashstore.h>
 
+#include <array>
+#include <memory>
 #include <vector>
 
+/** Every block at a multiple of this height keeps a table of the last block of each algo. */
+static const int ALGO_TABLE_INTERVAL = 32;
+
 /**
  * Maximum amount of time that a block timestamp is allowed to exceed the
  * current network-adjusted time before the block will be accepted.
@@ -208,15 +214,12 @@ public:
     //! Verification status of this block. See enum BlockStatus
     uint32_t nStatus;
 
-    //! block header
+    //! block header, the fields only used by equihash based algos are kept in equihashstore
     int32_t nVersion;
     uint256 hashMerkleRoot;
-	uint256 hashReserved;
     uint32_t nTime;
     uint32_t nBits;
     uint32_t nNonce;
-    uint256 nBigNonce;
-	std::vector<unsigned char> nSolution;
 
     //! (memory only) Sequential id assigned to distinguish order in which blocks are received.
     int32_t nSequenceId;
@@ -224,6 +227,21 @@ public:
     //! (memory only) Maximum nTime in the chain up to and including this block.
     unsigned int nTimeMax;
 
+    //! (memory only) pointer to the index of the nearest predecessor mined with the same algo
+    CBlockIndex* pprevAlgo;
+
+    //! (memory only) for blocks at a multiple of ALGO_TABLE_INTERVAL, the last block of each algo
+    //! up to and including this block
+    std::shared_ptr<const std::array<CBlockIndex*, NUM_ALGOS_IMPL> > pAlgoTable;
+
+    //! (memory only) height of the last block up to and including this block whose nTime
+    //! is before the activation of hardfork 1 respectively hardfork 2, -1 if there is none
+    int nLastPreHF1Height;
+    int nLastPreHF2Height;
+
+    //! (memory only) whether the per-algo fields above have been built
+    bool fAlgoSkipBuilt;
+
     void SetNull()
     {
         phashBlock = nullptr;
@@ -239,15 +257,17 @@ public:
         nStatus = 0;
         nSequenceId = 0;
         nTimeMax = 0;
+        pprevAlgo = nullptr;
+        pAlgoTable.reset();
+        nLastPreHF1Height = -1;
+        nLastPreHF2Height = -1;
+        fAlgoSkipBuilt = false;
 
         nVersion       = 0;
         hashMerkleRoot = uint256();
-		hashReserved   = uint256();
         nTime          = 0;
         nBits          = 0;
         nNonce         = 0;
-        nBigNonce      = uint256();
-		nSolution.clear();
     }
 
     CBlockIndex()
@@ -261,12 +281,9 @@ public:
 
         nVersion       = block.nVersion;
         hashMerkleRoot = block.hashMerkleRoot;
-		hashReserved   = block.hashReserved;
         nTime          = block.nTime;
         nBits          = block.nBits;
         nNonce         = block.nNonce;
-        nBigNonce      = block.nBigNonce;
-		nSolution      = block.nSolution;
     }
 
     CDiskBlockPos GetBlockPos() const {
@@ -383,8 +400,17 @@ public:
     //! Efficiently find an ancestor of this block.
     CBlockIndex* GetAncestor(int height);
     const CBlockIndex* GetAncestor(int height) const;
+
+    //! Build the per-algo predecessor pointer, algo table and hardfork heights for this entry.
+    void BuildAlgoSkip(const Consensus::Params& params);
+
+    //! Find the last block of an algo up to and including this block, regardless of hardfork activation.
+    CBlockIndex* GetLastAncestorForAlgo(uint8_t algo);
+    const CBlockIndex* GetLastAncestorForAlgo(uint8_t algo) const;
 };
 
+/** Work of a single block, without the multi-algo weighting of GetBlockProof. */
+arith_uint256 GetBlockProofBase(const CBlockIndex& block);
 arith_uint256 GetBlockProof(const CBlockIndex& block);
 arith_uint256 GetBlockProof(const CBlockIndex& block, const Consensus::Params&);
 double CalculateAlgoHashrate(const CBlockIndex& block, int algo, int lookup, const Consensus::Params&);
@@ -399,14 +425,15 @@ class CDiskBlockIndex : public CBlockIndex
 {
 public:
     uint256 hashPrev;
+    uint256 hashReserved;
+    uint256 nBigNonce;
+    std::vector<unsigned char> nSolution;
 
     CDiskBlockIndex() {
         hashPrev = uint256();
     }
 
-    explicit CDiskBlockIndex(const CBlockIndex* pindex) : CBlockIndex(*pindex) {
-        hashPrev = (pprev ? pprev->GetBlockHash() : uint256());
-    }
+    explicit CDiskBlockIndex(const CBlockIndex* pindex);
 
     ADD_SERIALIZE_METHODS;
 
@@ -446,19 +473,33 @@ public:
         }
     }
 
-    uint256 GetBlockHash() const
+    CBlockHeader GetDiskBlockHeader() const
     {
         CBlockHeader block;
         block.nVersion        = nVersion;
         block.hashPrevBlock   = hashPrev;
         block.hashMerkleRoot  = hashMerkleRoot;
-		block.hashReserved    = hashReserved;
+        block.hashReserved    = hashReserved;
         block.nTime           = nTime;
         block.nBits           = nBits;
         block.nNonce          = nNonce;
         block.nBigNonce       = nBigNonce;
-		block.nSolution       = nSolution;
-        return block.GetHash();
+        block.nSolution       = nSolution;
+        return block;
+    }
+
+    CEquihashFields GetEquihashFields() const
+    {
+        CEquihashFields fields;
+        fields.hashReserved   = hashReserved;
+        fields.nBigNonce      = nBigNonce;
+        fields.nSolution      = nSolution;
+        return fields;
+    }
+
+    uint256 GetBlockHash() const
+    {
+        return GetDiskBlockHeader().GetHash();
     }
 
 
@@ -41,6 +41,9 @@ typedef unsigned char byte;
         #define BLOCK_LEN_BYTES (BLOCK_LEN_INT64 * 8)    //Block length, in bytes
 #endif
 
+//Scratchpad bytes used for a memory matrix of nRows x nCols: sponge state, matrix and row pointers
+#define LYRA2_SCRATCHPAD_SIZE(nRows, nCols) (16 * sizeof (uint64_t) + (size_t) (nRows) * (nCols) * BLOCK_LEN_BYTES + (size_t) (nRows) * sizeof (uint64_t*))
+
 int LYRA2(void *K, uint64_t kLen, const void *pwd, uint64_t pwdlen, const void *salt, uint64_t saltlen, uint64_t timeCost, uint64_t nRows, uint64_t nCols);
 
 int LYRA2_3(void *K, uint64_t kLen, const void *pwd, uint64_t pwdlen, const void *salt, uint64_t saltlen, uint64_t timeCost, uint64_t nRows, uint64_t nCols);
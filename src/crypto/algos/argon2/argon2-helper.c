@@ -1,5 +1,62 @@
+#include "../powkernels.h"
+
 #if defined (__SSE2__)
+/*
+ * The baseline fill_segment() is built with the flags of the library, the
+ * ones for higher instruction sets (opt-sse41.c, opt-avx2.c) are selected at
+ * runtime by argon2_select_fill_segment().
+ */
+#define fill_block fill_block_baseline
+#define fill_segment fill_segment_baseline
 #include "opt.c"
+#undef fill_block
+#undef fill_segment
+
+typedef void (*fill_segment_t)(const argon2_instance_t *instance,
+                               argon2_position_t position);
+
+#if defined(ENABLE_SSE41) && defined(__x86_64__)
+extern void fill_segment_sse41(const argon2_instance_t *instance,
+                               argon2_position_t position);
+#endif
+#if defined(ENABLE_AVX2) && defined(__x86_64__)
+extern void fill_segment_avx2(const argon2_instance_t *instance,
+                              argon2_position_t position);
+#endif
+
+static fill_segment_t fill_segment_selected = fill_segment_baseline;
+
+void fill_segment(const argon2_instance_t *instance,
+                  argon2_position_t position) {
+    fill_segment_selected(instance, position);
+}
+
+const char *argon2_select_fill_segment(int tier) {
+#if defined(ENABLE_AVX2) && defined(__x86_64__)
+    if (tier >= POW_KERNEL_AVX2) {
+        fill_segment_selected = fill_segment_avx2;
+        return "avx2";
+    }
+#endif
+#if defined(ENABLE_SSE41) && defined(__x86_64__)
+    if (tier >= POW_KERNEL_SSE41) {
+        fill_segment_selected = fill_segment_sse41;
+        return "sse4.1";
+    }
+#endif
+    (void)tier;
+    fill_segment_selected = fill_segment_baseline;
+#if defined(__SSSE3__)
+    return "ssse3";
+#else
+    return "sse2";
+#endif
+}
 #else
 #include "ref.c"
-#endif
\ No newline at end of file
+
+const char *argon2_select_fill_segment(int tier) {
+    (void)tier;
+    return "generic";
+}
+#endif
@@ -5,12 +5,24 @@
 
 #include "argon2.h"
 #include "hashargon.h"
+#include "../scratchpad.h"
 
 #include <cstring>
 #include <cstdlib>
 #include <stdexcept>
 #include <assert.h>
 
+/** Argon2 memory is taken from the scratchpad arena of the thread, which keeps it for the next hash */
+static int AllocateScratchpad(uint8_t **memory, size_t bytes_to_allocate)
+{
+    *memory = static_cast<uint8_t*>(pow_scratchpad_get(bytes_to_allocate));
+    return *memory ? ARGON2_OK : ARGON2_MEMORY_ALLOCATION_ERROR;
+}
+
+static void FreeScratchpad(uint8_t *memory, size_t bytes_to_allocate)
+{
+}
+
 int cpu23R_hash_argon2i(void *out, size_t outlen, const void *in, size_t inlen,
                  const void *salt, size_t saltlen, unsigned int t_cost,
                  unsigned int m_cost) {
@@ -47,8 +59,8 @@ int cpu23R_hash_argon2i(void *out, size_t outlen, const void *in, size_t inlen,
     context.m_cost = m_cost;
     context.lanes = 1;
     context.threads = 1;
-    context.allocate_cbk = NULL;
-    context.free_cbk = NULL;
+    context.allocate_cbk = AllocateScratchpad;
+    context.free_cbk = FreeScratchpad;
     context.flags = ARGON2_DEFAULT_FLAGS;
 
     return argon2_ctx(&context, Argon2_i);
@@ -89,8 +101,8 @@ int cpu23R_hash_argon2d(void *out, size_t outlen, const void *in, size_t inlen,
     context.m_cost = m_cost;
     context.lanes = 1;
     context.threads = 1;
-    context.allocate_cbk = NULL;
-    context.free_cbk = NULL;
+    context.allocate_cbk = AllocateScratchpad;
+    context.free_cbk = FreeScratchpad;
     context.flags = ARGON2_DEFAULT_FLAGS;
 
     return argon2_ctx(&context, Argon2_d);
@@ -115,13 +127,13 @@ void Argon2dHash (const void* input, const size_t inlen, void* output, const siz
     ctx.ad              = nullptr;
     ctx.adlen           = 0;
 
-    ctx.m_cost          = 384;
-    ctx.t_cost          = 2;
-    ctx.lanes           = 2;
+    ctx.m_cost          = ARGON2D_HASH_M_COST;
+    ctx.t_cost          = ARGON2D_HASH_T_COST;
+    ctx.lanes           = ARGON2D_HASH_LANES;
     ctx.threads         = 1;
 
-    ctx.allocate_cbk    = nullptr;
-    ctx.free_cbk        = nullptr;
+    ctx.allocate_cbk    = AllocateScratchpad;
+    ctx.free_cbk        = FreeScratchpad;
 
     const int result = argon2_ctx (&ctx, Argon2_d);
     assert (result == ARGON2_OK);
@@ -146,13 +158,13 @@ void Argon2iHash (const void* input, const size_t inlen, void* output, const siz
     ctx.ad              = nullptr;
     ctx.adlen           = 0;
 
-    ctx.m_cost          = 128;
-    ctx.t_cost          = 4;
-    ctx.lanes           = 6;
+    ctx.m_cost          = ARGON2I_HASH_M_COST;
+    ctx.t_cost          = ARGON2I_HASH_T_COST;
+    ctx.lanes           = ARGON2I_HASH_LANES;
     ctx.threads         = 1;
 
-    ctx.allocate_cbk    = nullptr;
-    ctx.free_cbk        = nullptr;
+    ctx.allocate_cbk    = AllocateScratchpad;
+    ctx.free_cbk        = FreeScratchpad;
 
     const int result = argon2_ctx (&ctx, Argon2_i);
     assert (result == ARGON2_OK);
@@ -6,8 +6,23 @@
 #ifndef HASH_ARGON_H
 #define HASH_ARGON_H
 
+#include <cstddef>
 #include <cstdint>
 
+//! Costs of Argon2dHash and Argon2iHash
+static const uint32_t ARGON2D_HASH_M_COST = 384;
+static const uint32_t ARGON2D_HASH_T_COST = 2;
+static const uint32_t ARGON2D_HASH_LANES = 2;
+static const uint32_t ARGON2I_HASH_M_COST = 128;
+static const uint32_t ARGON2I_HASH_T_COST = 4;
+static const uint32_t ARGON2I_HASH_LANES = 6;
+
+/** Scratchpad bytes of an Argon2 hash with the given memory cost (KiB) and lanes, rounded as argon2_ctx does */
+constexpr size_t Argon2ScratchpadSize(uint32_t m_cost, uint32_t lanes)
+{
+    return (size_t)((m_cost < 8 * lanes ? 8 * lanes : m_cost) / (4 * lanes) * (4 * lanes)) * 1024;
+}
+
 void Argon2dHash(const void* input, const size_t inlen, void* output, const size_t outlen, const void *salthash, const size_t salthashlen, const void *secrethash, const size_t secrethashlen);
 void Argon2iHash(const void* input, const size_t inlen, void* output, const size_t outlen, const void *salthash, const size_t salthashlen, const void *secrethash, const size_t secrethashlen);
 
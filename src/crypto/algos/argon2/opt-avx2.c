@@ -0,0 +1,9 @@
+/*
+ * fill_segment() built for AVX2, selected at
+ * runtime by argon2_select_fill_segment() in argon2-helper.c.
+ */
+#if defined(__x86_64__)
+#define fill_block fill_block_avx2
+#define fill_segment fill_segment_avx2
+#include "opt.c"
+#endif
@@ -0,0 +1,9 @@
+/*
+ * fill_segment() built for SSE4.1, which brings the SSSE3 rounds, selected at
+ * runtime by argon2_select_fill_segment() in argon2-helper.c.
+ */
+#if defined(__x86_64__)
+#define fill_block fill_block_sse41
+#define fill_segment fill_segment_sse41
+#include "opt.c"
+#endif
@@ -726,51 +726,73 @@ invalidsolution:
 }
 
 template<unsigned int N, unsigned int K>
-bool Equihash<N,K>::IsValidSolution(const eh_HashState& base_state, std::vector<unsigned char> soln)
+bool Equihash<N,K>::IsValidSolution(const eh_HashState& base_state, const std::vector<unsigned char>& soln)
 {
-    if (soln.size() != SolutionWidth) {
+    return IsValidSolution(base_state, soln.data(), soln.size());
+}
+
+template<unsigned int N, unsigned int K>
+bool Equihash<N,K>::IsValidSolution(const eh_HashState& base_state, const unsigned char* soln, size_t solnLen)
+{
+    if (solnLen != SolutionWidth) {
         LogPrint(BCLog::POW, "Invalid solution length: %d (expected %d)\n",
-                 soln.size(), SolutionWidth);
+                 solnLen, SolutionWidth);
         return false;
     }
 
-    std::vector<FullStepRow<FinalFullWidth>> X;
-    X.reserve(1 << K);
+    // One row of HashLength bytes per index. At every level the right row of each
+    // pair of subtrees is merged into the left one, so after level l the row of the
+    // first index of a subtree holds its XOR from byte (l+1)*CollisionByteLength on.
+    eh_index indices[1 << K];
+    unsigned char rows[1 << K][HashLength];
     unsigned char tmpHash[HashOutput];
-    for (eh_index i : GetIndicesFromMinimal(soln, CollisionBitLength)) {
-        GenerateHash(base_state, i/IndicesPerHashOutput, tmpHash, HashOutput);
-        X.emplace_back(tmpHash+((i % IndicesPerHashOutput) * N/8),
-                       N/8, HashLength, CollisionBitLength, i);
+
+    ExpandArray(soln, solnLen, (unsigned char*)indices, sizeof(indices),
+                CollisionBitLength+1, sizeof(eh_index)-((CollisionBitLength+1)+7)/8);
+    for (size_t i = 0; i < (1 << K); i++) {
+        indices[i] = ArrayToEhIndex((const unsigned char*)&indices[i]);
+        GenerateHash(base_state, indices[i]/IndicesPerHashOutput, tmpHash, HashOutput);
+        ExpandArray(tmpHash+((indices[i] % IndicesPerHashOutput) * N/8), N/8,
+                    rows[i], HashLength, CollisionBitLength);
     }
 
-    size_t hashLen = HashLength;
-    size_t lenIndices = sizeof(eh_index);
-    while (X.size() > 1) {
-        std::vector<FullStepRow<FinalFullWidth>> Xc;
-        for (size_t i = 0; i < X.size(); i += 2) {
-            if (!HasCollision(X[i], X[i+1], CollisionByteLength)) {
+    // Every pair of indices meets in exactly one merge, so checking the indices of
+    // each merged pair of subtrees for duplicates amounts to checking all of them.
+    eh_index sorted[1 << K];
+    std::copy(indices, indices + (1 << K), sorted);
+    std::sort(sorted, sorted + (1 << K));
+    if (std::adjacent_find(sorted, sorted + (1 << K)) != sorted + (1 << K)) {
+        LogPrint(BCLog::POW, "Invalid solution: duplicate indices\n");
+        return false;
+    }
+
+    for (size_t level = 0, width = 1; level < K; level++, width *= 2) {
+        const size_t hashStart = level * CollisionByteLength;
+        for (size_t i = 0; i < (1 << K); i += 2 * width) {
+            unsigned char* a = rows[i];
+            const unsigned char* b = rows[i + width];
+            if (memcmp(a + hashStart, b + hashStart, CollisionByteLength) != 0) {
                 LogPrint(BCLog::POW, "Invalid solution: invalid collision length between StepRows\n");
-                LogPrint(BCLog::POW, "X[i]   = %s\n", X[i].GetHex(hashLen));
-                LogPrint(BCLog::POW, "X[i+1] = %s\n", X[i+1].GetHex(hashLen));
+                LogPrint(BCLog::POW, "X[i]   = %s\n", HexStr(a + hashStart, a + HashLength));
+                LogPrint(BCLog::POW, "X[i+1] = %s\n", HexStr(b + hashStart, b + HashLength));
                 return false;
             }
-            if (X[i+1].IndicesBefore(X[i], hashLen, lenIndices)) {
+            // The indices are distinct, so the index sequences of the two subtrees
+            // are ordered by their first index.
+            if (indices[i + width] < indices[i]) {
                 LogPrint(BCLog::POW, "Invalid solution: Index tree incorrectly ordered\n");
                 return false;
             }
-            if (!DistinctIndices(X[i], X[i+1], hashLen, lenIndices)) {
-                LogPrint(BCLog::POW, "Invalid solution: duplicate indices\n");
-                return false;
-            }
-            Xc.emplace_back(X[i], X[i+1], hashLen, lenIndices, CollisionByteLength);
+            for (size_t j = hashStart + CollisionByteLength; j < HashLength; j++)
+                a[j] ^= b[j];
         }
-        X = Xc;
-        hashLen -= CollisionByteLength;
-        lenIndices *= 2;
     }
 
-    assert(X.size() == 1);
-    return X[0].IsZero(hashLen);
+    for (size_t j = K * CollisionByteLength; j < HashLength; j++) {
+        if (rows[0][j] != 0)
+            return false;
+    }
+    return true;
 }
 
 // Explicit instantiations for Equihash<96,3>
@@ -781,7 +803,8 @@ template bool Equihash<96,3>::BasicSolve(const eh_HashState& base_state,
 template bool Equihash<96,3>::OptimisedSolve(const eh_HashState& base_state,
                                              const std::function<bool(std::vector<unsigned char>)> validBlock,
                                              const std::function<bool(EhSolverCancelCheck)> cancelled);
-template bool Equihash<96,3>::IsValidSolution(const eh_HashState& base_state, std::vector<unsigned char> soln);
+template bool Equihash<96,3>::IsValidSolution(const eh_HashState& base_state, const std::vector<unsigned char>& soln);
+template bool Equihash<96,3>::IsValidSolution(const eh_HashState& base_state, const unsigned char* soln, size_t solnLen);
 
 // Explicit instantiations for Equihash<200,9>
 template int Equihash<200,9>::InitialiseState(eh_HashState& base_state, const std::string strPersonalstring);
@@ -791,7 +814,8 @@ template bool Equihash<200,9>::BasicSolve(const eh_HashState& base_state,
 template bool Equihash<200,9>::OptimisedSolve(const eh_HashState& base_state,
                                               const std::function<bool(std::vector<unsigned char>)> validBlock,
                                               const std::function<bool(EhSolverCancelCheck)> cancelled);
-template bool Equihash<200,9>::IsValidSolution(const eh_HashState& base_state, std::vector<unsigned char> soln);
+template bool Equihash<200,9>::IsValidSolution(const eh_HashState& base_state, const std::vector<unsigned char>& soln);
+template bool Equihash<200,9>::IsValidSolution(const eh_HashState& base_state, const unsigned char* soln, size_t solnLen);
 
 // Explicit instantiations for Equihash<144,5>
 template int Equihash<144,5>::InitialiseState(eh_HashState& base_state, const std::string strPersonalstring);
@@ -801,7 +825,8 @@ template bool Equihash<144,5>::BasicSolve(const eh_HashState& base_state,
 template bool Equihash<144,5>::OptimisedSolve(const eh_HashState& base_state,
                                               const std::function<bool(std::vector<unsigned char>)> validBlock,
                                               const std::function<bool(EhSolverCancelCheck)> cancelled);
-template bool Equihash<144,5>::IsValidSolution(const eh_HashState& base_state, std::vector<unsigned char> soln);
+template bool Equihash<144,5>::IsValidSolution(const eh_HashState& base_state, const std::vector<unsigned char>& soln);
+template bool Equihash<144,5>::IsValidSolution(const eh_HashState& base_state, const unsigned char* soln, size_t solnLen);
 
 // Explicit instantiations for Equihash<96,5>
 template int Equihash<96,5>::InitialiseState(eh_HashState& base_state, const std::string strPersonalstring);
@@ -811,7 +836,8 @@ template bool Equihash<96,5>::BasicSolve(const eh_HashState& base_state,
 template bool Equihash<96,5>::OptimisedSolve(const eh_HashState& base_state,
                                              const std::function<bool(std::vector<unsigned char>)> validBlock,
                                              const std::function<bool(EhSolverCancelCheck)> cancelled);
-template bool Equihash<96,5>::IsValidSolution(const eh_HashState& base_state, std::vector<unsigned char> soln);
+template bool Equihash<96,5>::IsValidSolution(const eh_HashState& base_state, const std::vector<unsigned char>& soln);
+template bool Equihash<96,5>::IsValidSolution(const eh_HashState& base_state, const unsigned char* soln, size_t solnLen);
 
 // Explicit instantiations for Equihash<48,5>
 template int Equihash<48,5>::InitialiseState(eh_HashState& base_state, const std::string strPersonalstring);
@@ -821,7 +847,8 @@ template bool Equihash<48,5>::BasicSolve(const eh_HashState& base_state,
 template bool Equihash<48,5>::OptimisedSolve(const eh_HashState& base_state,
                                              const std::function<bool(std::vector<unsigned char>)> validBlock,
                                              const std::function<bool(EhSolverCancelCheck)> cancelled);
-template bool Equihash<48,5>::IsValidSolution(const eh_HashState& base_state, std::vector<unsigned char> soln);
+template bool Equihash<48,5>::IsValidSolution(const eh_HashState& base_state, const std::vector<unsigned char>& soln);
+template bool Equihash<48,5>::IsValidSolution(const eh_HashState& base_state, const unsigned char* soln, size_t solnLen);
 // Explicit instantiations for Equihash<192,7>
 template int Equihash<192,7>::InitialiseState(eh_HashState& base_state, const std::string strPersonalstring);
 template bool Equihash<192,7>::BasicSolve(const eh_HashState& base_state,
@@ -830,4 +857,5 @@ template bool Equihash<192,7>::BasicSolve(const eh_HashState& base_state,
 template bool Equihash<192,7>::OptimisedSolve(const eh_HashState& base_state,
                                              const std::function<bool(std::vector<unsigned char>)> validBlock,
                                              const std::function<bool(EhSolverCancelCheck)> cancelled);
-template bool Equihash<192,7>::IsValidSolution(const eh_HashState& base_state, std::vector<unsigned char> soln);
\ No newline at end of file
+template bool Equihash<192,7>::IsValidSolution(const eh_HashState& base_state, const std::vector<unsigned char>& soln);
+template bool Equihash<192,7>::IsValidSolution(const eh_HashState& base_state, const unsigned char* soln, size_t solnLen);
\ No newline at end of file
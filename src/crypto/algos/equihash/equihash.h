@@ -191,7 +191,12 @@ public:
     bool OptimisedSolve(const eh_HashState& base_state,
                         const std::function<bool(std::vector<unsigned char>)> validBlock,
                         const std::function<bool(EhSolverCancelCheck)> cancelled);
-    bool IsValidSolution(const eh_HashState& base_state, std::vector<unsigned char> soln);
+    bool IsValidSolution(const eh_HashState& base_state, const std::vector<unsigned char>& soln);
+    /**
+     * Check the minimal encoded solution soln of solnLen bytes in place, building
+     * the index tree in fixed-size buffers on the stack instead of on the heap.
+     */
+    bool IsValidSolution(const eh_HashState& base_state, const unsigned char* soln, size_t solnLen);
 };
 
 #include "equihash.tcc"
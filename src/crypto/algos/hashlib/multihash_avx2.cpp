@@ -0,0 +1,814 @@
+// Copyright (c) 2026 The Globaltoken Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+// Multi-buffer AVX2 implementations of the 512-bit hash functions used by the
+// X-family chains. Every lane hashes its own message, all messages of a call
+// have the same length. The results match the sph implementations.
+
+#ifdef ENABLE_AVX2
+
+#include <stdint.h>
+#include <string.h>
+#include <immintrin.h>
+#include <utility>
+
+#include <crypto/common.h>
+
+namespace multihash_avx2 {
+namespace {
+
+/** Four 64-bit lanes */
+inline __m256i K(uint64_t x) { return _mm256_set1_epi64x(x); }
+inline __m256i Add(__m256i x, __m256i y) { return _mm256_add_epi64(x, y); }
+inline __m256i Sub(__m256i x, __m256i y) { return _mm256_sub_epi64(x, y); }
+inline __m256i Xor(__m256i x, __m256i y) { return _mm256_xor_si256(x, y); }
+inline __m256i And(__m256i x, __m256i y) { return _mm256_and_si256(x, y); }
+inline __m256i Or(__m256i x, __m256i y) { return _mm256_or_si256(x, y); }
+/** ~x & y */
+inline __m256i AndNot(__m256i x, __m256i y) { return _mm256_andnot_si256(x, y); }
+inline __m256i Not(__m256i x) { return _mm256_xor_si256(x, _mm256_set1_epi32(-1)); }
+inline __m256i Shl(__m256i x, int n) { return _mm256_slli_epi64(x, n); }
+inline __m256i Shr(__m256i x, int n) { return _mm256_srli_epi64(x, n); }
+inline __m256i Rotl(__m256i x, int n) { return Or(Shl(x, n), Shr(x, 64 - n)); }
+inline __m256i Rotr(__m256i x, int n) { return Or(Shr(x, n), Shl(x, 64 - n)); }
+
+inline __m256i LoadLE(const unsigned char* const blk[4], int w)
+{
+    return _mm256_set_epi64x(ReadLE64(blk[3] + 8 * w), ReadLE64(blk[2] + 8 * w), ReadLE64(blk[1] + 8 * w), ReadLE64(blk[0] + 8 * w));
+}
+
+inline __m256i LoadBE(const unsigned char* const blk[4], int w)
+{
+    return _mm256_set_epi64x(ReadBE64(blk[3] + 8 * w), ReadBE64(blk[2] + 8 * w), ReadBE64(blk[1] + 8 * w), ReadBE64(blk[0] + 8 * w));
+}
+
+inline void StoreLE(unsigned char* const out[4], int w, __m256i x)
+{
+    alignas(32) uint64_t v[4];
+    _mm256_store_si256((__m256i*)v, x);
+    for (int l = 0; l < 4; l++)
+        WriteLE64(out[l] + 8 * w, v[l]);
+}
+
+inline void StoreBE(unsigned char* const out[4], int w, __m256i x)
+{
+    alignas(32) uint64_t v[4];
+    _mm256_store_si256((__m256i*)v, x);
+    for (int l = 0; l < 4; l++)
+        WriteBE64(out[l] + 8 * w, v[l]);
+}
+
+/** Eight 32-bit lanes */
+inline __m256i K32(uint32_t x) { return _mm256_set1_epi32(x); }
+inline __m256i Rotl32(__m256i x, int n) { return Or(_mm256_slli_epi32(x, n), _mm256_srli_epi32(x, 32 - n)); }
+
+inline __m256i LoadBE32(const unsigned char* const blk[8], int w)
+{
+    return _mm256_set_epi32(ReadBE32(blk[7] + 4 * w), ReadBE32(blk[6] + 4 * w), ReadBE32(blk[5] + 4 * w), ReadBE32(blk[4] + 4 * w),
+                            ReadBE32(blk[3] + 4 * w), ReadBE32(blk[2] + 4 * w), ReadBE32(blk[1] + 4 * w), ReadBE32(blk[0] + 4 * w));
+}
+
+inline void StoreBE32(unsigned char* const out[8], int w, __m256i x)
+{
+    alignas(32) uint32_t v[8];
+    _mm256_store_si256((__m256i*)v, x);
+    for (int l = 0; l < 8; l++)
+        WriteBE32(out[l] + 4 * w, v[l]);
+}
+
+/**
+ * Pad the last, partial block of every lane into tail. The lanes share the
+ * layout, so the caller only adds the length encoding of the algorithm.
+ */
+template<size_t NLANES>
+void PrepareTail(unsigned char (*tail)[256], const unsigned char* const in[NLANES], size_t off, size_t rem, size_t nTail)
+{
+    for (size_t l = 0; l < NLANES; l++) {
+        memset(tail[l], 0, nTail);
+        memcpy(tail[l], in[l] + off, rem);
+    }
+}
+
+/// BLAKE-512
+
+const uint64_t BLAKE512_IV[8] = {
+    0x6A09E667F3BCC908ULL, 0xBB67AE8584CAA73BULL, 0x3C6EF372FE94F82BULL, 0xA54FF53A5F1D36F1ULL,
+    0x510E527FADE682D1ULL, 0x9B05688C2B3E6C1FULL, 0x1F83D9ABFB41BD6BULL, 0x5BE0CD19137E2179ULL
+};
+
+const uint64_t BLAKE512_CB[16] = {
+    0x243F6A8885A308D3ULL, 0x13198A2E03707344ULL, 0xA4093822299F31D0ULL, 0x082EFA98EC4E6C89ULL,
+    0x452821E638D01377ULL, 0xBE5466CF34E90C6CULL, 0xC0AC29B7C97C50DDULL, 0x3F84D5B5B5470917ULL,
+    0x9216D5D98979FB1BULL, 0xD1310BA698DFB5ACULL, 0x2FFD72DBD01ADFB7ULL, 0xB8E1AFED6A267E96ULL,
+    0xBA7C9045F12C7F99ULL, 0x24A19947B3916CF7ULL, 0x0801F2E2858EFC16ULL, 0x636920D871574E69ULL
+};
+
+const uint8_t BLAKE_SIGMA[10][16] = {
+    { 0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15},
+    {14, 10,  4,  8,  9, 15, 13,  6,  1, 12,  0,  2, 11,  7,  5,  3},
+    {11,  8, 12,  0,  5,  2, 15, 13, 10, 14,  3,  6,  7,  1,  9,  4},
+    { 7,  9,  3,  1, 13, 12, 11, 14,  2,  6,  5, 10,  4,  0, 15,  8},
+    { 9,  0,  5,  7,  2,  4, 10, 15, 14,  1, 11, 12,  6,  8,  3, 13},
+    { 2, 12,  6, 10,  0, 11,  8,  3,  4, 13,  7,  5, 15, 14,  1,  9},
+    {12,  5,  1, 15, 14, 13,  4, 10,  0,  7,  6,  3,  9,  2,  8, 11},
+    {13, 11,  7, 14, 12,  1,  3,  9,  5,  0, 15,  4,  8,  6,  2, 10},
+    { 6, 15, 14,  9, 11,  3,  0,  8, 12,  2, 13,  7,  1,  4, 10,  5},
+    {10,  2,  8,  4,  7,  6,  1,  5, 15, 11,  9, 14,  3, 12, 13,  0}
+};
+
+inline void BlakeG(__m256i& a, __m256i& b, __m256i& c, __m256i& d, const __m256i m[16], const uint8_t* sigma, int i)
+{
+    a = Add(Add(a, b), Xor(m[sigma[2 * i]], K(BLAKE512_CB[sigma[2 * i + 1]])));
+    d = Rotr(Xor(d, a), 32);
+    c = Add(c, d);
+    b = Rotr(Xor(b, c), 25);
+    a = Add(Add(a, b), Xor(m[sigma[2 * i + 1]], K(BLAKE512_CB[sigma[2 * i]])));
+    d = Rotr(Xor(d, a), 16);
+    c = Add(c, d);
+    b = Rotr(Xor(b, c), 11);
+}
+
+/** Compress one block with the bit counter t (messages are shorter than 2^64 bits). */
+void Blake512Compress(__m256i h[8], const unsigned char* const blk[4], uint64_t t)
+{
+    __m256i m[16], v[16];
+    for (int i = 0; i < 16; i++)
+        m[i] = LoadBE(blk, i);
+    for (int i = 0; i < 8; i++)
+        v[i] = h[i];
+    v[8] = K(BLAKE512_CB[0]);
+    v[9] = K(BLAKE512_CB[1]);
+    v[10] = K(BLAKE512_CB[2]);
+    v[11] = K(BLAKE512_CB[3]);
+    v[12] = K(t ^ BLAKE512_CB[4]);
+    v[13] = K(t ^ BLAKE512_CB[5]);
+    v[14] = K(BLAKE512_CB[6]);
+    v[15] = K(BLAKE512_CB[7]);
+    for (int r = 0; r < 16; r++) {
+        const uint8_t* sigma = BLAKE_SIGMA[r % 10];
+        BlakeG(v[0], v[4], v[8], v[12], m, sigma, 0);
+        BlakeG(v[1], v[5], v[9], v[13], m, sigma, 1);
+        BlakeG(v[2], v[6], v[10], v[14], m, sigma, 2);
+        BlakeG(v[3], v[7], v[11], v[15], m, sigma, 3);
+        BlakeG(v[0], v[5], v[10], v[15], m, sigma, 4);
+        BlakeG(v[1], v[6], v[11], v[12], m, sigma, 5);
+        BlakeG(v[2], v[7], v[8], v[13], m, sigma, 6);
+        BlakeG(v[3], v[4], v[9], v[14], m, sigma, 7);
+    }
+    for (int i = 0; i < 8; i++)
+        h[i] = Xor(h[i], Xor(v[i], v[i + 8]));
+}
+
+/// BMW-512
+
+inline __m256i BmwS0(__m256i x) { return Xor(Xor(Shr(x, 1), Shl(x, 3)), Xor(Rotl(x, 4), Rotl(x, 37))); }
+inline __m256i BmwS1(__m256i x) { return Xor(Xor(Shr(x, 1), Shl(x, 2)), Xor(Rotl(x, 13), Rotl(x, 43))); }
+inline __m256i BmwS2(__m256i x) { return Xor(Xor(Shr(x, 2), Shl(x, 1)), Xor(Rotl(x, 19), Rotl(x, 53))); }
+inline __m256i BmwS3(__m256i x) { return Xor(Xor(Shr(x, 2), Shl(x, 2)), Xor(Rotl(x, 28), Rotl(x, 59))); }
+inline __m256i BmwS4(__m256i x) { return Xor(Shr(x, 1), x); }
+inline __m256i BmwS5(__m256i x) { return Xor(Shr(x, 2), x); }
+
+inline __m256i BmwS(int i, __m256i x)
+{
+    switch (i) {
+    case 0: return BmwS0(x);
+    case 1: return BmwS1(x);
+    case 2: return BmwS2(x);
+    case 3: return BmwS3(x);
+    default: return BmwS4(x);
+    }
+}
+
+inline __m256i BmwAddElement(const __m256i m[16], const __m256i h[16], int j)
+{
+    const int j0 = j & 15, j3 = (j + 3) & 15, j10 = (j + 10) & 15;
+    __m256i x = Sub(Add(Rotl(m[j0], j0 + 1), Rotl(m[j3], j3 + 1)), Rotl(m[j10], j10 + 1));
+    return Xor(Add(x, K((uint64_t)(j + 16) * 0x0555555555555555ULL)), h[(j + 7) & 15]);
+}
+
+void Bmw512Compress(const __m256i m[16], const __m256i h[16], __m256i dh[16])
+{
+    __m256i x[16], w[16], q[32];
+    for (int i = 0; i < 16; i++)
+        x[i] = Xor(m[i], h[i]);
+    w[0] = Add(Add(Add(Sub(x[5], x[7]), x[10]), x[13]), x[14]);
+    w[1] = Sub(Add(Add(Sub(x[6], x[8]), x[11]), x[14]), x[15]);
+    w[2] = Add(Sub(Add(Add(x[0], x[7]), x[9]), x[12]), x[15]);
+    w[3] = Add(Sub(Add(Sub(x[0], x[1]), x[8]), x[10]), x[13]);
+    w[4] = Sub(Sub(Add(Add(x[1], x[2]), x[9]), x[11]), x[14]);
+    w[5] = Add(Sub(Add(Sub(x[3], x[2]), x[10]), x[12]), x[15]);
+    w[6] = Add(Sub(Sub(Sub(x[4], x[0]), x[3]), x[11]), x[13]);
+    w[7] = Sub(Sub(Sub(Sub(x[1], x[4]), x[5]), x[12]), x[14]);
+    w[8] = Sub(Add(Sub(Sub(x[2], x[5]), x[6]), x[13]), x[15]);
+    w[9] = Add(Sub(Add(Sub(x[0], x[3]), x[6]), x[7]), x[14]);
+    w[10] = Add(Sub(Sub(Sub(x[8], x[1]), x[4]), x[7]), x[15]);
+    w[11] = Add(Sub(Sub(Sub(x[8], x[0]), x[2]), x[5]), x[9]);
+    w[12] = Add(Sub(Sub(Add(x[1], x[3]), x[6]), x[9]), x[10]);
+    w[13] = Add(Add(Add(Add(x[2], x[4]), x[7]), x[10]), x[11]);
+    w[14] = Sub(Sub(Add(Sub(x[3], x[5]), x[8]), x[11]), x[12]);
+    w[15] = Add(Sub(Sub(Sub(x[12], x[4]), x[6]), x[9]), x[13]);
+    for (int i = 0; i < 16; i++)
+        q[i] = Add(BmwS(i % 5, w[i]), h[(i + 1) & 15]);
+    for (int i = 16; i < 18; i++) {
+        __m256i s = BmwAddElement(m, h, i - 16);
+        for (int k = 0; k < 16; k++)
+            s = Add(s, BmwS((k + 1) & 3, q[i - 16 + k]));
+        q[i] = s;
+    }
+    for (int i = 18; i < 32; i++) {
+        __m256i s = BmwAddElement(m, h, i - 16);
+        s = Add(s, Add(q[i - 16], Rotl(q[i - 15], 5)));
+        s = Add(s, Add(q[i - 14], Rotl(q[i - 13], 11)));
+        s = Add(s, Add(q[i - 12], Rotl(q[i - 11], 27)));
+        s = Add(s, Add(q[i - 10], Rotl(q[i - 9], 32)));
+        s = Add(s, Add(q[i - 8], Rotl(q[i - 7], 37)));
+        s = Add(s, Add(q[i - 6], Rotl(q[i - 5], 43)));
+        s = Add(s, Add(q[i - 4], Rotl(q[i - 3], 53)));
+        s = Add(s, Add(BmwS4(q[i - 2]), BmwS5(q[i - 1])));
+        q[i] = s;
+    }
+    __m256i xl = Xor(Xor(Xor(q[16], q[17]), Xor(q[18], q[19])), Xor(Xor(q[20], q[21]), Xor(q[22], q[23])));
+    __m256i xh = Xor(Xor(Xor(xl, q[24]), Xor(q[25], q[26])), Xor(Xor(q[27], q[28]), Xor(Xor(q[29], q[30]), q[31])));
+    dh[0] = Add(Xor(Xor(Shl(xh, 5), Shr(q[16], 5)), m[0]), Xor(Xor(xl, q[24]), q[0]));
+    dh[1] = Add(Xor(Xor(Shr(xh, 7), Shl(q[17], 8)), m[1]), Xor(Xor(xl, q[25]), q[1]));
+    dh[2] = Add(Xor(Xor(Shr(xh, 5), Shl(q[18], 5)), m[2]), Xor(Xor(xl, q[26]), q[2]));
+    dh[3] = Add(Xor(Xor(Shr(xh, 1), Shl(q[19], 5)), m[3]), Xor(Xor(xl, q[27]), q[3]));
+    dh[4] = Add(Xor(Xor(Shr(xh, 3), q[20]), m[4]), Xor(Xor(xl, q[28]), q[4]));
+    dh[5] = Add(Xor(Xor(Shl(xh, 6), Shr(q[21], 6)), m[5]), Xor(Xor(xl, q[29]), q[5]));
+    dh[6] = Add(Xor(Xor(Shr(xh, 4), Shl(q[22], 6)), m[6]), Xor(Xor(xl, q[30]), q[6]));
+    dh[7] = Add(Xor(Xor(Shr(xh, 11), Shl(q[23], 2)), m[7]), Xor(Xor(xl, q[31]), q[7]));
+    dh[8] = Add(Add(Rotl(dh[4], 9), Xor(Xor(xh, q[24]), m[8])), Xor(Xor(Shl(xl, 8), q[23]), q[8]));
+    dh[9] = Add(Add(Rotl(dh[5], 10), Xor(Xor(xh, q[25]), m[9])), Xor(Xor(Shr(xl, 6), q[16]), q[9]));
+    dh[10] = Add(Add(Rotl(dh[6], 11), Xor(Xor(xh, q[26]), m[10])), Xor(Xor(Shl(xl, 6), q[17]), q[10]));
+    dh[11] = Add(Add(Rotl(dh[7], 12), Xor(Xor(xh, q[27]), m[11])), Xor(Xor(Shl(xl, 4), q[18]), q[11]));
+    dh[12] = Add(Add(Rotl(dh[0], 13), Xor(Xor(xh, q[28]), m[12])), Xor(Xor(Shr(xl, 3), q[19]), q[12]));
+    dh[13] = Add(Add(Rotl(dh[1], 14), Xor(Xor(xh, q[29]), m[13])), Xor(Xor(Shr(xl, 4), q[20]), q[13]));
+    dh[14] = Add(Add(Rotl(dh[2], 15), Xor(Xor(xh, q[30]), m[14])), Xor(Xor(Shr(xl, 7), q[21]), q[14]));
+    dh[15] = Add(Add(Rotl(dh[3], 16), Xor(Xor(xh, q[31]), m[15])), Xor(Xor(Shr(xl, 2), q[22]), q[15]));
+}
+
+void Bmw512Block(__m256i h[16], const unsigned char* const blk[4])
+{
+    __m256i m[16];
+    for (int i = 0; i < 16; i++)
+        m[i] = LoadLE(blk, i);
+    Bmw512Compress(m, h, h);
+}
+
+/// Keccak-512
+
+const uint64_t KECCAK_RC[24] = {
+    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808AULL, 0x8000000080008000ULL,
+    0x000000000000808BULL, 0x0000000080000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL,
+    0x000000000000008AULL, 0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000AULL,
+    0x000000008000808BULL, 0x800000000000008BULL, 0x8000000000008089ULL, 0x8000000000008003ULL,
+    0x8000000000008002ULL, 0x8000000000000080ULL, 0x000000000000800AULL, 0x800000008000000AULL,
+    0x8000000080008081ULL, 0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL
+};
+
+/** One round; the loops have constant bounds so the state stays in registers. */
+inline void KeccakRound(__m256i a[25], uint64_t rc)
+{
+    __m256i c[5], d[5], b[25];
+    for (int x = 0; x < 5; x++)
+        c[x] = Xor(Xor(Xor(a[x], a[x + 5]), Xor(a[x + 10], a[x + 15])), a[x + 20]);
+    d[0] = Xor(c[4], Rotl(c[1], 1));
+    d[1] = Xor(c[0], Rotl(c[2], 1));
+    d[2] = Xor(c[1], Rotl(c[3], 1));
+    d[3] = Xor(c[2], Rotl(c[4], 1));
+    d[4] = Xor(c[3], Rotl(c[0], 1));
+    for (int i = 0; i < 25; i++)
+        a[i] = Xor(a[i], d[i % 5]);
+    // rho and pi
+    b[0] = a[0];
+    b[1] = Rotl(a[6], 44);
+    b[2] = Rotl(a[12], 43);
+    b[3] = Rotl(a[18], 21);
+    b[4] = Rotl(a[24], 14);
+    b[5] = Rotl(a[3], 28);
+    b[6] = Rotl(a[9], 20);
+    b[7] = Rotl(a[10], 3);
+    b[8] = Rotl(a[16], 45);
+    b[9] = Rotl(a[22], 61);
+    b[10] = Rotl(a[1], 1);
+    b[11] = Rotl(a[7], 6);
+    b[12] = Rotl(a[13], 25);
+    b[13] = Rotl(a[19], 8);
+    b[14] = Rotl(a[20], 18);
+    b[15] = Rotl(a[4], 27);
+    b[16] = Rotl(a[5], 36);
+    b[17] = Rotl(a[11], 10);
+    b[18] = Rotl(a[17], 15);
+    b[19] = Rotl(a[23], 56);
+    b[20] = Rotl(a[2], 62);
+    b[21] = Rotl(a[8], 55);
+    b[22] = Rotl(a[14], 39);
+    b[23] = Rotl(a[15], 41);
+    b[24] = Rotl(a[21], 2);
+    // chi
+    for (int y = 0; y < 25; y += 5) {
+        a[y + 0] = Xor(b[y + 0], AndNot(b[y + 1], b[y + 2]));
+        a[y + 1] = Xor(b[y + 1], AndNot(b[y + 2], b[y + 3]));
+        a[y + 2] = Xor(b[y + 2], AndNot(b[y + 3], b[y + 4]));
+        a[y + 3] = Xor(b[y + 3], AndNot(b[y + 4], b[y + 0]));
+        a[y + 4] = Xor(b[y + 4], AndNot(b[y + 0], b[y + 1]));
+    }
+    a[0] = Xor(a[0], K(rc));
+}
+
+void KeccakF(__m256i a[25])
+{
+    for (int round = 0; round < 24; round++)
+        KeccakRound(a, KECCAK_RC[round]);
+}
+
+/// JH-512
+
+/** The JH constants are given big-endian, the bitsliced state is kept little-endian. */
+constexpr uint64_t Swap64(uint64_t x)
+{
+    return (x >> 56) | ((x >> 40) & 0xFF00ULL) | ((x >> 24) & 0xFF0000ULL) | ((x >> 8) & 0xFF000000ULL) |
+           ((x << 8) & 0xFF00000000ULL) | ((x << 24) & 0xFF0000000000ULL) | ((x << 40) & 0xFF000000000000ULL) | (x << 56);
+}
+
+const uint64_t JH512_IV[16] = {
+    Swap64(0x6fd14b963e00aa17ULL), Swap64(0x636a2e057a15d543ULL), Swap64(0x8a225e8d0c97ef0bULL), Swap64(0xe9341259f2b3c361ULL),
+    Swap64(0x891da0c1536f801eULL), Swap64(0x2aa9056bea2b6d80ULL), Swap64(0x588eccdb2075baa6ULL), Swap64(0xa90f3a76baf83bf7ULL),
+    Swap64(0x0169e60541e34a69ULL), Swap64(0x46b58a8e2e6fe65aULL), Swap64(0x1047a7d0c1843c24ULL), Swap64(0x3b6e71b12d5ac199ULL),
+    Swap64(0xcf57f6ec9db1f856ULL), Swap64(0xa706887c5716b156ULL), Swap64(0xe3c2fcdfe68517fbULL), Swap64(0x545a4678cc8cdd4bULL)
+};
+
+/** Round constants, four words per round: even high, even low, odd high, odd low */
+const uint64_t JH_C[168] = {
+    Swap64(0x72d5dea2df15f867ULL), Swap64(0x7b84150ab7231557ULL),
+    Swap64(0x81abd6904d5a87f6ULL), Swap64(0x4e9f4fc5c3d12b40ULL),
+    Swap64(0xea983ae05c45fa9cULL), Swap64(0x03c5d29966b2999aULL),
+    Swap64(0x660296b4f2bb538aULL), Swap64(0xb556141a88dba231ULL),
+    Swap64(0x03a35a5c9a190edbULL), Swap64(0x403fb20a87c14410ULL),
+    Swap64(0x1c051980849e951dULL), Swap64(0x6f33ebad5ee7cddcULL),
+    Swap64(0x10ba139202bf6b41ULL), Swap64(0xdc786515f7bb27d0ULL),
+    Swap64(0x0a2c813937aa7850ULL), Swap64(0x3f1abfd2410091d3ULL),
+    Swap64(0x422d5a0df6cc7e90ULL), Swap64(0xdd629f9c92c097ceULL),
+    Swap64(0x185ca70bc72b44acULL), Swap64(0xd1df65d663c6fc23ULL),
+    Swap64(0x976e6c039ee0b81aULL), Swap64(0x2105457e446ceca8ULL),
+    Swap64(0xeef103bb5d8e61faULL), Swap64(0xfd9697b294838197ULL),
+    Swap64(0x4a8e8537db03302fULL), Swap64(0x2a678d2dfb9f6a95ULL),
+    Swap64(0x8afe7381f8b8696cULL), Swap64(0x8ac77246c07f4214ULL),
+    Swap64(0xc5f4158fbdc75ec4ULL), Swap64(0x75446fa78f11bb80ULL),
+    Swap64(0x52de75b7aee488bcULL), Swap64(0x82b8001e98a6a3f4ULL),
+    Swap64(0x8ef48f33a9a36315ULL), Swap64(0xaa5f5624d5b7f989ULL),
+    Swap64(0xb6f1ed207c5ae0fdULL), Swap64(0x36cae95a06422c36ULL),
+    Swap64(0xce2935434efe983dULL), Swap64(0x533af974739a4ba7ULL),
+    Swap64(0xd0f51f596f4e8186ULL), Swap64(0x0e9dad81afd85a9fULL),
+    Swap64(0xa7050667ee34626aULL), Swap64(0x8b0b28be6eb91727ULL),
+    Swap64(0x47740726c680103fULL), Swap64(0xe0a07e6fc67e487bULL),
+    Swap64(0x0d550aa54af8a4c0ULL), Swap64(0x91e3e79f978ef19eULL),
+    Swap64(0x8676728150608dd4ULL), Swap64(0x7e9e5a41f3e5b062ULL),
+    Swap64(0xfc9f1fec4054207aULL), Swap64(0xe3e41a00cef4c984ULL),
+    Swap64(0x4fd794f59dfa95d8ULL), Swap64(0x552e7e1124c354a5ULL),
+    Swap64(0x5bdf7228bdfe6e28ULL), Swap64(0x78f57fe20fa5c4b2ULL),
+    Swap64(0x05897cefee49d32eULL), Swap64(0x447e9385eb28597fULL),
+    Swap64(0x705f6937b324314aULL), Swap64(0x5e8628f11dd6e465ULL),
+    Swap64(0xc71b770451b920e7ULL), Swap64(0x74fe43e823d4878aULL),
+    Swap64(0x7d29e8a3927694f2ULL), Swap64(0xddcb7a099b30d9c1ULL),
+    Swap64(0x1d1b30fb5bdc1be0ULL), Swap64(0xda24494ff29c82bfULL),
+    Swap64(0xa4e7ba31b470bfffULL), Swap64(0x0d324405def8bc48ULL),
+    Swap64(0x3baefc3253bbd339ULL), Swap64(0x459fc3c1e0298ba0ULL),
+    Swap64(0xe5c905fdf7ae090fULL), Swap64(0x947034124290f134ULL),
+    Swap64(0xa271b701e344ed95ULL), Swap64(0xe93b8e364f2f984aULL),
+    Swap64(0x88401d63a06cf615ULL), Swap64(0x47c1444b8752afffULL),
+    Swap64(0x7ebb4af1e20ac630ULL), Swap64(0x4670b6c5cc6e8ce6ULL),
+    Swap64(0xa4d5a456bd4fca00ULL), Swap64(0xda9d844bc83e18aeULL),
+    Swap64(0x7357ce453064d1adULL), Swap64(0xe8a6ce68145c2567ULL),
+    Swap64(0xa3da8cf2cb0ee116ULL), Swap64(0x33e906589a94999aULL),
+    Swap64(0x1f60b220c26f847bULL), Swap64(0xd1ceac7fa0d18518ULL),
+    Swap64(0x32595ba18ddd19d3ULL), Swap64(0x509a1cc0aaa5b446ULL),
+    Swap64(0x9f3d6367e4046bbaULL), Swap64(0xf6ca19ab0b56ee7eULL),
+    Swap64(0x1fb179eaa9282174ULL), Swap64(0xe9bdf7353b3651eeULL),
+    Swap64(0x1d57ac5a7550d376ULL), Swap64(0x3a46c2fea37d7001ULL),
+    Swap64(0xf735c1af98a4d842ULL), Swap64(0x78edec209e6b6779ULL),
+    Swap64(0x41836315ea3adba8ULL), Swap64(0xfac33b4d32832c83ULL),
+    Swap64(0xa7403b1f1c2747f3ULL), Swap64(0x5940f034b72d769aULL),
+    Swap64(0xe73e4e6cd2214ffdULL), Swap64(0xb8fd8d39dc5759efULL),
+    Swap64(0x8d9b0c492b49ebdaULL), Swap64(0x5ba2d74968f3700dULL),
+    Swap64(0x7d3baed07a8d5584ULL), Swap64(0xf5a5e9f0e4f88e65ULL),
+    Swap64(0xa0b8a2f436103b53ULL), Swap64(0x0ca8079e753eec5aULL),
+    Swap64(0x9168949256e8884fULL), Swap64(0x5bb05c55f8babc4cULL),
+    Swap64(0xe3bb3b99f387947bULL), Swap64(0x75daf4d6726b1c5dULL),
+    Swap64(0x64aeac28dc34b36dULL), Swap64(0x6c34a550b828db71ULL),
+    Swap64(0xf861e2f2108d512aULL), Swap64(0xe3db643359dd75fcULL),
+    Swap64(0x1cacbcf143ce3fa2ULL), Swap64(0x67bbd13c02e843b0ULL),
+    Swap64(0x330a5bca8829a175ULL), Swap64(0x7f34194db416535cULL),
+    Swap64(0x923b94c30e794d1eULL), Swap64(0x797475d7b6eeaf3fULL),
+    Swap64(0xeaa8d4f7be1a3921ULL), Swap64(0x5cf47e094c232751ULL),
+    Swap64(0x26a32453ba323cd2ULL), Swap64(0x44a3174a6da6d5adULL),
+    Swap64(0xb51d3ea6aff2c908ULL), Swap64(0x83593d98916b3c56ULL),
+    Swap64(0x4cf87ca17286604dULL), Swap64(0x46e23ecc086ec7f6ULL),
+    Swap64(0x2f9833b3b1bc765eULL), Swap64(0x2bd666a5efc4e62aULL),
+    Swap64(0x06f4b6e8bec1d436ULL), Swap64(0x74ee8215bcef2163ULL),
+    Swap64(0xfdc14e0df453c969ULL), Swap64(0xa77d5ac406585826ULL),
+    Swap64(0x7ec1141606e0fa16ULL), Swap64(0x7e90af3d28639d3fULL),
+    Swap64(0xd2c9f2e3009bd20cULL), Swap64(0x5faace30b7d40c30ULL),
+    Swap64(0x742a5116f2e03298ULL), Swap64(0x0deb30d8e3cef89aULL),
+    Swap64(0x4bc59e7bb5f17992ULL), Swap64(0xff51e66e048668d3ULL),
+    Swap64(0x9b234d57e6966731ULL), Swap64(0xcce6a6f3170a7505ULL),
+    Swap64(0xb17681d913326cceULL), Swap64(0x3c175284f805a262ULL),
+    Swap64(0xf42bcbb378471547ULL), Swap64(0xff46548223936a48ULL),
+    Swap64(0x38df58074e5e6565ULL), Swap64(0xf2fc7c89fc86508eULL),
+    Swap64(0x31702e44d00bca86ULL), Swap64(0xf04009a23078474eULL),
+    Swap64(0x65a0ee39d1f73883ULL), Swap64(0xf75ee937e42c3abdULL),
+    Swap64(0x2197b2260113f86fULL), Swap64(0xa344edd1ef9fdee7ULL),
+    Swap64(0x8ba0df15762592d9ULL), Swap64(0x3c85f7f612dc42beULL),
+    Swap64(0xd8a7ec7cab27b07eULL), Swap64(0x538d7ddaaa3ea8deULL),
+    Swap64(0xaa25ce93bd0269d8ULL), Swap64(0x5af643fd1a7308f9ULL),
+    Swap64(0xc05fefda174a19a5ULL), Swap64(0x974d66334cfd216aULL),
+    Swap64(0x35b49831db411570ULL), Swap64(0xea1e0fbbedcd549bULL),
+    Swap64(0x9ad063a151974072ULL), Swap64(0xf6759dbf91476fe2ULL),
+};
+
+/** S-box layer of one half of the state with the constant c */
+inline void JhSb(__m256i& x0, __m256i& x1, __m256i& x2, __m256i& x3, __m256i c)
+{
+    x3 = Not(x3);
+    x0 = Xor(x0, AndNot(x2, c));
+    __m256i tmp = Xor(c, And(x0, x1));
+    x0 = Xor(x0, And(x2, x3));
+    x3 = Xor(x3, AndNot(x1, x2));
+    x1 = Xor(x1, And(x0, x2));
+    x2 = Xor(x2, AndNot(x3, x0));
+    x0 = Xor(x0, Or(x1, x3));
+    x3 = Xor(x3, And(x1, x2));
+    x1 = Xor(x1, And(tmp, x0));
+    x2 = Xor(x2, tmp);
+}
+
+inline void JhLb(__m256i& x0, __m256i& x1, __m256i& x2, __m256i& x3, __m256i& x4, __m256i& x5, __m256i& x6, __m256i& x7)
+{
+    x4 = Xor(x4, x1);
+    x5 = Xor(x5, x2);
+    x6 = Xor(x6, Xor(x3, x0));
+    x7 = Xor(x7, x0);
+    x0 = Xor(x0, x5);
+    x1 = Xor(x1, x6);
+    x2 = Xor(x2, Xor(x7, x4));
+    x3 = Xor(x3, x4);
+}
+
+/** Swap the bit groups of width n selected by mask c */
+inline __m256i JhWz(__m256i x, uint64_t c, int n)
+{
+    return Or(And(Shr(x, n), K(c)), Shl(And(x, K(c)), n));
+}
+
+inline void JhW(int ro, __m256i x[2])
+{
+    static const uint64_t masks[6] = {
+        0x5555555555555555ULL, 0x3333333333333333ULL, 0x0F0F0F0F0F0F0F0FULL,
+        0x00FF00FF00FF00FFULL, 0x0000FFFF0000FFFFULL, 0x00000000FFFFFFFFULL
+    };
+    if (ro == 6) {
+        std::swap(x[0], x[1]);
+        return;
+    }
+    x[0] = JhWz(x[0], masks[ro], 1 << ro);
+    x[1] = JhWz(x[1], masks[ro], 1 << ro);
+}
+
+/** The state is kept as eight pairs of high and low words. */
+void JhE8(__m256i h[8][2])
+{
+    for (int r = 0; r < 42; r++) {
+        for (int k = 0; k < 2; k++) {
+            JhSb(h[0][k], h[2][k], h[4][k], h[6][k], K(JH_C[4 * r + k]));
+            JhSb(h[1][k], h[3][k], h[5][k], h[7][k], K(JH_C[4 * r + 2 + k]));
+            JhLb(h[0][k], h[2][k], h[4][k], h[6][k], h[1][k], h[3][k], h[5][k], h[7][k]);
+        }
+        for (int i = 1; i < 8; i += 2)
+            JhW(r % 7, h[i]);
+    }
+}
+
+void JhBlock(__m256i h[8][2], const unsigned char* const blk[4])
+{
+    __m256i m[8];
+    for (int i = 0; i < 8; i++) {
+        m[i] = LoadLE(blk, i);
+        h[i / 2][i % 2] = Xor(h[i / 2][i % 2], m[i]);
+    }
+    JhE8(h);
+    for (int i = 0; i < 8; i++)
+        h[4 + i / 2][i % 2] = Xor(h[4 + i / 2][i % 2], m[i]);
+}
+
+/// Luffa-512
+
+const uint32_t LUFFA_IV[5][8] = {
+    {0x6d251e69, 0x44b051e0, 0x4eaa6fb4, 0xdbf78465, 0x6e292011, 0x90152df4, 0xee058139, 0xdef610bb},
+    {0xc3b44b95, 0xd9d2f256, 0x70eee9a0, 0xde099fa3, 0x5d9b0557, 0x8fc944b3, 0xcf1ccf0e, 0x746cd581},
+    {0xf7efc89d, 0x5dba5781, 0x04016ce5, 0xad659c05, 0x0306194f, 0x666d1836, 0x24aa230a, 0x8b264ae7},
+    {0x858075d5, 0x36d79cce, 0xe571f7d7, 0x204b1f67, 0x35870c6a, 0x57e9e923, 0x14bcb808, 0x7cde72ce},
+    {0x6c68e9be, 0x5ec41e22, 0xc825b7c7, 0xaffb4363, 0xf5df3999, 0x0fc688f1, 0xb07224cc, 0x03e86cea}
+};
+
+/** Round constants of the five permutations, for words 0 and 4 */
+const uint32_t LUFFA_RC[5][2][8] = {
+    {{0x303994a6, 0xc0e65299, 0x6cc33a12, 0xdc56983e, 0x1e00108f, 0x7800423d, 0x8f5b7882, 0x96e1db12},
+     {0xe0337818, 0x441ba90d, 0x7f34d442, 0x9389217f, 0xe5a8bce6, 0x5274baf4, 0x26889ba7, 0x9a226e9d}},
+    {{0xb6de10ed, 0x70f47aae, 0x0707a3d4, 0x1c1e8f51, 0x707a3d45, 0xaeb28562, 0xbaca1589, 0x40a46f3e},
+     {0x01685f3d, 0x05a17cf4, 0xbd09caca, 0xf4272b28, 0x144ae5cc, 0xfaa7ae2b, 0x2e48f1c1, 0xb923c704}},
+    {{0xfc20d9d2, 0x34552e25, 0x7ad8818f, 0x8438764a, 0xbb6de032, 0xedb780c8, 0xd9847356, 0xa2c78434},
+     {0xe25e72c1, 0xe623bb72, 0x5c58a4a4, 0x1e38e2e7, 0x78e38b9d, 0x27586719, 0x36eda57f, 0x703aace7}},
+    {{0xb213afa5, 0xc84ebe95, 0x4e608a22, 0x56d858fe, 0x343b138f, 0xd0ec4e3d, 0x2ceb4882, 0xb3ad2208},
+     {0xe028c9bf, 0x44756f91, 0x7e8fce32, 0x956548be, 0xfe191be2, 0x3cb226e5, 0x5944a28e, 0xa1c4c355}},
+    {{0xf0d2e9e3, 0xac11d7fa, 0x1bcb66f2, 0x6f2d9bc9, 0x78602649, 0x8edae952, 0x3b6ba548, 0xedae9520},
+     {0x5090d577, 0x2d1925ab, 0xb46496ac, 0xd1925ab0, 0x29131ab6, 0x0fc053c3, 0x3f014f0c, 0xfc053c31}}
+};
+
+/** Multiplication by 2 in the ring of the message injection */
+inline void LuffaM2(__m256i d[8], const __m256i s[8])
+{
+    const __m256i tmp = s[7];
+    d[7] = s[6];
+    d[6] = s[5];
+    d[5] = s[4];
+    d[4] = Xor(s[3], tmp);
+    d[3] = Xor(s[2], tmp);
+    d[2] = s[1];
+    d[1] = Xor(s[0], tmp);
+    d[0] = tmp;
+}
+
+inline void LuffaXor(__m256i d[8], const __m256i a[8], const __m256i b[8])
+{
+    for (int i = 0; i < 8; i++)
+        d[i] = Xor(a[i], b[i]);
+}
+
+void LuffaMI(__m256i v[5][8], const unsigned char* const blk[8])
+{
+    __m256i m[8], a[8], b[8];
+    for (int i = 0; i < 8; i++)
+        m[i] = LoadBE32(blk, i);
+    LuffaXor(a, v[0], v[1]);
+    LuffaXor(b, v[2], v[3]);
+    LuffaXor(a, a, b);
+    LuffaXor(a, a, v[4]);
+    LuffaM2(a, a);
+    for (int j = 0; j < 5; j++)
+        LuffaXor(v[j], a, v[j]);
+    LuffaM2(b, v[0]);
+    LuffaXor(b, b, v[1]);
+    LuffaM2(v[1], v[1]);
+    LuffaXor(v[1], v[1], v[2]);
+    LuffaM2(v[2], v[2]);
+    LuffaXor(v[2], v[2], v[3]);
+    LuffaM2(v[3], v[3]);
+    LuffaXor(v[3], v[3], v[4]);
+    LuffaM2(v[4], v[4]);
+    LuffaXor(v[4], v[4], v[0]);
+    LuffaM2(v[0], b);
+    LuffaXor(v[0], v[0], v[4]);
+    LuffaM2(v[4], v[4]);
+    LuffaXor(v[4], v[4], v[3]);
+    LuffaM2(v[3], v[3]);
+    LuffaXor(v[3], v[3], v[2]);
+    LuffaM2(v[2], v[2]);
+    LuffaXor(v[2], v[2], v[1]);
+    LuffaM2(v[1], v[1]);
+    LuffaXor(v[1], v[1], b);
+    for (int j = 0; j < 5; j++) {
+        LuffaXor(v[j], v[j], m);
+        if (j < 4)
+            LuffaM2(m, m);
+    }
+}
+
+inline void LuffaSubCrumb(__m256i& a0, __m256i& a1, __m256i& a2, __m256i& a3)
+{
+    __m256i tmp = a0;
+    a0 = Or(a0, a1);
+    a2 = Xor(a2, a3);
+    a1 = Not(a1);
+    a0 = Xor(a0, a3);
+    a3 = And(a3, tmp);
+    a1 = Xor(a1, a3);
+    a3 = Xor(a3, a2);
+    a2 = And(a2, a0);
+    a0 = Not(a0);
+    a2 = Xor(a2, a1);
+    a1 = Or(a1, a3);
+    tmp = Xor(tmp, a1);
+    a3 = Xor(a3, a2);
+    a2 = And(a2, a1);
+    a1 = Xor(a1, a0);
+    a0 = tmp;
+}
+
+inline void LuffaMixWord(__m256i& u, __m256i& v)
+{
+    v = Xor(v, u);
+    u = Xor(Rotl32(u, 2), v);
+    v = Xor(Rotl32(v, 14), u);
+    u = Xor(Rotl32(u, 10), v);
+    v = Rotl32(v, 1);
+}
+
+void LuffaP(__m256i v[5][8])
+{
+    for (int j = 1; j < 5; j++) {
+        for (int i = 4; i < 8; i++)
+            v[j][i] = Rotl32(v[j][i], j);
+    }
+    for (int j = 0; j < 5; j++) {
+        __m256i* x = v[j];
+        for (int r = 0; r < 8; r++) {
+            LuffaSubCrumb(x[0], x[1], x[2], x[3]);
+            LuffaSubCrumb(x[5], x[6], x[7], x[4]);
+            for (int i = 0; i < 4; i++)
+                LuffaMixWord(x[i], x[i + 4]);
+            x[0] = Xor(x[0], K32(LUFFA_RC[j][0][r]));
+            x[4] = Xor(x[4], K32(LUFFA_RC[j][1][r]));
+        }
+    }
+}
+
+} // namespace
+
+void Blake512_4way(unsigned char* const out[4], const unsigned char* const in[4], size_t len)
+{
+    __m256i h[8];
+    for (int i = 0; i < 8; i++)
+        h[i] = K(BLAKE512_IV[i]);
+    const unsigned char* blk[4];
+    size_t off = 0;
+    for (; off + 128 <= len; off += 128) {
+        for (int l = 0; l < 4; l++)
+            blk[l] = in[l] + off;
+        Blake512Compress(h, blk, (uint64_t)(off + 128) << 3);
+    }
+
+    // A block without message bits is compressed with a zero counter.
+    unsigned char tail[4][256];
+    const size_t rem = len - off;
+    const size_t nTail = rem < 112 ? 128 : 256;
+    PrepareTail<4>(tail, in, off, rem, nTail);
+    for (int l = 0; l < 4; l++) {
+        tail[l][rem] = 0x80;
+        tail[l][nTail - 17] |= 1;
+        WriteBE64(tail[l] + nTail - 8, (uint64_t)len << 3);
+        blk[l] = tail[l];
+    }
+    Blake512Compress(h, blk, rem ? (uint64_t)len << 3 : 0);
+    if (nTail == 256) {
+        for (int l = 0; l < 4; l++)
+            blk[l] = tail[l] + 128;
+        Blake512Compress(h, blk, 0);
+    }
+    for (int i = 0; i < 8; i++)
+        StoreBE(out, i, h[i]);
+}
+
+void Bmw512_4way(unsigned char* const out[4], const unsigned char* const in[4], size_t len)
+{
+    static const uint64_t final[16] = {
+        0xaaaaaaaaaaaaaaa0ULL, 0xaaaaaaaaaaaaaaa1ULL, 0xaaaaaaaaaaaaaaa2ULL, 0xaaaaaaaaaaaaaaa3ULL,
+        0xaaaaaaaaaaaaaaa4ULL, 0xaaaaaaaaaaaaaaa5ULL, 0xaaaaaaaaaaaaaaa6ULL, 0xaaaaaaaaaaaaaaa7ULL,
+        0xaaaaaaaaaaaaaaa8ULL, 0xaaaaaaaaaaaaaaa9ULL, 0xaaaaaaaaaaaaaaaaULL, 0xaaaaaaaaaaaaaaabULL,
+        0xaaaaaaaaaaaaaaacULL, 0xaaaaaaaaaaaaaaadULL, 0xaaaaaaaaaaaaaaaeULL, 0xaaaaaaaaaaaaaaafULL
+    };
+    __m256i h[16];
+    for (int i = 0; i < 16; i++)
+        h[i] = K(0x8081828384858687ULL + i * 0x0808080808080808ULL);
+    const unsigned char* blk[4];
+    size_t off = 0;
+    for (; off + 128 <= len; off += 128) {
+        for (int l = 0; l < 4; l++)
+            blk[l] = in[l] + off;
+        Bmw512Block(h, blk);
+    }
+
+    unsigned char tail[4][256];
+    const size_t rem = len - off;
+    const size_t nTail = rem < 120 ? 128 : 256;
+    PrepareTail<4>(tail, in, off, rem, nTail);
+    for (int l = 0; l < 4; l++) {
+        tail[l][rem] = 0x80;
+        WriteLE64(tail[l] + nTail - 8, (uint64_t)len << 3);
+    }
+    for (size_t b = 0; b < nTail; b += 128) {
+        for (int l = 0; l < 4; l++)
+            blk[l] = tail[l] + b;
+        Bmw512Block(h, blk);
+    }
+
+    // Final compression of the chaining value as message.
+    __m256i f[16];
+    for (int i = 0; i < 16; i++)
+        f[i] = K(final[i]);
+    Bmw512Compress(h, f, h);
+    for (int i = 0; i < 8; i++)
+        StoreLE(out, i, h[8 + i]);
+}
+
+void Keccak512_4way(unsigned char* const out[4], const unsigned char* const in[4], size_t len)
+{
+    static const size_t RATE = 72;
+    __m256i a[25];
+    for (int i = 0; i < 25; i++)
+        a[i] = _mm256_setzero_si256();
+    const unsigned char* blk[4];
+    size_t off = 0;
+    for (; off + RATE <= len; off += RATE) {
+        for (int l = 0; l < 4; l++)
+            blk[l] = in[l] + off;
+        for (size_t i = 0; i < RATE / 8; i++)
+            a[i] = Xor(a[i], LoadLE(blk, i));
+        KeccakF(a);
+    }
+
+    unsigned char tail[4][256];
+    const size_t rem = len - off;
+    PrepareTail<4>(tail, in, off, rem, RATE);
+    for (int l = 0; l < 4; l++) {
+        tail[l][rem] ^= 0x01;
+        tail[l][RATE - 1] ^= 0x80;
+        blk[l] = tail[l];
+    }
+    for (size_t i = 0; i < RATE / 8; i++)
+        a[i] = Xor(a[i], LoadLE(blk, i));
+    KeccakF(a);
+    for (int i = 0; i < 8; i++)
+        StoreLE(out, i, a[i]);
+}
+
+void Jh512_4way(unsigned char* const out[4], const unsigned char* const in[4], size_t len)
+{
+    __m256i h[8][2];
+    for (int i = 0; i < 16; i++)
+        h[i / 2][i % 2] = K(JH512_IV[i]);
+    const unsigned char* blk[4];
+    size_t off = 0;
+    for (; off + 64 <= len; off += 64) {
+        for (int l = 0; l < 4; l++)
+            blk[l] = in[l] + off;
+        JhBlock(h, blk);
+    }
+
+    unsigned char tail[4][256];
+    const size_t rem = len - off;
+    const size_t nTail = rem == 0 ? 64 : 128;
+    PrepareTail<4>(tail, in, off, rem, nTail);
+    for (int l = 0; l < 4; l++) {
+        tail[l][rem] = 0x80;
+        WriteBE64(tail[l] + nTail - 8, (uint64_t)len << 3);
+    }
+    for (size_t b = 0; b < nTail; b += 64) {
+        for (int l = 0; l < 4; l++)
+            blk[l] = tail[l] + b;
+        JhBlock(h, blk);
+    }
+    for (int i = 0; i < 8; i++)
+        StoreLE(out, i, h[4 + i / 2][i % 2]);
+}
+
+void Luffa512_8way(unsigned char* const out[8], const unsigned char* const in[8], size_t len)
+{
+    __m256i v[5][8];
+    for (int j = 0; j < 5; j++) {
+        for (int i = 0; i < 8; i++)
+            v[j][i] = K32(LUFFA_IV[j][i]);
+    }
+    const unsigned char* blk[8];
+    size_t off = 0;
+    for (; off + 32 <= len; off += 32) {
+        for (int l = 0; l < 8; l++)
+            blk[l] = in[l] + off;
+        LuffaMI(v, blk);
+        LuffaP(v);
+    }
+
+    unsigned char tail[8][256];
+    const size_t rem = len - off;
+    PrepareTail<8>(tail, in, off, rem, 32);
+    for (int l = 0; l < 8; l++) {
+        tail[l][rem] = 0x80;
+        blk[l] = tail[l];
+    }
+    LuffaMI(v, blk);
+    LuffaP(v);
+
+    // Two blank rounds, each one produces half of the output.
+    for (int l = 0; l < 8; l++)
+        memset(tail[l], 0, 32);
+    for (int half = 0; half < 2; half++) {
+        LuffaMI(v, blk);
+        LuffaP(v);
+        for (int i = 0; i < 8; i++)
+            StoreBE32(out, 8 * half + i, Xor(Xor(Xor(v[0][i], v[1][i]), Xor(v[2][i], v[3][i])), v[4][i]));
+    }
+}
+
+} // namespace multihash_avx2
+
+#endif
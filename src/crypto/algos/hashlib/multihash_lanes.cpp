@@ -0,0 +1,188 @@
+// Copyright (c) 2026 The Globaltoken Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#if defined(HAVE_CONFIG_H)
+#include <config/bitcoin-config.h>
+#endif
+
+#include <crypto/algos/hashlib/multihash_lanes.h>
+
+#include <crypto/algos/hashlib/sph_blake.h>
+#include <crypto/algos/hashlib/sph_bmw.h>
+#include <crypto/algos/hashlib/sph_cubehash.h>
+#include <crypto/algos/hashlib/sph_echo.h>
+#include <crypto/algos/hashlib/sph_fugue.h>
+#include <crypto/algos/hashlib/sph_groestl.h>
+#include <crypto/algos/hashlib/sph_hamsi.h>
+#include <crypto/algos/hashlib/sph_haval.h>
+#include <crypto/algos/hashlib/sph_jh.h>
+#include <crypto/algos/hashlib/sph_keccak.h>
+#include <crypto/algos/hashlib/sph_luffa.h>
+#include <crypto/algos/hashlib/sph_sha2.h>
+#include <crypto/algos/hashlib/sph_shabal.h>
+#include <crypto/algos/hashlib/sph_shavite.h>
+#include <crypto/algos/hashlib/sph_simd.h>
+#include <crypto/algos/hashlib/sph_skein.h>
+#include <crypto/algos/hashlib/sph_whirlpool.h>
+
+#include <algorithm>
+#include <assert.h>
+#include <string.h>
+
+#if defined(ENABLE_AVX2) && (defined(__x86_64__) || defined(__amd64__))
+#include <cpuid.h>
+namespace multihash_avx2
+{
+void Blake512_4way(unsigned char* const out[4], const unsigned char* const in[4], size_t len);
+void Bmw512_4way(unsigned char* const out[4], const unsigned char* const in[4], size_t len);
+void Keccak512_4way(unsigned char* const out[4], const unsigned char* const in[4], size_t len);
+void Jh512_4way(unsigned char* const out[4], const unsigned char* const in[4], size_t len);
+void Luffa512_8way(unsigned char* const out[8], const unsigned char* const in[8], size_t len);
+}
+#endif
+
+namespace
+{
+typedef void (*ScalarHashType)(const unsigned char* in, size_t len, unsigned char* out);
+
+template<typename Context, void (*Init)(void*), void (*Update)(void*, const void*, size_t), void (*Close)(void*, void*)>
+void ScalarHash(const unsigned char* in, size_t len, unsigned char* out)
+{
+    Context ctx;
+    Init(&ctx);
+    Update(&ctx, in, len);
+    Close(&ctx, out);
+}
+
+void ScalarHaval256_5(const unsigned char* in, size_t len, unsigned char* out)
+{
+    ScalarHash<sph_haval256_5_context, sph_haval256_5_init, sph_haval256_5, sph_haval256_5_close>(in, len, out);
+    memset(out + 32, 0, 32);
+}
+
+const ScalarHashType SCALAR_HASH[HASH512_NUM] = {
+    ScalarHash<sph_blake512_context, sph_blake512_init, sph_blake512, sph_blake512_close>,
+    ScalarHash<sph_bmw512_context, sph_bmw512_init, sph_bmw512, sph_bmw512_close>,
+    ScalarHash<sph_groestl512_context, sph_groestl512_init, sph_groestl512, sph_groestl512_close>,
+    ScalarHash<sph_jh512_context, sph_jh512_init, sph_jh512, sph_jh512_close>,
+    ScalarHash<sph_keccak512_context, sph_keccak512_init, sph_keccak512, sph_keccak512_close>,
+    ScalarHash<sph_skein512_context, sph_skein512_init, sph_skein512, sph_skein512_close>,
+    ScalarHash<sph_luffa512_context, sph_luffa512_init, sph_luffa512, sph_luffa512_close>,
+    ScalarHash<sph_cubehash512_context, sph_cubehash512_init, sph_cubehash512, sph_cubehash512_close>,
+    ScalarHash<sph_shavite512_context, sph_shavite512_init, sph_shavite512, sph_shavite512_close>,
+    ScalarHash<sph_simd512_context, sph_simd512_init, sph_simd512, sph_simd512_close>,
+    ScalarHash<sph_echo512_context, sph_echo512_init, sph_echo512, sph_echo512_close>,
+    ScalarHash<sph_hamsi512_context, sph_hamsi512_init, sph_hamsi512, sph_hamsi512_close>,
+    ScalarHash<sph_fugue512_context, sph_fugue512_init, sph_fugue512, sph_fugue512_close>,
+    ScalarHash<sph_shabal512_context, sph_shabal512_init, sph_shabal512, sph_shabal512_close>,
+    ScalarHash<sph_whirlpool_context, sph_whirlpool_init, sph_whirlpool, sph_whirlpool_close>,
+    ScalarHash<sph_sha512_context, sph_sha512_init, sph_sha512, sph_sha512_close>,
+    ScalarHaval256_5,
+};
+
+/** A multi-buffer implementation hashing nWidth lanes per call. */
+struct LaneKernel
+{
+    size_t nWidth;
+    void (*fn)(unsigned char* const* out, const unsigned char* const* in, size_t len);
+};
+
+static const size_t MAX_KERNEL_WIDTH = 8;
+
+LaneKernel kernels[HASH512_NUM] = {};
+
+#if defined(ENABLE_AVX2) && (defined(__x86_64__) || defined(__amd64__))
+/** Compare a kernel against the scalar implementation for a few message lengths. */
+bool SelfTest(Hash512Function fn, const LaneKernel& kernel)
+{
+    static const size_t LENGTHS[] = {0, 1, 63, 64, 80, 127, 128, 200};
+    unsigned char in[MAX_KERNEL_WIDTH][200];
+    unsigned char out[MAX_KERNEL_WIDTH][64];
+    unsigned char expected[64];
+    const unsigned char* pin[MAX_KERNEL_WIDTH];
+    unsigned char* pout[MAX_KERNEL_WIDTH];
+    for (size_t l = 0; l < kernel.nWidth; l++) {
+        for (size_t i = 0; i < sizeof(in[l]); i++)
+            in[l][i] = (unsigned char)(i * 7 + l * 31 + 1);
+        pin[l] = in[l];
+        pout[l] = out[l];
+    }
+    for (size_t len : LENGTHS) {
+        kernel.fn(pout, pin, len);
+        for (size_t l = 0; l < kernel.nWidth; l++) {
+            SCALAR_HASH[fn](in[l], len, expected);
+            if (memcmp(out[l], expected, sizeof(expected))) return false;
+        }
+    }
+    return true;
+}
+
+bool HaveAVX2()
+{
+    uint32_t eax, ebx, ecx, edx;
+    // AVX and OSXSAVE, and the OS saves the YMM registers.
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) || ((ecx >> 27) & 3) != 3) return false;
+    uint32_t xcr0_lo, xcr0_hi;
+    __asm__("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+    if ((xcr0_lo & 6) != 6) return false;
+    if (__get_cpuid_max(0, nullptr) < 7) return false;
+    __cpuid_count(7, 0, eax, ebx, ecx, edx);
+    return (ebx >> 5) & 1;
+}
+
+template<size_t NWIDTH>
+LaneKernel MakeKernel(void (*fn)(unsigned char* const out[NWIDTH], const unsigned char* const in[NWIDTH], size_t len))
+{
+    static_assert(NWIDTH <= MAX_KERNEL_WIDTH, "kernel too wide");
+    return LaneKernel{NWIDTH, fn};
+}
+#endif
+
+} // namespace
+
+std::string Hash512AutoDetect()
+{
+#if defined(ENABLE_AVX2) && (defined(__x86_64__) || defined(__amd64__))
+    if (HaveAVX2()) {
+        kernels[HASH512_BLAKE] = MakeKernel<4>(multihash_avx2::Blake512_4way);
+        kernels[HASH512_BMW] = MakeKernel<4>(multihash_avx2::Bmw512_4way);
+        kernels[HASH512_JH] = MakeKernel<4>(multihash_avx2::Jh512_4way);
+        kernels[HASH512_KECCAK] = MakeKernel<4>(multihash_avx2::Keccak512_4way);
+        kernels[HASH512_LUFFA] = MakeKernel<8>(multihash_avx2::Luffa512_8way);
+        for (int fn = 0; fn < HASH512_NUM; fn++) {
+            if (kernels[fn].nWidth != 0)
+                assert(SelfTest((Hash512Function)fn, kernels[fn]));
+        }
+        return "avx2";
+    }
+#endif
+    return "standard";
+}
+
+void Hash512Lanes(Hash512Function fn, const unsigned char* const* in, size_t len, unsigned char* const* out, size_t nLanes)
+{
+    assert(fn < HASH512_NUM);
+    const LaneKernel& kernel = kernels[fn];
+    size_t i = 0;
+    if (kernel.nWidth != 0) {
+        for (; i + kernel.nWidth <= nLanes; i += kernel.nWidth)
+            kernel.fn(out + i, in + i, len);
+        // A group that is at least half full is still cheaper as one kernel call,
+        // the missing lanes repeat the last message and are discarded.
+        const size_t nRemaining = nLanes - i;
+        if (nRemaining != 0 && nRemaining * 2 >= kernel.nWidth) {
+            const unsigned char* inGroup[MAX_KERNEL_WIDTH];
+            unsigned char* outGroup[MAX_KERNEL_WIDTH];
+            unsigned char scratch[MAX_KERNEL_WIDTH][64];
+            for (size_t l = 0; l < kernel.nWidth; l++) {
+                inGroup[l] = in[i + std::min(l, nRemaining - 1)];
+                outGroup[l] = l < nRemaining ? out[i + l] : scratch[l];
+            }
+            kernel.fn(outGroup, inGroup, len);
+            i = nLanes;
+        }
+    }
+    for (; i < nLanes; i++)
+        SCALAR_HASH[fn](in[i], len, out[i]);
+}
@@ -0,0 +1,49 @@
+// Copyright (c) 2026 The Globaltoken Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef MULTIHASH_LANES_H
+#define MULTIHASH_LANES_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+/** The 512-bit hash functions of the X-family chains, in X16R selection order. */
+enum Hash512Function : uint8_t
+{
+    HASH512_BLAKE = 0,
+    HASH512_BMW,
+    HASH512_GROESTL,
+    HASH512_JH,
+    HASH512_KECCAK,
+    HASH512_SKEIN,
+    HASH512_LUFFA,
+    HASH512_CUBEHASH,
+    HASH512_SHAVITE,
+    HASH512_SIMD,
+    HASH512_ECHO,
+    HASH512_HAMSI,
+    HASH512_FUGUE,
+    HASH512_SHABAL,
+    HASH512_WHIRLPOOL,
+    HASH512_SHA512,
+    //! 256-bit output, the upper 32 bytes of the result are zero
+    HASH512_HAVAL256_5,
+
+    HASH512_NUM
+};
+
+/**
+ * Hash nLanes messages of len bytes with the same function, writing 64 bytes
+ * per lane. Output buffers may alias their own input. Uses the multi-buffer
+ * implementation selected by Hash512AutoDetect where one exists.
+ */
+void Hash512Lanes(Hash512Function fn, const unsigned char* const* in, size_t len, unsigned char* const* out, size_t nLanes);
+
+/** Autodetect the best available multi-buffer implementation.
+ *  Returns the name of the implementation.
+ */
+std::string Hash512AutoDetect();
+
+#endif // MULTIHASH_LANES_H
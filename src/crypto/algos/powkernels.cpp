@@ -0,0 +1,111 @@
+// Copyright (c) 2026 The Globaltoken Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#if defined(HAVE_CONFIG_H)
+#include <config/bitcoin-config.h>
+#endif
+
+#include <crypto/algos/powkernels.h>
+
+#include <crypto/algos/argon2/hashargon.h>
+#include <crypto/algos/scrypt/scrypt.h>
+#include <crypto/algos/yescrypt/yescrypt.h>
+#include <crypto/algos/yespower/yespower.h>
+
+#include <assert.h>
+#include <string.h>
+
+#if (defined(ENABLE_SSE41) || defined(ENABLE_AVX2)) && (defined(__x86_64__) || defined(__amd64__) || defined(__i386__))
+#include <cpuid.h>
+#define HAVE_POW_KERNEL_TIERS 1
+#endif
+
+namespace {
+
+#ifdef HAVE_POW_KERNEL_TIERS
+bool HaveAVX2()
+{
+    uint32_t eax, ebx, ecx, edx;
+    // AVX and OSXSAVE, and the OS saves the YMM registers.
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) || ((ecx >> 27) & 3) != 3) return false;
+    uint32_t xcr0_lo, xcr0_hi;
+    __asm__("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+    if ((xcr0_lo & 6) != 6) return false;
+    if (__get_cpuid_max(0, nullptr) < 7) return false;
+    __cpuid_count(7, 0, eax, ebx, ecx, edx);
+    return (ebx >> 5) & 1;
+}
+
+bool HaveSSE41()
+{
+    uint32_t eax, ebx, ecx, edx;
+    return __get_cpuid(1, &eax, &ebx, &ecx, &edx) && ((ecx >> 19) & 1);
+}
+
+typedef const char* (*SelectKernelType)(int tier);
+
+/** Compare the kernel selected for a tier against the baseline one on a fixed input. */
+bool SelfTest(SelectKernelType select, int tier, void (*hash)(const unsigned char* in, unsigned char* out))
+{
+    unsigned char in[80], expected[32], out[32];
+    for (size_t i = 0; i < sizeof(in); i++)
+        in[i] = (unsigned char)(i * 7 + 1);
+    select(POW_KERNEL_BASELINE);
+    hash(in, expected);
+    select(tier);
+    hash(in, out);
+    return memcmp(expected, out, sizeof(out)) == 0;
+}
+
+void YescryptHash(const unsigned char* in, unsigned char* out)
+{
+    yescrypt_hash((const char*)in, (char*)out);
+}
+
+void YespowerHash(const unsigned char* in, unsigned char* out)
+{
+    yespower_hash((const char*)in, (char*)out);
+}
+
+void Argon2Hash(const unsigned char* in, unsigned char* out)
+{
+    Argon2dHash(in, 80, out, 32, in, 32, in + 32, 32);
+}
+#endif
+
+} // namespace
+
+int PowKernelTierDetect()
+{
+#ifdef HAVE_POW_KERNEL_TIERS
+    if (HaveAVX2())
+        return POW_KERNEL_AVX2;
+    if (HaveSSE41())
+        return POW_KERNEL_SSE41;
+#endif
+    return POW_KERNEL_BASELINE;
+}
+
+std::vector<std::pair<std::string, std::string> > PowKernelsAutoDetect()
+{
+    const int tier = PowKernelTierDetect();
+#ifdef HAVE_POW_KERNEL_TIERS
+    if (tier != POW_KERNEL_BASELINE) {
+        assert(SelfTest(yescrypt_select_kdf, tier, YescryptHash));
+        assert(SelfTest(yespower_select_kernel, tier, YespowerHash));
+        assert(SelfTest(argon2_select_fill_segment, tier, Argon2Hash));
+    }
+#endif
+
+    std::vector<std::pair<std::string, std::string> > kernels;
+    kernels.emplace_back("yescrypt", yescrypt_select_kdf(tier));
+    kernels.emplace_back("yespower", yespower_select_kernel(tier));
+    kernels.emplace_back("argon2", argon2_select_fill_segment(tier));
+#if defined(USE_SSE2)
+    kernels.emplace_back("scrypt", scrypt_detect_sse2());
+#else
+    kernels.emplace_back("scrypt", "generic");
+#endif
+    return kernels;
+}
@@ -0,0 +1,45 @@
+// Copyright (c) 2026 The Globaltoken Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef GLOBALTOKEN_CRYPTO_ALGOS_POWKERNELS_H
+#define GLOBALTOKEN_CRYPTO_ALGOS_POWKERNELS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Instruction set tiers the kernels of the memory-hard algos are built for
+ * in addition to the baseline, which uses the flags of the library. A tier
+ * implies the ones below it.
+ */
+enum pow_kernel_tier {
+    POW_KERNEL_BASELINE = 0,
+    POW_KERNEL_SSE41    = 1,
+    POW_KERNEL_AVX2     = 2,
+};
+
+/**
+ * Select the fastest kernel built for a tier up to the given one and return
+ * its name. Must not be called while hashes are computed.
+ */
+const char *yescrypt_select_kdf(int tier);
+const char *yespower_select_kernel(int tier);
+const char *argon2_select_fill_segment(int tier);
+
+#ifdef __cplusplus
+}
+
+#include <string>
+#include <utility>
+#include <vector>
+
+/** Highest tier the CPU supports */
+int PowKernelTierDetect();
+
+/** Select the kernels of the memory-hard algos for the CPU, returns the algos with the selected implementation. */
+std::vector<std::pair<std::string, std::string> > PowKernelsAutoDetect();
+#endif
+
+#endif // GLOBALTOKEN_CRYPTO_ALGOS_POWKERNELS_H
@@ -0,0 +1,162 @@
+// Copyright (c) 2026 The Globaltoken Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#if defined(HAVE_CONFIG_H)
+#include <config/bitcoin-config.h>
+#endif
+
+#include <crypto/algos/scratchpad.h>
+
+#include <algorithm>
+#include <atomic>
+#include <stdlib.h>
+
+#ifdef WIN32
+#include <malloc.h>
+#else
+#include <sys/mman.h>
+#endif
+
+namespace {
+
+const size_t SCRATCHPAD_ALIGNMENT = 64;
+const size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+std::atomic<size_t> nArenaSize{0};
+std::atomic<bool> fArenaHugePages{false};
+
+std::atomic<size_t> nArenas{0};
+std::atomic<size_t> nReserved{0};
+std::atomic<size_t> nHugePagesReserved{0};
+std::atomic<uint64_t> nAllocations{0};
+std::atomic<uint64_t> nFallbacks{0};
+
+/** Memory of one arena, plain data so it can live in thread-local storage without a constructor */
+struct ScratchpadArena
+{
+    void* pBase;
+    size_t nSize;
+    bool fMapped;
+    bool fHuge;
+
+    bool Allocate(size_t nSizeIn)
+    {
+        nSize = nSizeIn;
+        fMapped = false;
+        fHuge = false;
+#if !defined(WIN32) && defined(MAP_ANONYMOUS)
+        if (fArenaHugePages) {
+            nSize = (nSize + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+#ifdef MAP_HUGETLB
+            pBase = mmap(nullptr, nSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            fHuge = pBase != MAP_FAILED;
+#endif
+            if (!fHuge) {
+                // No explicit huge pages reserved, ask for transparent ones
+                pBase = mmap(nullptr, nSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                if (pBase == MAP_FAILED) {
+                    pBase = nullptr;
+                    return false;
+                }
+#ifdef MADV_HUGEPAGE
+                madvise(pBase, nSize, MADV_HUGEPAGE);
+#endif
+            }
+            fMapped = true;
+            return true;
+        }
+#endif
+#ifdef WIN32
+        pBase = _aligned_malloc(nSize, SCRATCHPAD_ALIGNMENT);
+#else
+        if (posix_memalign(&pBase, SCRATCHPAD_ALIGNMENT, nSize) != 0)
+            pBase = nullptr;
+#endif
+        return pBase != nullptr;
+    }
+
+    void Release()
+    {
+        if (pBase == nullptr)
+            return;
+#ifdef WIN32
+        _aligned_free(pBase);
+#else
+        if (fMapped)
+            munmap(pBase, nSize);
+        else
+            free(pBase);
+#endif
+        nArenas--;
+        nReserved -= nSize;
+        if (fHuge)
+            nHugePagesReserved -= nSize;
+        pBase = nullptr;
+        nSize = 0;
+    }
+
+    void* Get(size_t nNeeded)
+    {
+        if (pBase != nullptr && nSize >= nNeeded)
+            return pBase;
+        Release();
+        if (!Allocate(std::max(nNeeded, nArenaSize.load()))) {
+            pBase = nullptr;
+            nSize = 0;
+            return nullptr;
+        }
+        nArenas++;
+        nReserved += nSize;
+        if (fHuge)
+            nHugePagesReserved += nSize;
+        nAllocations++;
+        return pBase;
+    }
+};
+
+#ifdef HAVE_THREAD_LOCAL
+/** Releases the arena of a thread when it exits */
+struct ScratchpadArenaOwner
+{
+    ScratchpadArena arena{nullptr, 0, false, false};
+    ~ScratchpadArenaOwner() { arena.Release(); }
+};
+thread_local ScratchpadArenaOwner arenaOwner;
+#define THREAD_ARENA arenaOwner.arena
+#else
+// Without thread_local destructors the arena lives as long as the process
+static __thread ScratchpadArena threadArena;
+#define THREAD_ARENA threadArena
+#endif
+
+} // namespace
+
+void *pow_scratchpad_get(size_t size)
+{
+    return THREAD_ARENA.Get(size);
+}
+
+void pow_scratchpad_note_fallback(void)
+{
+    nFallbacks++;
+}
+
+void PowScratchpadInit(size_t nSize, bool fHugePages)
+{
+    nArenaSize = (nSize + SCRATCHPAD_ALIGNMENT - 1) & ~(SCRATCHPAD_ALIGNMENT - 1);
+    fArenaHugePages = fHugePages;
+}
+
+PowScratchpadStats PowScratchpadGetStats()
+{
+    PowScratchpadStats stats;
+    stats.nSize = nArenaSize;
+    stats.fHugePages = fArenaHugePages;
+    stats.nArenas = nArenas;
+    stats.nReserved = nReserved;
+    stats.nHugePagesReserved = nHugePagesReserved;
+    stats.nAllocations = nAllocations;
+    stats.nFallbacks = nFallbacks;
+    return stats;
+}
@@ -0,0 +1,67 @@
+// Copyright (c) 2026 The Globaltoken Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef GLOBALTOKEN_CRYPTO_ALGOS_SCRATCHPAD_H
+#define GLOBALTOKEN_CRYPTO_ALGOS_SCRATCHPAD_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Working memory of the memory-hard proof-of-work kernels.
+ *
+ * Every thread owns one arena, allocated on first use with at least the size
+ * set by PowScratchpadInit and released when the thread exits. The returned
+ * memory is 64-byte aligned and its contents are undefined; it stays valid
+ * until the next call on the same thread, so kernels must not nest calls.
+ * The arena only grows when a kernel asks for more than it holds.
+ *
+ * Returns NULL if the memory cannot be allocated.
+ */
+void *pow_scratchpad_get(size_t size);
+
+/**
+ * To be called by kernels that had to allocate memory of their own because
+ * the scratchpad they were given was too small, which is a sizing bug.
+ */
+void pow_scratchpad_note_fallback(void);
+
+#ifdef __cplusplus
+}
+
+#include <stdint.h>
+
+static const bool DEFAULT_POW_HUGEPAGES = false;
+
+/** Statistics of the scratchpad arenas of all threads */
+struct PowScratchpadStats
+{
+    //! Size new arenas are allocated with
+    size_t nSize;
+    //! Whether arenas are backed by huge pages where the platform allows it
+    bool fHugePages;
+    //! Number of threads holding an arena
+    size_t nArenas;
+    //! Bytes held by all arenas
+    size_t nReserved;
+    //! Bytes held in explicitly allocated huge pages
+    size_t nHugePagesReserved;
+    //! Number of arena allocations, including regrowths
+    uint64_t nAllocations;
+    //! Number of hashes whose kernel allocated memory besides the arena
+    uint64_t nFallbacks;
+};
+
+/**
+ * Set the size of arenas allocated from now on, normally that of the largest
+ * memory-hard algo, and whether to back them with huge pages.
+ */
+void PowScratchpadInit(size_t nSize, bool fHugePages);
+PowScratchpadStats PowScratchpadGetStats();
+#endif
+
+#endif // GLOBALTOKEN_CRYPTO_ALGOS_SCRATCHPAD_H
@@ -27,9 +27,10 @@
  * online backup system.
  */
 
+#include "crypto/algos/scrypt/scrypt.h"
+
 #if defined(USE_SSE2)
 
-#include "crypto/algos/scrypt/scrypt.h"
 #include <stdlib.h>
 #include <stdint.h>
 #include <string.h>
@@ -295,7 +295,7 @@ std::string scrypt_detect_sse2()
 {
     std::string ret;
 #if defined(USE_SSE2_ALWAYS)
-    ret = "scrypt: using scrypt-sse2 as built.";
+    ret = "sse2";
 #else // USE_SSE2_ALWAYS
     // 32bit x86 Linux or Windows, detect cpuid features
     unsigned int cpuid_edx=0;
@@ -313,12 +313,12 @@ std::string scrypt_detect_sse2()
     if (cpuid_edx & 1<<26)
     {
         scrypt_1024_1_1_256_sp_detected = &scrypt_1024_1_1_256_sp_sse2;
-        ret = "scrypt: using scrypt-sse2 as detected";
+        ret = "sse2";
     }
     else
     {
         scrypt_1024_1_1_256_sp_detected = &scrypt_1024_1_1_256_sp_generic;
-        ret = "scrypt: using scrypt-generic, SSE2 unavailable";
+        ret = "generic";
     }
 #endif // USE_SSE2_ALWAYS
     return ret;
@@ -8,6 +8,11 @@ static const int SCRYPT_SCRATCHPAD_SIZE = 131072 + 63;
 void scrypt_1024_1_1_256(const char *input, char *output);
 void scrypt_1024_1_1_256_sp_generic(const char *input, char *output, char *scratchpad);
 
+#if !defined(USE_SSE2) && (defined(_M_X64) || defined(__x86_64__) || defined(_M_AMD64))
+// SSE2 is part of x86-64, so its kernel is built without --enable-sse2 too
+#define USE_SSE2 1
+#endif
+
 #if defined(USE_SSE2)
 #include <string>
 #if defined(_M_X64) || defined(__x86_64__) || defined(_M_AMD64) || (defined(MAC_OSX) && defined(__i386__))
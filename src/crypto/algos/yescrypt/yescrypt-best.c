@@ -1,5 +1,85 @@
 #if defined (__x86_64__)
+#include "../powkernels.h"
+
+/*
+ * The baseline kernel is built with the flags of the library, the ones for
+ * higher instruction sets (yescrypt-sse41.c, yescrypt-avx2.c) are selected
+ * at runtime by yescrypt_select_kdf().
+ */
+#define yescrypt_kdf yescrypt_kdf_baseline
 #include "yescrypt-simd.c"
+#undef yescrypt_kdf
+
+typedef int (*yescrypt_kdf_t)(const yescrypt_shared_t * shared,
+    yescrypt_local_t * local,
+    const uint8_t * passwd, size_t passwdlen,
+    const uint8_t * salt, size_t saltlen,
+    uint64_t N, uint32_t r, uint32_t p, uint32_t t,
+    yescrypt_flags_t flags,
+    uint8_t * buf, size_t buflen);
+
+#ifdef ENABLE_SSE41
+extern int yescrypt_kdf_sse41(const yescrypt_shared_t * shared,
+    yescrypt_local_t * local,
+    const uint8_t * passwd, size_t passwdlen,
+    const uint8_t * salt, size_t saltlen,
+    uint64_t N, uint32_t r, uint32_t p, uint32_t t,
+    yescrypt_flags_t flags,
+    uint8_t * buf, size_t buflen);
+#endif
+#ifdef ENABLE_AVX2
+extern int yescrypt_kdf_avx2(const yescrypt_shared_t * shared,
+    yescrypt_local_t * local,
+    const uint8_t * passwd, size_t passwdlen,
+    const uint8_t * salt, size_t saltlen,
+    uint64_t N, uint32_t r, uint32_t p, uint32_t t,
+    yescrypt_flags_t flags,
+    uint8_t * buf, size_t buflen);
+#endif
+
+static yescrypt_kdf_t yescrypt_kdf_selected = yescrypt_kdf_baseline;
+
+int
+yescrypt_kdf(const yescrypt_shared_t * shared, yescrypt_local_t * local,
+    const uint8_t * passwd, size_t passwdlen,
+    const uint8_t * salt, size_t saltlen,
+    uint64_t N, uint32_t r, uint32_t p, uint32_t t, yescrypt_flags_t flags,
+    uint8_t * buf, size_t buflen)
+{
+	return yescrypt_kdf_selected(shared, local, passwd, passwdlen,
+	    salt, saltlen, N, r, p, t, flags, buf, buflen);
+}
+
+const char *
+yescrypt_select_kdf(int tier)
+{
+#ifdef ENABLE_AVX2
+	if (tier >= POW_KERNEL_AVX2) {
+		yescrypt_kdf_selected = yescrypt_kdf_avx2;
+		return "avx2";
+	}
+#endif
+#ifdef ENABLE_SSE41
+	if (tier >= POW_KERNEL_SSE41) {
+		yescrypt_kdf_selected = yescrypt_kdf_sse41;
+		return "sse4.1";
+	}
+#endif
+	yescrypt_kdf_selected = yescrypt_kdf_baseline;
+#ifdef __SSE4_1__
+	return "sse4.1";
+#else
+	return "sse2";
+#endif
+}
 #else
+#include "../powkernels.h"
 #include "yescrypt-opt.c"
+
+const char *
+yescrypt_select_kdf(int tier)
+{
+	(void)tier;
+	return "generic";
+}
 #endif
@@ -24,6 +24,7 @@
 #include <sys/mman.h>
 #endif
 #include "yescrypt.h"
+#include "../scratchpad.h"
 #define HUGEPAGE_THRESHOLD		(12 * 1024 * 1024)
 
 #ifdef __x86_64__
@@ -112,6 +113,8 @@ free_region(yescrypt_region_t * region)
 	return 0;
 }
 
+/* Built once, not again with each yescrypt_kdf() variant */
+#ifndef YESCRYPT_KDF_ONLY
 int
 yescrypt_init_shared(yescrypt_shared_t * shared,
     const uint8_t * param, size_t paramlen,
@@ -188,8 +191,21 @@ yescrypt_init_local(yescrypt_local_t * local)
 	return 0;
 }
 
+int
+yescrypt_init_local_scratchpad(yescrypt_local_t * local,
+    uint64_t N, uint32_t r, uint32_t p)
+{
+	size_t size = YESCRYPT_LOCAL_SIZE(N, r, p);
+	init_region(local);
+	if (!(local->aligned = pow_scratchpad_get(size)))
+		return -1;
+	local->aligned_size = size;
+	return 0;
+}
+
 int
 yescrypt_free_local(yescrypt_local_t * local)
 {
 	return free_region(local);
 }
+#endif
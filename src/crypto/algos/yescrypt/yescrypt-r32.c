@@ -18,6 +18,7 @@
  * SUCH DAMAGE.
  */
 #include "yescrypt.h"
+#include "../scratchpad.h"
 
 #define YESCRYPT_N 4096
 #define YESCRYPT_R 32
@@ -25,79 +26,38 @@
 #define YESCRYPT_T 0
 #define YESCRYPT_FLAGS (YESCRYPT_RW | YESCRYPT_PWXFORM)
 
-#ifdef __clang__
-
 static int yescrypt_wavi(const uint8_t *passwd, size_t passwdlen,
-                            const uint8_t *salt, size_t saltlen,
-                            uint8_t *buf, size_t buflen)
+                         const uint8_t *salt, size_t saltlen,
+                         uint8_t *buf, size_t buflen)
 {
     yescrypt_shared_t shared;
     yescrypt_local_t local;
     int retval;
-    
+
+    /* "shared" is a dummy without a ROM, "local" lives on the scratchpad of
+     * the thread, which is kept for the next hash. */
     if (yescrypt_init_shared(&shared, NULL, 0,
                              0, 0, 0, YESCRYPT_SHARED_DEFAULTS, 0, NULL, 0))
         return -1;
-    if (yescrypt_init_local(&local)) {
+    if (yescrypt_init_local_scratchpad(&local, YESCRYPT_N, YESCRYPT_R, YESCRYPT_P)) {
         yescrypt_free_shared(&shared);
         return -1;
     }
     retval = yescrypt_kdf(&shared, &local, passwd, passwdlen, salt, saltlen,
                           YESCRYPT_N, YESCRYPT_R, YESCRYPT_P, YESCRYPT_T,
                           YESCRYPT_FLAGS, buf, buflen);
+    if (local.base)
+        pow_scratchpad_note_fallback();
     if (yescrypt_free_local(&local)) {
         yescrypt_free_shared(&shared);
         return -1;
     }
     if (yescrypt_free_shared(&shared))
         return -1;
-    
-    return retval;
-}
-
-#else
 
-static int yescrypt_wavi(const uint8_t *passwd, size_t passwdlen,
-                            const uint8_t *salt, size_t saltlen,
-                            uint8_t *buf, size_t buflen)
-{
-    static __thread int initialized = 0;
-    static __thread yescrypt_shared_t shared;
-    static __thread yescrypt_local_t local;
-    int retval;
-    if (!initialized) {
-        /* "shared" could in fact be shared, but it's simpler to keep it private
-         * along with "local".  It's dummy and tiny anyway. */
-        if (yescrypt_init_shared(&shared, NULL, 0,
-                                 0, 0, 0, YESCRYPT_SHARED_DEFAULTS, 0, NULL, 0))
-            return -1;
-        if (yescrypt_init_local(&local)) {
-            yescrypt_free_shared(&shared);
-            return -1;
-        }
-        initialized = 1;
-    }
-    retval = yescrypt_kdf(&shared, &local, passwd, passwdlen, salt, saltlen,
-                          YESCRYPT_N, YESCRYPT_R, YESCRYPT_P, YESCRYPT_T,
-                          YESCRYPT_FLAGS, buf, buflen);
-#if 0
-    if (yescrypt_free_local(&local)) {
-        yescrypt_free_shared(&shared);
-        return -1;
-    }
-    if (yescrypt_free_shared(&shared))
-        return -1;
-    initialized = 0;
-#endif
-    if (retval < 0) {
-        yescrypt_free_local(&local);
-        yescrypt_free_shared(&shared);
-    }
     return retval;
 }
 
-#endif
-
 void yescrypt_r32_hash(const char *input, char *output)
 {
     yescrypt_wavi((const uint8_t *) input, 80,
@@ -0,0 +1,9 @@
+/*
+ * yescrypt_kdf() built for SSE4.1, selected at runtime by
+ * yescrypt_select_kdf() in yescrypt-best.c.
+ */
+#if defined (__x86_64__)
+#define YESCRYPT_KDF_ONLY
+#define yescrypt_kdf yescrypt_kdf_sse41
+#include "yescrypt-simd.c"
+#endif
@@ -186,6 +186,28 @@ extern int yescrypt_free_shared(yescrypt_shared_t * __shared);
  */
 extern int yescrypt_init_local(yescrypt_local_t * __local);
 
+/**
+ * YESCRYPT_LOCAL_SIZE(N, r, p):
+ * Upper bound of the thread-local (RAM) memory yescrypt_kdf() needs for the
+ * given parameters when called without a ROM, by both the SIMD and the
+ * portable (yescrypt-opt.c) implementation.  The latter pads XY by 64 bytes.
+ */
+#define YESCRYPT_LOCAL_SIZE(N, r, p) \
+	((size_t)128 * (r) * ((N) + (p)) + (size_t)256 * (r) + 64 + \
+	    (size_t)8192 * (p))
+
+/**
+ * yescrypt_init_local_scratchpad(local, N, r, p):
+ * Initialize the thread-local (RAM) data structure on the proof-of-work
+ * scratchpad of the calling thread, sized for the given parameters.  The
+ * memory is owned by the scratchpad; yescrypt_free_local() only releases
+ * memory yescrypt_kdf() had to allocate in addition.
+ *
+ * Return 0 on success; or -1 on error.
+ */
+extern int yescrypt_init_local_scratchpad(yescrypt_local_t * __local,
+    uint64_t __N, uint32_t __r, uint32_t __p);
+
 /**
  * yescrypt_free_local(local):
  * Free memory that may have been allocated for an initialized thread-local
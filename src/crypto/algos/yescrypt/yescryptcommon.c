@@ -22,6 +22,7 @@
 #include <string.h>
 #include <stdio.h>
 #include "yescrypt.h"
+#include "../scratchpad.h"
 
 #define BYTES2CHARS(bytes) \
 	((((bytes) * 8) + 5) / 6)
@@ -332,34 +333,29 @@ yescrypt_bsty(const uint8_t * passwd, size_t passwdlen,
     const uint8_t * salt, size_t saltlen, uint64_t N, uint32_t r, uint32_t p,
     uint8_t * buf, size_t buflen)
 {
-	static __thread int initialized = 0;
-	static __thread yescrypt_shared_t shared;
-	static __thread yescrypt_local_t local;
+	yescrypt_shared_t shared;
+	yescrypt_local_t local;
 	int retval;
-	if (!initialized) {
-/* "shared" could in fact be shared, but it's simpler to keep it private
- * along with "local".  It's dummy and tiny anyway. */
-		if (yescrypt_init_shared(&shared, NULL, 0,
-		    0, 0, 0, YESCRYPT_SHARED_DEFAULTS, 0, NULL, 0))
-			return -1;
-		if (yescrypt_init_local(&local)) {
-			yescrypt_free_shared(&shared);
-			return -1;
-		}
-		initialized = 1;
- 	}
+/* "shared" is a dummy without a ROM, "local" lives on the scratchpad of the
+ * thread, which is kept for the next hash. */
+	if (yescrypt_init_shared(&shared, NULL, 0,
+	    0, 0, 0, YESCRYPT_SHARED_DEFAULTS, 0, NULL, 0))
+		return -1;
+	if (yescrypt_init_local_scratchpad(&local, N, r, p)) {
+		yescrypt_free_shared(&shared);
+		return -1;
+	}
 	retval = yescrypt_kdf(&shared, &local,
 	    passwd, passwdlen, salt, saltlen, N, r, p, 0, YESCRYPT_FLAGS,
-	    buf, buflen);		
-#if 0		
+	    buf, buflen);
+	if (local.base)
+		pow_scratchpad_note_fallback();
 	if (yescrypt_free_local(&local)) {
 		yescrypt_free_shared(&shared);
 		return -1;
 	}
 	if (yescrypt_free_shared(&shared))
 		return -1;
-	initialized = 0;
-#endif		
 	return retval;
 }
 
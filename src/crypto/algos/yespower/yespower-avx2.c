@@ -0,0 +1,9 @@
+/*
+ * yespower() built for AVX2, selected at runtime by
+ * yespower_select_kernel() in yespower-opt.c.
+ */
+#if defined(__x86_64__)
+#define YESPOWER_KERNEL_ONLY
+#define yespower yespower_avx2
+#include "yespower-opt.c"
+#endif
@@ -99,6 +99,8 @@
 #include "sysendian.h"
 
 #include "yespower.h"
+#include "../powkernels.h"
+#include "../scratchpad.h"
 
 #include "yespower-platform.c"
 
@@ -1112,26 +1114,78 @@ int yespower(yespower_local_t *local,
 	return 0;
 }
 
+/* Built once, not again with each yespower() variant */
+#ifndef YESPOWER_KERNEL_ONLY
+typedef int (*yespower_kernel_t)(yespower_local_t *local,
+    const uint8_t *src, size_t srclen,
+    const yespower_params_t *params, yespower_binary_t *dst);
+
+#ifdef ENABLE_SSE41
+extern int yespower_sse41(yespower_local_t *local,
+    const uint8_t *src, size_t srclen,
+    const yespower_params_t *params, yespower_binary_t *dst);
+#endif
+#ifdef ENABLE_AVX2
+extern int yespower_avx2(yespower_local_t *local,
+    const uint8_t *src, size_t srclen,
+    const yespower_params_t *params, yespower_binary_t *dst);
+#endif
+
+static yespower_kernel_t yespower_kernel = yespower;
+
+const char *yespower_select_kernel(int tier)
+{
+#if defined(ENABLE_AVX2) && defined(__x86_64__)
+	if (tier >= POW_KERNEL_AVX2) {
+		yespower_kernel = yespower_avx2;
+		return "avx2";
+	}
+#endif
+#if defined(ENABLE_SSE41) && defined(__x86_64__)
+	if (tier >= POW_KERNEL_SSE41) {
+		yespower_kernel = yespower_sse41;
+		return "sse4.1";
+	}
+#endif
+	(void)tier;
+	yespower_kernel = yespower;
+#if defined(__AVX__)
+	return "avx";
+#elif defined(__SSE4_1__)
+	return "sse4.1";
+#elif defined(__SSE2__)
+	return "sse2";
+#else
+	return "generic";
+#endif
+}
+
 /**
  * yespower_tls(src, srclen, params, dst):
  * Compute yespower(src[0 .. srclen - 1], N, r), to be checked for "< target".
- * The memory allocation is maintained internally using thread-local storage.
+ * The memory is taken from the proof-of-work scratchpad of the thread.
  *
  * Return 0 on success; or -1 on error.
  */
 int yespower_tls(const uint8_t *src, size_t srclen,
     const yespower_params_t *params, yespower_binary_t *dst)
 {
-	static __thread int initialized = 0;
-	static __thread yespower_local_t local;
+	yespower_local_t local;
+	size_t size = YESPOWER_LOCAL_SIZE(params->N, params->r);
+	int retval;
 
-	if (!initialized) {
-		if (yespower_init_local(&local))
-			return -1;
-		initialized = 1;
-	}
+	init_region(&local);
+	if (!(local.aligned = pow_scratchpad_get(size)))
+		return -1;
+	local.aligned_size = size;
 
-	return yespower(&local, src, srclen, params, dst);
+	retval = yespower_kernel(&local, src, srclen, params, dst);
+	if (local.base)
+		pow_scratchpad_note_fallback();
+	/* Only frees memory yespower() had to allocate in addition */
+	if (yespower_free_local(&local))
+		return -1;
+	return retval;
 }
 
 int yespower_init_local(yespower_local_t *local)
@@ -1144,4 +1198,5 @@ int yespower_free_local(yespower_local_t *local)
 {
 	return free_region(local);
 }
+#endif /* !YESPOWER_KERNEL_ONLY */
 #endif
@@ -0,0 +1,9 @@
+/*
+ * yespower() built for SSE4.1, selected at runtime by
+ * yespower_select_kernel() in yespower-opt.c.
+ */
+#if defined(__x86_64__)
+#define YESPOWER_KERNEL_ONLY
+#define yespower yespower_sse41
+#include "yespower-opt.c"
+#endif
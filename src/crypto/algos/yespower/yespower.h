@@ -73,6 +73,14 @@ typedef struct {
 	unsigned char uc[32];
 } yespower_binary_t;
 
+/**
+ * YESPOWER_LOCAL_SIZE(N, r):
+ * Upper bound of the thread-local (RAM) memory yespower() needs for the given
+ * parameters, in either version.
+ */
+#define YESPOWER_LOCAL_SIZE(N, r) \
+	((size_t)128 * (r) * ((size_t)(N) + 3) + 98304)
+
 /**
  * yespower_init_local(local):
  * Initialize the thread-local (RAM) data structure.  Actual memory allocation
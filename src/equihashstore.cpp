@@ -0,0 +1,138 @@
+// Copyright (c) 2026 The Globaltoken Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <equihashstore.h>
+
+#include <chain.h>
+#include <memusage.h>
+#include <txdb.h>
+#include <validation.h>
+
+CEquihashStore equihashstore;
+
+CEquihashStore::CEquihashStore(size_t nMaxUsageIn) : nMaxUsage(nMaxUsageIn), nPendingUsage(0), nCachedUsage(0),
+    nOffloaded(0), nOffloadedBytes(0), nHits(0), nReads(0)
+{
+}
+
+size_t CEquihashStore::InlineUsage(const CEquihashFields& fields)
+{
+    return sizeof(CEquihashFields) + memusage::DynamicUsage(fields.nSolution);
+}
+
+size_t CEquihashStore::EntryUsage(const CEquihashFields& fields)
+{
+    // list node + hash table node + solution
+    return memusage::MallocUsage(sizeof(list_type::value_type) + 2 * sizeof(void*)) +
+           memusage::MallocUsage(sizeof(std::pair<const uint256, list_type::iterator>) + sizeof(void*)) +
+           memusage::DynamicUsage(fields.nSolution);
+}
+
+void CEquihashStore::Trim()
+{
+    AssertLockHeld(cs);
+    while (nCachedUsage > nMaxUsage && !lruEntries.empty()) {
+        nCachedUsage -= EntryUsage(lruEntries.back().second);
+        mapCached.erase(lruEntries.back().first);
+        lruEntries.pop_back();
+    }
+}
+
+void CEquihashStore::Cache(const uint256& hash, CEquihashFields&& fields)
+{
+    AssertLockHeld(cs);
+    if (nMaxUsage == 0 || mapCached.count(hash))
+        return;
+    nCachedUsage += EntryUsage(fields);
+    lruEntries.emplace_front(hash, std::move(fields));
+    mapCached.emplace(hash, lruEntries.begin());
+    Trim();
+}
+
+void CEquihashStore::AddPending(const uint256& hash, const CEquihashFields& fields)
+{
+    LOCK(cs);
+    if (mapPending.emplace(hash, fields).second)
+        nPendingUsage += memusage::MallocUsage(sizeof(std::pair<const uint256, CEquihashFields>) + sizeof(void*)) +
+                         memusage::DynamicUsage(fields.nSolution);
+}
+
+void CEquihashStore::SetWritten(const std::vector<const CBlockIndex*>& vBlocks)
+{
+    LOCK(cs);
+    for (const CBlockIndex* pindex : vBlocks) {
+        auto it = mapPending.find(pindex->GetBlockHash());
+        if (it == mapPending.end())
+            continue;
+        nPendingUsage -= memusage::MallocUsage(sizeof(std::pair<const uint256, CEquihashFields>) + sizeof(void*)) +
+                         memusage::DynamicUsage(it->second.nSolution);
+        nOffloaded++;
+        nOffloadedBytes += InlineUsage(it->second);
+        // Recently added headers are the ones most likely to be asked for next.
+        Cache(it->first, std::move(it->second));
+        mapPending.erase(it);
+    }
+}
+
+void CEquihashStore::AddOffloaded(const CEquihashFields& fields)
+{
+    LOCK(cs);
+    nOffloaded++;
+    nOffloadedBytes += InlineUsage(fields);
+}
+
+bool CEquihashStore::Get(const uint256& hash, CEquihashFields& fields)
+{
+    {
+        LOCK(cs);
+        auto it = mapPending.find(hash);
+        if (it != mapPending.end()) {
+            fields = it->second;
+            return true;
+        }
+        auto itCached = mapCached.find(hash);
+        if (itCached != mapCached.end()) {
+            nHits++;
+            lruEntries.splice(lruEntries.begin(), lruEntries, itCached->second);
+            fields = itCached->second->second;
+            return true;
+        }
+        nReads++;
+    }
+
+    if (!pblocktree || !pblocktree->ReadEquihashFields(hash, fields))
+        return false;
+
+    LOCK(cs);
+    CEquihashFields copy(fields);
+    Cache(hash, std::move(copy));
+    return true;
+}
+
+void CEquihashStore::Clear()
+{
+    LOCK(cs);
+    mapPending.clear();
+    lruEntries.clear();
+    mapCached.clear();
+    nPendingUsage = 0;
+    nCachedUsage = 0;
+    nOffloaded = 0;
+    nOffloadedBytes = 0;
+}
+
+EquihashStoreStats CEquihashStore::GetStats() const
+{
+    LOCK(cs);
+    EquihashStoreStats stats;
+    stats.nPending = mapPending.size();
+    stats.nCached = mapCached.size();
+    stats.nUsage = nPendingUsage + nCachedUsage;
+    stats.nMaxUsage = nMaxUsage;
+    stats.nOffloaded = nOffloaded;
+    stats.nOffloadedBytes = nOffloadedBytes;
+    stats.nHits = nHits;
+    stats.nReads = nReads;
+    return stats;
+}
@@ -0,0 +1,116 @@
+// Copyright (c) 2026 The Globaltoken Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_EQUIHASHSTORE_H
+#define BITCOIN_EQUIHASHSTORE_H
+
+#include <serialize.h>
+#include <sync.h>
+#include <uint256.h>
+
+#include <list>
+#include <stdint.h>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class CBlockIndex;
+
+/** Maximum memory used by equihash fields read back from the block tree database */
+static const size_t DEFAULT_EQUIHASH_STORE_CACHE_SIZE = 8 << 20;
+
+/** The header fields only used by equihash based algos */
+struct CEquihashFields
+{
+    uint256 hashReserved;
+    uint256 nBigNonce;
+    std::vector<unsigned char> nSolution;
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action) {
+        READWRITE(hashReserved);
+        READWRITE(nBigNonce);
+        READWRITE(nSolution);
+    }
+};
+
+/** Memory statistics of a CEquihashStore */
+struct EquihashStoreStats
+{
+    size_t nPending;
+    size_t nCached;
+    size_t nUsage;
+    size_t nMaxUsage;
+    uint64_t nOffloaded;
+    uint64_t nOffloadedBytes;
+    uint64_t nHits;
+    uint64_t nReads;
+};
+
+/**
+ * Side table for the equihash header fields of the block index.
+ *
+ * CBlockIndex does not keep hashReserved, nBigNonce and nSolution in memory,
+ * most blocks are not mined with an equihash algo and the solution of those
+ * that are is by far the largest part of their index entry. Entries of new
+ * headers are kept until the block index has been flushed to the block tree
+ * database; after that they are read back from it on demand, with a
+ * size-bounded LRU cache in front.
+ */
+class CEquihashStore
+{
+private:
+    struct EntryHasher
+    {
+        size_t operator()(const uint256& hash) const { return hash.GetCheapHash(); }
+    };
+
+    typedef std::list<std::pair<uint256, CEquihashFields> > list_type;
+
+    mutable CCriticalSection cs;
+    //! Entries of headers that have not been written to the block tree database yet
+    std::unordered_map<uint256, CEquihashFields, EntryHasher> mapPending;
+    //! Entries read back from the database, ordered from most to least recently used
+    list_type lruEntries;
+    std::unordered_map<uint256, list_type::iterator, EntryHasher> mapCached;
+    size_t nMaxUsage;
+    size_t nPendingUsage;
+    size_t nCachedUsage;
+    uint64_t nOffloaded;
+    uint64_t nOffloadedBytes;
+    uint64_t nHits;
+    uint64_t nReads;
+
+    static size_t EntryUsage(const CEquihashFields& fields);
+    void Cache(const uint256& hash, CEquihashFields&& fields);
+    void Trim();
+
+public:
+    explicit CEquihashStore(size_t nMaxUsageIn = DEFAULT_EQUIHASH_STORE_CACHE_SIZE);
+
+    /** Memory the fields of one header would take up inside CBlockIndex. */
+    static size_t InlineUsage(const CEquihashFields& fields);
+
+    /** Keep the fields of a header that was added to the block index. */
+    void AddPending(const uint256& hash, const CEquihashFields& fields);
+
+    /** Release the pending entries of index entries written to the database. */
+    void SetWritten(const std::vector<const CBlockIndex*>& vBlocks);
+
+    /** Account for the fields of an index entry loaded without them. */
+    void AddOffloaded(const CEquihashFields& fields);
+
+    /** Look up the fields of a block, reading them from the database if necessary. */
+    bool Get(const uint256& hash, CEquihashFields& fields);
+
+    void Clear();
+
+    EquihashStoreStats GetStats() const;
+};
+
+extern CEquihashStore equihashstore;
+
+#endif // BITCOIN_EQUIHASHSTORE_H
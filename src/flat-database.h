@@ -13,15 +13,106 @@
 
 #include <boost/filesystem.hpp>
 
+#include <map>
+#include <vector>
+
+/** Marker at the start of versioned flat files, files without it are in the legacy format */
+static const unsigned char FLATDB_FILE_MARKER[4] = {'G', 'F', 'D', 'B'};
+/** Marker at the start of the delta logs kept next to flat files by CFlatDBLog */
+static const unsigned char FLATDB_LOG_MARKER[4] = {'G', 'F', 'D', 'L'};
+/** Current version of the flat file format */
+static const uint32_t FLATDB_VERSION = 2;
+
+/**
+ * Writes to a file while hashing what was written. Like CDataStream, size() is
+ * the number of bytes written so far.
+ */
+class CHashFileWriter : public CHashWriter
+{
+private:
+    CAutoFile* file;
+    size_t nWritten;
+
+public:
+    explicit CHashFileWriter(CAutoFile* fileIn) : CHashWriter(fileIn->GetType(), fileIn->GetVersion()), file(fileIn), nWritten(0) {}
+
+    void write(const char* pch, size_t nSize)
+    {
+        file->write(pch, nSize);
+        CHashWriter::write(pch, nSize);
+        nWritten += nSize;
+    }
+
+    size_t size() const { return nWritten; }
+
+    template<typename T>
+    CHashFileWriter& operator<<(const T& obj)
+    {
+        ::Serialize(*this, obj);
+        return (*this);
+    }
+};
+
+/**
+ * Reads the first nSize bytes of a file while hashing what was read. Like
+ * CDataStream, size() is the number of bytes left to read, which some of the
+ * stored objects check to detect their older formats.
+ */
+class CHashFileReader : public CHashWriter
+{
+private:
+    CAutoFile* file;
+    size_t nRemaining;
+
+public:
+    CHashFileReader(CAutoFile* fileIn, size_t nSize) : CHashWriter(fileIn->GetType(), fileIn->GetVersion()), file(fileIn), nRemaining(nSize) {}
+
+    void read(char* pch, size_t nSize)
+    {
+        if (nSize > nRemaining)
+            throw std::ios_base::failure("CHashFileReader::read(): end of data");
+        file->read(pch, nSize);
+        CHashWriter::write(pch, nSize);
+        nRemaining -= nSize;
+    }
+
+    void ignore(size_t nSize)
+    {
+        char data[1024];
+        while (nSize > 0) {
+            size_t now = std::min<size_t>(nSize, sizeof(data));
+            read(data, now);
+            nSize -= now;
+        }
+    }
+
+    size_t size() const { return nRemaining; }
+
+    template<typename T>
+    CHashFileReader& operator>>(T& obj)
+    {
+        ::Unserialize(*this, obj);
+        return (*this);
+    }
+};
+
 /** 
 *   Generic Dumping and Loading
 *   ---------------------------
+*
+*   Files start with FLATDB_FILE_MARKER and the format version, followed by the
+*   magic message, the network magic number, the object and the hash of all of
+*   it. Files are written to a temporary file that replaces the old one once it
+*   is complete, and read as a stream, so neither direction buffers the whole
+*   serialized object in memory. Files of the legacy format, which starts with
+*   the magic message, are still read and are rewritten in the current format
+*   on the next dump.
 */
 
 template<typename T>
 class CFlatDB
 {
-private:
+protected:
 
     enum ReadResult {
         Ok,
@@ -37,42 +128,108 @@ private:
     std::string strFilename;
     std::string strMagicMessage;
 
-    bool Write(const T& objToSave)
+    /** Write the object to a new file, and return the checksum at its end in hashRet */
+    bool Write(const T& objToSave, uint256& hashRet)
     {
         // LOCK(objToSave.cs);
 
         int64_t nStart = GetTimeMillis();
 
-        // serialize, checksum data up to that point, then append checksum
-        CDataStream ssObj(SER_DISK, CLIENT_VERSION);
-        ssObj << strMagicMessage; // specific magic message for this type of object
-        ssObj << FLATDATA(Params().MessageStart()); // network specific magic number
-        ssObj << objToSave;
-        uint256 hash = Hash(ssObj.begin(), ssObj.end());
-        ssObj << hash;
-
-        // open output file, and associate with CAutoFile
-        FILE *file = fopen(pathDB.string().c_str(), "wb");
+        // open a temporary output file, and associate with CAutoFile
+        boost::filesystem::path pathTmp = pathDB;
+        pathTmp += ".new";
+        FILE *file = fopen(pathTmp.string().c_str(), "wb");
         CAutoFile fileout(file, SER_DISK, CLIENT_VERSION);
         if (fileout.IsNull())
-            return error("%s: Failed to open file %s", __func__, pathDB.string());
+            return error("%s: Failed to open file %s", __func__, pathTmp.string());
 
-        // Write and commit header, data
+        // serialize while hashing, then append the checksum of everything written
         try {
-            fileout << ssObj;
+            CHashFileWriter writer(&fileout);
+            writer << FLATDATA(FLATDB_FILE_MARKER);
+            writer << FLATDB_VERSION;
+            writer << strMagicMessage; // specific magic message for this type of object
+            writer << FLATDATA(Params().MessageStart()); // network specific magic number
+            writer << objToSave;
+            hashRet = writer.GetHash();
+            fileout << hashRet;
         }
         catch (std::exception &e) {
+            fileout.fclose();
+            boost::filesystem::remove(pathTmp);
             return error("%s: Serialize or I/O error - %s", __func__, e.what());
         }
+        FileCommit(fileout.Get());
         fileout.fclose();
 
+        if (!RenameOver(pathTmp, pathDB))
+            return error("%s: Rename-into-place failed", __func__);
+
         LogPrintf("Written info to %s  %dms\n", strFilename, GetTimeMillis() - nStart);
         LogPrintf("     %s\n", objToSave.ToString());
 
         return true;
     }
 
-    ReadResult Read(T& objToLoad, bool fDryRun = false)
+    /** Read and check the file header, leaving the stream at the object */
+    template<typename Stream>
+    ReadResult ReadHeader(Stream& s)
+    {
+        unsigned char pchMarker[4];
+        uint32_t nVersion = 0;
+        std::string strMagicMessageTmp;
+        unsigned char pchMsgTmp[4];
+        try {
+            s >> FLATDATA(pchMarker);
+            if (memcmp(pchMarker, FLATDB_FILE_MARKER, sizeof(pchMarker)) == 0) {
+                s >> nVersion;
+                if (nVersion > FLATDB_VERSION)
+                {
+                    error("%s: Unknown file format version %u", __func__, nVersion);
+                    return IncorrectFormat;
+                }
+                s >> strMagicMessageTmp;
+            } else {
+                // legacy format, the marker bytes are the start of the magic message
+                size_t nSize = pchMarker[0];
+                if (nSize < sizeof(pchMarker) - 1 || nSize >= 253)
+                {
+                    error("%s: Invalid magic message", __func__);
+                    return IncorrectMagicMessage;
+                }
+                strMagicMessageTmp.assign((const char*)pchMarker + 1, sizeof(pchMarker) - 1);
+                std::string strRest(nSize - (sizeof(pchMarker) - 1), '\0');
+                if (!strRest.empty())
+                    s.read(&strRest[0], strRest.size());
+                strMagicMessageTmp += strRest;
+            }
+
+            // verify the message matches predefined one
+            if (strMagicMessage != strMagicMessageTmp)
+            {
+                error("%s: Invalid magic message", __func__);
+                return IncorrectMagicMessage;
+            }
+
+            // de-serialize file header (network specific magic number) and ..
+            s >> FLATDATA(pchMsgTmp);
+
+            // ... verify the network matches ours
+            if (memcmp(pchMsgTmp, Params().MessageStart(), sizeof(pchMsgTmp)))
+            {
+                error("%s: Invalid network magic number", __func__);
+                return IncorrectMagicNumber;
+            }
+        }
+        catch (std::exception &e) {
+            error("%s: Deserialize or I/O error - %s", __func__, e.what());
+            return IncorrectFormat;
+        }
+        return Ok;
+    }
+
+    /** Read the object from the file, and return the checksum at its end in hashRet */
+    ReadResult Read(T& objToLoad, uint256& hashRet)
     {
         //LOCK(objToLoad.cs);
 
@@ -86,95 +243,64 @@ private:
             return FileError;
         }
 
-        // use file size to size memory buffer
-        int fileSize = boost::filesystem::file_size(pathDB);
-        int dataSize = fileSize - sizeof(uint256);
-        // Don't try to resize to a negative number if file is small
-        if (dataSize < 0)
-            dataSize = 0;
-        std::vector<unsigned char> vchData;
-        vchData.resize(dataSize);
-        uint256 hashIn;
+        // check the header and de-serialize the data into T object, hashing everything read
+        int64_t nDataSize = (int64_t)boost::filesystem::file_size(pathDB) - (int64_t)sizeof(uint256);
+        // Don't try to read a negative number of bytes if file is small
+        if (nDataSize < 0)
+            nDataSize = 0;
+        CHashFileReader reader(&filein, nDataSize);
+        ReadResult result = ReadHeader(reader);
+        if (result != Ok)
+            return result;
+
+        bool fFormatOk = true;
+        try {
+            reader >> objToLoad;
+        }
+        catch (std::exception &e) {
+            objToLoad.Clear();
+            error("%s: Deserialize or I/O error - %s", __func__, e.what());
+            fFormatOk = false;
+        }
 
-        // read data and checksum from file
+        // verify stored checksum matches all of the data, also when it could not be
+        // de-serialized to tell corruption from a format change
         try {
-            filein.read((char *)&vchData[0], dataSize);
-            filein >> hashIn;
+            reader.ignore(reader.size());
+            filein >> hashRet;
         }
         catch (std::exception &e) {
+            objToLoad.Clear();
             error("%s: Deserialize or I/O error - %s", __func__, e.what());
             return HashReadError;
         }
         filein.fclose();
 
-        CDataStream ssObj(vchData, SER_DISK, CLIENT_VERSION);
-
-        // verify stored checksum matches input data
-        uint256 hashTmp = Hash(ssObj.begin(), ssObj.end());
-        if (hashIn != hashTmp)
+        if (hashRet != reader.GetHash())
         {
+            objToLoad.Clear();
             error("%s: Checksum mismatch, data corrupted", __func__);
             return IncorrectHash;
         }
-
-
-        unsigned char pchMsgTmp[4];
-        std::string strMagicMessageTmp;
-        try {
-            // de-serialize file header (file specific magic message) and ..
-            ssObj >> strMagicMessageTmp;
-
-            // ... verify the message matches predefined one
-            if (strMagicMessage != strMagicMessageTmp)
-            {
-                error("%s: Invalid magic message", __func__);
-                return IncorrectMagicMessage;
-            }
-
-
-            // de-serialize file header (network specific magic number) and ..
-            ssObj >> FLATDATA(pchMsgTmp);
-
-            // ... verify the network matches ours
-            if (memcmp(pchMsgTmp, Params().MessageStart(), sizeof(pchMsgTmp)))
-            {
-                error("%s: Invalid network magic number", __func__);
-                return IncorrectMagicNumber;
-            }
-
-            // de-serialize data into T object
-            ssObj >> objToLoad;
-        }
-        catch (std::exception &e) {
-            objToLoad.Clear();
-            error("%s: Deserialize or I/O error - %s", __func__, e.what());
+        if (!fFormatOk)
             return IncorrectFormat;
-        }
 
         LogPrintf("Loaded info from %s  %dms\n", strFilename, GetTimeMillis() - nStart);
         LogPrintf("     %s\n", objToLoad.ToString());
-        if(!fDryRun) {
-            LogPrintf("%s: Cleaning....\n", __func__);
-            objToLoad.CheckAndRemove();
-            LogPrintf("     %s\n", objToLoad.ToString());
-        }
 
         return Ok;
     }
 
-
-public:
-    CFlatDB(std::string strFilenameIn, std::string strMagicMessageIn)
+    void Clean(T& objToLoad)
     {
-        pathDB = GetDataDir() / strFilenameIn;
-        strFilename = strFilenameIn;
-        strMagicMessage = strMagicMessageIn;
+        LogPrintf("%s: Cleaning....\n", __func__);
+        objToLoad.CheckAndRemove();
+        LogPrintf("     %s\n", objToLoad.ToString());
     }
 
-    bool Load(T& objToLoad)
+    /** Log the result of reading the file, returns false if it must not be overwritten */
+    bool CheckReadResult(ReadResult readResult)
     {
-        LogPrintf("Reading info from %s...\n", strFilename);
-        ReadResult readResult = Read(objToLoad);
         if (readResult == FileError)
             LogPrintf("Missing file %s, will try to recreate\n", strFilename);
         else if (readResult != Ok)
@@ -193,31 +319,59 @@ public:
         return true;
     }
 
+    /** Check the header of the file on disk before it is replaced, and return the checksum at its end in hashRet */
+    ReadResult VerifyFile(uint256& hashRet)
+    {
+        FILE *file = fopen(pathDB.string().c_str(), "rb");
+        CAutoFile filein(file, SER_DISK, CLIENT_VERSION);
+        if (filein.IsNull())
+            return FileError;
+        ReadResult readResult = ReadHeader(filein);
+        if (readResult != Ok)
+            return readResult;
+        // a file too short to hold its checksum is recreated like one of an unknown format
+        try {
+            if (fseek(filein.Get(), -(long)sizeof(uint256), SEEK_END))
+                return IncorrectFormat;
+            filein >> hashRet;
+        }
+        catch (std::exception &e) {
+            error("%s: Deserialize or I/O error - %s", __func__, e.what());
+            return IncorrectFormat;
+        }
+        return Ok;
+    }
+
+public:
+    CFlatDB(std::string strFilenameIn, std::string strMagicMessageIn)
+    {
+        pathDB = GetDataDir() / strFilenameIn;
+        strFilename = strFilenameIn;
+        strMagicMessage = strMagicMessageIn;
+    }
+
+    bool Load(T& objToLoad)
+    {
+        LogPrintf("Reading info from %s...\n", strFilename);
+        uint256 hashFile;
+        ReadResult readResult = Read(objToLoad, hashFile);
+        if (readResult == Ok)
+            Clean(objToLoad);
+        return CheckReadResult(readResult);
+    }
+
     bool Dump(T& objToSave)
     {
         int64_t nStart = GetTimeMillis();
 
         LogPrintf("Verifying %s format...\n", strFilename);
-        T tmpObjToLoad;
-        ReadResult readResult = Read(tmpObjToLoad, true);
-
+        uint256 hashFile;
         // there was an error and it was not an error on file opening => do not proceed
-        if (readResult == FileError)
-            LogPrintf("Missing file %s, will try to recreate\n", strFilename);
-        else if (readResult != Ok)
-        {
-            LogPrintf("Error reading %s: ", strFilename);
-            if(readResult == IncorrectFormat)
-                LogPrintf("%s: Magic is ok but data has invalid format, will try to recreate\n", __func__);
-            else
-            {
-                LogPrintf("%s: File format is unknown or invalid, please fix it manually\n", __func__);
-                return false;
-            }
-        }
+        if (!CheckReadResult(VerifyFile(hashFile)))
+            return false;
 
         LogPrintf("Writing info to %s...\n", strFilename);
-        Write(objToSave);
+        Write(objToSave, hashFile);
         LogPrintf("%s dump finished  %dms\n", strFilename, GetTimeMillis() - nStart);
 
         return true;
@@ -225,5 +379,334 @@ public:
 
 };
 
+/**
+*   Dumping and Loading with a Delta Log
+*   ------------------------------------
+*
+*   For objects that track what changed since they were last loaded or dumped,
+*   dumps append those changes to a log next to the flat file, "<file>.log",
+*   instead of rewriting the whole file. The log starts with FLATDB_LOG_MARKER,
+*   the format version, the magic message, the network magic number and the
+*   checksum of the flat file it extends. Each record is the size of the
+*   changes, the changes and their hash. Records are appended in place and
+*   committed one by one; a record cut short by a crash fails its hash and is
+*   truncated away on the next load. Once the log outgrows the flat file, or
+*   the object cannot tell what changed, the next dump compacts both into a
+*   new flat file and starts an empty log for it.
+*
+*   T must provide CanSerializeDelta(), SerializeDelta(s), UnserializeDelta(s)
+*   and ClearDelta() on top of what CFlatDB requires.
+*/
+
+template<typename T>
+class CFlatDBLog : public CFlatDB<T>
+{
+private:
+    typedef typename CFlatDB<T>::ReadResult ReadResult;
+    typedef CFlatDB<T> Base;
+
+    boost::filesystem::path pathLog;
+
+    /** Size of a record before its changes: the size of the changes */
+    static const size_t RECORD_HEADER_SIZE = sizeof(uint64_t);
+
+    /** Start an empty log for the flat file with checksum hashDB */
+    bool WriteLogHeader(const uint256& hashDB)
+    {
+        boost::filesystem::path pathTmp = pathLog;
+        pathTmp += ".new";
+        FILE *file = fopen(pathTmp.string().c_str(), "wb");
+        CAutoFile fileout(file, SER_DISK, CLIENT_VERSION);
+        if (fileout.IsNull())
+            return error("%s: Failed to open file %s", __func__, pathTmp.string());
+
+        try {
+            fileout << FLATDATA(FLATDB_LOG_MARKER);
+            fileout << FLATDB_VERSION;
+            fileout << this->strMagicMessage;
+            fileout << FLATDATA(Params().MessageStart());
+            fileout << hashDB;
+        }
+        catch (std::exception &e) {
+            fileout.fclose();
+            boost::filesystem::remove(pathTmp);
+            return error("%s: Serialize or I/O error - %s", __func__, e.what());
+        }
+        FileCommit(fileout.Get());
+        fileout.fclose();
+
+        if (!RenameOver(pathTmp, pathLog))
+            return error("%s: Rename-into-place failed", __func__);
+        return true;
+    }
+
+    /** Check the log header, and return the checksum of the flat file it extends in hashRet */
+    bool ReadLogHeader(CAutoFile& filein, uint256& hashRet)
+    {
+        unsigned char pchMarker[4];
+        uint32_t nVersion = 0;
+        std::string strMagicMessageTmp;
+        unsigned char pchMsgTmp[4];
+        try {
+            filein >> FLATDATA(pchMarker);
+            if (memcmp(pchMarker, FLATDB_LOG_MARKER, sizeof(pchMarker)) != 0)
+                return error("%s: Invalid log marker", __func__);
+            filein >> nVersion;
+            if (nVersion > FLATDB_VERSION)
+                return error("%s: Unknown log format version %u", __func__, nVersion);
+            filein >> strMagicMessageTmp;
+            if (strMagicMessageTmp != this->strMagicMessage)
+                return error("%s: Invalid magic message", __func__);
+            filein >> FLATDATA(pchMsgTmp);
+            if (memcmp(pchMsgTmp, Params().MessageStart(), sizeof(pchMsgTmp)))
+                return error("%s: Invalid network magic number", __func__);
+            filein >> hashRet;
+        }
+        catch (std::exception &e) {
+            return error("%s: Deserialize or I/O error - %s", __func__, e.what());
+        }
+        return true;
+    }
+
+    /**
+     * Apply the records of the log that extends the flat file with checksum
+     * hashDB. Records are verified before any of them is applied, and the log
+     * is truncated after the last complete one. Returns false if a verified
+     * record could not be applied, in which case the object is cleared.
+     */
+    bool ReadLog(T& objToLoad, const uint256& hashDB)
+    {
+        FILE *file = fopen(pathLog.string().c_str(), "rb+");
+        CAutoFile filein(file, SER_DISK, CLIENT_VERSION);
+        if (filein.IsNull())
+            return true;
+
+        uint256 hashLog;
+        if (!ReadLogHeader(filein, hashLog) || hashLog != hashDB) {
+            LogPrintf("%s: Ignoring %s, it does not extend %s\n", __func__, pathLog.filename().string(), this->strFilename);
+            return true;
+        }
+
+        // find the complete records
+        const uint64_t nFileSize = boost::filesystem::file_size(pathLog);
+        std::vector<std::pair<long, uint64_t> > vRecords;
+        long nPos = ftell(filein.Get());
+        try {
+            while ((uint64_t)nPos + RECORD_HEADER_SIZE + sizeof(uint256) < nFileSize) {
+                uint64_t nSize;
+                filein >> nSize;
+                if (nSize == 0 || nSize > nFileSize - nPos - RECORD_HEADER_SIZE - sizeof(uint256))
+                    break;
+                CHashFileReader reader(&filein, nSize);
+                reader.ignore(nSize);
+                uint256 hashRecord;
+                filein >> hashRecord;
+                if (hashRecord != reader.GetHash())
+                    break;
+                vRecords.emplace_back(nPos + RECORD_HEADER_SIZE, nSize);
+                nPos += RECORD_HEADER_SIZE + nSize + sizeof(uint256);
+            }
+        }
+        catch (std::exception &e) {
+            error("%s: Deserialize or I/O error - %s", __func__, e.what());
+        }
+        if ((uint64_t)nPos != nFileSize) {
+            LogPrintf("%s: Truncating incomplete record at the end of %s\n", __func__, pathLog.filename().string());
+            if (!TruncateFile(filein.Get(), nPos))
+                error("%s: Failed to truncate %s", __func__, pathLog.string());
+        }
+
+        try {
+            for (const auto& record : vRecords) {
+                if (fseek(filein.Get(), record.first, SEEK_SET))
+                    throw std::ios_base::failure("CFlatDBLog::ReadLog(): seek failed");
+                CHashFileReader reader(&filein, record.second);
+                objToLoad.UnserializeDelta(reader);
+            }
+        }
+        catch (std::exception &e) {
+            objToLoad.Clear();
+            return error("%s: Deserialize or I/O error - %s", __func__, e.what());
+        }
+
+        LogPrintf("Applied %d records from %s\n", vRecords.size(), pathLog.filename().string());
+        return true;
+    }
+
+    /** Append the changes of the object to the log */
+    bool AppendLog(const T& objToSave)
+    {
+        FILE *file = fopen(pathLog.string().c_str(), "rb+");
+        CAutoFile fileout(file, SER_DISK, CLIENT_VERSION);
+        if (fileout.IsNull())
+            return error("%s: Failed to open file %s", __func__, pathLog.string());
+        if (fseek(fileout.Get(), 0, SEEK_END))
+            return error("%s: Failed to seek in %s", __func__, pathLog.string());
+        long nPos = ftell(fileout.Get());
+
+        // the size of the changes is only known once they are written, it is
+        // filled in after them, so a torn record never has a valid size and hash
+        try {
+            fileout << (uint64_t)0;
+            CHashFileWriter writer(&fileout);
+            objToSave.SerializeDelta(writer);
+            fileout << writer.GetHash();
+            FileCommit(fileout.Get());
+            if (fseek(fileout.Get(), nPos, SEEK_SET))
+                throw std::ios_base::failure("CFlatDBLog::AppendLog(): seek failed");
+            fileout << (uint64_t)writer.size();
+        }
+        catch (std::exception &e) {
+            TruncateFile(fileout.Get(), nPos);
+            return error("%s: Serialize or I/O error - %s", __func__, e.what());
+        }
+        FileCommit(fileout.Get());
+        return true;
+    }
+
+public:
+    CFlatDBLog(std::string strFilenameIn, std::string strMagicMessageIn) : CFlatDB<T>(strFilenameIn, strMagicMessageIn)
+    {
+        pathLog = this->pathDB;
+        pathLog += ".log";
+    }
+
+    bool Load(T& objToLoad)
+    {
+        LogPrintf("Reading info from %s...\n", this->strFilename);
+        uint256 hashDB;
+        ReadResult readResult = this->Read(objToLoad, hashDB);
+        if (readResult == Base::Ok) {
+            if (ReadLog(objToLoad, hashDB)) {
+                // the object now matches what is on disk
+                objToLoad.ClearDelta();
+            } else {
+                readResult = Base::IncorrectFormat;
+            }
+            this->Clean(objToLoad);
+        }
+        return this->CheckReadResult(readResult);
+    }
+
+    bool Dump(T& objToSave)
+    {
+        int64_t nStart = GetTimeMillis();
+
+        LogPrintf("Verifying %s format...\n", this->strFilename);
+        uint256 hashDB;
+        ReadResult readResult = this->VerifyFile(hashDB);
+        if (!this->CheckReadResult(readResult))
+            return false;
+
+        bool fAppend = false;
+        if (readResult == Base::Ok && objToSave.CanSerializeDelta()) {
+            FILE *file = fopen(pathLog.string().c_str(), "rb");
+            CAutoFile filein(file, SER_DISK, CLIENT_VERSION);
+            uint256 hashLog;
+            fAppend = !filein.IsNull() && ReadLogHeader(filein, hashLog) && hashLog == hashDB &&
+                      boost::filesystem::file_size(pathLog) < boost::filesystem::file_size(this->pathDB);
+        }
+
+        if (fAppend && AppendLog(objToSave)) {
+            LogPrintf("Appended changes to %s\n", pathLog.filename().string());
+        } else {
+            // compact, the log only becomes valid once the new flat file is in place
+            LogPrintf("Writing info to %s...\n", this->strFilename);
+            if (!this->Write(objToSave, hashDB) || !WriteLogHeader(hashDB))
+                return false;
+        }
+        objToSave.ClearDelta();
+        LogPrintf("%s dump finished  %dms\n", this->strFilename, GetTimeMillis() - nStart);
+
+        return true;
+    }
+
+};
+
+/**
+ * Changes of a std::map since it was last persisted, for the delta of objects
+ * dumped with CFlatDBLog. Like CMasternodeRegistry, ClearChanged() records the
+ * hash of every value and changes are found by comparing hashes, so the map
+ * can be modified anywhere without telling the tracker.
+ */
+template<typename K, typename V>
+class CFlatDBMapChanges
+{
+private:
+    //! Hash of every value when it was last persisted
+    std::map<K, uint256> mapPersisted;
+    //! Whether what was persisted is unknown, until ClearChanged() is first called and after SetAllChanged()
+    bool fAllChanged;
+
+    static uint256 GetPersistedHash(const V& value)
+    {
+        CDataStream ss(SER_DISK, CLIENT_VERSION);
+        ss << value;
+        return Hash(ss.begin(), ss.end());
+    }
+
+public:
+    CFlatDBMapChanges() : fAllChanged(true) {}
+
+    /** Serialize the changes of mapIn since the last ClearChanged(): the erased keys, then the changed entries. */
+    template<typename Stream>
+    void SerializeChanged(Stream& s, const std::map<K, V>& mapIn) const
+    {
+        assert(!fAllChanged);
+        std::vector<K> vecErased;
+        for (const auto& item : mapPersisted) {
+            if (!mapIn.count(item.first))
+                vecErased.push_back(item.first);
+        }
+        std::vector<const std::pair<const K, V>*> vecChanged;
+        for (const auto& item : mapIn) {
+            auto it = mapPersisted.find(item.first);
+            if (it == mapPersisted.end() || it->second != GetPersistedHash(item.second))
+                vecChanged.push_back(&item);
+        }
+        s << vecErased;
+        WriteCompactSize(s, vecChanged.size());
+        for (const auto* pitem : vecChanged) {
+            s << pitem->first << pitem->second;
+        }
+    }
+
+    /** Apply the changes written by SerializeChanged to mapInOut. */
+    template<typename Stream>
+    static void UnserializeChanged(Stream& s, std::map<K, V>& mapInOut)
+    {
+        std::vector<K> vecErased;
+        s >> vecErased;
+        for (const K& key : vecErased) {
+            mapInOut.erase(key);
+        }
+        uint64_t nSize = ReadCompactSize(s);
+        for (uint64_t i = 0; i < nSize; i++) {
+            K key;
+            V value;
+            s >> key >> value;
+            mapInOut[key] = value;
+        }
+    }
+
+    /** Whether SerializeChanged can tell what changed since the last ClearChanged(). */
+    bool HasChangedEntries() const { return !fAllChanged; }
+    /** Record the current entries of mapIn as persisted. */
+    void ClearChanged(const std::map<K, V>& mapIn)
+    {
+        mapPersisted.clear();
+        for (const auto& item : mapIn) {
+            mapPersisted.emplace_hint(mapPersisted.end(), item.first, GetPersistedHash(item.second));
+        }
+        fAllChanged = false;
+    }
+    /** Forget what was persisted, the next dump rewrites the flat file. */
+    void SetAllChanged()
+    {
+        mapPersisted.clear();
+        fAllChanged = true;
+    }
+};
+
 
 #endif
@@ -18,6 +18,7 @@
 #include <globaltoken/multihasher.h>
 #include <globaltoken/powalgorithm.h>
 #include <crypto/algos/hashlib/multihash.h>
+#include <crypto/algos/hashlib/multihash_lanes.h>
 #include <crypto/algos/neoscrypt/neoscrypt.h>
 #include <crypto/algos/scrypt/scrypt.h>
 #include <crypto/algos/yescrypt/yescrypt.h>
@@ -28,333 +29,551 @@
 #include <crypto/algos/yespower/yespower.h>
 #include <crypto/algos/honeycomb/hash_honeycomb.h>
 #include <crypto/algos/allium/allium.h>
+#include <primitives/pureheader.h>
 #include <uint256.h>
 #include <hash.h>
 #include <version.h>
 
+#include <algorithm>
 
-uint256 CMultihasher::GetSHA256Hash() const
-{
-    CHashWriter ss(nType, nVersion);
-    for(size_t i = 0; i < buf.size(); i++)
-        ss << buf[i];
-    return ss.GetHash();
-}
 
-uint256 CMultihasher::GetHash() const 
+namespace {
+
+typedef uint256 (*MultihashFunction)(const unsigned char* pbegin, const unsigned char* pend, int nVersion);
+
+/**
+ * Hash functions of the algos, indexed by algo ID. The algos without an entry
+ * (SHA256d and the equihash based algos) are hashed with double SHA256. Input
+ * size requirements are checked against the algo registry before the call.
+ */
+class CMultihashTable
 {
-    switch (nAlgo)
+private:
+    MultihashFunction functions[NUM_ALGOS_IMPL];
+
+public:
+    CMultihashTable()
     {
-        case ALGO_SHA256D:
-        {
-            return this->GetSHA256Hash();
-        }
-        case ALGO_SCRYPT:
+        for (MultihashFunction& function : functions)
+            function = nullptr;
+        functions[ALGO_SCRYPT] = [](const unsigned char* pbegin, const unsigned char* pend, int nVersion) -> uint256
         {
             uint256 thash;
-            assert(buf.size() == 80);
-            scrypt_1024_1_1_256((const char*)buf.data(), (char*)&thash);
+            scrypt_1024_1_1_256((const char*)pbegin, (char*)&thash);
             return thash;
-        }
-        case ALGO_X11:
+        };
+        functions[ALGO_X11] = [](const unsigned char* pbegin, const unsigned char* pend, int nVersion) -> uint256
         {
-            return HashX11(buf.data(), buf.data() + buf.size());
-        }
-        case ALGO_NEOSCRYPT:
+            return HashX11(pbegin, pend);
+        };
+        functions[ALGO_NEOSCRYPT] = [](const unsigned char* pbegin, const unsigned char* pend, int nVersion) -> uint256
         {
             unsigned int profile = 0x0;
             uint256 thash;
-            assert(buf.size() == 80);
-            neoscrypt(buf.data(), (unsigned char *)&thash, profile);				
+            neoscrypt(pbegin, (unsigned char *)&thash, profile);
             return thash;
-        }
-        case ALGO_EQUIHASH:
-        {
-            return this->GetSHA256Hash();
-        }
-        case ALGO_YESCRYPT:
+        };
+        functions[ALGO_YESCRYPT] = [](const unsigned char* pbegin, const unsigned char* pend, int nVersion) -> uint256
         {
             uint256 thash;
-            assert(buf.size() == 80);
-            yescrypt_hash((const char*)buf.data(), (char*)&thash);
+            yescrypt_hash((const char*)pbegin, (char*)&thash);
             return thash;
-        }
-        case ALGO_HMQ1725:
+        };
+        functions[ALGO_HMQ1725] = [](const unsigned char* pbegin, const unsigned char* pend, int nVersion) -> uint256
         {
-            return HMQ1725(buf.data(), buf.data() + buf.size());
-        }
-        case ALGO_XEVAN:
+            return HMQ1725(pbegin, pend);
+        };
+        functions[ALGO_XEVAN] = [](const unsigned char* pbegin, const unsigned char* pend, int nVersion) -> uint256
         {
-            return XEVAN(buf.data(), buf.data() + buf.size());	    
-        }
-        case ALGO_NIST5:
+            return XEVAN(pbegin, pend);
+        };
+        functions[ALGO_NIST5] = [](const unsigned char* pbegin, const unsigned char* pend, int nVersion) -> uint256
         {
-            return NIST5(buf.data(), buf.data() + buf.size());	    
-        }
-        case ALGO_TIMETRAVEL10:
+            return NIST5(pbegin, pend);
+        };
+        functions[ALGO_TIMETRAVEL10] = [](const unsigned char* pbegin, const unsigned char* pend, int nVersion) -> uint256
         {
-            assert(buf.size() == 80);
             uint32_t nTime;
-            memcpy(&nTime, buf.data() + 68, 4);
-            return HashTimeTravel(buf.data(), buf.data() + buf.size(), nTime);	    
-        }
-        case ALGO_PAWELHASH:
+            memcpy(&nTime, pbegin + 68, 4);
+            return HashTimeTravel(pbegin, pend, nTime);
+        };
+        functions[ALGO_PAWELHASH] = [](const unsigned char* pbegin, const unsigned char* pend, int nVersion) -> uint256
         {
-            return PawelHash(buf.data(), buf.data() + buf.size());
-        }
-        case ALGO_X13:
+            return PawelHash(pbegin, pend);
+        };
+        functions[ALGO_X13] = [](const unsigned char* pbegin, const unsigned char* pend, int nVersion) -> uint256
         {
-            return HashX13(buf.data(), buf.data() + buf.size());
-        }
-        case ALGO_X14:
+            return HashX13(pbegin, pend);
+        };
+        functions[ALGO_X14] = [](const unsigned char* pbegin, const unsigned char* pend, int nVersion) -> uint256
         {
-            return HashX14(buf.data(), buf.data() + buf.size());
-        }
-        case ALGO_X15:
+            return HashX14(pbegin, pend);
+        };
+        functions[ALGO_X15] = [](const unsigned char* pbegin, const unsigned char* pend, int nVersion) -> uint256
         {
-            return HashX15(buf.data(), buf.data() + buf.size());
-        }
-        case ALGO_X17:
+            return HashX15(pbegin, pend);
+        };
+        functions[ALGO_X17] = [](const unsigned char* pbegin, const unsigned char* pend, int nVersion) -> uint256
         {
-            return HashX17(buf.data(), buf.data() + buf.size());
-        }
-        case ALGO_LYRA2REV2:
+            return HashX17(pbegin, pend);
+        };
+        functions[ALGO_LYRA2REV2] = [](const unsigned char* pbegin, const unsigned char* pend, int nVersion) -> uint256
         {
-            assert(buf.size() == 80);
             uint256 thash;
-            lyra2re2_hash((const char*)buf.data(), (char*)&thash);
+            lyra2re2_hash((const char*)pbegin, (char*)&thash);
             return thash;
-        }
-        case ALGO_BLAKE2S:
+        };
+        functions[ALGO_BLAKE2S] = [](const unsigned char* pbegin, const unsigned char* pend, int nVersion) -> uint256
         {
-            return HashBlake2S(buf.data(), buf.data() + buf.size());
-        }
-        case ALGO_BLAKE2B:
+            return HashBlake2S(pbegin, pend);
+        };
+        functions[ALGO_BLAKE2B] = [](const unsigned char* pbegin, const unsigned char* pend, int nVersion) -> uint256
         {
-            return HashBlake2B(buf.data(), buf.data() + buf.size());
-        }
-        case ALGO_ASTRALHASH:
+            return HashBlake2B(pbegin, pend);
+        };
+        functions[ALGO_ASTRALHASH] = [](const unsigned char* pbegin, const unsigned char* pend, int nVersion) -> uint256
         {
-            return AstralHash(buf.data(), buf.data() + buf.size());
-        }
-        case ALGO_PADIHASH:
+            return AstralHash(pbegin, pend);
+        };
+        functions[ALGO_PADIHASH] = [](const unsigned char* pbegin, const unsigned char* pend, int nVersion) -> uint256
         {
-            return PadiHash(buf.data(), buf.data() + buf.size());
-        }
-        case ALGO_JEONGHASH:
+            return PadiHash(pbegin, pend);
+        };
+        functions[ALGO_JEONGHASH] = [](const unsigned char* pbegin, const unsigned char* pend, int nVersion) -> uint256
         {
-            return JeongHash(buf.data(), buf.data() + buf.size());
-        }
-        case ALGO_KECCAKC:
+            return JeongHash(pbegin, pend);
+        };
+        functions[ALGO_KECCAKC] = [](const unsigned char* pbegin, const unsigned char* pend, int nVersion) -> uint256
         {
-            return HashKeccakC(buf.data(), buf.data() + buf.size());
-        }
-        case ALGO_ZHASH:
+            return HashKeccakC(pbegin, pend);
+        };
+        functions[ALGO_GLOBALHASH] = [](const unsigned char* pbegin, const unsigned char* pend, int nVersion) -> uint256
         {
-            return this->GetSHA256Hash();
-        }
-        case ALGO_GLOBALHASH:
+            return GlobalHash(pbegin, pend);
+        };
+        functions[ALGO_GROESTL] = [](const unsigned char* pbegin, const unsigned char* pend, int nVersion) -> uint256
         {
-            return GlobalHash(buf.data(), buf.data() + buf.size());
-        }
-        case ALGO_GROESTL:
+            return HashGroestl(pbegin, pend);
+        };
+        functions[ALGO_SKEIN] = [](const unsigned char* pbegin, const unsigned char* pend, int nVersion) -> uint256
         {
-            return HashGroestl(buf.data(), buf.data() + buf.size());
-        }
-        case ALGO_SKEIN:
+            return HashSkein(pbegin, pend);
+        };
+        functions[ALGO_QUBIT] = [](const unsigned char* pbegin, const unsigned char* pend, int nVersion) -> uint256
         {
-            return HashSkein(buf.data(), buf.data() + buf.size());
-        }
-        case ALGO_QUBIT:
+            return HashQubit(pbegin, pend);
+        };
+        functions[ALGO_SKUNKHASH] = [](const unsigned char* pbegin, const unsigned char* pend, int nVersion) -> uint256
         {
-            return HashQubit(buf.data(), buf.data() + buf.size());
-        }
-        case ALGO_SKUNKHASH:
+            return SkunkHash5(pbegin, pend);
+        };
+        functions[ALGO_QUARK] = [](const unsigned char* pbegin, const unsigned char* pend, int nVersion) -> uint256
         {
-            return SkunkHash5(buf.data(), buf.data() + buf.size());
-        }
-        case ALGO_QUARK:
+            return QUARK(pbegin, pend);
+        };
+        functions[ALGO_X16R] = [](const unsigned char* pbegin, const unsigned char* pend, int nVersion) -> uint256
         {
-            return QUARK(buf.data(), buf.data() + buf.size());
-        }
-        case ALGO_X16R:
-        {
-            assert(buf.size() == 80);
             uint256 hashPrevBlock;
-            memcpy(&hashPrevBlock, buf.data() + 4, 32);
-            return HashX16R(buf.data(), buf.data() + buf.size(), hashPrevBlock);
-        }
-        case ALGO_LYRA2REV3:
+            memcpy(&hashPrevBlock, pbegin + 4, 32);
+            return HashX16R(pbegin, pend, hashPrevBlock);
+        };
+        functions[ALGO_LYRA2REV3] = [](const unsigned char* pbegin, const unsigned char* pend, int nVersion) -> uint256
         {
-            assert(buf.size() == 80);
             uint256 thash;
-            lyra2re3_hash((const char*)buf.data(), (char*)&thash);
+            lyra2re3_hash((const char*)pbegin, (char*)&thash);
             return thash;
-        }
-        case ALGO_YESCRYPT_R16V2:
+        };
+        functions[ALGO_YESCRYPT_R16V2] = [](const unsigned char* pbegin, const unsigned char* pend, int nVersion) -> uint256
         {
-            assert(buf.size() == 80);
             uint256 thash;
-            yescrypt_r16v2_hash((const char*)buf.data(), (char*)&thash);
+            yescrypt_r16v2_hash((const char*)pbegin, (char*)&thash);
             return thash;
-        }
-        case ALGO_YESCRYPT_R24:
+        };
+        functions[ALGO_YESCRYPT_R24] = [](const unsigned char* pbegin, const unsigned char* pend, int nVersion) -> uint256
         {
-            assert(buf.size() == 80);
             uint256 thash;
-            yescrypt_r24_hash((const char*)buf.data(), (char*)&thash);
+            yescrypt_r24_hash((const char*)pbegin, (char*)&thash);
             return thash;
-        }
-        case ALGO_YESCRYPT_R8:
+        };
+        functions[ALGO_YESCRYPT_R8] = [](const unsigned char* pbegin, const unsigned char* pend, int nVersion) -> uint256
         {
-            assert(buf.size() == 80);
             uint256 thash;
-            if(this->nVersion & MULTIHASHER_YESCRYPT_R8_NEW)
-                yescrypt_r8_hash((const char*)buf.data(), (char*)&thash);
+            if(nVersion & MULTIHASHER_YESCRYPT_R8_NEW)
+                yescrypt_r8_hash((const char*)pbegin, (char*)&thash);
             else
-                yescrypt_hash((const char*)buf.data(), (char*)&thash);
+                yescrypt_hash((const char*)pbegin, (char*)&thash);
             return thash;
-        }
-        case ALGO_YESCRYPT_R32:
+        };
+        functions[ALGO_YESCRYPT_R32] = [](const unsigned char* pbegin, const unsigned char* pend, int nVersion) -> uint256
         {
-            assert(buf.size() == 80);
             uint256 thash;
-            yescrypt_r32_hash((const char*)buf.data(), (char*)&thash);
+            yescrypt_r32_hash((const char*)pbegin, (char*)&thash);
             return thash;
-        }
-        case ALGO_X25X:
+        };
+        functions[ALGO_X25X] = [](const unsigned char* pbegin, const unsigned char* pend, int nVersion) -> uint256
         {
-            return HashX25X(buf.data(), buf.data() + buf.size());
-        }
-        case ALGO_ARGON2D:
+            return HashX25X(pbegin, pend);
+        };
+        functions[ALGO_ARGON2D] = [](const unsigned char* pbegin, const unsigned char* pend, int nVersion) -> uint256
         {
             uint256 salt, pepper, finalhash;
-            salt = GlobalHash(buf.data(), buf.data() + buf.size());
-            pepper = HashX16R(buf.data(), buf.data() + buf.size(), salt);
-            Argon2dHash(buf.data(), buf.size(), finalhash.begin(), 32, salt.begin(), 32, pepper.begin(), 32);
+            salt = GlobalHash(pbegin, pend);
+            pepper = HashX16R(pbegin, pend, salt);
+            Argon2dHash(pbegin, pend - pbegin, finalhash.begin(), 32, salt.begin(), 32, pepper.begin(), 32);
             return finalhash;
-        }
-        case ALGO_ARGON2I:
+        };
+        functions[ALGO_ARGON2I] = [](const unsigned char* pbegin, const unsigned char* pend, int nVersion) -> uint256
         {
             uint256 salt, pepper, finalhash;
-            salt = GlobalHash(buf.data(), buf.data() + buf.size());
-            pepper = HashCPU23R(buf.data(), buf.data() + buf.size(), salt);
-            Argon2iHash(buf.data(), buf.size(), finalhash.begin(), 32, salt.begin(), 32, pepper.begin(), 32);
+            salt = GlobalHash(pbegin, pend);
+            pepper = HashCPU23R(pbegin, pend, salt);
+            Argon2iHash(pbegin, pend - pbegin, finalhash.begin(), 32, salt.begin(), 32, pepper.begin(), 32);
             return finalhash;
-        }
-        case ALGO_CPU23R:
+        };
+        functions[ALGO_CPU23R] = [](const unsigned char* pbegin, const unsigned char* pend, int nVersion) -> uint256
         {
-            assert(buf.size() == 80);
             uint256 hashPrevBlock;
-            memcpy(&hashPrevBlock, buf.data() + 4, 32);
-            return HashCPU23R(buf.data(), buf.data() + buf.size(), hashPrevBlock);
-        }
-        case ALGO_YESPOWER:
+            memcpy(&hashPrevBlock, pbegin + 4, 32);
+            return HashCPU23R(pbegin, pend, hashPrevBlock);
+        };
+        functions[ALGO_YESPOWER] = [](const unsigned char* pbegin, const unsigned char* pend, int nVersion) -> uint256
         {
-            assert(buf.size() == 80);
             uint256 thash;
-            yespower_hash((const char*)buf.data(), (char*)&thash);
+            yespower_hash((const char*)pbegin, (char*)&thash);
             return thash;
-        }
-        case ALGO_X21S:
+        };
+        functions[ALGO_X21S] = [](const unsigned char* pbegin, const unsigned char* pend, int nVersion) -> uint256
         {
-            assert(buf.size() == 80);
             uint256 hashPrevBlock;
-            memcpy(&hashPrevBlock, buf.data() + 4, 32);
-            return HashX21S(buf.data(), buf.data() + buf.size(), hashPrevBlock);
-        }
-        case ALGO_X16S:
+            memcpy(&hashPrevBlock, pbegin + 4, 32);
+            return HashX21S(pbegin, pend, hashPrevBlock);
+        };
+        functions[ALGO_X16S] = [](const unsigned char* pbegin, const unsigned char* pend, int nVersion) -> uint256
         {
-            assert(buf.size() == 80);
             uint256 hashPrevBlock;
-            memcpy(&hashPrevBlock, buf.data() + 4, 32);
-            return HashX16s(buf.data(), buf.data() + buf.size(), hashPrevBlock);
-        }
-        case ALGO_X22I:
+            memcpy(&hashPrevBlock, pbegin + 4, 32);
+            return HashX16s(pbegin, pend, hashPrevBlock);
+        };
+        functions[ALGO_X22I] = [](const unsigned char* pbegin, const unsigned char* pend, int nVersion) -> uint256
         {
-            return HashX22I(buf.data(), buf.data() + buf.size());
-        }
-        case ALGO_LYRA2Z:
+            return HashX22I(pbegin, pend);
+        };
+        functions[ALGO_LYRA2Z] = [](const unsigned char* pbegin, const unsigned char* pend, int nVersion) -> uint256
         {
-            assert(buf.size() == 80);
             uint256 thash;
-            lyra2z_hash((const char*)buf.data(), (char*)&thash);
+            lyra2z_hash((const char*)pbegin, (char*)&thash);
             return thash;
-        }
-        case ALGO_HONEYCOMB:
+        };
+        functions[ALGO_HONEYCOMB] = [](const unsigned char* pbegin, const unsigned char* pend, int nVersion) -> uint256
         {
-            return HashHoneyComb(buf.data(), buf.data() + buf.size());
-        }
-        case ALGO_EH192:
+            return HashHoneyComb(pbegin, pend);
+        };
+        functions[ALGO_X12] = [](const unsigned char* pbegin, const unsigned char* pend, int nVersion) -> uint256
         {
-            return this->GetSHA256Hash();
-        }
-        case ALGO_MARS:
+            return HashX12(pbegin, pend);
+        };
+        functions[ALGO_HEX] = [](const unsigned char* pbegin, const unsigned char* pend, int nVersion) -> uint256
         {
-            return this->GetSHA256Hash();
-        }
-        case ALGO_X12:
+            return HashHEX(pbegin, pend);
+        };
+        functions[ALGO_DEDAL] = [](const unsigned char* pbegin, const unsigned char* pend, int nVersion) -> uint256
         {
-            return HashX12(buf.data(), buf.data() + buf.size());
-        }
-        case ALGO_HEX:
+            return HashDedal(pbegin, pend);
+        };
+        functions[ALGO_C11] = [](const unsigned char* pbegin, const unsigned char* pend, int nVersion) -> uint256
         {
-            return HashHEX(buf.data(), buf.data() + buf.size());
-        }
-        case ALGO_DEDAL:
+            return HashC11(pbegin, pend);
+        };
+        functions[ALGO_PHI1612] = [](const unsigned char* pbegin, const unsigned char* pend, int nVersion) -> uint256
         {
-            return HashDedal(buf.data(), buf.data() + buf.size());
-        }
-        case ALGO_C11:
+            return Phi1612(pbegin, pend);
+        };
+        functions[ALGO_PHI2] = [](const unsigned char* pbegin, const unsigned char* pend, int nVersion) -> uint256
         {
-            return HashC11(buf.data(), buf.data() + buf.size());
-        }
-        case ALGO_PHI1612:
-        {
-            return Phi1612(buf.data(), buf.data() + buf.size());
-        }
-        case ALGO_PHI2:
-        {
-            return PHI2(buf.data(), buf.data() + buf.size());
-        }
-        case ALGO_X16RT:
+            return PHI2(pbegin, pend);
+        };
+        functions[ALGO_X16RT] = [](const unsigned char* pbegin, const unsigned char* pend, int nVersion) -> uint256
         {
-            assert(buf.size() == 80);
             uint32_t nTime;
-            memcpy(&nTime, buf.data() + 68, 4);
+            memcpy(&nTime, pbegin + 68, 4);
             int32_t nTimeX16r = nTime & 0xffffff80;
             uint256 hashTime = Hash(static_cast<char*>(static_cast<void*>(&nTimeX16r)), static_cast<char*>(static_cast<void*>(&nTimeX16r))+4);
-            return HashX16R(buf.data(), buf.data() + buf.size(), hashTime);
-        }
-        case ALGO_TRIBUS:
+            return HashX16R(pbegin, pend, hashTime);
+        };
+        functions[ALGO_TRIBUS] = [](const unsigned char* pbegin, const unsigned char* pend, int nVersion) -> uint256
         {
-            return Tribus(buf.data(), buf.data() + buf.size());
-        }
-        case ALGO_ALLIUM:
+            return Tribus(pbegin, pend);
+        };
+        functions[ALGO_ALLIUM] = [](const unsigned char* pbegin, const unsigned char* pend, int nVersion) -> uint256
         {
-            assert(buf.size() == 80);
             uint256 thash;
-            allium_hash((const char*)buf.data(), (char*)&thash);
+            allium_hash((const char*)pbegin, (char*)&thash);
             return thash;
-        }
-        case ALGO_ARCTICHASH:
+        };
+        functions[ALGO_ARCTICHASH] = [](const unsigned char* pbegin, const unsigned char* pend, int nVersion) -> uint256
         {
-            return ArcticHash(buf.data(), buf.data() + buf.size());
-        }
-        case ALGO_DESERTHASH:
+            return ArcticHash(pbegin, pend);
+        };
+        functions[ALGO_DESERTHASH] = [](const unsigned char* pbegin, const unsigned char* pend, int nVersion) -> uint256
         {
-            return DesertHash(buf.data(), buf.data() + buf.size());
-        }
-        case ALGO_CRYPTOANDCOFFEE:
+            return DesertHash(pbegin, pend);
+        };
+        functions[ALGO_CRYPTOANDCOFFEE] = [](const unsigned char* pbegin, const unsigned char* pend, int nVersion) -> uint256
         {
-            return cryptoandcoffee_hash(buf.data(), buf.data() + buf.size());
-        }
-        case ALGO_RICKHASH:
+            return cryptoandcoffee_hash(pbegin, pend);
+        };
+        functions[ALGO_RICKHASH] = [](const unsigned char* pbegin, const unsigned char* pend, int nVersion) -> uint256
         {
-            return RickHash(buf.data(), buf.data() + buf.size());
+            return RickHash(pbegin, pend);
+        };
+    }
+
+    MultihashFunction Get(uint8_t nAlgo) const
+    {
+        return nAlgo < NUM_ALGOS_IMPL ? functions[nAlgo] : nullptr;
+    }
+};
+
+const CMultihashTable& GetMultihashTable()
+{
+    static const CMultihashTable table;
+    return table;
+}
+
+/** One function of a hash chain. */
+struct ChainStage
+{
+    //! Function applied if bit 3 of the previous hash is set
+    Hash512Function fnSet;
+    //! Function applied otherwise, same as fnSet for the fixed stages
+    Hash512Function fnClear;
+};
+
+/**
+ * The algos that chain 512-bit hash functions over an 80 byte header, by algo
+ * ID, so MultiAlgoHashBatch can run each stage for several headers at once.
+ * The stages have to match the functions in multihash.h.
+ */
+class CHashChainTable
+{
+private:
+    std::vector<ChainStage> chains[NUM_ALGOS_IMPL];
+
+    static std::vector<ChainStage> Fixed(std::initializer_list<Hash512Function> functions)
+    {
+        std::vector<ChainStage> stages;
+        for (Hash512Function fn : functions)
+            stages.push_back(ChainStage{fn, fn});
+        return stages;
+    }
+
+public:
+    CHashChainTable()
+    {
+        chains[ALGO_X11] = Fixed({HASH512_BLAKE, HASH512_BMW, HASH512_GROESTL, HASH512_SKEIN, HASH512_JH, HASH512_KECCAK,
+                                  HASH512_LUFFA, HASH512_CUBEHASH, HASH512_SHAVITE, HASH512_SIMD, HASH512_ECHO});
+        chains[ALGO_X13] = chains[ALGO_X11];
+        chains[ALGO_X13].push_back(ChainStage{HASH512_HAMSI, HASH512_HAMSI});
+        chains[ALGO_X13].push_back(ChainStage{HASH512_FUGUE, HASH512_FUGUE});
+        chains[ALGO_X14] = chains[ALGO_X13];
+        chains[ALGO_X14].push_back(ChainStage{HASH512_SHABAL, HASH512_SHABAL});
+        chains[ALGO_X15] = chains[ALGO_X14];
+        chains[ALGO_X15].push_back(ChainStage{HASH512_WHIRLPOOL, HASH512_WHIRLPOOL});
+        chains[ALGO_X17] = chains[ALGO_X15];
+        chains[ALGO_X17].push_back(ChainStage{HASH512_SHA512, HASH512_SHA512});
+        chains[ALGO_X17].push_back(ChainStage{HASH512_HAVAL256_5, HASH512_HAVAL256_5});
+        chains[ALGO_NIST5] = Fixed({HASH512_BLAKE, HASH512_GROESTL, HASH512_JH, HASH512_KECCAK, HASH512_SKEIN});
+        chains[ALGO_QUBIT] = Fixed({HASH512_LUFFA, HASH512_CUBEHASH, HASH512_SHAVITE, HASH512_SIMD, HASH512_ECHO});
+        chains[ALGO_QUARK] = {
+            {HASH512_BLAKE, HASH512_BLAKE}, {HASH512_BMW, HASH512_BMW}, {HASH512_GROESTL, HASH512_SKEIN},
+            {HASH512_GROESTL, HASH512_GROESTL}, {HASH512_JH, HASH512_JH}, {HASH512_BLAKE, HASH512_BMW},
+            {HASH512_KECCAK, HASH512_KECCAK}, {HASH512_SKEIN, HASH512_SKEIN}, {HASH512_KECCAK, HASH512_JH},
+        };
+    }
+
+    /** The stages of an algo, empty if it is not a hash chain. X16R is handled separately. */
+    const std::vector<ChainStage>& Get(uint8_t nAlgo) const
+    {
+        assert(nAlgo < NUM_ALGOS_IMPL);
+        return chains[nAlgo];
+    }
+};
+
+const CHashChainTable& GetHashChainTable()
+{
+    static const CHashChainTable table;
+    return table;
+}
+
+/** Number of headers hashed side by side, a multiple of every kernel width. */
+static const size_t HASH_BATCH_LANES = 16;
+
+/** A writer stream that serializes a non-equihash header into an 80 byte lane. */
+class CHeaderLaneWriter
+{
+private:
+    unsigned char* const pbegin;
+    size_t nSize;
+    const int nVersion;
+
+public:
+    CHeaderLaneWriter(unsigned char* pbeginIn, int nVersionIn) : pbegin(pbeginIn), nSize(0), nVersion(nVersionIn) {}
+
+    int GetType() const { return SER_GETHASH; }
+    int GetVersion() const { return nVersion; }
+    size_t size() const { return nSize; }
+
+    void write(const char *pch, size_t size)
+    {
+        assert(nSize + size <= MULTIHASH_HEADER_SIZE);
+        memcpy(pbegin + nSize, pch, size);
+        nSize += size;
+    }
+
+    template<typename T>
+    CHeaderLaneWriter& operator<<(const T& obj)
+    {
+        ::Serialize(*this, obj);
+        return (*this);
+    }
+};
+
+/** Run a hash chain for up to HASH_BATCH_LANES serialized headers. */
+void HashChainLanes(uint8_t nAlgo, const unsigned char (*input)[MULTIHASH_HEADER_SIZE], size_t nLanes, uint256* out)
+{
+    const std::vector<ChainStage>& stages = GetHashChainTable().Get(nAlgo);
+    const size_t nStages = nAlgo == ALGO_X16R ? 16 : stages.size();
+    unsigned char state[HASH_BATCH_LANES][64];
+    uint256 hashPrevBlock[HASH_BATCH_LANES];
+    if (nAlgo == ALGO_X16R) {
+        for (size_t l = 0; l < nLanes; l++)
+            memcpy(hashPrevBlock[l].begin(), input[l] + 4, 32);
+    }
+
+    for (size_t i = 0; i < nStages; i++) {
+        // Group the lanes by the function of this stage.
+        const unsigned char* in[HASH512_NUM][HASH_BATCH_LANES];
+        unsigned char* outLanes[HASH512_NUM][HASH_BATCH_LANES];
+        size_t count[HASH512_NUM] = {};
+        for (size_t l = 0; l < nLanes; l++) {
+            Hash512Function fn;
+            if (nAlgo == ALGO_X16R)
+                fn = (Hash512Function)GetHashSelectionX16R(hashPrevBlock[l], i);
+            else
+                fn = (i == 0 || (state[l][0] & 8) != 0) ? stages[i].fnSet : stages[i].fnClear;
+            in[fn][count[fn]] = i == 0 ? input[l] : state[l];
+            outLanes[fn][count[fn]++] = state[l];
+        }
+        for (int fn = 0; fn < HASH512_NUM; fn++) {
+            if (count[fn] != 0)
+                Hash512Lanes((Hash512Function)fn, in[fn], i == 0 ? MULTIHASH_HEADER_SIZE : 64, outLanes[fn], count[fn]);
         }
     }
-    return this->GetSHA256Hash();
+
+    for (size_t l = 0; l < nLanes; l++)
+        memcpy(out[l].begin(), state[l], 32);
+}
+
+bool IsHashChainAlgo(uint8_t nAlgo)
+{
+    return nAlgo < NUM_ALGOS_IMPL && (nAlgo == ALGO_X16R || !GetHashChainTable().Get(nAlgo).empty());
+}
+
+} // namespace
+
+CMultihasher::CMultihasher(int nTypeIn, int nVersionIn, uint8_t nAlgoIn) : nSize(0), nType(nTypeIn), nVersion(nVersionIn), nAlgo(nAlgoIn), fSHA256(GetMultihashTable().Get(nAlgoIn) == nullptr)
+{
+}
+
+void CMultihasher::WriteSpill(const char *pch, size_t size)
+{
+    if (fSHA256) {
+        // Hash the buffered header in one call, then the rest straight from the caller's memory.
+        hasher.Write(buf, nSize);
+        nSize = 0;
+        if (size <= INLINE_SIZE) {
+            memcpy(buf, pch, size);
+            nSize = size;
+        } else {
+            hasher.Write((const unsigned char*)pch, size);
+        }
+        return;
+    }
+    if (vSpill.empty())
+        vSpill.assign(buf, buf + nSize);
+    vSpill.insert(vSpill.end(), pch, pch + size);
+    // Keep later writes out of buf, they have to follow the spilled input.
+    nSize = INLINE_SIZE;
+}
+
+uint256 CMultihasher::GetSHA256Hash()
+{
+    uint256 result;
+    hasher.Write(data(), size()).Finalize(result.begin());
+    return result;
+}
+
+uint256 CMultihasher::GetHash()
+{
+    if (fSHA256)
+        return GetSHA256Hash();
+
+    const unsigned char* pbegin = data();
+    const unsigned char* pend = pbegin + size();
+    assert(GetAlgoInfo(nAlgo).nInputSize == 0 || size() == GetAlgoInfo(nAlgo).nInputSize);
+    return GetMultihashTable().Get(nAlgo)(pbegin, pend, nVersion);
+}
+
+void MultiAlgoHashBatch(uint8_t nAlgo, const CPureBlockHeader* const* headers, size_t n, uint256* out, int nVersion)
+{
+    if (!IsHashChainAlgo(nAlgo)) {
+        for (size_t i = 0; i < n; i++)
+            out[i] = headers[i]->GetPoWHash(nAlgo, SER_GETHASH, nVersion);
+        return;
+    }
+
+    unsigned char input[HASH_BATCH_LANES][MULTIHASH_HEADER_SIZE];
+    uint256 hashes[HASH_BATCH_LANES];
+    size_t index[HASH_BATCH_LANES];
+    size_t nLanes = 0;
+    for (size_t i = 0; i < n; i++) {
+        // Equihash headers serialize their solution, they take the single header path.
+        if (IsEquihashBasedAlgo(headers[i]->GetAlgo())) {
+            out[i] = headers[i]->GetPoWHash(nAlgo, SER_GETHASH, nVersion);
+            continue;
+        }
+        CHeaderLaneWriter writer(input[nLanes], nVersion);
+        writer << *headers[i];
+        assert(writer.size() == MULTIHASH_HEADER_SIZE);
+        index[nLanes++] = i;
+        if (nLanes == HASH_BATCH_LANES) {
+            HashChainLanes(nAlgo, input, nLanes, hashes);
+            for (size_t l = 0; l < nLanes; l++)
+                out[index[l]] = hashes[l];
+            nLanes = 0;
+        }
+    }
+    if (nLanes != 0) {
+        HashChainLanes(nAlgo, input, nLanes, hashes);
+        for (size_t l = 0; l < nLanes; l++)
+            out[index[l]] = hashes[l];
+    }
+}
+
+void MultiAlgoHashBatch(uint8_t nAlgo, const unsigned char (*headers)[MULTIHASH_HEADER_SIZE], size_t n, uint256* out, int nVersion)
+{
+    if (IsHashChainAlgo(nAlgo)) {
+        for (size_t i = 0; i < n; i += HASH_BATCH_LANES)
+            HashChainLanes(nAlgo, headers + i, std::min(n - i, HASH_BATCH_LANES), out + i);
+        return;
+    }
+
+    const MultihashFunction function = GetMultihashTable().Get(nAlgo);
+    for (size_t i = 0; i < n; i++) {
+        const unsigned char* pbegin = headers[i];
+        const unsigned char* pend = pbegin + MULTIHASH_HEADER_SIZE;
+        out[i] = function ? function(pbegin, pend, nVersion) : Hash(pbegin, pend);
+    }
 }
 
 int LoadMultiHasherVersionFlags(bool fHardfork3Activated)
@@ -8,36 +8,66 @@
 #define GLOBALTOKEN_MULTIHASHER_H
 
 #include <globaltoken/powalgorithm.h>
+#include <hash.h>
 #include <serialize.h>
 #include <version.h>
 #include <uint256.h>
 
+#include <string.h>
 #include <vector>
 
+class CPureBlockHeader;
+
 static const int MULTIHASHER_YESCRYPT_R8_NEW = 0x40000000;
 
-/** A writer stream (for serialization) that computes a 256-bit hash, with selected algorithm. */
+/** Size of a serialized header of the algos that are not equihash based */
+static const size_t MULTIHASH_HEADER_SIZE = 80;
+
+/**
+ * A writer stream (for serialization) that computes a 256-bit hash, with selected algorithm.
+ *
+ * Serialized headers (80 bytes, 140 bytes for equihash headers) are collected in
+ * an inline buffer. For the SHA256d based algos the input is streamed into the
+ * hasher instead, so an equihash solution is hashed straight from its vector.
+ */
 class CMultihasher
 {
 private:
-    std::vector<unsigned char> buf;
+    //! Size of a serialized equihash header without its solution
+    static const size_t INLINE_SIZE = 140;
+
+    unsigned char buf[INLINE_SIZE];
+    size_t nSize;
+    //! Input that does not fit into buf, only used for the non-SHA256d algos
+    std::vector<unsigned char> vSpill;
+    CHash256 hasher;
 
     const int nType;
     const int nVersion;
     uint8_t nAlgo;
-    uint256 GetSHA256Hash() const;
+    const bool fSHA256;
+
+    void WriteSpill(const char *pch, size_t size);
+    const unsigned char* data() const { return vSpill.empty() ? buf : vSpill.data(); }
+    size_t size() const { return vSpill.empty() ? nSize : vSpill.size(); }
+    uint256 GetSHA256Hash();
 public:
 
-    CMultihasher(int nTypeIn, int nVersionIn, uint8_t nAlgoIn) : nType(nTypeIn), nVersion(nVersionIn), nAlgo(nAlgoIn) {}
+    CMultihasher(int nTypeIn, int nVersionIn, uint8_t nAlgoIn);
 
     int GetType() const { return nType; }
     int GetVersion() const { return nVersion; }
 
     void write(const char *pch, size_t size) {
-        buf.insert(buf.end(), pch, pch + size);
+        if (nSize + size <= INLINE_SIZE) {
+            memcpy(buf + nSize, pch, size);
+            nSize += size;
+            return;
+        }
+        WriteSpill(pch, size);
     }
 
-    uint256 GetHash() const;
+    uint256 GetHash();
 
     template<typename T>
     CMultihasher& operator<<(const T& obj) {
@@ -56,6 +86,18 @@ uint256 SerializeMultiAlgoHash(const T& obj, uint8_t nAlgo, int nType=SER_GETHAS
     return ss.GetHash();
 }
 
+/**
+ * Compute the hashes of n headers with the given algo, out[i] equals
+ * headers[i]->GetPoWHash(nAlgo, SER_GETHASH, nVersion). The X-family chains
+ * (X11 to X17, NIST5, Quark, Qubit and X16R) hash several headers side by side
+ * with the multi-buffer implementations selected by Hash512AutoDetect, the
+ * other algos are hashed one header at a time.
+ */
+void MultiAlgoHashBatch(uint8_t nAlgo, const CPureBlockHeader* const* headers, size_t n, uint256* out, int nVersion=PROTOCOL_VERSION);
+
+/** Like MultiAlgoHashBatch for n headers that are already serialized, none of them equihash based. */
+void MultiAlgoHashBatch(uint8_t nAlgo, const unsigned char (*headers)[MULTIHASH_HEADER_SIZE], size_t n, uint256* out, int nVersion=PROTOCOL_VERSION);
+
 int LoadMultiHasherVersionFlags(bool fHardfork3Activated);
 
 #endif // GLOBALTOKEN_MULTIHASHER_H
@@ -5,267 +5,187 @@
 
 #include <globaltoken/powalgorithm.h>
 
+#include <crypto/algos/Lyra2RE/Lyra2.h>
+#include <crypto/algos/argon2/hashargon.h>
+#include <crypto/algos/yescrypt/yescrypt.h>
+#include <crypto/algos/yespower/yespower.h>
+
+#include <assert.h>
 #include <sstream>
+#include <utility>
 #include <vector>
 #include <algorithm>
 
-std::string GetAlgoName(uint8_t Algo)
+namespace {
+
+/** All implemented algos, indexed by algo ID */
+constexpr CAlgoInfo algoRegistry[NUM_ALGOS_IMPL] = {
+    { ALGO_SHA256D,           BLOCK_VERSION_SHA256D,         "sha256d",          0, ALGO_MEMORY_LIGHT,    0 },
+    { ALGO_SCRYPT,            BLOCK_VERSION_SCRYPT,          "scrypt",          80, ALGO_MEMORY_HARD,     0 },
+    { ALGO_X11,               BLOCK_VERSION_X11,             "x11",              0, ALGO_MEMORY_LIGHT,    0 },
+    { ALGO_NEOSCRYPT,         BLOCK_VERSION_NEOSCRYPT,       "neoscrypt",       80, ALGO_MEMORY_HARD,     0 },
+    { ALGO_EQUIHASH,          BLOCK_VERSION_EQUIHASH,        "equihash",         0, ALGO_MEMORY_EQUIHASH, 0 },
+    { ALGO_YESCRYPT,          BLOCK_VERSION_YESCRYPT,        "yescrypt",        80, ALGO_MEMORY_HARD,     YESCRYPT_LOCAL_SIZE(2048, 8, 1) },
+    { ALGO_HMQ1725,           BLOCK_VERSION_HMQ1725,         "hmq1725",          0, ALGO_MEMORY_LIGHT,    0 },
+    { ALGO_XEVAN,             BLOCK_VERSION_XEVAN,           "xevan",            0, ALGO_MEMORY_LIGHT,    0 },
+    { ALGO_NIST5,             BLOCK_VERSION_NIST5,           "nist5",            0, ALGO_MEMORY_LIGHT,    0 },
+    { ALGO_TIMETRAVEL10,      BLOCK_VERSION_TIMETRAVEL10,    "timetravel10",    80, ALGO_MEMORY_LIGHT,    0 },
+    { ALGO_PAWELHASH,         BLOCK_VERSION_PAWELHASH,       "pawelhash",        0, ALGO_MEMORY_LIGHT,    0 },
+    { ALGO_X13,               BLOCK_VERSION_X13,             "x13",              0, ALGO_MEMORY_LIGHT,    0 },
+    { ALGO_X14,               BLOCK_VERSION_X14,             "x14",              0, ALGO_MEMORY_LIGHT,    0 },
+    { ALGO_X15,               BLOCK_VERSION_X15,             "x15",              0, ALGO_MEMORY_LIGHT,    0 },
+    { ALGO_X17,               BLOCK_VERSION_X17,             "x17",              0, ALGO_MEMORY_LIGHT,    0 },
+    { ALGO_LYRA2REV2,         BLOCK_VERSION_LYRA2REV2,       "lyra2rev2",       80, ALGO_MEMORY_HARD,     LYRA2_SCRATCHPAD_SIZE(4, 4) },
+    { ALGO_BLAKE2S,           BLOCK_VERSION_BLAKE2S,         "blake2s",          0, ALGO_MEMORY_LIGHT,    0 },
+    { ALGO_BLAKE2B,           BLOCK_VERSION_BLAKE2B,         "blake2b",          0, ALGO_MEMORY_LIGHT,    0 },
+    { ALGO_ASTRALHASH,        BLOCK_VERSION_ASTRALHASH,      "astralhash",       0, ALGO_MEMORY_LIGHT,    0 },
+    { ALGO_PADIHASH,          BLOCK_VERSION_PADIHASH,        "padihash",         0, ALGO_MEMORY_LIGHT,    0 },
+    { ALGO_JEONGHASH,         BLOCK_VERSION_JEONGHASH,       "jeonghash",        0, ALGO_MEMORY_LIGHT,    0 },
+    { ALGO_KECCAKC,           BLOCK_VERSION_KECCAKC,         "keccakc",          0, ALGO_MEMORY_LIGHT,    0 },
+    { ALGO_ZHASH,             BLOCK_VERSION_ZHASH,           "zhash",            0, ALGO_MEMORY_EQUIHASH, 0 },
+    { ALGO_GLOBALHASH,        BLOCK_VERSION_GLOBALHASH,      "globalhash",       0, ALGO_MEMORY_LIGHT,    0 },
+    { ALGO_SKEIN,             BLOCK_VERSION_SKEIN,           "skein",            0, ALGO_MEMORY_LIGHT,    0 },
+    { ALGO_GROESTL,           BLOCK_VERSION_GROESTL,         "groestl",          0, ALGO_MEMORY_LIGHT,    0 },
+    { ALGO_QUBIT,             BLOCK_VERSION_QUBIT,           "qubit",            0, ALGO_MEMORY_LIGHT,    0 },
+    { ALGO_SKUNKHASH,         BLOCK_VERSION_SKUNKHASH,       "skunkhash",        0, ALGO_MEMORY_LIGHT,    0 },
+    { ALGO_QUARK,             BLOCK_VERSION_QUARK,           "quark",            0, ALGO_MEMORY_LIGHT,    0 },
+    { ALGO_X16R,              BLOCK_VERSION_X16R,            "x16r",            80, ALGO_MEMORY_LIGHT,    0 },
+    { ALGO_LYRA2REV3,         BLOCK_VERSION_LYRA2REV3,       "lyra2rev3",       80, ALGO_MEMORY_HARD,     LYRA2_SCRATCHPAD_SIZE(4, 4) },
+    { ALGO_YESCRYPT_R16V2,    BLOCK_VERSION_YESCRYPT_R16V2,  "yescryptr16v2",   80, ALGO_MEMORY_HARD,     YESCRYPT_LOCAL_SIZE(4096, 16, 4) },
+    { ALGO_YESCRYPT_R24,      BLOCK_VERSION_YESCRYPT_R24,    "yescryptr24",     80, ALGO_MEMORY_HARD,     YESCRYPT_LOCAL_SIZE(4096, 24, 1) },
+    { ALGO_YESCRYPT_R8,       BLOCK_VERSION_YESCRYPT_R8,     "yescryptr8",      80, ALGO_MEMORY_HARD,     YESCRYPT_LOCAL_SIZE(8192, 8, 2) },
+    { ALGO_YESCRYPT_R32,      BLOCK_VERSION_YESCRYPT_R32,    "yescryptr32",     80, ALGO_MEMORY_HARD,     YESCRYPT_LOCAL_SIZE(4096, 32, 1) },
+    { ALGO_X25X,              BLOCK_VERSION_X25X,            "x25x",             0, ALGO_MEMORY_LIGHT,    0 },
+    { ALGO_ARGON2D,           BLOCK_VERSION_ARGON2D,         "argon2d",          0, ALGO_MEMORY_HARD,     Argon2ScratchpadSize(ARGON2D_HASH_M_COST, ARGON2D_HASH_LANES) },
+    { ALGO_ARGON2I,           BLOCK_VERSION_ARGON2I,         "argon2i",          0, ALGO_MEMORY_HARD,     Argon2ScratchpadSize(ARGON2I_HASH_M_COST, ARGON2I_HASH_LANES) },
+    { ALGO_CPU23R,            BLOCK_VERSION_CPU23R,          "cpu23r",          80, ALGO_MEMORY_LIGHT,    0 },
+    { ALGO_YESPOWER,          BLOCK_VERSION_YESPOWER,        "yespower",        80, ALGO_MEMORY_HARD,     YESPOWER_LOCAL_SIZE(2048, 32) },
+    { ALGO_X21S,              BLOCK_VERSION_X21S,            "x21s",            80, ALGO_MEMORY_LIGHT,    0 },
+    { ALGO_X16S,              BLOCK_VERSION_X16S,            "x16s",            80, ALGO_MEMORY_LIGHT,    0 },
+    { ALGO_X22I,              BLOCK_VERSION_X22I,            "x22i",             0, ALGO_MEMORY_LIGHT,    0 },
+    { ALGO_LYRA2Z,            BLOCK_VERSION_LYRA2Z,          "lyra2z",          80, ALGO_MEMORY_HARD,     LYRA2_SCRATCHPAD_SIZE(8, 8) },
+    { ALGO_HONEYCOMB,         BLOCK_VERSION_HONEYCOMB,       "honeycomb",        0, ALGO_MEMORY_LIGHT,    0 },
+    { ALGO_EH192,             BLOCK_VERSION_EH192,           "equihash192",      0, ALGO_MEMORY_EQUIHASH, 0 },
+    { ALGO_MARS,              BLOCK_VERSION_MARS,            "mars",             0, ALGO_MEMORY_EQUIHASH, 0 },
+    { ALGO_X12,               BLOCK_VERSION_X12,             "x12",              0, ALGO_MEMORY_LIGHT,    0 },
+    { ALGO_HEX,               BLOCK_VERSION_HEX,             "hex",              0, ALGO_MEMORY_LIGHT,    0 },
+    { ALGO_DEDAL,             BLOCK_VERSION_DEDAL,           "dedal",            0, ALGO_MEMORY_LIGHT,    0 },
+    { ALGO_C11,               BLOCK_VERSION_C11,             "c11",              0, ALGO_MEMORY_LIGHT,    0 },
+    { ALGO_PHI1612,           BLOCK_VERSION_PHI1612,         "phi1612",          0, ALGO_MEMORY_LIGHT,    0 },
+    { ALGO_PHI2,              BLOCK_VERSION_PHI2,            "phi2",             0, ALGO_MEMORY_HARD,     LYRA2_SCRATCHPAD_SIZE(8, 8) },
+    { ALGO_X16RT,             BLOCK_VERSION_X16RT,           "x16rt",           80, ALGO_MEMORY_LIGHT,    0 },
+    { ALGO_TRIBUS,            BLOCK_VERSION_TRIBUS,          "tribus",           0, ALGO_MEMORY_LIGHT,    0 },
+    { ALGO_ALLIUM,            BLOCK_VERSION_ALLIUM,          "allium",          80, ALGO_MEMORY_HARD,     LYRA2_SCRATCHPAD_SIZE(8, 8) },
+    { ALGO_ARCTICHASH,        BLOCK_VERSION_ARCTICHASH,      "arctichash",       0, ALGO_MEMORY_LIGHT,    0 },
+    { ALGO_DESERTHASH,        BLOCK_VERSION_DESERTHASH,      "deserthash",       0, ALGO_MEMORY_LIGHT,    0 },
+    { ALGO_CRYPTOANDCOFFEE,   BLOCK_VERSION_CRYPTOANDCOFFEE, "cryptoandcoffee",  0, ALGO_MEMORY_LIGHT,    0 },
+    { ALGO_RICKHASH,          BLOCK_VERSION_RICKHASH,        "rickhash",         0, ALGO_MEMORY_LIGHT,    0 },
+};
+
+constexpr bool IsRegistryConsistent(int i)
+{
+    return i == NUM_ALGOS_IMPL ||
+           (algoRegistry[i].nAlgo == i && algoRegistry[i].nVersionBits == ((i + 1) << 9) &&
+            GetAlgoFromVersionBits(algoRegistry[i].nVersionBits) == i && IsRegistryConsistent(i + 1));
+}
+static_assert(IsRegistryConsistent(0), "algoRegistry must be ordered by algo ID and match the BLOCK_VERSION_ALGO bits");
+
+/** Names accepted by GetAlgoByName besides the canonical ones */
+const std::pair<const char*, uint8_t> algoAliases[] = {
+    {"sha", ALGO_SHA256D}, {"sha256", ALGO_SHA256D},
+    {"zcash", ALGO_EQUIHASH}, {"equihash200", ALGO_EQUIHASH}, {"equihash2009", ALGO_EQUIHASH}, {"equihash200.9", ALGO_EQUIHASH},
+    {"timetravel", ALGO_TIMETRAVEL10},
+    {"lyra", ALGO_LYRA2REV2}, {"lyra2re", ALGO_LYRA2REV2}, {"lyra2", ALGO_LYRA2REV2},
+    {"sia", ALGO_BLAKE2B},
+    {"keccak", ALGO_KECCAKC}, {"sha3-keccak", ALGO_KECCAKC}, {"sha3keccak", ALGO_KECCAKC},
+    {"equihash144", ALGO_ZHASH}, {"equihash1445", ALGO_ZHASH}, {"equihash144_5", ALGO_ZHASH}, {"equihash144.5", ALGO_ZHASH},
+    {"groestlsha2", ALGO_GROESTL},
+    {"skeinsha2", ALGO_SKEIN},
+    {"q2c", ALGO_QUBIT},
+    {"skunk", ALGO_SKUNKHASH},
+    {"equihash1927", ALGO_EH192}, {"equihash192.7", ALGO_EH192}, {"equihash192_7", ALGO_EH192},
+    {"equihash96", ALGO_MARS}, {"equihash965", ALGO_MARS}, {"equihash96_5", ALGO_MARS}, {"equihash96.5", ALGO_MARS},
+    {"phi1", ALGO_PHI1612}, {"phi", ALGO_PHI1612},
+};
+
+/**
+ * Perfect hash of all canonical names and aliases: FNV-1a with a seed chosen
+ * so that the top ALGO_NAME_HASH_BITS bits do not collide for any of them.
+ */
+const int ALGO_NAME_HASH_BITS = 9;
+const uint32_t ALGO_NAME_HASH_SEED = 5410;
+
+uint32_t AlgoNameHash(const std::string& strName)
 {
-    switch (Algo)
+    uint32_t h = ALGO_NAME_HASH_SEED;
+    for (unsigned char c : strName)
+        h = (h ^ c) * 16777619;
+    return h >> (32 - ALGO_NAME_HASH_BITS);
+}
+
+class CAlgoNameTable
+{
+private:
+    static const uint8_t EMPTY = 0xff;
+
+    struct Slot
     {
-        case ALGO_SHA256D:
-            return std::string("sha256d");
-        case ALGO_SCRYPT:
-            return std::string("scrypt");
-        case ALGO_X11:
-            return std::string("x11");
-        case ALGO_NEOSCRYPT:
-            return std::string("neoscrypt");
-        case ALGO_YESCRYPT:
-            return std::string("yescrypt");
-        case ALGO_EQUIHASH:
-            return std::string("equihash");
-        case ALGO_HMQ1725:
-            return std::string("hmq1725");
-        case ALGO_XEVAN:
-            return std::string("xevan");
-        case ALGO_NIST5:
-            return std::string("nist5");
-        case ALGO_TIMETRAVEL10:
-            return std::string("timetravel10");
-        case ALGO_PAWELHASH:
-            return std::string("pawelhash");
-        case ALGO_X13:
-            return std::string("x13");
-        case ALGO_X14:
-            return std::string("x14");
-        case ALGO_X15:
-            return std::string("x15");
-        case ALGO_X17:
-            return std::string("x17");
-        case ALGO_LYRA2REV2:
-            return std::string("lyra2rev2");
-        case ALGO_BLAKE2S:
-            return std::string("blake2s");
-        case ALGO_BLAKE2B:
-            return std::string("blake2b");
-        case ALGO_ASTRALHASH:
-            return std::string("astralhash");
-        case ALGO_PADIHASH:
-            return std::string("padihash");
-        case ALGO_JEONGHASH:
-            return std::string("jeonghash");
-        case ALGO_KECCAKC:
-            return std::string("keccakc");
-        case ALGO_ZHASH:
-            return std::string("zhash");
-        case ALGO_GLOBALHASH:
-            return std::string("globalhash");
-        case ALGO_SKEIN:
-            return std::string("skein");
-        case ALGO_GROESTL:
-            return std::string("groestl");
-        case ALGO_QUBIT:
-            return std::string("qubit");
-        case ALGO_SKUNKHASH:
-            return std::string("skunkhash");
-        case ALGO_QUARK:
-            return std::string("quark");
-        case ALGO_X16R:
-            return std::string("x16r");
-        case ALGO_LYRA2REV3:
-            return std::string("lyra2rev3");
-        case ALGO_YESCRYPT_R16V2:
-            return std::string("yescryptr16v2");
-        case ALGO_YESCRYPT_R24:
-            return std::string("yescryptr24");
-        case ALGO_YESCRYPT_R8:
-            return std::string("yescryptr8");
-        case ALGO_YESCRYPT_R32:
-            return std::string("yescryptr32");
-        case ALGO_X25X:
-            return std::string("x25x");
-        case ALGO_ARGON2D:
-            return std::string("argon2d");
-        case ALGO_ARGON2I:
-            return std::string("argon2i");
-        case ALGO_CPU23R:
-            return std::string("cpu23r");
-        case ALGO_YESPOWER:
-            return std::string("yespower");
-        case ALGO_X21S:
-            return std::string("x21s");
-        case ALGO_X16S:
-            return std::string("x16s");
-        case ALGO_X22I:
-            return std::string("x22i");
-        case ALGO_LYRA2Z:
-            return std::string("lyra2z");
-        case ALGO_HONEYCOMB:
-            return std::string("honeycomb");
-        case ALGO_EH192:
-            return std::string("equihash192");
-        case ALGO_MARS:
-            return std::string("mars");
-        case ALGO_X12:
-            return std::string("x12");
-        case ALGO_HEX:
-            return std::string("hex");
-        case ALGO_DEDAL:
-            return std::string("dedal");
-        case ALGO_C11:
-            return std::string("c11");
-        case ALGO_PHI1612:
-            return std::string("phi1612");
-        case ALGO_PHI2:
-            return std::string("phi2");
-        case ALGO_X16RT:
-            return std::string("x16rt");
-        case ALGO_TRIBUS:
-            return std::string("tribus");
-        case ALGO_ALLIUM:
-            return std::string("allium");
-        case ALGO_ARCTICHASH:
-            return std::string("arctichash");
-        case ALGO_DESERTHASH:
-            return std::string("deserthash");
-        case ALGO_CRYPTOANDCOFFEE:
-            return std::string("cryptoandcoffee");
-        case ALGO_RICKHASH:
-            return std::string("rickhash");
+        const char* pszName;
+        uint8_t nAlgo;
+    };
+    Slot slots[1 << ALGO_NAME_HASH_BITS];
+
+    void Insert(const char* pszName, uint8_t nAlgo)
+    {
+        Slot& slot = slots[AlgoNameHash(pszName)];
+        assert(slot.nAlgo == EMPTY); // a new name needs a new ALGO_NAME_HASH_SEED
+        slot.pszName = pszName;
+        slot.nAlgo = nAlgo;
     }
-    return std::string("unknown");       
+
+public:
+    CAlgoNameTable()
+    {
+        for (Slot& slot : slots)
+            slot = Slot{"", EMPTY};
+        for (const CAlgoInfo& info : algoRegistry)
+            Insert(info.pszName, info.nAlgo);
+        for (const auto& alias : algoAliases)
+            Insert(alias.first, alias.second);
+    }
+
+    bool Find(const std::string& strName, uint8_t& nAlgo) const
+    {
+        const Slot& slot = slots[AlgoNameHash(strName)];
+        if (slot.nAlgo == EMPTY || strName != slot.pszName)
+            return false;
+        nAlgo = slot.nAlgo;
+        return true;
+    }
+};
+
+} // namespace
+
+const CAlgoInfo& GetAlgoInfo(uint8_t nAlgo)
+{
+    assert(nAlgo < NUM_ALGOS_IMPL);
+    return algoRegistry[nAlgo];
+}
+
+std::string GetAlgoName(uint8_t Algo)
+{
+    if (Algo < NUM_ALGOS_IMPL)
+        return std::string(algoRegistry[Algo].pszName);
+    return std::string("unknown");
 }
 
 uint8_t GetAlgoByName(std::string strAlgo, uint8_t fallback, bool &fAlgoFound)
 {
+    static const CAlgoNameTable nameTable;
     transform(strAlgo.begin(),strAlgo.end(),strAlgo.begin(),::tolower);
-    fAlgoFound = true;
-    if (strAlgo == "sha" || strAlgo == "sha256" || strAlgo == "sha256d")
-        return ALGO_SHA256D;
-    else if (strAlgo == "scrypt")
-        return ALGO_SCRYPT;
-    else if (strAlgo == "neoscrypt")
-        return ALGO_NEOSCRYPT;
-    else if (strAlgo == "equihash" || strAlgo == "zcash" || strAlgo == "equihash200" || strAlgo == "equihash2009" || strAlgo == "equihash200.9")
-        return ALGO_EQUIHASH;
-    else if (strAlgo == "yescrypt")
-        return ALGO_YESCRYPT;
-    else if (strAlgo == "hmq1725")
-        return ALGO_HMQ1725;
-    else if (strAlgo == "xevan")
-        return ALGO_XEVAN;
-    else if (strAlgo == "nist5")
-        return ALGO_NIST5;
-    else if (strAlgo == "timetravel" || strAlgo == "timetravel10")
-        return ALGO_TIMETRAVEL10;
-    else if (strAlgo == "pawelhash")
-        return ALGO_PAWELHASH;
-    else if (strAlgo == "x11")
-        return ALGO_X11;
-    else if (strAlgo == "x13")
-        return ALGO_X13;
-    else if (strAlgo == "x14")
-        return ALGO_X14;
-    else if (strAlgo == "x15")
-        return ALGO_X15;
-    else if (strAlgo == "x16r")
-        return ALGO_X16R;
-    else if (strAlgo == "x17")
-        return ALGO_X17;
-    else if (strAlgo == "lyra" || strAlgo == "lyra2re" || strAlgo == "lyra2" || strAlgo == "lyra2rev2")
-        return ALGO_LYRA2REV2;
-    else if (strAlgo == "blake2s")
-        return ALGO_BLAKE2S;
-    else if (strAlgo == "blake2b" || strAlgo == "sia")
-        return ALGO_BLAKE2B;
-    else if (strAlgo == "astralhash")
-        return ALGO_ASTRALHASH;
-    else if (strAlgo == "padihash")
-        return ALGO_PADIHASH;
-    else if (strAlgo == "jeonghash")
-        return ALGO_JEONGHASH;
-    else if (strAlgo == "keccak" || strAlgo == "keccakc" || strAlgo == "sha3-keccak" || strAlgo == "sha3keccak")
-        return ALGO_KECCAKC;
-    else if (strAlgo == "zhash" || strAlgo == "equihash144" || strAlgo == "equihash1445" || strAlgo == "equihash144_5" || strAlgo == "equihash144.5")
-        return ALGO_ZHASH;
-    else if (strAlgo == "globalhash")
-        return ALGO_GLOBALHASH;
-    else if (strAlgo == "groestl" || strAlgo == "groestlsha2")
-        return ALGO_GROESTL;
-    else if (strAlgo == "skein" || strAlgo == "skeinsha2")
-        return ALGO_SKEIN;
-    else if (strAlgo == "q2c" || strAlgo == "qubit")
-        return ALGO_QUBIT;
-    else if (strAlgo == "skunk" || strAlgo == "skunkhash")
-        return ALGO_SKUNKHASH;
-    else if (strAlgo == "quark")
-        return ALGO_QUARK;
-    else if (strAlgo == "lyra2rev3")
-        return ALGO_LYRA2REV3;
-    else if (strAlgo == "yescryptr16v2")
-        return ALGO_YESCRYPT_R16V2;
-    else if (strAlgo == "yescryptr24")
-        return ALGO_YESCRYPT_R24;
-    else if (strAlgo == "yescryptr8")
-        return ALGO_YESCRYPT_R8;
-    else if (strAlgo == "yescryptr32")
-        return ALGO_YESCRYPT_R32;
-    else if (strAlgo == "x25x")
-        return ALGO_X25X;
-    else if (strAlgo == "argon2d")
-        return ALGO_ARGON2D;
-    else if (strAlgo == "argon2i")
-        return ALGO_ARGON2I;
-    else if (strAlgo == "cpu23r")
-        return ALGO_CPU23R;
-    else if (strAlgo == "yespower")
-        return ALGO_YESPOWER;
-    else if (strAlgo == "x21s")
-        return ALGO_X21S;
-    else if (strAlgo == "x16s")
-        return ALGO_X16S;
-    else if (strAlgo == "x22i")
-        return ALGO_X22I;
-    else if (strAlgo == "lyra2z")
-        return ALGO_LYRA2Z;
-    else if (strAlgo == "honeycomb")
-        return ALGO_HONEYCOMB;
-    else if (strAlgo == "equihash192" || strAlgo == "equihash1927" || strAlgo == "equihash192.7" || strAlgo == "equihash192_7")
-        return ALGO_EH192;
-    else if (strAlgo == "mars" || strAlgo == "equihash96" || strAlgo == "equihash965" || strAlgo == "equihash96_5" || strAlgo == "equihash96.5")
-        return ALGO_MARS;
-    else if (strAlgo == "x12")
-        return ALGO_X12;
-    else if (strAlgo == "hex")
-        return ALGO_HEX;
-    else if (strAlgo == "dedal")
-        return ALGO_DEDAL;
-    else if (strAlgo == "c11")
-        return ALGO_C11;
-    else if (strAlgo == "phi1612" || strAlgo == "phi1" || strAlgo == "phi")
-        return ALGO_PHI1612;
-    else if (strAlgo == "phi2")
-        return ALGO_PHI2;
-    else if (strAlgo == "x16rt")
-        return ALGO_X16RT;
-    else if (strAlgo == "tribus")
-        return ALGO_TRIBUS;
-    else if (strAlgo == "allium")
-        return ALGO_ALLIUM;
-    else if (strAlgo == "arctichash")
-        return ALGO_ARCTICHASH;
-    else if (strAlgo == "deserthash")
-        return ALGO_DESERTHASH;
-    else if (strAlgo == "cryptoandcoffee")
-        return ALGO_CRYPTOANDCOFFEE;
-    else if (strAlgo == "rickhash")
-        return ALGO_RICKHASH;
-    else
-    {
-        fAlgoFound = false;
-        return fallback;
-    }
+    uint8_t nAlgo;
+    fAlgoFound = nameTable.Find(strAlgo, nAlgo);
+    return fAlgoFound ? nAlgo : fallback;
 }
 
 std::string GetAlgoRangeString()
@@ -290,6 +210,14 @@ std::string GetAlgoRangeString()
     return strStream.str();
 }
 
+size_t GetMaxAlgoScratchpadSize()
+{
+    size_t nMax = 0;
+    for (const CAlgoInfo& info : algoRegistry)
+        nMax = std::max(nMax, info.nScratchpadSize);
+    return nMax;
+}
+
 bool IsAlgoAllowedBeforeHF2(uint8_t nAlgo)
 {
     // Hardfork 1 starts with algo sha256 and ends with last algo id x16r
@@ -298,7 +226,7 @@ bool IsAlgoAllowedBeforeHF2(uint8_t nAlgo)
 
 bool IsEquihashBasedAlgo(uint8_t nAlgo)
 {
-    return (nAlgo == ALGO_EQUIHASH || nAlgo == ALGO_ZHASH || nAlgo == ALGO_EH192 || nAlgo == ALGO_MARS);
+    return nAlgo < NUM_ALGOS_IMPL && algoRegistry[nAlgo].memoryClass == ALGO_MEMORY_EQUIHASH;
 }
 
 std::string GetEquihashBasedDefaultPersonalize(uint8_t nAlgo)
@@ -9,6 +9,8 @@
 #include <arith_uint256.h>
 #include <uint256.h>
 
+#include <stdint.h>
+#include <string>
 
 /** Algos */
 enum : uint8_t { 
@@ -141,6 +143,41 @@ enum {
 const int NUM_ALGOS_OLD = 30;
 const int NUM_ALGOS = 60;
 
+/** Memory requirements of an algo's proof-of-work hash */
+enum AlgoMemoryClass : uint8_t {
+    ALGO_MEMORY_LIGHT    = 0, // chained hash functions, a few KiB of state
+    ALGO_MEMORY_HARD     = 1, // scratchpad based (scrypt, yescrypt, lyra2, argon2, ...)
+    ALGO_MEMORY_EQUIHASH = 2, // equihash solution, the header is hashed with SHA256d
+};
+
+/** Registry entry of a proof-of-work algo */
+struct CAlgoInfo
+{
+    uint8_t nAlgo;
+    //! BLOCK_VERSION_* bits selecting the algo in a block version
+    int32_t nVersionBits;
+    //! Canonical name, as returned by GetAlgoName
+    const char* pszName;
+    //! Required size of the hashed input, 0 if any size is accepted
+    uint16_t nInputSize;
+    AlgoMemoryClass memoryClass;
+    //! Bytes the hash takes from the scratchpad of the thread, 0 if it keeps its state on the stack
+    //! (light algos chaining a Lyra2 round take a few KiB on demand)
+    size_t nScratchpadSize;
+};
+
+/** Registry entry of an implemented algo, nAlgo must be below NUM_ALGOS_IMPL. */
+const CAlgoInfo& GetAlgoInfo(uint8_t nAlgo);
+
+/** Algo selected by the BLOCK_VERSION_ALGO bits of a block version, NUM_ALGOS_IMPL if the bits select none. */
+constexpr uint8_t GetAlgoFromVersionBits(int32_t nVersion)
+{
+    return (((nVersion & BLOCK_VERSION_ALGO) >> 9) - 1u) < NUM_ALGOS_IMPL ? ((nVersion & BLOCK_VERSION_ALGO) >> 9) - 1 : NUM_ALGOS_IMPL;
+}
+
+/** Largest scratchpad of all algos, the size the scratchpad of a hashing thread is allocated with. */
+size_t GetMaxAlgoScratchpadSize();
+
 std::string GetAlgoName(uint8_t Algo);
 uint8_t GetAlgoByName(std::string strAlgo, uint8_t fallback, bool &fAlgoFound);
 std::string GetAlgoRangeString();
@@ -13,13 +13,19 @@
 #include <init.h>
 
 #include <addrman.h>
+#include <algostats.h>
 #include <amount.h>
+#include <auxpowcache.h>
 #include <base58.h>
 #include <chain.h>
 #include <chainparams.h>
 #include <checkpoints.h>
 #include <compat/sanity.h>
 #include <consensus/validation.h>
+#include <crypto/algos/hashlib/multihash_lanes.h>
+#include <crypto/algos/powkernels.h>
+#include <crypto/algos/scratchpad.h>
+#include <globaltoken/powalgorithm.h>
 #include <fs.h>
 #include <httpserver.h>
 #include <httprpc.h>
@@ -32,6 +38,7 @@
 #include <policy/feerate.h>
 #include <policy/fees.h>
 #include <policy/policy.h>
+#include <powcache.h>
 #include <rpc/server.h>
 #include <rpc/register.h>
 #include <rpc/safemode.h>
@@ -66,6 +73,7 @@
 #include <masternodeconfig.h>
 #include <messagesigner.h>
 #include <netfulfilledman.h>
+#include <payeeindex.h>
 #include <spork.h>
 
 #include <warnings.h>
@@ -89,10 +97,6 @@
 #include <zmq/zmqnotificationinterface.h>
 #endif
 
-#ifdef USE_SSE2
-#include <crypto/algos/scrypt/scrypt.h>
-#endif
-
 bool fFeeEstimatesInitialized = false;
 static const bool DEFAULT_PROXYRANDOMIZE = true;
 static const bool DEFAULT_REST_ENABLE = false;
@@ -231,9 +235,9 @@ void Shutdown()
     
     // STORE DATA CACHES INTO SERIALIZED DAT FILES
     if (!fLiteMode) {
-        CFlatDB<CMasternodeMan> flatdb1("mncache.dat", "magicMasternodeCache");
+        CFlatDBLog<CMasternodeMan> flatdb1("mncache.dat", "magicMasternodeCache");
         flatdb1.Dump(mnodeman);
-        CFlatDB<CMasternodePayments> flatdb2("mnpayments.dat", "magicMasternodePaymentsCache");
+        CFlatDBLog<CMasternodePayments> flatdb2("mnpayments.dat", "magicMasternodePaymentsCache");
         flatdb2.Dump(mnpayments);
         CFlatDB<CNetFulfilledRequestManager> flatdb4("netfulfilled.dat", "magicFulfilledCache");
         flatdb4.Dump(netfulfilledman);
@@ -290,6 +294,7 @@ void Shutdown()
         LOCK(cs_main);
         if (pcoinsTip != nullptr) {
             FlushStateToDisk();
+            WritePowWatermark();
         }
         pcoinsTip.reset();
         pcoinscatcher.reset();
@@ -309,11 +314,17 @@ void Shutdown()
 #endif
 
     if (pgltNotificationInterface) {
+        UnregisterValidationInterface(&algostatstracker);
         UnregisterValidationInterface(pgltNotificationInterface);
         delete pgltNotificationInterface;
         pgltNotificationInterface = nullptr;
     }
 
+    if (ppayeeindex) {
+        UnregisterValidationInterface(ppayeeindex.get());
+        ppayeeindex.reset();
+    }
+
 #ifndef WIN32
     try {
         fs::remove(GetPidFile());
@@ -386,6 +397,7 @@ std::string HelpMessage(HelpMessageMode mode)
     strUsage += HelpMessageOpt("-version", _("Print version and exit"));
     strUsage += HelpMessageOpt("-alertnotify=<cmd>", _("Execute command when a relevant alert is received or we see a really long fork (%s in cmd is replaced by message)"));
     strUsage +=HelpMessageOpt("-assumevalid=<hex>", strprintf(_("If this block is in the chain assume that it and its ancestors are valid and potentially skip their script verification (0 to verify all, default: %s, testnet: %s)"), defaultChainParams->GetConsensus().defaultAssumeValid.GetHex(), testnetChainParams->GetConsensus().defaultAssumeValid.GetHex()));
+    strUsage += HelpMessageOpt("-auxpowcache=<n>", strprintf(_("Set the size of the in-memory cache of merge-mined block headers in megabytes (0 to %d, default: %d)"), MAX_AUXPOW_CACHE_SIZE, DEFAULT_AUXPOW_CACHE_SIZE));
     strUsage += HelpMessageOpt("-blocknotify=<cmd>", _("Execute command when the best block changes (%s in cmd is replaced by block hash)"));
     strUsage += HelpMessageOpt("-blockreconstructionextratxn=<n>", strprintf(_("Extra transactions to keep in memory for compact block reconstructions (default: %u)"), DEFAULT_BLOCK_RECONSTRUCTION_EXTRA_TXN));
     if (showDebug)
@@ -412,12 +424,13 @@ std::string HelpMessage(HelpMessageMode mode)
     if (showDebug) {
         strUsage += HelpMessageOpt("-minimumchainwork=<hex>", strprintf("Minimum work assumed to exist on a valid chain in hex (default: %s, testnet: %s)", defaultChainParams->GetConsensus().nMinimumChainWork.GetHex(), testnetChainParams->GetConsensus().nMinimumChainWork.GetHex()));
     }
-    strUsage += HelpMessageOpt("-par=<n>", strprintf(_("Set the number of script verification threads (%u to %d, 0 = auto, <0 = leave that many cores free, default: %d)"),
+    strUsage += HelpMessageOpt("-par=<n>", strprintf(_("Set the number of script and proof-of-work verification threads (%u to %d, 0 = auto, <0 = leave that many cores free, default: %d)"),
         -GetNumCores(), MAX_SCRIPTCHECK_THREADS, DEFAULT_SCRIPTCHECK_THREADS));
     strUsage += HelpMessageOpt("-persistmempool", strprintf(_("Whether to save the mempool on shutdown and load on restart (default: %u)"), DEFAULT_PERSIST_MEMPOOL));
 #ifndef WIN32
     strUsage += HelpMessageOpt("-pid=<file>", strprintf(_("Specify pid file. Relative paths will be prefixed by a net-specific datadir location. (default: %s)"), BITCOIN_PID_FILENAME));
 #endif
+    strUsage += HelpMessageOpt("-powhugepages", strprintf(_("Back the proof-of-work scratchpads of hashing threads with huge pages where the system provides them (default: %u)"), DEFAULT_POW_HUGEPAGES));
     strUsage += HelpMessageOpt("-prune=<n>", strprintf(_("Reduce storage requirements by enabling pruning (deleting) of old blocks. This allows the pruneblockchain RPC to be called to delete specific blocks, and enables automatic pruning of old blocks if a target size in MiB is provided. This mode is incompatible with -txindex and -rescan. "
             "Warning: Reverting this setting requires re-downloading the entire blockchain. "
             "(default: 0 = disable pruning blocks, 1 = allow manual pruning via RPC, >%u = automatically prune block files to stay under the specified target size in MiB)"), MIN_DISK_SPACE_FOR_BLOCK_FILES / 1024 / 1024));
@@ -486,6 +499,7 @@ std::string HelpMessage(HelpMessageMode mode)
     if (showDebug)
     {
         strUsage += HelpMessageOpt("-checkblocks=<n>", strprintf(_("How many blocks to check at startup (default: %u, 0 = all)"), DEFAULT_CHECKBLOCKS));
+        strUsage += HelpMessageOpt("-checkpowonload=<mode>", strprintf(_("Proof-of-work verification of the block index at startup (0 = none, 1 = skip headers verified before the last clean shutdown, full = all, default: %s)"), DEFAULT_CHECKPOWONLOAD));
         strUsage += HelpMessageOpt("-checklevel=<n>", strprintf(_("How thorough the block verification of -checkblocks is (0-4, default: %u)"), DEFAULT_CHECKLEVEL));
         strUsage += HelpMessageOpt("-checkblockindex", strprintf("Do a full consistency check for mapBlockIndex, setBlockIndexCandidates, chainActive and mapBlocksUnlinked occasionally. Also sets -checkmempool (default: %u)", defaultChainParams->DefaultConsistencyChecks()));
         strUsage += HelpMessageOpt("-checkmempool=<n>", strprintf("Run checks every <n> transactions (default: %u)", defaultChainParams->DefaultConsistencyChecks()));
@@ -515,6 +529,8 @@ std::string HelpMessage(HelpMessageMode mode)
         strUsage += HelpMessageOpt("-logtimemicros", strprintf("Add microsecond precision to debug timestamps (default: %u)", DEFAULT_LOGTIMEMICROS));
         strUsage += HelpMessageOpt("-mocktime=<n>", "Replace actual time with <n> seconds since epoch (default: 0)");
         strUsage += HelpMessageOpt("-maxsigcachesize=<n>", strprintf("Limit sum of signature cache and script execution cache sizes to <n> MiB (default: %u)", DEFAULT_MAX_SIG_CACHE_SIZE));
+        strUsage += HelpMessageOpt("-maxpowcachesize=<n>", strprintf("Limit the cache of verified block header proof-of-work to <n> MiB (default: %u)", DEFAULT_MAX_POW_CACHE_SIZE));
+        strUsage += HelpMessageOpt("-maxmnsigcachesize=<n>", strprintf("Limit the cache of verified masternode message signatures to <n> MiB (default: %u)", DEFAULT_MAX_HASH_SIG_CACHE_SIZE));
         strUsage += HelpMessageOpt("-maxtipage=<n>", strprintf("Maximum tip age in seconds to consider node in initial block download (default: %u)", DEFAULT_MAX_TIP_AGE));
     }
     strUsage += HelpMessageOpt("-maxtxfee=<amt>", strprintf(_("Maximum total fees (in %s) to use in a single wallet transaction or raw transaction; setting this too low may abort large transactions (default: %s)"),
@@ -1123,6 +1139,16 @@ bool AppInitParameterInteraction()
     else if (nScriptCheckThreads > MAX_SCRIPTCHECK_THREADS)
         nScriptCheckThreads = MAX_SCRIPTCHECK_THREADS;
 
+    std::string strCheckPowOnLoad = gArgs.GetArg("-checkpowonload", DEFAULT_CHECKPOWONLOAD);
+    if (strCheckPowOnLoad == "0")
+        nCheckPowOnLoad = POW_LOAD_CHECK_NONE;
+    else if (strCheckPowOnLoad == "1")
+        nCheckPowOnLoad = POW_LOAD_CHECK_WATERMARK;
+    else if (strCheckPowOnLoad == "full")
+        nCheckPowOnLoad = POW_LOAD_CHECK_FULL;
+    else
+        return InitError(strprintf(_("Invalid -checkpowonload value: '%s' (must be 0, 1 or full)"), strCheckPowOnLoad));
+
     // block pruning; get the amount of disk space (in MiB) to allot for block & undo files
     int64_t nPruneArg = gArgs.GetArg("-prune", 0);
     if (nPruneArg < 0) {
@@ -1267,6 +1293,11 @@ bool AppInitSanityChecks()
     // Initialize elliptic curve code
     std::string sha256_algo = SHA256AutoDetect();
     LogPrintf("Using the '%s' SHA256 implementation\n", sha256_algo);
+    std::string hash512_algo = Hash512AutoDetect();
+    LogPrintf("Using the '%s' multi-buffer hash implementation\n", hash512_algo);
+    for (const auto& kernel : PowKernelsAutoDetect()) {
+        LogPrintf("Using the '%s' %s implementation\n", kernel.second, kernel.first);
+    }
     RandomInit();
     ECC_Start();
     globalVerifyHandle.reset(new ECCVerifyHandle());
@@ -1330,11 +1361,17 @@ bool AppInitMain()
 
     InitSignatureCache();
     InitScriptExecutionCache();
+    InitPowCache();
+    PowScratchpadInit(GetMaxAlgoScratchpadSize(), gArgs.GetBoolArg("-powhugepages", DEFAULT_POW_HUGEPAGES));
+    InitHashSigCache();
 
-    LogPrintf("Using %u threads for script verification\n", nScriptCheckThreads);
+    LogPrintf("Using %u threads for script, proof-of-work and masternode message signature verification\n", nScriptCheckThreads);
     if (nScriptCheckThreads) {
-        for (int i=0; i<nScriptCheckThreads-1; i++)
+        for (int i=0; i<nScriptCheckThreads-1; i++) {
             threadGroup.create_thread(&ThreadScriptCheck);
+            threadGroup.create_thread(&ThreadPowCheck);
+            threadGroup.create_thread(&ThreadHashSigCheck);
+        }
     }
 
     // Start the lightweight task scheduler thread
@@ -1366,11 +1403,6 @@ bool AppInitMain()
 
     int64_t nStart;
 
-#if defined(USE_SSE2)
-    std::string sse2detect = scrypt_detect_sse2();
-    LogPrintf("%s\n", sse2detect);
-#endif
-
     // ********************************************************* Step 5: verify wallet database integrity
 #ifdef ENABLE_WALLET
     if (!VerifyWallets())
@@ -1495,6 +1527,7 @@ bool AppInitMain()
 
     pgltNotificationInterface = new CGLTNotificationInterface(connman);
     RegisterValidationInterface(pgltNotificationInterface);
+    RegisterValidationInterface(&algostatstracker);
 
     uint64_t nMaxOutboundLimit = 0; //unlimited unless -maxuploadtarget is set
     uint64_t nMaxOutboundTimeframe = MAX_UPLOAD_TIMEFRAME;
@@ -1524,6 +1557,15 @@ bool AppInitMain()
     LogPrintf("* Using %.1fMiB for block index database\n", nBlockTreeDBCache * (1.0 / 1024 / 1024));
     LogPrintf("* Using %.1fMiB for chain state database\n", nCoinDBCache * (1.0 / 1024 / 1024));
     LogPrintf("* Using %.1fMiB for in-memory UTXO set (plus up to %.1fMiB of unused mempool space)\n", nCoinCacheUsage * (1.0 / 1024 / 1024), nMempoolSizeMax * (1.0 / 1024 / 1024));
+    int64_t nAuxPowCache = gArgs.GetArg("-auxpowcache", DEFAULT_AUXPOW_CACHE_SIZE);
+    nAuxPowCache = std::max(nAuxPowCache, (int64_t)0);
+    nAuxPowCache = std::min(nAuxPowCache, MAX_AUXPOW_CACHE_SIZE);
+    auxpowcache.SetMaxUsage(nAuxPowCache << 20);
+    LogPrintf("* Using %.1fMiB for auxpow header cache\n", nAuxPowCache * 1.0);
+    LogPrintf("* Using %.1fMiB for masternode payee index database\n", DEFAULT_PAYEE_INDEX_CACHE * 1.0);
+
+    ppayeeindex.reset(new CPayeeIndex(DEFAULT_PAYEE_INDEX_CACHE << 20, false, fReindex));
+    RegisterValidationInterface(ppayeeindex.get());
 
     bool fLoaded = false;
     while (!fLoaded && !fRequestShutdown) {
@@ -1881,7 +1923,7 @@ bool AppInitMain()
 
         strDBName = "mncache.dat";
         uiInterface.InitMessage(_("Loading masternode cache..."));
-        CFlatDB<CMasternodeMan> flatdb1(strDBName, "magicMasternodeCache");
+        CFlatDBLog<CMasternodeMan> flatdb1(strDBName, "magicMasternodeCache");
         if(!flatdb1.Load(mnodeman)) {
             return InitError(_("Failed to load masternode cache from") + "\n" + (pathDB / strDBName).string());
         }
@@ -1889,7 +1931,7 @@ bool AppInitMain()
         if(mnodeman.size()) {
             strDBName = "mnpayments.dat";
             uiInterface.InitMessage(_("Loading masternode payment cache..."));
-            CFlatDB<CMasternodePayments> flatdb2(strDBName, "magicMasternodePaymentsCache");
+            CFlatDBLog<CMasternodePayments> flatdb2(strDBName, "magicMasternodePaymentsCache");
             if(!flatdb2.Load(mnpayments)) {
                 return InitError(_("Failed to load masternode payments cache from") + "\n" + (pathDB / strDBName).string());
             }
@@ -1913,10 +1955,13 @@ bool AppInitMain()
     // but don't call it directly to prevent triggering of other listeners like zmq etc.
     // GetMainSignals().UpdatedBlockTip(chainActive.Tip());
     pgltNotificationInterface->InitializeCurrentBlockTip();
+    algostatstracker.InitializeCurrentBlockTip();
+    ppayeeindex->Sync();
     
     // ********************************************************* Step 12d: start globaltoken-helper threads
 
     threadGroup.create_thread(boost::bind(&ThreadCheckMasternodes, boost::ref(*g_connman)));
+    scheduler.scheduleEvery(boost::bind(&ProcessPendingSignedMessages, boost::ref(*g_connman)), PENDING_SIGNED_MESSAGES_INTERVAL);
 
     // ********************************************************* Step 13: start node
 
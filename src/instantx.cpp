@@ -80,7 +80,17 @@ void CInstantSend::ProcessMessage(CNode* pfrom, const std::string& strCommand, C
             if (!ret.second) return;
         }
 
-        ProcessNewTxLockVote(pfrom, vote, connman);
+        // votes of unknown masternodes are left to ProcessNewTxLockVote to deal with
+        std::vector<CHashSigCheck> vChecks;
+        masternode_info_t infoMn;
+        if(mnodeman.GetMasternodeInfo(vote.GetMasternodeOutpoint(), infoMn))
+            vChecks.push_back(vote.GetSignatureCheck(infoMn.pubKeyMasternode));
+
+        bool fBatchDue = pendingMessages.Add(pfrom, vChecks, [this, vote](CNode* pnode, CConnman& connmanIn) {
+            ProcessNewTxLockVote(pnode, vote, connmanIn);
+        });
+        if (fBatchDue)
+            ProcessPendingMessages(connman);
 
         return;
     }
@@ -100,7 +110,7 @@ bool CInstantSend::ProcessTxLockRequest(const CTxLockRequest& txLockRequest, CCo
 
         // Check to see if we conflict with existing completed lock
         for (const auto& txin : txLockRequest.tx->vin) {
-            std::map<COutPoint, uint256>::iterator it = mapLockedOutpoints.find(txin.prevout);
+            auto it = mapLockedOutpoints.find(txin.prevout);
             if(it != mapLockedOutpoints.end() && it->second != txLockRequest.GetHash()) {
                 // Conflicting with complete lock, proceed to see if we should cancel them both
                 LogPrintf("CInstantSend::ProcessTxLockRequest -- WARNING: Found conflicting completed Transaction Lock, txid=%s, completed lock txid=%s\n",
@@ -111,7 +121,7 @@ bool CInstantSend::ProcessTxLockRequest(const CTxLockRequest& txLockRequest, CCo
         // Check to see if there are votes for conflicting request,
         // if so - do not fail, just warn user
         for (const auto& txin : txLockRequest.tx->vin) {
-            std::map<COutPoint, std::set<uint256> >::iterator it = mapVotedOutpoints.find(txin.prevout);
+            auto it = mapVotedOutpoints.find(txin.prevout);
             if(it != mapVotedOutpoints.end()) {
                 for (const auto& hash : it->second) {
                     if(hash != txLockRequest.GetHash()) {
@@ -134,11 +144,11 @@ bool CInstantSend::ProcessTxLockRequest(const CTxLockRequest& txLockRequest, CCo
         // If this just happened - process orphan votes, lock inputs, resolve conflicting locks,
         // update transaction status forcing external script/zmq notifications.
 #ifdef ENABLE_WALLET
-        ProcessOrphanTxLockVotes(pwallet);
+        ProcessOrphanTxLockVotes(txHash, pwallet);
 #else
-        ProcessOrphanTxLockVotes();
+        ProcessOrphanTxLockVotes(txHash);
 #endif
-        std::map<uint256, CTxLockCandidate>::iterator itLockCandidate = mapTxLockCandidates.find(txHash);
+        auto itLockCandidate = mapTxLockCandidates.find(txHash);
 #ifdef ENABLE_WALLET
         TryToFinalizeLockCandidate(itLockCandidate->second, pwallet);
 #else
@@ -158,7 +168,7 @@ bool CInstantSend::CreateTxLockCandidate(const CTxLockRequest& txLockRequest)
 
     uint256 txHash = txLockRequest.GetHash();
 
-    std::map<uint256, CTxLockCandidate>::iterator itLockCandidate = mapTxLockCandidates.find(txHash);
+    auto itLockCandidate = mapTxLockCandidates.find(txHash);
     if(itLockCandidate == mapTxLockCandidates.end()) {
         LogPrintf("CInstantSend::CreateTxLockCandidate -- new, txid=%s\n", txHash.ToString());
 
@@ -269,14 +279,14 @@ void CInstantSend::Vote(CTxLockCandidate& txLockCandidate, CConnman& connman)
 
         LogPrint(BCLog::INSTANTSEND, "CInstantSend::Vote -- In the top %d (%d)\n", nSignaturesTotal, nRank);
 
-        std::map<COutPoint, std::set<uint256> >::iterator itVoted = mapVotedOutpoints.find(itOutpointLock->first);
+        auto itVoted = mapVotedOutpoints.find(itOutpointLock->first);
 
         // Check to see if we already voted for this outpoint,
         // refuse to vote twice or to include the same outpoint in another tx
         bool fAlreadyVoted = false;
         if(itVoted != mapVotedOutpoints.end()) {
             for (const auto& hash : itVoted->second) {
-                std::map<uint256, CTxLockCandidate>::iterator it2 = mapTxLockCandidates.find(hash);
+                auto it2 = mapTxLockCandidates.find(hash);
                 if(it2->second.HasMasternodeVoted(itOutpointLock->first, activeMasternode.outpoint)) {
                     // we already voted for this outpoint to be included either in the same tx or in a competing one,
                     // skip it anyway
@@ -307,7 +317,7 @@ void CInstantSend::Vote(CTxLockCandidate& txLockCandidate, CConnman& connman)
         // vote constructed sucessfully, let's store and relay it
         uint256 nVoteHash = vote.GetHash();
         mapTxLockVotes.insert(std::make_pair(nVoteHash, vote));
-        if(itOutpointLock->second.AddVote(vote)) {
+        if(txLockCandidate.AddVote(vote)) {
             LogPrintf("CInstantSend::Vote -- Vote created successfully, relaying: txHash=%s, outpoint=%s, vote=%s\n",
                     txHash.ToString(), itOutpointLock->first.ToStringShort(), nVoteHash.ToString());
 
@@ -355,14 +365,14 @@ bool CInstantSend::ProcessNewTxLockVote(CNode* pfrom, const CTxLockVote& vote, C
         // Masternodes will sometimes propagate votes before the transaction is known to the client,
         // will actually process only after the lock request itself has arrived
 
-        std::map<uint256, CTxLockCandidate>::iterator it = mapTxLockCandidates.find(txHash);
+        auto it = mapTxLockCandidates.find(txHash);
         if(it == mapTxLockCandidates.end() || !it->second.txLockRequest) {
             // no or empty tx lock candidate
             if(it == mapTxLockCandidates.end()) {
                 // start timeout countdown after the very first vote
                 CreateEmptyTxLockCandidate(txHash);
             }
-            bool fInserted = mapTxLockVotesOrphan.emplace(nVoteHash, vote).second;
+            bool fInserted = AddOrphanTxLockVote(nVoteHash, vote);
             LogPrint(BCLog::INSTANTSEND, "CInstantSend::%s -- Orphan vote: txid=%s  masternode=%s %s\n",
                     __func__, txHash.ToString(), vote.GetMasternodeOutpoint().ToStringShort(), fInserted ? "new" : "seen");
 
@@ -373,6 +383,7 @@ bool CInstantSend::ProcessNewTxLockVote(CNode* pfrom, const CTxLockVote& vote, C
             auto itMnOV = mapMasternodeOrphanVotes.find(vote.GetMasternodeOutpoint());
             if(itMnOV == mapMasternodeOrphanVotes.end()) {
                 mapMasternodeOrphanVotes.emplace(vote.GetMasternodeOutpoint(), nMasternodeOrphanExpireTime);
+                nMasternodeOrphanVoteTimeTotal += nMasternodeOrphanExpireTime;
             } else {
                 if(itMnOV->second > GetTime() && itMnOV->second > GetAverageMasternodeOrphanVoteTime()) {
                     LogPrint(BCLog::INSTANTSEND, "CInstantSend::%s -- masternode is spamming orphan Transaction Lock Votes: txid=%s  masternode=%s\n",
@@ -381,6 +392,7 @@ bool CInstantSend::ProcessNewTxLockVote(CNode* pfrom, const CTxLockVote& vote, C
                     return false;
                 }
                 // not spamming, refresh
+                nMasternodeOrphanVoteTimeTotal += nMasternodeOrphanExpireTime - itMnOV->second;
                 itMnOV->second = nMasternodeOrphanExpireTime;
             }
 
@@ -437,7 +449,7 @@ bool CInstantSend::ProcessOrphanTxLockVote(const CTxLockVote& vote)
     uint256 txHash = vote.GetTxHash();
 
     // We shouldn't process orphan votes without a valid tx lock candidate
-    std::map<uint256, CTxLockCandidate>::iterator it = mapTxLockCandidates.find(txHash);
+    auto it = mapTxLockCandidates.find(txHash);
     if(it == mapTxLockCandidates.end() || !it->second.txLockRequest)
         return false; // this shouldn never happen
 
@@ -471,14 +483,14 @@ void CInstantSend::UpdateVotedOutpoints(const CTxLockVote& vote, CTxLockCandidat
 
     uint256 txHash = vote.GetTxHash();
 
-    std::map<COutPoint, std::set<uint256> >::iterator it1 = mapVotedOutpoints.find(vote.GetOutpoint());
+    auto it1 = mapVotedOutpoints.find(vote.GetOutpoint());
     if(it1 != mapVotedOutpoints.end()) {
         for (const auto& hash : it1->second) {
             if(hash != txHash) {
                 // same outpoint was already voted to be locked by another tx lock request,
                 // let's see if it was the same masternode who voted on this outpoint
                 // for another tx lock request
-                std::map<uint256, CTxLockCandidate>::iterator it2 = mapTxLockCandidates.find(hash);
+                auto it2 = mapTxLockCandidates.find(hash);
                 if(it2 !=mapTxLockCandidates.end() && it2->second.HasMasternodeVoted(vote.GetOutpoint(), vote.GetMasternodeOutpoint())) {
                     // yes, it was the same masternode
                     LogPrintf("CInstantSend::%s -- masternode sent conflicting votes! %s\n", __func__, vote.GetMasternodeOutpoint().ToStringShort());
@@ -502,27 +514,56 @@ void CInstantSend::UpdateVotedOutpoints(const CTxLockVote& vote, CTxLockCandidat
     }
 }
 
+bool CInstantSend::AddOrphanTxLockVote(const uint256& nVoteHash, const CTxLockVote& vote)
+{
+    AssertLockHeld(cs_instantsend);
+
+    if(!mapTxLockVotesOrphan.emplace(nVoteHash, vote).second) return false;
+    mapTxLockVotesOrphanByTx[vote.GetTxHash()].insert(nVoteHash);
+    return true;
+}
+
+void CInstantSend::RemoveOrphanTxLockVote(const uint256& nVoteHash, const uint256& txHash)
+{
+    AssertLockHeld(cs_instantsend);
+
+    mapTxLockVotesOrphan.erase(nVoteHash);
+    auto it = mapTxLockVotesOrphanByTx.find(txHash);
+    if(it == mapTxLockVotesOrphanByTx.end()) return;
+    it->second.erase(nVoteHash);
+    if(it->second.empty()) {
+        mapTxLockVotesOrphanByTx.erase(it);
+    }
+}
+
 #ifdef ENABLE_WALLET
-void CInstantSend::ProcessOrphanTxLockVotes(CWallet *wallet)
+void CInstantSend::ProcessOrphanTxLockVotes(const uint256& txHash, CWallet *wallet)
 #else
-void CInstantSend::ProcessOrphanTxLockVotes()
+void CInstantSend::ProcessOrphanTxLockVotes(const uint256& txHash)
 #endif
 {
     AssertLockHeld(cs_main);
     AssertLockHeld(cs_instantsend);
 
-    std::map<uint256, CTxLockVote>::iterator it = mapTxLockVotesOrphan.begin();
-    while(it != mapTxLockVotesOrphan.end()) {
+    // Only the votes for this tx can have become processable
+    auto itByTx = mapTxLockVotesOrphanByTx.find(txHash);
+    if(itByTx == mapTxLockVotesOrphanByTx.end()) return;
+
+    std::vector<uint256> vecProcessed;
+    for (const auto& nVoteHash : itByTx->second) {
+        auto it = mapTxLockVotesOrphan.find(nVoteHash);
+        if(it == mapTxLockVotesOrphan.end()) continue;
 #ifdef ENABLE_WALLET
         if(ProcessOrphanTxLockVote(it->second, wallet)) {
 #else
         if(ProcessOrphanTxLockVote(it->second)) {
 #endif
-            mapTxLockVotesOrphan.erase(it++);
-        } else {
-            ++it;
+            vecProcessed.push_back(nVoteHash);
         }
     }
+    for (const auto& nVoteHash : vecProcessed) {
+        RemoveOrphanTxLockVote(nVoteHash, txHash);
+    }
 }
 
 #ifdef ENABLE_WALLET
@@ -621,7 +662,7 @@ void CInstantSend::LockTransactionInputs(const CTxLockCandidate& txLockCandidate
 bool CInstantSend::GetLockedOutPointTxHash(const COutPoint& outpoint, uint256& hashRet)
 {
     LOCK(cs_instantsend);
-    std::map<COutPoint, uint256>::iterator it = mapLockedOutpoints.find(outpoint);
+    auto it = mapLockedOutpoints.find(outpoint);
     if(it == mapLockedOutpoints.end()) return false;
     hashRet = it->second;
     return true;
@@ -644,8 +685,8 @@ bool CInstantSend::ResolveConflicts(const CTxLockCandidate& txLockCandidate)
         if(GetLockedOutPointTxHash(txin.prevout, hashConflicting) && txHash != hashConflicting) {
             // completed lock which conflicts with another completed one?
             // this means that majority of MNs in the quorum for this specific tx input are malicious!
-            std::map<uint256, CTxLockCandidate>::iterator itLockCandidate = mapTxLockCandidates.find(txHash);
-            std::map<uint256, CTxLockCandidate>::iterator itLockCandidateConflicting = mapTxLockCandidates.find(hashConflicting);
+            auto itLockCandidate = mapTxLockCandidates.find(txHash);
+            auto itLockCandidateConflicting = mapTxLockCandidates.find(hashConflicting);
             if(itLockCandidate == mapTxLockCandidates.end() || itLockCandidateConflicting == mapTxLockCandidates.end()) {
                 // safety check, should never really happen
                 LogPrintf("CInstantSend::ResolveConflicts -- ERROR: Found conflicting completed Transaction Lock, but one of txLockCandidate-s is missing, txid=%s, conflicting txid=%s\n",
@@ -709,15 +750,7 @@ int64_t CInstantSend::GetAverageMasternodeOrphanVoteTime()
     // NOTE: should never actually call this function when mapMasternodeOrphanVotes is empty
     if(mapMasternodeOrphanVotes.empty()) return 0;
 
-    std::map<COutPoint, int64_t>::iterator it = mapMasternodeOrphanVotes.begin();
-    int64_t total = 0;
-
-    while(it != mapMasternodeOrphanVotes.end()) {
-        total+= it->second;
-        ++it;
-    }
-
-    return total / mapMasternodeOrphanVotes.size();
+    return nMasternodeOrphanVoteTimeTotal / (int64_t)mapMasternodeOrphanVotes.size();
 }
 
 void CInstantSend::CheckAndRemove()
@@ -726,7 +759,7 @@ void CInstantSend::CheckAndRemove()
 
     LOCK(cs_instantsend);
 
-    std::map<uint256, CTxLockCandidate>::iterator itLockCandidate = mapTxLockCandidates.begin();
+    auto itLockCandidate = mapTxLockCandidates.begin();
 
     // remove expired candidates
     while(itLockCandidate != mapTxLockCandidates.end()) {
@@ -749,7 +782,7 @@ void CInstantSend::CheckAndRemove()
     }
 
     // remove expired votes
-    std::map<uint256, CTxLockVote>::iterator itVote = mapTxLockVotes.begin();
+    auto itVote = mapTxLockVotes.begin();
     while(itVote != mapTxLockVotes.end()) {
         if(itVote->second.IsExpired(nCachedBlockHeight)) {
             LogPrint(BCLog::INSTANTSEND, "CInstantSend::CheckAndRemove -- Removing expired vote: txid=%s  masternode=%s\n",
@@ -761,13 +794,17 @@ void CInstantSend::CheckAndRemove()
     }
 
     // remove timed out orphan votes
-    std::map<uint256, CTxLockVote>::iterator itOrphanVote = mapTxLockVotesOrphan.begin();
+    auto itOrphanVote = mapTxLockVotesOrphan.begin();
     while(itOrphanVote != mapTxLockVotesOrphan.end()) {
-        if(itOrphanVote->second.IsTimedOut()) {
+        const CTxLockVote& vote = itOrphanVote->second;
+        if(vote.IsTimedOut()) {
             LogPrint(BCLog::INSTANTSEND, "CInstantSend::CheckAndRemove -- Removing timed out orphan vote: txid=%s  masternode=%s\n",
-                    itOrphanVote->second.GetTxHash().ToString(), itOrphanVote->second.GetMasternodeOutpoint().ToStringShort());
-            mapTxLockVotes.erase(itOrphanVote->first);
-            mapTxLockVotesOrphan.erase(itOrphanVote++);
+                    vote.GetTxHash().ToString(), vote.GetMasternodeOutpoint().ToStringShort());
+            uint256 nVoteHash = itOrphanVote->first;
+            uint256 txHash = vote.GetTxHash();
+            ++itOrphanVote;
+            mapTxLockVotes.erase(nVoteHash);
+            RemoveOrphanTxLockVote(nVoteHash, txHash);
         } else {
             ++itOrphanVote;
         }
@@ -786,11 +823,12 @@ void CInstantSend::CheckAndRemove()
     }
 
     // remove timed out masternode orphan votes (DOS protection)
-    std::map<COutPoint, int64_t>::iterator itMasternodeOrphan = mapMasternodeOrphanVotes.begin();
+    auto itMasternodeOrphan = mapMasternodeOrphanVotes.begin();
     while(itMasternodeOrphan != mapMasternodeOrphanVotes.end()) {
         if(itMasternodeOrphan->second < GetTime()) {
             LogPrint(BCLog::INSTANTSEND, "CInstantSend::CheckAndRemove -- Removing timed out orphan masternode vote: masternode=%s\n",
                     itMasternodeOrphan->first.ToStringShort());
+            nMasternodeOrphanVoteTimeTotal -= itMasternodeOrphan->second;
             mapMasternodeOrphanVotes.erase(itMasternodeOrphan++);
         } else {
             ++itMasternodeOrphan;
@@ -829,7 +867,7 @@ bool CInstantSend::GetTxLockRequest(const uint256& txHash, CTxLockRequest& txLoc
 {
     LOCK(cs_instantsend);
 
-    std::map<uint256, CTxLockCandidate>::iterator it = mapTxLockCandidates.find(txHash);
+    auto it = mapTxLockCandidates.find(txHash);
     if(it == mapTxLockCandidates.end() || !it->second.txLockRequest) return false;
     txLockRequestRet = it->second.txLockRequest;
 
@@ -840,7 +878,7 @@ bool CInstantSend::GetTxLockVote(const uint256& hash, CTxLockVote& txLockVoteRet
 {
     LOCK(cs_instantsend);
 
-    std::map<uint256, CTxLockVote>::iterator it = mapTxLockVotes.find(hash);
+    auto it = mapTxLockVotes.find(hash);
     if(it == mapTxLockVotes.end()) return false;
     txLockVoteRet = it->second;
 
@@ -855,7 +893,7 @@ bool CInstantSend::IsInstantSendReadyToLock(const uint256& txHash)
     LOCK(cs_instantsend);
     // There must be a successfully verified lock request
     // and all outputs must be locked (i.e. have enough signatures)
-    std::map<uint256, CTxLockCandidate>::iterator it = mapTxLockCandidates.find(txHash);
+    auto it = mapTxLockCandidates.find(txHash);
     return it != mapTxLockCandidates.end() && it->second.IsAllOutPointsReady();
 }
 
@@ -867,7 +905,7 @@ bool CInstantSend::IsLockedInstantSendTransaction(const uint256& txHash)
     LOCK(cs_instantsend);
 
     // there must be a lock candidate
-    std::map<uint256, CTxLockCandidate>::iterator itLockCandidate = mapTxLockCandidates.find(txHash);
+    auto itLockCandidate = mapTxLockCandidates.find(txHash);
     if(itLockCandidate == mapTxLockCandidates.end()) return false;
 
     // which should have outpoints
@@ -892,7 +930,7 @@ int CInstantSend::GetTransactionLockSignatures(const uint256& txHash)
 
     LOCK(cs_instantsend);
 
-    std::map<uint256, CTxLockCandidate>::iterator itLockCandidate = mapTxLockCandidates.find(txHash);
+    auto itLockCandidate = mapTxLockCandidates.find(txHash);
     if(itLockCandidate != mapTxLockCandidates.end()) {
         return itLockCandidate->second.CountVotes();
     }
@@ -913,7 +951,7 @@ bool CInstantSend::IsTxLockCandidateTimedOut(const uint256& txHash)
 
     LOCK(cs_instantsend);
 
-    std::map<uint256, CTxLockCandidate>::iterator itLockCandidate = mapTxLockCandidates.find(txHash);
+    auto itLockCandidate = mapTxLockCandidates.find(txHash);
     if (itLockCandidate != mapTxLockCandidates.end()) {
         return !itLockCandidate->second.IsAllOutPointsReady() &&
                 itLockCandidate->second.IsTimedOut();
@@ -926,7 +964,7 @@ void CInstantSend::Relay(const uint256& txHash, CConnman& connman)
 {
     LOCK(cs_instantsend);
 
-    std::map<uint256, CTxLockCandidate>::const_iterator itLockCandidate = mapTxLockCandidates.find(txHash);
+    auto itLockCandidate = mapTxLockCandidates.find(txHash);
     if (itLockCandidate != mapTxLockCandidates.end()) {
         itLockCandidate->second.Relay(connman);
     }
@@ -957,7 +995,7 @@ void CInstantSend::SyncTransaction(const CTransactionRef& ptx, const CBlockIndex
     LogPrint(BCLog::INSTANTSEND, "CInstantSend::SyncTransaction -- txid=%s nHeightNew=%d\n", txHash.ToString(), nHeightNew);
 
     // Check lock candidates
-    std::map<uint256, CTxLockCandidate>::iterator itLockCandidate = mapTxLockCandidates.find(txHash);
+    auto itLockCandidate = mapTxLockCandidates.find(txHash);
     if(itLockCandidate != mapTxLockCandidates.end()) {
         LogPrint(BCLog::INSTANTSEND, "CInstantSend::SyncTransaction -- txid=%s nHeightNew=%d lock candidate updated\n",
                 txHash.ToString(), nHeightNew);
@@ -968,12 +1006,11 @@ void CInstantSend::SyncTransaction(const CTransactionRef& ptx, const CBlockIndex
             // Check corresponding lock votes
             std::vector<CTxLockVote> vVotes = itOutpointLock->second.GetVotes();
             std::vector<CTxLockVote>::iterator itVote = vVotes.begin();
-            std::map<uint256, CTxLockVote>::iterator it;
             while(itVote != vVotes.end()) {
                 uint256 nVoteHash = itVote->GetHash();
                 LogPrint(BCLog::INSTANTSEND, "CInstantSend::SyncTransaction -- txid=%s nHeightNew=%d vote %s updated\n",
                         txHash.ToString(), nHeightNew, nVoteHash.ToString());
-                it = mapTxLockVotes.find(nVoteHash);
+                auto it = mapTxLockVotes.find(nVoteHash);
                 if(it != mapTxLockVotes.end()) {
                     it->second.SetConfirmedHeight(nHeightNew);
                 }
@@ -984,14 +1021,13 @@ void CInstantSend::SyncTransaction(const CTransactionRef& ptx, const CBlockIndex
     }
 
     // check orphan votes
-    std::map<uint256, CTxLockVote>::iterator itOrphanVote = mapTxLockVotesOrphan.begin();
-    while(itOrphanVote != mapTxLockVotesOrphan.end()) {
-        if(itOrphanVote->second.GetTxHash() == txHash) {
+    auto itOrphanVotes = mapTxLockVotesOrphanByTx.find(txHash);
+    if(itOrphanVotes != mapTxLockVotesOrphanByTx.end()) {
+        for (const auto& nVoteHash : itOrphanVotes->second) {
             LogPrint(BCLog::INSTANTSEND, "CInstantSend::SyncTransaction -- txid=%s nHeightNew=%d vote %s updated\n",
-                    txHash.ToString(), nHeightNew, itOrphanVote->first.ToString());
-            mapTxLockVotes[itOrphanVote->first].SetConfirmedHeight(nHeightNew);
+                    txHash.ToString(), nHeightNew, nVoteHash.ToString());
+            mapTxLockVotes[nVoteHash].SetConfirmedHeight(nHeightNew);
         }
-        ++itOrphanVote;
     }
 }
 
@@ -1125,6 +1161,11 @@ uint256 CTxLockVote::GetSignatureHash() const
     return GetHash();
 }
 
+std::string CTxLockVote::GetSignatureMessage() const
+{
+    return txHash.ToString() + outpoint.ToStringShort();
+}
+
 bool CTxLockVote::CheckSignature() const
 {
     std::string strError;
@@ -1141,7 +1182,7 @@ bool CTxLockVote::CheckSignature() const
 
         if (!CHashSigner::VerifyHash(hash, infoMn.pubKeyMasternode, vchMasternodeSignature, strError)) {
             // could be a signature in old format
-            std::string strMessage = txHash.ToString() + outpoint.ToStringShort();
+            std::string strMessage = GetSignatureMessage();
             if(!CMessageSigner::VerifyMessage(infoMn.pubKeyMasternode, vchMasternodeSignature, strMessage, strError)) {
                 // nope, not in old format either
                 LogPrintf("CTxLockVote::CheckSignature -- VerifyMessage() failed, error: %s\n", strError);
@@ -1149,7 +1190,7 @@ bool CTxLockVote::CheckSignature() const
             }
         }
     } else {
-        std::string strMessage = txHash.ToString() + outpoint.ToStringShort();
+        std::string strMessage = GetSignatureMessage();
         if(!CMessageSigner::VerifyMessage(infoMn.pubKeyMasternode, vchMasternodeSignature, strMessage, strError)) {
             LogPrintf("CTxLockVote::CheckSignature -- VerifyMessage() failed, error: %s\n", strError);
             return false;
@@ -1176,7 +1217,7 @@ bool CTxLockVote::Sign()
             return false;
         }
     } else {
-        std::string strMessage = txHash.ToString() + outpoint.ToStringShort();
+        std::string strMessage = GetSignatureMessage();
 
         if(!CMessageSigner::SignMessage(strMessage, vchMasternodeSignature, activeMasternode.keyMasternode)) {
             LogPrintf("CTxLockVote::Sign -- SignMessage() failed\n");
@@ -1192,6 +1233,14 @@ bool CTxLockVote::Sign()
     return true;
 }
 
+CHashSigCheck CTxLockVote::GetSignatureCheck(const CPubKey& pubKeyMasternode) const
+{
+    if (sporkManager.IsSporkActive(SPORK_4_NEW_SIGS))
+        return CHashSigCheck(GetSignatureHash(), pubKeyMasternode.GetID(), vchMasternodeSignature);
+
+    return CHashSigCheck(CMessageSigner::GetMessageHash(GetSignatureMessage()), pubKeyMasternode.GetID(), vchMasternodeSignature);
+}
+
 void CTxLockVote::Relay(CConnman& connman) const
 {
     CInv inv(MSG_TXLOCK_VOTE, GetHash());
@@ -1263,27 +1312,26 @@ void CTxLockCandidate::AddOutPointLock(const COutPoint& outpoint)
 void CTxLockCandidate::MarkOutpointAsAttacked(const COutPoint& outpoint)
 {
     std::map<COutPoint, COutPointLock>::iterator it = mapOutPointLocks.find(outpoint);
-    if(it != mapOutPointLocks.end())
-        it->second.MarkAsAttacked();
+    if(it == mapOutPointLocks.end() || it->second.IsAttacked()) return;
+    nVotes -= it->second.CountVotes();
+    if(it->second.IsReady()) nReadyOutPointLocks--;
+    it->second.MarkAsAttacked();
 }
 
 bool CTxLockCandidate::AddVote(const CTxLockVote& vote)
 {
     std::map<COutPoint, COutPointLock>::iterator it = mapOutPointLocks.find(vote.GetOutpoint());
     if(it == mapOutPointLocks.end()) return false;
-    return it->second.AddVote(vote);
+    bool fWasReady = it->second.IsReady();
+    if(!it->second.AddVote(vote)) return false;
+    if(!it->second.IsAttacked()) nVotes++;
+    if(!fWasReady && it->second.IsReady()) nReadyOutPointLocks++;
+    return true;
 }
 
 bool CTxLockCandidate::IsAllOutPointsReady() const
 {
-    if(mapOutPointLocks.empty()) return false;
-
-    std::map<COutPoint, COutPointLock>::const_iterator it = mapOutPointLocks.begin();
-    while(it != mapOutPointLocks.end()) {
-        if(!it->second.IsReady()) return false;
-        ++it;
-    }
-    return true;
+    return !mapOutPointLocks.empty() && nReadyOutPointLocks == (int)mapOutPointLocks.size();
 }
 
 bool CTxLockCandidate::HasMasternodeVoted(const COutPoint& outpointIn, const COutPoint& outpointMasternodeIn)
@@ -1292,18 +1340,6 @@ bool CTxLockCandidate::HasMasternodeVoted(const COutPoint& outpointIn, const COu
     return it !=mapOutPointLocks.end() && it->second.HasMasternodeVoted(outpointMasternodeIn);
 }
 
-int CTxLockCandidate::CountVotes() const
-{
-    // Note: do NOT use vote count to figure out if tx is locked, use IsAllOutPointsReady() instead
-    int nCountVotes = 0;
-    std::map<COutPoint, COutPointLock>::const_iterator it = mapOutPointLocks.begin();
-    while(it != mapOutPointLocks.end()) {
-        nCountVotes += it->second.CountVotes();
-        ++it;
-    }
-    return nCountVotes;
-}
-
 bool CTxLockCandidate::IsExpired(int nHeight) const
 {
     // Locks and votes expire nInstantSendKeepLock blocks after the block corresponding tx was included into.
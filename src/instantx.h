@@ -5,8 +5,13 @@
 #define INSTANTX_H
 
 #include <chain.h>
+#include <coins.h>
+#include <messagesigner.h>
 #include <net.h>
 #include <primitives/transaction.h>
+#include <txmempool.h>
+
+#include <unordered_map>
 
 #ifdef ENABLE_WALLET
 #include <wallet/wallet.h>
@@ -61,18 +66,21 @@ private:
     int nCachedBlockHeight;
 
     // maps for AlreadyHave
-    std::map<uint256, CTxLockRequest> mapLockRequestAccepted; ///< Tx hash - Tx
-    std::map<uint256, CTxLockRequest> mapLockRequestRejected; ///< Tx hash - Tx
-    std::map<uint256, CTxLockVote> mapTxLockVotes; ///< Vote hash - Vote
-    std::map<uint256, CTxLockVote> mapTxLockVotesOrphan; ///< Vote hash - Vote
+    std::unordered_map<uint256, CTxLockRequest, SaltedTxidHasher> mapLockRequestAccepted; ///< Tx hash - Tx
+    std::unordered_map<uint256, CTxLockRequest, SaltedTxidHasher> mapLockRequestRejected; ///< Tx hash - Tx
+    std::unordered_map<uint256, CTxLockVote, SaltedTxidHasher> mapTxLockVotes; ///< Vote hash - Vote
+    std::unordered_map<uint256, CTxLockVote, SaltedTxidHasher> mapTxLockVotesOrphan; ///< Vote hash - Vote
+    std::unordered_map<uint256, std::set<uint256>, SaltedTxidHasher> mapTxLockVotesOrphanByTx; ///< Tx hash - Orphan vote hash set
 
-    std::map<uint256, CTxLockCandidate> mapTxLockCandidates; ///< Tx hash - Lock candidate
+    std::unordered_map<uint256, CTxLockCandidate, SaltedTxidHasher> mapTxLockCandidates; ///< Tx hash - Lock candidate
 
-    std::map<COutPoint, std::set<uint256> > mapVotedOutpoints; ///< UTXO - Tx hash set
-    std::map<COutPoint, uint256> mapLockedOutpoints; ///< UTXO - Tx hash
+    std::unordered_map<COutPoint, std::set<uint256>, SaltedOutpointHasher> mapVotedOutpoints; ///< UTXO - Tx hash set
+    std::unordered_map<COutPoint, uint256, SaltedOutpointHasher> mapLockedOutpoints; ///< UTXO - Tx hash
 
     /// Track masternodes who voted with no txlockrequest (for DOS protection)
-    std::map<COutPoint, int64_t> mapMasternodeOrphanVotes; ///< MN outpoint - Time
+    std::unordered_map<COutPoint, int64_t, SaltedOutpointHasher> mapMasternodeOrphanVotes; ///< MN outpoint - Time
+    /// Sum of the times in mapMasternodeOrphanVotes
+    int64_t nMasternodeOrphanVoteTimeTotal;
 
     bool CreateTxLockCandidate(const CTxLockRequest& txLockRequest);
     void CreateEmptyTxLockCandidate(const uint256& txHash);
@@ -84,11 +92,13 @@ private:
     void UpdateVotedOutpoints(const CTxLockVote& vote, CTxLockCandidate& txLockCandidate);
 #ifdef ENABLE_WALLET
     bool ProcessOrphanTxLockVote(const CTxLockVote& vote, CWallet *wallet);
-    void ProcessOrphanTxLockVotes(CWallet *wallet);
+    void ProcessOrphanTxLockVotes(const uint256& txHash, CWallet *wallet);
 #else
     bool ProcessOrphanTxLockVote(const CTxLockVote& vote);
-    void ProcessOrphanTxLockVotes();
+    void ProcessOrphanTxLockVotes(const uint256& txHash);
 #endif
+    bool AddOrphanTxLockVote(const uint256& nVoteHash, const CTxLockVote& vote);
+    void RemoveOrphanTxLockVote(const uint256& nVoteHash, const uint256& txHash);
     int64_t GetAverageMasternodeOrphanVoteTime();
 
 #ifdef ENABLE_WALLET
@@ -107,10 +117,17 @@ private:
 
     bool IsInstantSendReadyToLock(const uint256 &txHash);
 
+    /// Votes waiting for their signatures to be verified in a batch
+    CPendingSigMessages pendingMessages;
+
 public:
     CCriticalSection cs_instantsend;
 
+    CInstantSend() : nCachedBlockHeight(0), nMasternodeOrphanVoteTimeTotal(0) {}
+
     void ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStream& vRecv, CConnman& connman);
+    /// Verify the signatures of the queued votes in a batch and process them
+    void ProcessPendingMessages(CConnman& connman) { pendingMessages.Process(connman); }
 
     bool ProcessTxLockRequest(const CTxLockRequest& txLockRequest, CConnman& connman);
     void Vote(const uint256& txHash, CConnman& connman);
@@ -250,6 +267,8 @@ public:
 
     uint256 GetHash() const;
     uint256 GetSignatureHash() const;
+    /// The message signed before SPORK_4_NEW_SIGS
+    std::string GetSignatureMessage() const;
 
     uint256 GetTxHash() const { return txHash; }
     COutPoint GetOutpoint() const { return outpoint; }
@@ -263,6 +282,8 @@ public:
 
     bool Sign();
     bool CheckSignature() const;
+    /// The check CheckSignature starts with, to verify ahead of it in a batch
+    CHashSigCheck GetSignatureCheck(const CPubKey& pubKeyMasternode) const;
 
     void Relay(CConnman& connman) const;
 };
@@ -293,6 +314,7 @@ public:
     bool HasMasternodeVoted(const COutPoint& outpointMasternodeIn) const;
     int CountVotes() const { return fAttacked ? 0 : mapMasternodeVotes.size(); }
     bool IsReady() const { return !fAttacked && CountVotes() >= SIGNATURES_REQUIRED; }
+    bool IsAttacked() const { return fAttacked; }
     void MarkAsAttacked() { fAttacked = true; }
 
     void Relay(CConnman& connman) const;
@@ -306,16 +328,23 @@ class CTxLockCandidate
 private:
     int nConfirmedHeight; ///<When corresponding tx is 0-confirmed or conflicted, nConfirmedHeight is -1
     int64_t nTimeCreated;
+    /// Votes on outpoints that are not attacked, kept up to date by AddVote and MarkOutpointAsAttacked
+    int nVotes;
+    /// Outpoint locks that are ready
+    int nReadyOutPointLocks;
 
 public:
     CTxLockCandidate(const CTxLockRequest& txLockRequestIn) :
         nConfirmedHeight(-1),
         nTimeCreated(GetTime()),
+        nVotes(0),
+        nReadyOutPointLocks(0),
         txLockRequest(txLockRequestIn),
         mapOutPointLocks()
         {}
 
     CTxLockRequest txLockRequest;
+    /// Only modify through AddOutPointLock, MarkOutpointAsAttacked and AddVote to keep the vote counters in sync
     std::map<COutPoint, COutPointLock> mapOutPointLocks;
 
     uint256 GetHash() const { return txLockRequest.GetHash(); }
@@ -326,7 +355,8 @@ public:
     bool IsAllOutPointsReady() const;
 
     bool HasMasternodeVoted(const COutPoint& outpointIn, const COutPoint& outpointMasternodeIn);
-    int CountVotes() const;
+    /// Note: do NOT use vote count to figure out if tx is locked, use IsAllOutPointsReady() instead
+    int CountVotes() const { return nVotes; }
 
     void SetConfirmedHeight(int nConfirmedHeightIn) { nConfirmedHeight = nConfirmedHeightIn; }
     bool IsExpired(int nHeight) const;
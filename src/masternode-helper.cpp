@@ -12,6 +12,7 @@
 #include <masternode-sync.h>
 #include <masternodeman.h>
 #include <netfulfilledman.h>
+#include <spork.h>
 
 void ThreadCheckMasternodes(CConnman& connman)
 {
@@ -61,4 +62,14 @@ void ThreadCheckMasternodes(CConnman& connman)
             }
         }
     }
-}
\ No newline at end of file
+}
+
+void ProcessPendingSignedMessages(CConnman& connman)
+{
+    if(fLiteMode || ShutdownRequested()) return;
+
+    mnodeman.ProcessPendingMessages(connman);
+    mnpayments.ProcessPendingMessages(connman);
+    instantsend.ProcessPendingMessages(connman);
+    sporkManager.ProcessPendingMessages(connman);
+}
@@ -6,8 +6,15 @@
 #ifndef MASTERNODE_HELPER_H
 #define MASTERNODE_HELPER_H
 
+#include <stdint.h>
+
 class CConnman;
 
+/** Milliseconds between runs of ProcessPendingSignedMessages */
+static const int64_t PENDING_SIGNED_MESSAGES_INTERVAL = 100;
+
 void ThreadCheckMasternodes(CConnman& connman);
+/** Verify and finish the masternode messages still waiting for their signatures, see CPendingSigMessages */
+void ProcessPendingSignedMessages(CConnman& connman);
 
 #endif // MASTERNODE_HELPER_H
\ No newline at end of file
@@ -63,6 +63,8 @@ void CMasternodePayments::Clear()
     LOCK2(cs_mapMasternodeBlocks, cs_mapMasternodePaymentVotes);
     mapMasternodeBlocks.clear();
     mapMasternodePaymentVotes.clear();
+    changesMasternodePaymentVotes.SetAllChanged();
+    changesMasternodeBlocks.SetAllChanged();
 }
 
 bool CMasternodePayments::UpdateLastVote(const CMasternodePaymentVote& vote)
@@ -223,40 +225,49 @@ void CMasternodePayments::ProcessMessage(CNode* pfrom, const std::string& strCom
             return;
         }
 
-        int nDos = 0;
-        if(!vote.CheckSignature(mnInfo.pubKeyMasternode, nCachedBlockHeight, nDos)) {
-            if(nDos) {
-                LOCK(cs_main);
-                LogPrintf("MASTERNODEPAYMENTVOTE -- ERROR: invalid signature\n");
-                Misbehaving(pfrom->GetId(), nDos);
-            } else {
-                // only warn about anything non-critical (i.e. nDos == 0) in debug mode
-                LogPrint(BCLog::MNPAYMENTS, "MASTERNODEPAYMENTVOTE -- WARNING: invalid signature\n");
+        std::vector<CHashSigCheck> vChecks;
+        vChecks.push_back(vote.GetSignatureCheck(mnInfo.pubKeyMasternode));
+
+        bool fBatchDue = pendingMessages.Add(pfrom, vChecks, [this, vote, nHash, mnInfo](CNode* pnode, CConnman& connmanIn) {
+            // the same vote may have been queued twice before either was verified
+            if(HasVerifiedPaymentVote(nHash)) return;
+
+            int nDos = 0;
+            if(!vote.CheckSignature(mnInfo.pubKeyMasternode, nCachedBlockHeight, nDos)) {
+                if(nDos) {
+                    LOCK(cs_main);
+                    LogPrintf("MASTERNODEPAYMENTVOTE -- ERROR: invalid signature\n");
+                    Misbehaving(pnode->GetId(), nDos);
+                } else {
+                    // only warn about anything non-critical (i.e. nDos == 0) in debug mode
+                    LogPrint(BCLog::MNPAYMENTS, "MASTERNODEPAYMENTVOTE -- WARNING: invalid signature\n");
+                }
+                // Either our info or vote info could be outdated.
+                // In case our info is outdated, ask for an update,
+                mnodeman.AskForMN(pnode, vote.masternodeOutpoint, connmanIn);
+                // but there is nothing we can do if vote info itself is outdated
+                // (i.e. it was signed by a mn which changed its key),
+                // so just quit here.
+                return;
             }
-            // Either our info or vote info could be outdated.
-            // In case our info is outdated, ask for an update,
-            mnodeman.AskForMN(pfrom, vote.masternodeOutpoint, connman);
-            // but there is nothing we can do if vote info itself is outdated
-            // (i.e. it was signed by a mn which changed its key),
-            // so just quit here.
-            return;
-        }
 
-        if(!UpdateLastVote(vote)) {
-            LogPrintf("MASTERNODEPAYMENTVOTE -- masternode already voted, masternode=%s\n", vote.masternodeOutpoint.ToStringShort());
-            return;
-        }
+            if(!UpdateLastVote(vote)) {
+                LogPrintf("MASTERNODEPAYMENTVOTE -- masternode already voted, masternode=%s\n", vote.masternodeOutpoint.ToStringShort());
+                return;
+            }
 
-        CTxDestination address;
-        ExtractDestination(vote.payee, address);
+            CTxDestination address;
+            ExtractDestination(vote.payee, address);
 
-        LogPrint(BCLog::MNPAYMENTS, "MASTERNODEPAYMENTVOTE -- vote: address=%s, nBlockHeight=%d, nHeight=%d, prevout=%s, hash=%s new\n",
-                    EncodeDestination(address), vote.nBlockHeight, nCachedBlockHeight, vote.masternodeOutpoint.ToStringShort(), nHash.ToString());
+            LogPrint(BCLog::MNPAYMENTS, "MASTERNODEPAYMENTVOTE -- vote: address=%s, nBlockHeight=%d, nHeight=%d, prevout=%s, hash=%s new\n",
+                        EncodeDestination(address), vote.nBlockHeight, nCachedBlockHeight, vote.masternodeOutpoint.ToStringShort(), nHash.ToString());
 
-        if(AddOrUpdatePaymentVote(vote)){
-            vote.Relay(connman);
-            masternodeSync.BumpAssetLastTime("MASTERNODEPAYMENTVOTE");
-        }
+            if(AddOrUpdatePaymentVote(vote)){
+                vote.Relay(connmanIn);
+                masternodeSync.BumpAssetLastTime("MASTERNODEPAYMENTVOTE");
+            }
+        });
+        if (fBatchDue) ProcessPendingMessages(connman);
     }
 }
 
@@ -276,6 +287,13 @@ uint256 CMasternodePaymentVote::GetSignatureHash() const
     return SerializeHash(*this);
 }
 
+std::string CMasternodePaymentVote::GetSignatureMessage() const
+{
+    return masternodeOutpoint.ToStringShort() +
+            boost::lexical_cast<std::string>(nBlockHeight) +
+            ScriptToAsmStr(payee);
+}
+
 bool CMasternodePaymentVote::Sign()
 {
     std::string strError;
@@ -293,9 +311,7 @@ bool CMasternodePaymentVote::Sign()
             return false;
         }
     } else {
-        std::string strMessage = masternodeOutpoint.ToStringShort() +
-                    boost::lexical_cast<std::string>(nBlockHeight) +
-                    ScriptToAsmStr(payee);
+        std::string strMessage = GetSignatureMessage();
 
         if(!CMessageSigner::SignMessage(strMessage, vchSig, activeMasternode.keyMasternode)) {
             LogPrintf("CMasternodePaymentVote::Sign -- SignMessage() failed\n");
@@ -739,9 +755,7 @@ bool CMasternodePaymentVote::CheckSignature(const CPubKey& pubKeyMasternode, int
 
         if (!CHashSigner::VerifyHash(hash, pubKeyMasternode, vchSig, strError)) {
             // could be a signature in old format
-            std::string strMessage = masternodeOutpoint.ToStringShort() +
-                        boost::lexical_cast<std::string>(nBlockHeight) +
-                        ScriptToAsmStr(payee);
+            std::string strMessage = GetSignatureMessage();
             if(!CMessageSigner::VerifyMessage(pubKeyMasternode, vchSig, strMessage, strError)) {
                 // nope, not in old format either
                 // Only ban for future block vote when we are already synced.
@@ -755,9 +769,7 @@ bool CMasternodePaymentVote::CheckSignature(const CPubKey& pubKeyMasternode, int
             }
         }
     } else {
-        std::string strMessage = masternodeOutpoint.ToStringShort() +
-                    boost::lexical_cast<std::string>(nBlockHeight) +
-                    ScriptToAsmStr(payee);
+        std::string strMessage = GetSignatureMessage();
 
         if (!CMessageSigner::VerifyMessage(pubKeyMasternode, vchSig, strMessage, strError)) {
             // Only ban for future block vote when we are already synced.
@@ -774,6 +786,14 @@ bool CMasternodePaymentVote::CheckSignature(const CPubKey& pubKeyMasternode, int
     return true;
 }
 
+CHashSigCheck CMasternodePaymentVote::GetSignatureCheck(const CPubKey& pubKeyMasternode) const
+{
+    if (sporkManager.IsSporkActive(SPORK_4_NEW_SIGS))
+        return CHashSigCheck(GetSignatureHash(), pubKeyMasternode.GetID(), vchSig);
+
+    return CHashSigCheck(CMessageSigner::GetMessageHash(GetSignatureMessage()), pubKeyMasternode.GetID(), vchSig);
+}
+
 std::string CMasternodePaymentVote::ToString() const
 {
     std::ostringstream info;
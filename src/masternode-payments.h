@@ -7,8 +7,10 @@
 
 #include <util.h>
 #include <core_io.h>
+#include <flat-database.h>
 #include <key.h>
 #include <masternode.h>
+#include <messagesigner.h>
 #include <net_processing.h>
 #include <utilstrencodings.h>
 
@@ -156,9 +158,13 @@ public:
 
     uint256 GetHash() const;
     uint256 GetSignatureHash() const;
+    /// The message signed before SPORK_4_NEW_SIGS
+    std::string GetSignatureMessage() const;
 
     bool Sign();
     bool CheckSignature(const CPubKey& pubKeyMasternode, int nValidationHeight, int &nDos) const;
+    /// The check CheckSignature starts with, to verify ahead of it in a batch
+    CHashSigCheck GetSignatureCheck(const CPubKey& pubKeyMasternode) const;
 
     bool IsValid(CNode* pnode, int nValidationHeight, std::string& strError, CConnman& connman) const;
     void Relay(CConnman& connman) const;
@@ -185,6 +191,13 @@ private:
     // Keep track of current block height
     int nCachedBlockHeight;
 
+    // payment votes waiting for their signatures to be verified in a batch
+    CPendingSigMessages pendingMessages;
+
+    // changes of the persisted maps since mnpayments.dat was last dumped or loaded
+    CFlatDBMapChanges<uint256, CMasternodePaymentVote> changesMasternodePaymentVotes;
+    CFlatDBMapChanges<int, CMasternodeBlockPayees> changesMasternodeBlocks;
+
 public:
     std::map<uint256, CMasternodePaymentVote> mapMasternodePaymentVotes;
     std::map<int, CMasternodeBlockPayees> mapMasternodeBlocks;
@@ -201,6 +214,37 @@ public:
         READWRITE(mapMasternodeBlocks);
     }
 
+    /// Whether the entries changed since the last ClearDelta() are known, see CFlatDBLog.
+    bool CanSerializeDelta() const
+    {
+        LOCK2(cs_mapMasternodeBlocks, cs_mapMasternodePaymentVotes);
+        return changesMasternodePaymentVotes.HasChangedEntries() && changesMasternodeBlocks.HasChangedEntries();
+    }
+
+    /// Write the votes and blocks changed or erased since the last ClearDelta().
+    template <typename Stream>
+    void SerializeDelta(Stream& s) const
+    {
+        LOCK2(cs_mapMasternodeBlocks, cs_mapMasternodePaymentVotes);
+        changesMasternodePaymentVotes.SerializeChanged(s, mapMasternodePaymentVotes);
+        changesMasternodeBlocks.SerializeChanged(s, mapMasternodeBlocks);
+    }
+
+    template <typename Stream>
+    void UnserializeDelta(Stream& s)
+    {
+        LOCK2(cs_mapMasternodeBlocks, cs_mapMasternodePaymentVotes);
+        changesMasternodePaymentVotes.UnserializeChanged(s, mapMasternodePaymentVotes);
+        changesMasternodeBlocks.UnserializeChanged(s, mapMasternodeBlocks);
+    }
+
+    void ClearDelta()
+    {
+        LOCK2(cs_mapMasternodeBlocks, cs_mapMasternodePaymentVotes);
+        changesMasternodePaymentVotes.ClearChanged(mapMasternodePaymentVotes);
+        changesMasternodeBlocks.ClearChanged(mapMasternodeBlocks);
+    }
+
     void Clear();
 
     bool AddOrUpdatePaymentVote(const CMasternodePaymentVote& vote);
@@ -220,6 +264,8 @@ public:
 
     int GetMinMasternodePaymentsProto() const;
     void ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStream& vRecv, CConnman& connman);
+    /// Verify the signatures of the queued payment votes in a batch and finish them
+    void ProcessPendingMessages(CConnman& connman) { pendingMessages.Process(connman); }
     std::string GetRequiredPaymentsString(int nBlockHeight) const;
     void FillBlockPayee(CMutableTransaction& txNew, int nBlockHeight, CAmount blockReward, CTxOut& txoutMasternodeRet) const;
     std::string ToString() const;
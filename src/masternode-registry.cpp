@@ -0,0 +1,220 @@
+// Copyright (c) 2026 The Globaltoken Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <masternode-registry.h>
+
+#include <clientversion.h>
+#include <hash.h>
+#include <streams.h>
+
+void CMasternodeRegistry::AddToIndexes(const Entry& entry)
+{
+    const COutPoint& outpoint = entry.mn.outpoint;
+    setByLastPaid.emplace(entry.nBlockLastPaid, outpoint, &entry.mn);
+    setByProtocol.emplace(entry.nProtocolVersion, outpoint, &entry.mn);
+    setByState.emplace(entry.nActiveState, outpoint, &entry.mn);
+    setByAddr.emplace(entry.addr, outpoint, &entry.mn);
+    mapProtocolCount[entry.nProtocolVersion]++;
+    if (entry.nActiveState == CMasternode::MASTERNODE_ENABLED)
+        mapEnabledProtocolCount[entry.nProtocolVersion]++;
+}
+
+void CMasternodeRegistry::RemoveFromIndexes(const Entry& entry)
+{
+    const COutPoint& outpoint = entry.mn.outpoint;
+    setByLastPaid.erase(IndexEntry<int>(entry.nBlockLastPaid, outpoint));
+    setByProtocol.erase(IndexEntry<int>(entry.nProtocolVersion, outpoint));
+    setByState.erase(IndexEntry<int>(entry.nActiveState, outpoint));
+    setByAddr.erase(IndexEntry<CService>(entry.addr, outpoint));
+    if (--mapProtocolCount[entry.nProtocolVersion] == 0)
+        mapProtocolCount.erase(entry.nProtocolVersion);
+    if (entry.nActiveState == CMasternode::MASTERNODE_ENABLED && --mapEnabledProtocolCount[entry.nProtocolVersion] == 0)
+        mapEnabledProtocolCount.erase(entry.nProtocolVersion);
+}
+
+void CMasternodeRegistry::ReindexEntry(Entry& entry)
+{
+    entry.fDirty = false;
+    const CMasternode& mn = entry.mn;
+    if (mn.nBlockLastPaid == entry.nBlockLastPaid && mn.nProtocolVersion == entry.nProtocolVersion &&
+        mn.nActiveState == entry.nActiveState && mn.addr == entry.addr)
+        return;
+
+    if (mn.nProtocolVersion != entry.nProtocolVersion)
+        nGeneration++;
+    RemoveFromIndexes(entry);
+    entry.nBlockLastPaid = mn.nBlockLastPaid;
+    entry.nProtocolVersion = mn.nProtocolVersion;
+    entry.nActiveState = mn.nActiveState;
+    entry.addr = mn.addr;
+    AddToIndexes(entry);
+}
+
+void CMasternodeRegistry::MarkDirty(Entry& entry)
+{
+    if (entry.fDirty || fAllDirty)
+        return;
+    entry.fDirty = true;
+    vecDirty.push_back(entry.mn.outpoint);
+}
+
+uint256 CMasternodeRegistry::GetPersistedHash(const CMasternode& mn)
+{
+    CDataStream ss(SER_DISK, CLIENT_VERSION);
+    ss << mn;
+    return Hash(ss.begin(), ss.end());
+}
+
+void CMasternodeRegistry::Reindex()
+{
+    if (fAllDirty) {
+        for (auto& entry : mapEntries) {
+            ReindexEntry(entry.second);
+        }
+    } else {
+        for (const COutPoint& outpoint : vecDirty) {
+            auto it = mapEntries.find(outpoint);
+            if (it != mapEntries.end())
+                ReindexEntry(it->second);
+        }
+    }
+    fAllDirty = false;
+    vecDirty.clear();
+}
+
+int CMasternodeRegistry::CountFrom(const std::map<int, int>& mapCount, int nMinProtocol)
+{
+    int nCount = 0;
+    for (auto it = mapCount.lower_bound(nMinProtocol); it != mapCount.end(); ++it) {
+        nCount += it->second;
+    }
+    return nCount;
+}
+
+bool CMasternodeRegistry::Add(const CMasternode& mn)
+{
+    auto ret = mapEntries.emplace(mn.outpoint, Entry(mn));
+    if (!ret.second)
+        return false;
+    AddToIndexes(ret.first->second);
+    nGeneration++;
+    return true;
+}
+
+bool CMasternodeRegistry::Erase(const COutPoint& outpoint)
+{
+    auto it = mapEntries.find(outpoint);
+    if (it == mapEntries.end())
+        return false;
+    RemoveFromIndexes(it->second);
+    if (!fAllChanged && !it->second.hashPersisted.IsNull())
+        setErased.insert(outpoint);
+    mapEntries.erase(it);
+    nGeneration++;
+    return true;
+}
+
+void CMasternodeRegistry::Clear()
+{
+    mapEntries.clear();
+    vecDirty.clear();
+    fAllDirty = false;
+    setByLastPaid.clear();
+    setByProtocol.clear();
+    setByState.clear();
+    setByAddr.clear();
+    mapProtocolCount.clear();
+    mapEnabledProtocolCount.clear();
+    setErased.clear();
+    fAllChanged = true;
+    nGeneration++;
+}
+
+void CMasternodeRegistry::ClearChanged()
+{
+    for (auto& entry : mapEntries) {
+        entry.second.hashPersisted = GetPersistedHash(entry.second.mn);
+    }
+    setErased.clear();
+    fAllChanged = false;
+}
+
+const CMasternode* CMasternodeRegistry::Get(const COutPoint& outpoint) const
+{
+    auto it = mapEntries.find(outpoint);
+    return it == mapEntries.end() ? nullptr : &it->second.mn;
+}
+
+CMasternode* CMasternodeRegistry::Find(const COutPoint& outpoint)
+{
+    auto it = mapEntries.find(outpoint);
+    if (it == mapEntries.end())
+        return nullptr;
+    MarkDirty(it->second);
+    return &it->second.mn;
+}
+
+uint64_t CMasternodeRegistry::GetGeneration()
+{
+    Reindex();
+    return nGeneration;
+}
+
+int CMasternodeRegistry::Count(int nMinProtocol)
+{
+    Reindex();
+    return CountFrom(mapProtocolCount, nMinProtocol);
+}
+
+int CMasternodeRegistry::CountEnabled(int nMinProtocol)
+{
+    Reindex();
+    return CountFrom(mapEnabledProtocolCount, nMinProtocol);
+}
+
+const CMasternodeRegistry::int_index_t& CMasternodeRegistry::ByLastPaid()
+{
+    Reindex();
+    return setByLastPaid;
+}
+
+const CMasternodeRegistry::int_index_t& CMasternodeRegistry::ByProtocol()
+{
+    Reindex();
+    return setByProtocol;
+}
+
+const CMasternodeRegistry::int_index_t& CMasternodeRegistry::ByState()
+{
+    Reindex();
+    return setByState;
+}
+
+const CMasternodeRegistry::addr_index_t& CMasternodeRegistry::ByAddr()
+{
+    Reindex();
+    return setByAddr;
+}
+
+std::vector<COutPoint> CMasternodeRegistry::GetOutpointsByState(int nActiveState)
+{
+    Reindex();
+    std::vector<COutPoint> vecOutpoints;
+    auto it = setByState.lower_bound(IndexEntry<int>(nActiveState, COutPoint(uint256(), 0)));
+    for (; it != setByState.end() && it->key == nActiveState; ++it) {
+        vecOutpoints.push_back(it->outpoint);
+    }
+    return vecOutpoints;
+}
+
+std::vector<COutPoint> CMasternodeRegistry::GetOutpointsByAddr(const CService& addr)
+{
+    Reindex();
+    std::vector<COutPoint> vecOutpoints;
+    auto it = setByAddr.lower_bound(IndexEntry<CService>(addr, COutPoint(uint256(), 0)));
+    for (; it != setByAddr.end() && it->key == addr; ++it) {
+        vecOutpoints.push_back(it->outpoint);
+    }
+    return vecOutpoints;
+}
@@ -0,0 +1,226 @@
+// Copyright (c) 2026 The Globaltoken Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef MASTERNODEREGISTRY_H
+#define MASTERNODEREGISTRY_H
+
+#include <coins.h>
+#include <masternode.h>
+#include <serialize.h>
+
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+/**
+ * Storage of the masternode list with secondary indexes.
+ *
+ * Entries live in a hash table keyed by collateral outpoint, so pointers to
+ * them stay valid until they are erased. They are indexed by last paid block,
+ * protocol version, state and address; the indexes are ordered by key and
+ * then by outpoint, which keeps the order of queries deterministic.
+ *
+ * Entries handed out as mutable (Find, the non-const ForEach) are marked
+ * dirty. Their index keys are refreshed before the next index query, which
+ * only re-inserts the entries whose keys actually changed.
+ *
+ * For the delta log of mncache.dat, ClearChanged() records the hash of every
+ * entry as it was persisted, and the outpoints of persisted entries that are
+ * erased afterwards are kept. Entries are handed out as mutable far more often
+ * than they change, so changes are found by comparing hashes, not by access.
+ */
+class CMasternodeRegistry
+{
+public:
+    template <typename Key>
+    struct IndexEntry
+    {
+        Key key;
+        COutPoint outpoint;
+        const CMasternode* pmn;
+
+        IndexEntry(const Key& keyIn, const COutPoint& outpointIn, const CMasternode* pmnIn = nullptr) :
+            key(keyIn), outpoint(outpointIn), pmn(pmnIn) {}
+
+        bool operator<(const IndexEntry& other) const
+        {
+            if (key < other.key) return true;
+            if (other.key < key) return false;
+            return outpoint < other.outpoint;
+        }
+    };
+
+    typedef std::set<IndexEntry<int> > int_index_t;
+    typedef std::set<IndexEntry<CService> > addr_index_t;
+
+private:
+    struct Entry
+    {
+        CMasternode mn;
+        //! Keys the entry is currently indexed under
+        int nBlockLastPaid;
+        int nProtocolVersion;
+        int nActiveState;
+        CService addr;
+        bool fDirty;
+        //! Hash of the entry when it was last persisted, null if it was not
+        uint256 hashPersisted;
+
+        explicit Entry(const CMasternode& mnIn) :
+            mn(mnIn), nBlockLastPaid(mnIn.nBlockLastPaid), nProtocolVersion(mnIn.nProtocolVersion),
+            nActiveState(mnIn.nActiveState), addr(mnIn.addr), fDirty(false) {}
+    };
+
+    std::unordered_map<COutPoint, Entry, SaltedOutpointHasher> mapEntries;
+    std::vector<COutPoint> vecDirty;
+    bool fAllDirty;
+    //! Persisted entries erased since the last ClearChanged()
+    std::unordered_set<COutPoint, SaltedOutpointHasher> setErased;
+    //! Whether what was persisted is unknown, until ClearChanged() is first called and after Clear()
+    bool fAllChanged;
+    //! Changes whenever entries are added or removed or change their protocol version
+    uint64_t nGeneration;
+
+    int_index_t setByLastPaid;
+    int_index_t setByProtocol;
+    int_index_t setByState;
+    addr_index_t setByAddr;
+    //! Number of entries per protocol version, all and enabled ones
+    std::map<int, int> mapProtocolCount;
+    std::map<int, int> mapEnabledProtocolCount;
+
+    void AddToIndexes(const Entry& entry);
+    void RemoveFromIndexes(const Entry& entry);
+    void ReindexEntry(Entry& entry);
+    void MarkDirty(Entry& entry);
+    /** Hash of an entry as written to disk, including the signatures left out of its GetHash() */
+    static uint256 GetPersistedHash(const CMasternode& mn);
+    void Reindex();
+
+    static int CountFrom(const std::map<int, int>& mapCount, int nMinProtocol);
+
+public:
+    CMasternodeRegistry() : fAllDirty(false), fAllChanged(true), nGeneration(0) {}
+
+    template <typename Stream>
+    void Serialize(Stream& s) const
+    {
+        // Same format as the std::map<COutPoint, CMasternode> this replaces
+        WriteCompactSize(s, mapEntries.size());
+        for (const auto& entry : mapEntries) {
+            s << entry.first << entry.second.mn;
+        }
+    }
+
+    template <typename Stream>
+    void Unserialize(Stream& s)
+    {
+        Clear();
+        uint64_t nSize = ReadCompactSize(s);
+        for (uint64_t i = 0; i < nSize; i++) {
+            COutPoint outpoint;
+            CMasternode mn;
+            s >> outpoint >> mn;
+            Add(mn);
+        }
+    }
+
+    /** Serialize the changes since the last ClearChanged(): the erased outpoints, then the changed entries. */
+    template <typename Stream>
+    void SerializeChanged(Stream& s) const
+    {
+        assert(!fAllChanged);
+        std::vector<const CMasternode*> vecChanged;
+        for (const auto& entry : mapEntries) {
+            if (entry.second.hashPersisted != GetPersistedHash(entry.second.mn))
+                vecChanged.push_back(&entry.second.mn);
+        }
+        s << std::vector<COutPoint>(setErased.begin(), setErased.end());
+        WriteCompactSize(s, vecChanged.size());
+        for (const CMasternode* pmn : vecChanged) {
+            s << pmn->outpoint << *pmn;
+        }
+    }
+
+    /** Apply the changes written by SerializeChanged. */
+    template <typename Stream>
+    void UnserializeChanged(Stream& s)
+    {
+        std::vector<COutPoint> vecErased;
+        s >> vecErased;
+        for (const COutPoint& outpoint : vecErased) {
+            Erase(outpoint);
+        }
+        uint64_t nSize = ReadCompactSize(s);
+        for (uint64_t i = 0; i < nSize; i++) {
+            COutPoint outpoint;
+            CMasternode mn;
+            s >> outpoint >> mn;
+            Erase(outpoint);
+            Add(mn);
+        }
+    }
+
+    /** Whether SerializeChanged can tell what changed since the last ClearChanged(). */
+    bool HasChangedEntries() const { return !fAllChanged; }
+    /** Record the current entries as persisted. */
+    void ClearChanged();
+
+    bool Add(const CMasternode& mn);
+    bool Erase(const COutPoint& outpoint);
+    void Clear();
+
+    size_t size() const { return mapEntries.size(); }
+    bool empty() const { return mapEntries.empty(); }
+    bool Has(const COutPoint& outpoint) const { return mapEntries.count(outpoint) != 0; }
+
+    /** Look up an entry for reading. */
+    const CMasternode* Get(const COutPoint& outpoint) const;
+    /** Look up an entry that may be modified, its index keys are refreshed on the next query. */
+    CMasternode* Find(const COutPoint& outpoint);
+
+    template <typename Callable>
+    void ForEach(Callable&& func) const
+    {
+        for (const auto& entry : mapEntries) {
+            func(static_cast<const CMasternode&>(entry.second.mn));
+        }
+    }
+
+    /** Visit every entry for modification, all index keys are rechecked on the next query. */
+    template <typename Callable>
+    void ForEach(Callable&& func)
+    {
+        fAllDirty = true;
+        for (auto& entry : mapEntries) {
+            func(entry.second.mn);
+        }
+    }
+
+    /** Changes whenever the set of entries at or above any protocol version changes. */
+    uint64_t GetGeneration();
+
+    /** Number of entries with at least the given protocol version. */
+    int Count(int nMinProtocol);
+    /** Number of enabled entries with at least the given protocol version. */
+    int CountEnabled(int nMinProtocol);
+
+    /** Entries ordered by last paid block, least recently paid first. */
+    const int_index_t& ByLastPaid();
+    /** Entries ordered by protocol version. */
+    const int_index_t& ByProtocol();
+    /** Entries ordered by state. */
+    const int_index_t& ByState();
+    /** Entries ordered by address. */
+    const addr_index_t& ByAddr();
+
+    /** Outpoints of the entries in the given state. */
+    std::vector<COutPoint> GetOutpointsByState(int nActiveState);
+    /** Outpoints of the entries with the given address. */
+    std::vector<COutPoint> GetOutpointsByAddr(const CService& addr);
+};
+
+#endif // MASTERNODEREGISTRY_H
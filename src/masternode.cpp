@@ -13,6 +13,7 @@
 #include <masternode-sync.h>
 #include <masternodeman.h>
 #include <messagesigner.h>
+#include <payeeindex.h>
 #include <script/standard.h>
 #include <util.h>
 #ifdef ENABLE_WALLET
@@ -289,6 +290,23 @@ void CMasternode::UpdateLastPaid(const CBlockIndex *pindex, int nMaxBlocksToScan
 
     LOCK(cs_mapMasternodeBlocks);
 
+    // Look the payments up in the payee index when it covers the blocks to scan
+    std::vector<CPayeePayment> vPayments;
+    int nMinHeight = std::max(nBlockLastPaid, pindex->nHeight - nMaxBlocksToScanBack);
+    if (ppayeeindex && ppayeeindex->GetPayments(mnpayee, pindex, nMinHeight, vPayments)) {
+        for (const auto& payment : vPayments) {
+            if(mnpayments.mapMasternodeBlocks.count(payment.nHeight) &&
+                mnpayments.mapMasternodeBlocks[payment.nHeight].HasPayeeWithVotes(mnpayee, 2))
+            {
+                nBlockLastPaid = payment.nHeight;
+                nTimeLastPaid = pindex->GetAncestor(payment.nHeight)->nTime;
+                LogPrint(BCLog::MNPAYMENTS, "CMasternode::UpdateLastPaidBlock -- searching for block with payment to %s -- found new %d\n", outpoint.ToStringShort(), nBlockLastPaid);
+                return;
+            }
+        }
+        return;
+    }
+
     for (int i = 0; BlockReading && BlockReading->nHeight > nBlockLastPaid && i < nMaxBlocksToScanBack; i++) {
         if(mnpayments.mapMasternodeBlocks.count(BlockReading->nHeight) &&
             mnpayments.mapMasternodeBlocks[BlockReading->nHeight].HasPayeeWithVotes(mnpayee, 2))
@@ -592,6 +610,13 @@ uint256 CMasternodeBroadcast::GetSignatureHash() const
     return ss.GetHash();
 }
 
+std::string CMasternodeBroadcast::GetSignatureMessage() const
+{
+    return addr.ToString() + boost::lexical_cast<std::string>(sigTime) +
+            pubKeyCollateralAddress.GetID().ToString() + pubKeyMasternode.GetID().ToString() +
+            boost::lexical_cast<std::string>(nProtocolVersion);
+}
+
 bool CMasternodeBroadcast::Sign(const CKey& keyCollateralAddress)
 {
     std::string strError;
@@ -611,9 +636,7 @@ bool CMasternodeBroadcast::Sign(const CKey& keyCollateralAddress)
             return false;
         }
     } else {
-        std::string strMessage = addr.ToString() + boost::lexical_cast<std::string>(sigTime) +
-                        pubKeyCollateralAddress.GetID().ToString() + pubKeyMasternode.GetID().ToString() +
-                        boost::lexical_cast<std::string>(nProtocolVersion);
+        std::string strMessage = GetSignatureMessage();
 
         if (!CMessageSigner::SignMessage(strMessage, vchSig, keyCollateralAddress)) {
             LogPrintf("CMasternodeBroadcast::Sign -- SignMessage() failed\n");
@@ -639,9 +662,7 @@ bool CMasternodeBroadcast::CheckSignature(int& nDos) const
 
         if (!CHashSigner::VerifyHash(hash, pubKeyCollateralAddress, vchSig, strError)) {
             // maybe it's in old format
-            std::string strMessage = addr.ToString() + boost::lexical_cast<std::string>(sigTime) +
-                            pubKeyCollateralAddress.GetID().ToString() + pubKeyMasternode.GetID().ToString() +
-                            boost::lexical_cast<std::string>(nProtocolVersion);
+            std::string strMessage = GetSignatureMessage();
 
             if (!CMessageSigner::VerifyMessage(pubKeyCollateralAddress, vchSig, strMessage, strError)){
                 // nope, not in old format either
@@ -651,9 +672,7 @@ bool CMasternodeBroadcast::CheckSignature(int& nDos) const
             }
         }
     } else {
-        std::string strMessage = addr.ToString() + boost::lexical_cast<std::string>(sigTime) +
-                        pubKeyCollateralAddress.GetID().ToString() + pubKeyMasternode.GetID().ToString() +
-                        boost::lexical_cast<std::string>(nProtocolVersion);
+        std::string strMessage = GetSignatureMessage();
 
         if (!CMessageSigner::VerifyMessage(pubKeyCollateralAddress, vchSig, strMessage, strError)){
             LogPrintf("CMasternodeBroadcast::CheckSignature -- Got bad Masternode announce signature, error: %s\n", strError);
@@ -665,6 +684,17 @@ bool CMasternodeBroadcast::CheckSignature(int& nDos) const
     return true;
 }
 
+void CMasternodeBroadcast::GetSignatureChecks(std::vector<CHashSigCheck>& vChecks) const
+{
+    if (sporkManager.IsSporkActive(SPORK_4_NEW_SIGS)) {
+        vChecks.emplace_back(GetSignatureHash(), pubKeyCollateralAddress.GetID(), vchSig);
+    } else {
+        vChecks.emplace_back(CMessageSigner::GetMessageHash(GetSignatureMessage()), pubKeyCollateralAddress.GetID(), vchSig);
+    }
+    if (lastPing)
+        vChecks.push_back(lastPing.GetSignatureCheck(pubKeyMasternode));
+}
+
 void CMasternodeBroadcast::Relay(CConnman& connman) const
 {
     // Do not relay until fully synced
@@ -700,6 +730,12 @@ uint256 CMasternodePing::GetSignatureHash() const
     return GetHash();
 }
 
+std::string CMasternodePing::GetSignatureMessage() const
+{
+    return CTxIn(masternodeOutpoint).ToString() + blockHash.ToString() +
+            boost::lexical_cast<std::string>(sigTime);
+}
+
 CMasternodePing::CMasternodePing(const COutPoint& outpoint)
 {
     LOCK(cs_main);
@@ -730,8 +766,7 @@ bool CMasternodePing::Sign(const CKey& keyMasternode, const CPubKey& pubKeyMaste
             return false;
         }
     } else {
-        std::string strMessage = CTxIn(masternodeOutpoint).ToString() + blockHash.ToString() +
-                    boost::lexical_cast<std::string>(sigTime);
+        std::string strMessage = GetSignatureMessage();
 
         if (!CMessageSigner::SignMessage(strMessage, vchSig, keyMasternode)) {
             LogPrintf("CMasternodePing::Sign -- SignMessage() failed\n");
@@ -756,8 +791,7 @@ bool CMasternodePing::CheckSignature(const CPubKey& pubKeyMasternode, int &nDos)
         uint256 hash = GetSignatureHash();
 
         if (!CHashSigner::VerifyHash(hash, pubKeyMasternode, vchSig, strError)) {
-            std::string strMessage = CTxIn(masternodeOutpoint).ToString() + blockHash.ToString() +
-                        boost::lexical_cast<std::string>(sigTime);
+            std::string strMessage = GetSignatureMessage();
 
             if (!CMessageSigner::VerifyMessage(pubKeyMasternode, vchSig, strMessage, strError)) {
                 LogPrintf("CMasternodePing::CheckSignature -- Got bad Masternode ping signature, masternode=%s, error: %s\n", masternodeOutpoint.ToStringShort(), strError);
@@ -766,8 +800,7 @@ bool CMasternodePing::CheckSignature(const CPubKey& pubKeyMasternode, int &nDos)
             }
         }
     } else {
-        std::string strMessage = CTxIn(masternodeOutpoint).ToString() + blockHash.ToString() +
-                    boost::lexical_cast<std::string>(sigTime);
+        std::string strMessage = GetSignatureMessage();
 
         if (!CMessageSigner::VerifyMessage(pubKeyMasternode, vchSig, strMessage, strError)) {
             LogPrintf("CMasternodePing::CheckSignature -- Got bad Masternode ping signature, masternode=%s, error: %s\n", masternodeOutpoint.ToStringShort(), strError);
@@ -779,6 +812,14 @@ bool CMasternodePing::CheckSignature(const CPubKey& pubKeyMasternode, int &nDos)
     return true;
 }
 
+CHashSigCheck CMasternodePing::GetSignatureCheck(const CPubKey& pubKeyMasternode) const
+{
+    if (sporkManager.IsSporkActive(SPORK_4_NEW_SIGS))
+        return CHashSigCheck(GetSignatureHash(), pubKeyMasternode.GetID(), vchSig);
+
+    return CHashSigCheck(CMessageSigner::GetMessageHash(GetSignatureMessage()), pubKeyMasternode.GetID(), vchSig);
+}
+
 bool CMasternodePing::SimpleCheck(int& nDos)
 {
     // don't ban by default
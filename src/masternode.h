@@ -6,6 +6,7 @@
 #define MASTERNODE_H
 
 #include <key.h>
+#include <messagesigner.h>
 #include <validation.h>
 #include <spork.h>
 
@@ -83,11 +84,15 @@ public:
 
     uint256 GetHash() const;
     uint256 GetSignatureHash() const;
+    /// The message signed before SPORK_4_NEW_SIGS
+    std::string GetSignatureMessage() const;
 
     bool IsExpired() const { return GetAdjustedTime() - sigTime > MASTERNODE_NEW_START_REQUIRED_SECONDS; }
 
     bool Sign(const CKey& keyMasternode, const CPubKey& pubKeyMasternode);
     bool CheckSignature(const CPubKey& pubKeyMasternode, int &nDos) const;
+    /// The check CheckSignature starts with, to verify ahead of it in a batch
+    CHashSigCheck GetSignatureCheck(const CPubKey& pubKeyMasternode) const;
     bool SimpleCheck(int& nDos);
     bool CheckAndUpdate(CMasternode* pmn, bool fFromNewBroadcast, int& nDos, CConnman& connman);
     void Relay(CConnman& connman);
@@ -358,6 +363,8 @@ public:
 
     uint256 GetHash() const;
     uint256 GetSignatureHash() const;
+    /// The message signed before SPORK_4_NEW_SIGS
+    std::string GetSignatureMessage() const;
 
     /// Create Masternode broadcast, needs to be relayed manually after that
     static bool Create(const COutPoint& outpoint, const CService& service, const CKey& keyCollateralAddressNew, const CPubKey& pubKeyCollateralAddressNew, const CKey& keyMasternodeNew, const CPubKey& pubKeyMasternodeNew, std::string &strErrorRet, CMasternodeBroadcast &mnbRet);
@@ -369,6 +376,8 @@ public:
 
     bool Sign(const CKey& keyCollateralAddress);
     bool CheckSignature(int& nDos) const;
+    /// The checks CheckSignature and the check of the ping start with, to verify ahead of them in a batch
+    void GetSignatureChecks(std::vector<CHashSigCheck>& vChecks) const;
     void Relay(CConnman& connman) const;
 };
 
@@ -24,15 +24,6 @@ const std::string CMasternodeMan::SERIALIZATION_VERSION_STRING = "CMasternodeMan
 const int CMasternodeMan::LAST_PAID_SCAN_BLOCKS = 100;
 const int CMasternodeMan::MAX_POSE_CONNECTIONS = 10;
 
-struct CompareLastPaidBlock
-{
-    bool operator()(const std::pair<int, const CMasternode*>& t1,
-                    const std::pair<int, const CMasternode*>& t2) const
-    {
-        return (t1.first != t2.first) ? (t1.first < t2.first) : (t1.second->outpoint < t2.second->outpoint);
-    }
-};
-
 struct CompareScoreMN
 {
     bool operator()(const std::pair<arith_uint256, const CMasternode*>& t1,
@@ -42,19 +33,9 @@ struct CompareScoreMN
     }
 };
 
-struct CompareByAddr
-
-{
-    bool operator()(const CMasternode* t1,
-                    const CMasternode* t2) const
-    {
-        return t1->addr < t2->addr;
-    }
-};
-
 CMasternodeMan::CMasternodeMan():
     cs(),
-    mapMasternodes(),
+    mnRegistry(),
     mAskedUsForMasternodeList(),
     mWeAskedForMasternodeList(),
     mWeAskedForMasternodeListEntry(),
@@ -62,6 +43,7 @@ CMasternodeMan::CMasternodeMan():
     mMnbRecoveryRequests(),
     mMnbRecoveryGoodReplies(),
     listScheduledMnbRequestConnections(),
+    nRankCacheGeneration(0),
     fMasternodesAdded(false),
     fMasternodesRemoved(false),
     mapSeenMasternodeBroadcast(),
@@ -75,7 +57,7 @@ bool CMasternodeMan::Add(CMasternode &mn)
     if (Has(mn.outpoint)) return false;
 
     LogPrint(BCLog::MASTERNODE, "CMasternodeMan::Add -- Adding new Masternode: addr=%s, %i now\n", mn.addr.ToString(), size() + 1);
-    mapMasternodes[mn.outpoint] = mn;
+    mnRegistry.Add(mn);
     fMasternodesAdded = true;
     return true;
 }
@@ -133,11 +115,11 @@ void CMasternodeMan::Check()
 
     LogPrint(BCLog::MASTERNODE, "CMasternodeMan::Check -- Checking ...\n");
 
-    for (auto& mnpair : mapMasternodes) {
+    mnRegistry.ForEach([](CMasternode& mn) {
         // NOTE: internally it checks only every MASTERNODE_CHECK_SECONDS seconds
         // since the last time, so expect some MNs to skip this
-        mnpair.second.Check();
-    }
+        mn.Check();
+    });
 }
 
 void CMasternodeMan::CheckAndRemove(CConnman& connman)
@@ -157,28 +139,25 @@ void CMasternodeMan::CheckAndRemove(CConnman& connman)
         rank_pair_vec_t vecMasternodeRanks;
         // ask for up to MNB_RECOVERY_MAX_ASK_ENTRIES masternode entries at a time
         int nAskForMnbRecovery = MNB_RECOVERY_MAX_ASK_ENTRIES;
-        std::map<COutPoint, CMasternode>::iterator it = mapMasternodes.begin();
-        while (it != mapMasternodes.end()) {
-            CMasternodeBroadcast mnb = CMasternodeBroadcast(it->second);
-            uint256 hash = mnb.GetHash();
-            // If collateral was spent ...
-            if (it->second.IsOutpointSpent()) {
-                LogPrint(BCLog::MASTERNODE, "CMasternodeMan::CheckAndRemove -- Removing Masternode: %s  addr=%s  %i now\n", it->second.GetStateString(), it->second.addr.ToString(), size() - 1);
-
-                // erase all of the broadcasts we've seen from this txin, ...
-                mapSeenMasternodeBroadcast.erase(hash);
-                mWeAskedForMasternodeListEntry.erase(it->first);
-
-                // and finally remove it from the list
-                mapMasternodes.erase(it++);
-                fMasternodesRemoved = true;
-            } else {
-                bool fAsk = (nAskForMnbRecovery > 0) &&
-                            masternodeSync.IsSynced() &&
-                            it->second.IsNewStartRequired() &&
-                            !IsMnbRecoveryRequested(hash) &&
-                            !gArgs.IsArgSet("-connect");
-                if(fAsk) {
+        // If collateral was spent ...
+        for (const COutPoint& outpoint : mnRegistry.GetOutpointsByState(CMasternode::MASTERNODE_OUTPOINT_SPENT)) {
+            const CMasternode* pmn = mnRegistry.Get(outpoint);
+            LogPrint(BCLog::MASTERNODE, "CMasternodeMan::CheckAndRemove -- Removing Masternode: %s  addr=%s  %i now\n", pmn->GetStateString(), pmn->addr.ToString(), size() - 1);
+
+            // erase all of the broadcasts we've seen from this txin, ...
+            mapSeenMasternodeBroadcast.erase(CMasternodeBroadcast(*pmn).GetHash());
+            mWeAskedForMasternodeListEntry.erase(outpoint);
+
+            // and finally remove it from the list
+            mnRegistry.Erase(outpoint);
+            fMasternodesRemoved = true;
+        }
+
+        if (masternodeSync.IsSynced() && !gArgs.IsArgSet("-connect")) {
+            for (const COutPoint& outpoint : mnRegistry.GetOutpointsByState(CMasternode::MASTERNODE_NEW_START_REQUIRED)) {
+                if (nAskForMnbRecovery <= 0) break;
+                uint256 hash = CMasternodeBroadcast(*mnRegistry.Get(outpoint)).GetHash();
+                if(!IsMnbRecoveryRequested(hash)) {
                     // this mn is in a non-recoverable state and we haven't asked other nodes yet
                     std::set<CService> setRequested;
                     // calulate only once and only when it's needed
@@ -190,7 +169,7 @@ void CMasternodeMan::CheckAndRemove(CConnman& connman)
                     // ask first MNB_RECOVERY_QUORUM_TOTAL masternodes we can connect to and we haven't asked recently
                     for(int i = 0; setRequested.size() < MNB_RECOVERY_QUORUM_TOTAL && i < (int)vecMasternodeRanks.size(); i++) {
                         // avoid banning
-                        if(mWeAskedForMasternodeListEntry.count(it->first) && mWeAskedForMasternodeListEntry[it->first].count(vecMasternodeRanks[i].second.addr)) continue;
+                        if(mWeAskedForMasternodeListEntry.count(outpoint) && mWeAskedForMasternodeListEntry[outpoint].count(vecMasternodeRanks[i].second.addr)) continue;
                         // didn't ask recently, ok to ask now
                         CService addr = vecMasternodeRanks[i].second.addr;
                         setRequested.insert(addr);
@@ -198,13 +177,12 @@ void CMasternodeMan::CheckAndRemove(CConnman& connman)
                         fAskedForMnbRecovery = true;
                     }
                     if(fAskedForMnbRecovery) {
-                        LogPrint(BCLog::MASTERNODE, "CMasternodeMan::CheckAndRemove -- Recovery initiated, masternode=%s\n", it->first.ToStringShort());
+                        LogPrint(BCLog::MASTERNODE, "CMasternodeMan::CheckAndRemove -- Recovery initiated, masternode=%s\n", outpoint.ToStringShort());
                         nAskForMnbRecovery--;
                     }
                     // wait for mnb recovery replies for MNB_RECOVERY_WAIT_SECONDS seconds
                     mMnbRecoveryRequests[hash] = std::make_pair(GetTime() + MNB_RECOVERY_WAIT_SECONDS, setRequested);
                 }
-                ++it;
             }
         }
 
@@ -326,40 +304,37 @@ void CMasternodeMan::CheckAndRemove(CConnman& connman)
 void CMasternodeMan::Clear()
 {
     LOCK(cs);
-    mapMasternodes.clear();
+    mnRegistry.Clear();
     mAskedUsForMasternodeList.clear();
     mWeAskedForMasternodeList.clear();
     mWeAskedForMasternodeListEntry.clear();
     mapSeenMasternodeBroadcast.clear();
     mapSeenMasternodePing.clear();
+    listRankCache.clear();
+    mapRankCache.clear();
+    changesAskedUsForMasternodeList.SetAllChanged();
+    changesWeAskedForMasternodeList.SetAllChanged();
+    changesWeAskedForMasternodeListEntry.SetAllChanged();
+    changesMnbRecoveryRequests.SetAllChanged();
+    changesMnbRecoveryGoodReplies.SetAllChanged();
+    changesSeenMasternodeBroadcast.SetAllChanged();
+    changesSeenMasternodePing.SetAllChanged();
 }
 
 int CMasternodeMan::CountMasternodes(int nProtocolVersion)
 {
     LOCK(cs);
-    int nCount = 0;
     nProtocolVersion = nProtocolVersion == -1 ? mnpayments.GetMinMasternodePaymentsProto() : nProtocolVersion;
 
-    for (const auto& mnpair : mapMasternodes) {
-        if(mnpair.second.nProtocolVersion < nProtocolVersion) continue;
-        nCount++;
-    }
-
-    return nCount;
+    return mnRegistry.Count(nProtocolVersion);
 }
 
 int CMasternodeMan::CountEnabled(int nProtocolVersion)
 {
     LOCK(cs);
-    int nCount = 0;
     nProtocolVersion = nProtocolVersion == -1 ? mnpayments.GetMinMasternodePaymentsProto() : nProtocolVersion;
 
-    for (const auto& mnpair : mapMasternodes) {
-        if(mnpair.second.nProtocolVersion < nProtocolVersion || !mnpair.second.IsEnabled()) continue;
-        nCount++;
-    }
-
-    return nCount;
+    return mnRegistry.CountEnabled(nProtocolVersion);
 }
 
 /* Only IPv4 masternodes are allowed in 12.1, saving this for later
@@ -409,63 +384,73 @@ void CMasternodeMan::DsegUpdate(CNode* pnode, CConnman& connman)
 CMasternode* CMasternodeMan::Find(const COutPoint &outpoint)
 {
     LOCK(cs);
-    auto it = mapMasternodes.find(outpoint);
-    return it == mapMasternodes.end() ? nullptr : &(it->second);
+    return mnRegistry.Find(outpoint);
 }
 
 bool CMasternodeMan::Get(const COutPoint& outpoint, CMasternode& masternodeRet)
 {
     // Theses mutexes are recursive so double locking by the same thread is safe.
     LOCK(cs);
-    auto it = mapMasternodes.find(outpoint);
-    if (it == mapMasternodes.end()) {
+    const CMasternode* pmn = mnRegistry.Get(outpoint);
+    if (!pmn) {
         return false;
     }
 
-    masternodeRet = it->second;
+    masternodeRet = *pmn;
     return true;
 }
 
 bool CMasternodeMan::GetMasternodeInfo(const COutPoint& outpoint, masternode_info_t& mnInfoRet)
 {
     LOCK(cs);
-    auto it = mapMasternodes.find(outpoint);
-    if (it == mapMasternodes.end()) {
+    const CMasternode* pmn = mnRegistry.Get(outpoint);
+    if (!pmn) {
         return false;
     }
-    mnInfoRet = it->second.GetInfo();
+    mnInfoRet = pmn->GetInfo();
     return true;
 }
 
 bool CMasternodeMan::GetMasternodeInfo(const CPubKey& pubKeyMasternode, masternode_info_t& mnInfoRet)
 {
     LOCK(cs);
-    for (const auto& mnpair : mapMasternodes) {
-        if (mnpair.second.pubKeyMasternode == pubKeyMasternode) {
-            mnInfoRet = mnpair.second.GetInfo();
-            return true;
+    bool fFound = false;
+    mnRegistry.ForEach([&](const CMasternode& mn) {
+        if (!fFound && mn.pubKeyMasternode == pubKeyMasternode) {
+            mnInfoRet = mn.GetInfo();
+            fFound = true;
         }
-    }
-    return false;
+    });
+    return fFound;
 }
 
 bool CMasternodeMan::GetMasternodeInfo(const CScript& payee, masternode_info_t& mnInfoRet)
 {
     LOCK(cs);
-    for (const auto& mnpair : mapMasternodes) {
-        CScript scriptCollateralAddress = GetScriptForDestination(mnpair.second.pubKeyCollateralAddress.GetID());
-        if (scriptCollateralAddress == payee) {
-            mnInfoRet = mnpair.second.GetInfo();
-            return true;
+    bool fFound = false;
+    mnRegistry.ForEach([&](const CMasternode& mn) {
+        if (!fFound && GetScriptForDestination(mn.pubKeyCollateralAddress.GetID()) == payee) {
+            mnInfoRet = mn.GetInfo();
+            fFound = true;
         }
-    }
-    return false;
+    });
+    return fFound;
 }
 
 bool CMasternodeMan::Has(const COutPoint& outpoint)
 {
     LOCK(cs);
-    return mapMasternodes.find(outpoint) != mapMasternodes.end();
+    return mnRegistry.Has(outpoint);
+}
+
+std::map<COutPoint, CMasternode> CMasternodeMan::GetFullMasternodeMap()
+{
+    LOCK(cs);
+    std::map<COutPoint, CMasternode> mapMasternodes;
+    mnRegistry.ForEach([&](const CMasternode& mn) {
+        mapMasternodes.emplace(mn.outpoint, mn);
+    });
+    return mapMasternodes;
 }
 
 //
@@ -489,63 +474,58 @@ bool CMasternodeMan::GetNextMasternodeInQueueForPayment(int nBlockHeight, bool f
     // Need LOCK2 here to ensure consistent locking order because the GetBlockHash call below locks cs_main
     LOCK2(cs_main,cs);
 
-    std::vector<std::pair<int, const CMasternode*> > vecMasternodeLastPaid;
+    int nMnCount = CountMasternodes();
+    int nMinProtocol = mnpayments.GetMinMasternodePaymentsProto();
 
-    /*
-        Make a vector with all of the last paid times
-    */
+    uint256 blockHash;
+    bool fHaveBlockHash = GetBlockHash(blockHash, nBlockHeight - 101);
 
-    int nMnCount = CountMasternodes();
+    // Look at 1/10 of the oldest nodes (by last payment), calculate their scores and pay the best one
+    //  -- This doesn't look at who is being paid in the +8-10 blocks, allowing for double payments very rarely
+    //  -- 1/100 payments should be a double payment on mainnet - (1/(3000/10))*2
+    //  -- (chance per block * chances before IsScheduled will fire)
+    int nTenthNetwork = nMnCount/10;
+    arith_uint256 nHighest = 0;
+    const CMasternode *pBestMasternode = nullptr;
 
-    for (const auto& mnpair : mapMasternodes) {
-        if(!mnpair.second.IsValidForPayment()) continue;
+    /*
+        Walk the masternodes from least to most recently paid, the whole list
+        is counted but only the first tenth of the eligible ones is scored
+    */
+    for (const auto& entry : mnRegistry.ByLastPaid()) {
+        const CMasternode& mn = *entry.pmn;
+        if(!mn.IsValidForPayment()) continue;
 
         //check protocol version
-        if(mnpair.second.nProtocolVersion < mnpayments.GetMinMasternodePaymentsProto()) continue;
+        if(mn.nProtocolVersion < nMinProtocol) continue;
 
         //it's in the list (up to 8 entries ahead of current block to allow propagation) -- so let's skip it
-        if(mnpayments.IsScheduled(mnpair.second, nBlockHeight)) continue;
+        if(mnpayments.IsScheduled(mn, nBlockHeight)) continue;
 
         //it's too new, wait for a cycle
-        if(fFilterSigTime && mnpair.second.sigTime + (nMnCount*2.6*60) > GetAdjustedTime()) continue;
+        if(fFilterSigTime && mn.sigTime + (nMnCount*2.6*60) > GetAdjustedTime()) continue;
 
         //make sure it has at least as many confirmations as there are masternodes
-        if(GetUTXOConfirmations(mnpair.first) < nMnCount) continue;
-
-        vecMasternodeLastPaid.push_back(std::make_pair(mnpair.second.GetLastPaidBlock(), &mnpair.second));
+        if(GetUTXOConfirmations(mn.outpoint) < nMnCount) continue;
+
+        nCountRet++;
+        if(fHaveBlockHash && (nCountRet == 1 || nCountRet <= nTenthNetwork)) {
+            arith_uint256 nScore = mn.CalculateScore(blockHash);
+            if(nScore > nHighest){
+                nHighest = nScore;
+                pBestMasternode = &mn;
+            }
+        }
     }
 
-    nCountRet = (int)vecMasternodeLastPaid.size();
-
     //when the network is in the process of upgrading, don't penalize nodes that recently restarted
     if(fFilterSigTime && nCountRet < nMnCount/3)
         return GetNextMasternodeInQueueForPayment(nBlockHeight, false, nCountRet, mnInfoRet);
 
-    // Sort them low to high
-    sort(vecMasternodeLastPaid.begin(), vecMasternodeLastPaid.end(), CompareLastPaidBlock());
-
-    uint256 blockHash;
-    if(!GetBlockHash(blockHash, nBlockHeight - 101)) {
+    if(!fHaveBlockHash) {
         LogPrintf("CMasternode::GetNextMasternodeInQueueForPayment -- ERROR: GetBlockHash() failed at nBlockHeight %d\n", nBlockHeight - 101);
         return false;
     }
-    // Look at 1/10 of the oldest nodes (by last payment), calculate their scores and pay the best one
-    //  -- This doesn't look at who is being paid in the +8-10 blocks, allowing for double payments very rarely
-    //  -- 1/100 payments should be a double payment on mainnet - (1/(3000/10))*2
-    //  -- (chance per block * chances before IsScheduled will fire)
-    int nTenthNetwork = nMnCount/10;
-    int nCountTenth = 0;
-    arith_uint256 nHighest = 0;
-    const CMasternode *pBestMasternode = nullptr;
-    for (const auto& s : vecMasternodeLastPaid) {
-        arith_uint256 nScore = s.second->CalculateScore(blockHash);
-        if(nScore > nHighest){
-            nHighest = nScore;
-            pBestMasternode = s.second;
-        }
-        nCountTenth++;
-        if(nCountTenth >= nTenthNetwork) break;
-    }
     if (pBestMasternode) {
         mnInfoRet = pBestMasternode->GetInfo();
     }
@@ -564,10 +544,13 @@ masternode_info_t CMasternodeMan::FindRandomNotInVec(const std::vector<COutPoint
     LogPrintf("CMasternodeMan::FindRandomNotInVec -- %d enabled masternodes, %d masternodes to choose from\n", nCountEnabled, nCountNotExcluded);
     if(nCountNotExcluded < 1) return masternode_info_t();
 
-    // fill a vector of pointers
+    // fill a vector of pointers to the enabled ones
     std::vector<const CMasternode*> vpMasternodesShuffled;
-    for (const auto& mnpair : mapMasternodes) {
-        vpMasternodesShuffled.push_back(&mnpair.second);
+    vpMasternodesShuffled.reserve(nCountEnabled);
+    for (const auto& outpoint : mnRegistry.GetOutpointsByState(CMasternode::MASTERNODE_ENABLED)) {
+        const CMasternode* pmn = mnRegistry.Get(outpoint);
+        if(pmn->nProtocolVersion < nProtocolVersion) continue;
+        vpMasternodesShuffled.push_back(pmn);
     }
 
     FastRandomContext insecure_rand;
@@ -577,7 +560,6 @@ masternode_info_t CMasternodeMan::FindRandomNotInVec(const std::vector<COutPoint
 
     // loop through
     for (const auto& pmn : vpMasternodesShuffled) {
-        if(pmn->nProtocolVersion < nProtocolVersion || !pmn->IsEnabled()) continue;
         fExclude = false;
         for (const auto& outpointToExclude : vecToExclude) {
             if(pmn->outpoint == outpointToExclude) {
@@ -595,27 +577,59 @@ masternode_info_t CMasternodeMan::FindRandomNotInVec(const std::vector<COutPoint
     return masternode_info_t();
 }
 
-bool CMasternodeMan::GetMasternodeScores(const uint256& nBlockHash, CMasternodeMan::score_pair_vec_t& vecMasternodeScoresRet, int nMinProtocol)
+const CMasternodeMan::rank_cache_entry_t* CMasternodeMan::GetMasternodeScores(const uint256& nBlockHash, int nMinProtocol)
 {
-    vecMasternodeScoresRet.clear();
-
     if (!masternodeSync.IsMasternodeListSynced())
-        return false;
+        return nullptr;
 
     AssertLockHeld(cs);
 
-    if (mapMasternodes.empty())
-        return false;
+    if (mnRegistry.empty())
+        return nullptr;
 
-    // calculate scores
-    for (const auto& mnpair : mapMasternodes) {
-        if (mnpair.second.nProtocolVersion >= nMinProtocol) {
-            vecMasternodeScoresRet.push_back(std::make_pair(mnpair.second.CalculateScore(nBlockHash), &mnpair.second));
-        }
+    // cached scores point into the registry, drop them once its entries changed
+    uint64_t nGeneration = mnRegistry.GetGeneration();
+    if (nGeneration != nRankCacheGeneration) {
+        listRankCache.clear();
+        mapRankCache.clear();
+        nRankCacheGeneration = nGeneration;
+    }
+
+    rank_cache_key_t key = std::make_pair(nBlockHash, nMinProtocol);
+    auto itCache = mapRankCache.find(key);
+    if (itCache != mapRankCache.end()) {
+        listRankCache.splice(listRankCache.begin(), listRankCache, itCache->second);
+        return &itCache->second->second;
+    }
+
+    rank_cache_entry_t entry;
+
+    // calculate scores, skipping the entries below nMinProtocol
+    const CMasternodeRegistry::int_index_t& setByProtocol = mnRegistry.ByProtocol();
+    entry.vecScores.reserve(mnRegistry.Count(nMinProtocol));
+    auto it = setByProtocol.lower_bound(CMasternodeRegistry::IndexEntry<int>(nMinProtocol, COutPoint(uint256(), 0)));
+    for (; it != setByProtocol.end(); ++it) {
+        entry.vecScores.push_back(std::make_pair(it->pmn->CalculateScore(nBlockHash), it->pmn));
     }
+    if (entry.vecScores.empty())
+        return nullptr;
 
-    sort(vecMasternodeScoresRet.rbegin(), vecMasternodeScoresRet.rend(), CompareScoreMN());
-    return !vecMasternodeScoresRet.empty();
+    sort(entry.vecScores.rbegin(), entry.vecScores.rend(), CompareScoreMN());
+
+    entry.vecRanks.reserve(entry.vecScores.size());
+    int nRank = 0;
+    for (const auto& scorePair : entry.vecScores) {
+        entry.vecRanks.push_back(std::make_pair(scorePair.second->outpoint, ++nRank));
+    }
+    std::sort(entry.vecRanks.begin(), entry.vecRanks.end());
+
+    listRankCache.emplace_front(key, std::move(entry));
+    mapRankCache.emplace(key, listRankCache.begin());
+    if (listRankCache.size() > MAX_RANK_CACHE_ENTRIES) {
+        mapRankCache.erase(listRankCache.back().first);
+        listRankCache.pop_back();
+    }
+    return &listRankCache.front().second;
 }
 
 bool CMasternodeMan::GetMasternodeRank(const COutPoint& outpoint, int& nRankRet, int nBlockHeight, int nMinProtocol)
@@ -634,17 +648,14 @@ bool CMasternodeMan::GetMasternodeRank(const COutPoint& outpoint, int& nRankRet,
 
     LOCK(cs);
 
-    score_pair_vec_t vecMasternodeScores;
-    if (!GetMasternodeScores(nBlockHash, vecMasternodeScores, nMinProtocol))
+    const rank_cache_entry_t* pScores = GetMasternodeScores(nBlockHash, nMinProtocol);
+    if (!pScores)
         return false;
 
-    int nRank = 0;
-    for (const auto& scorePair : vecMasternodeScores) {
-        nRank++;
-        if(scorePair.second->outpoint == outpoint) {
-            nRankRet = nRank;
-            return true;
-        }
+    auto it = std::lower_bound(pScores->vecRanks.begin(), pScores->vecRanks.end(), std::make_pair(outpoint, 0));
+    if (it != pScores->vecRanks.end() && it->first == outpoint) {
+        nRankRet = it->second;
+        return true;
     }
 
     return false;
@@ -666,12 +677,13 @@ bool CMasternodeMan::GetMasternodeRanks(CMasternodeMan::rank_pair_vec_t& vecMast
 
     LOCK(cs);
 
-    score_pair_vec_t vecMasternodeScores;
-    if (!GetMasternodeScores(nBlockHash, vecMasternodeScores, nMinProtocol))
+    const rank_cache_entry_t* pScores = GetMasternodeScores(nBlockHash, nMinProtocol);
+    if (!pScores)
         return false;
 
+    vecMasternodeRanksRet.reserve(pScores->vecScores.size());
     int nRank = 0;
-    for (const auto& scorePair : vecMasternodeScores) {
+    for (const auto& scorePair : pScores->vecScores) {
         nRank++;
         vecMasternodeRanksRet.push_back(std::make_pair(nRank, *scorePair.second));
     }
@@ -777,19 +789,31 @@ void CMasternodeMan::ProcessMessage(CNode* pfrom, const std::string& strCommand,
 
         LogPrint(BCLog::MASTERNODE, "MNANNOUNCE -- Masternode announce, masternode=%s\n", mnb.outpoint.ToStringShort());
 
-        int nDos = 0;
-
-        if (CheckMnbAndUpdateMasternodeList(pfrom, mnb, nDos, connman)) {
-            // use announced Masternode as a peer
-            connman.AddNewAddress(CAddress(mnb.addr, NODE_NETWORK), pfrom->addr, 2*60*60);
-        } else if(nDos > 0) {
-            LOCK(cs_main);
-            Misbehaving(pfrom->GetId(), nDos);
+        // the signatures of a seen announce are not checked again
+        std::vector<CHashSigCheck> vChecks;
+        {
+            LOCK(cs);
+            if (!mapSeenMasternodeBroadcast.count(mnb.GetHash()))
+                mnb.GetSignatureChecks(vChecks);
         }
 
-        if(fMasternodesAdded) {
-            NotifyMasternodeUpdates(connman);
-        }
+        bool fBatchDue = pendingMessages.Add(pfrom, vChecks, [this, mnb](CNode* pnode, CConnman& connmanIn) mutable {
+            int nDos = 0;
+
+            if (CheckMnbAndUpdateMasternodeList(pnode, mnb, nDos, connmanIn)) {
+                // use announced Masternode as a peer
+                connmanIn.AddNewAddress(CAddress(mnb.addr, NODE_NETWORK), pnode->addr, 2*60*60);
+            } else if(nDos > 0) {
+                LOCK(cs_main);
+                Misbehaving(pnode->GetId(), nDos);
+            }
+
+            if(fMasternodesAdded) {
+                NotifyMasternodeUpdates(connmanIn);
+            }
+        });
+        if (fBatchDue) ProcessPendingMessages(connman);
+
     } else if (strCommand == NetMsgType::MNPING) { //Masternode Ping
 
         CMasternodePing mnp;
@@ -803,34 +827,47 @@ void CMasternodeMan::ProcessMessage(CNode* pfrom, const std::string& strCommand,
 
         LogPrint(BCLog::MASTERNODE, "MNPING -- Masternode ping, masternode=%s\n", mnp.masternodeOutpoint.ToStringShort());
 
-        // Need LOCK2 here to ensure consistent locking order because the CheckAndUpdate call below locks cs_main
-        LOCK2(cs_main, cs);
+        // the signature is checked against the key of the masternode, if it is known by now
+        std::vector<CHashSigCheck> vChecks;
+        {
+            LOCK(cs);
+            if(mapSeenMasternodePing.count(nHash)) return; //seen
+            const CMasternode* pmn = mnRegistry.Get(mnp.masternodeOutpoint);
+            if(pmn && !pmn->IsNewStartRequired())
+                vChecks.push_back(mnp.GetSignatureCheck(pmn->pubKeyMasternode));
+        }
 
-        if(mapSeenMasternodePing.count(nHash)) return; //seen
-        mapSeenMasternodePing.insert(std::make_pair(nHash, mnp));
+        bool fBatchDue = pendingMessages.Add(pfrom, vChecks, [this, mnp, nHash](CNode* pnode, CConnman& connmanIn) mutable {
+            // Need LOCK2 here to ensure consistent locking order because the CheckAndUpdate call below locks cs_main
+            LOCK2(cs_main, cs);
 
-        LogPrint(BCLog::MASTERNODE, "MNPING -- Masternode ping, masternode=%s new\n", mnp.masternodeOutpoint.ToStringShort());
+            if(mapSeenMasternodePing.count(nHash)) return; //seen
+            mapSeenMasternodePing.insert(std::make_pair(nHash, mnp));
 
-        // see if we have this Masternode
-        CMasternode* pmn = Find(mnp.masternodeOutpoint);
+            LogPrint(BCLog::MASTERNODE, "MNPING -- Masternode ping, masternode=%s new\n", mnp.masternodeOutpoint.ToStringShort());
 
-        // too late, new MNANNOUNCE is required
-        if(pmn && pmn->IsNewStartRequired()) return;
+            // see if we have this Masternode
+            CMasternode* pmn = Find(mnp.masternodeOutpoint);
 
-        int nDos = 0;
-        if(mnp.CheckAndUpdate(pmn, false, nDos, connman)) return;
+            // too late, new MNANNOUNCE is required
+            if(pmn && pmn->IsNewStartRequired()) return;
 
-        if(nDos > 0) {
-            // if anything significant failed, mark that node
-            Misbehaving(pfrom->GetId(), nDos);
-        } else if(pmn != nullptr) {
-            // nothing significant failed, mn is a known one too
-            return;
-        }
+            int nDos = 0;
+            if(mnp.CheckAndUpdate(pmn, false, nDos, connmanIn)) return;
+
+            if(nDos > 0) {
+                // if anything significant failed, mark that node
+                Misbehaving(pnode->GetId(), nDos);
+            } else if(pmn != nullptr) {
+                // nothing significant failed, mn is a known one too
+                return;
+            }
 
-        // something significant is broken or mn is unknown,
-        // we might have to ask for a masternode entry once
-        AskForMN(pfrom, mnp.masternodeOutpoint, connman);
+            // something significant is broken or mn is unknown,
+            // we might have to ask for a masternode entry once
+            AskForMN(pnode, mnp.masternodeOutpoint, connmanIn);
+        });
+        if (fBatchDue) ProcessPendingMessages(connman);
 
     } else if (strCommand == NetMsgType::DSEG) { //Get Masternode list or specific entry
         // Ignore such requests until we are fully synced.
@@ -888,13 +925,13 @@ void CMasternodeMan::SyncSingle(CNode* pnode, const COutPoint& outpoint, CConnma
 
     LOCK(cs);
 
-    auto it = mapMasternodes.find(outpoint);
+    const CMasternode* pmn = mnRegistry.Get(outpoint);
 
-    if(it != mapMasternodes.end()) {
-        if (it->second.addr.IsRFC1918() || it->second.addr.IsLocal()) return; // do not send local network masternode
+    if(pmn) {
+        if (pmn->addr.IsRFC1918() || pmn->addr.IsLocal()) return; // do not send local network masternode
         // NOTE: send masternode regardless of its current state, the other node will need it to verify old votes.
-        LogPrint(BCLog::MASTERNODE, "CMasternodeMan::%s -- Sending Masternode entry: masternode=%s  addr=%s\n", __func__, outpoint.ToStringShort(), it->second.addr.ToString());
-        PushDsegInvs(pnode, it->second);
+        LogPrint(BCLog::MASTERNODE, "CMasternodeMan::%s -- Sending Masternode entry: masternode=%s  addr=%s\n", __func__, outpoint.ToStringShort(), pmn->addr.ToString());
+        PushDsegInvs(pnode, *pmn);
         LogPrintf("CMasternodeMan::%s -- Sent 1 Masternode inv to peer=%d\n", __func__, pnode->GetId());
     }
 }
@@ -925,13 +962,13 @@ void CMasternodeMan::SyncAll(CNode* pnode, CConnman& connman)
 
     LOCK(cs);
 
-    for (const auto& mnpair : mapMasternodes) {
-        if (mnpair.second.addr.IsRFC1918() || mnpair.second.addr.IsLocal()) continue; // do not send local network masternode
+    mnRegistry.ForEach([&](const CMasternode& mn) {
+        if (mn.addr.IsRFC1918() || mn.addr.IsLocal()) return; // do not send local network masternode
         // NOTE: send masternode regardless of its current state, the other node will need it to verify old votes.
-        LogPrint(BCLog::MASTERNODE, "CMasternodeMan::%s -- Sending Masternode entry: masternode=%s  addr=%s\n", __func__, mnpair.first.ToStringShort(), mnpair.second.addr.ToString());
-        PushDsegInvs(pnode, mnpair.second);
+        LogPrint(BCLog::MASTERNODE, "CMasternodeMan::%s -- Sending Masternode entry: masternode=%s  addr=%s\n", __func__, mn.outpoint.ToStringShort(), mn.addr.ToString());
+        PushDsegInvs(pnode, mn);
         nInvCount++;
-    }
+    });
 
     connman.PushMessage(pnode, CNetMsgMaker(pnode->GetSendVersion()).Make(NetMsgType::SYNCSTATUSCOUNT, MASTERNODE_SYNC_LIST, nInvCount));
     LogPrintf("CMasternodeMan::%s -- Sent %d Masternode invs to peer=%d\n", __func__, nInvCount, pnode->GetId());
@@ -994,12 +1031,11 @@ void CMasternodeMan::DoFullVerificationStep(CConnman& connman)
     if(nOffset >= (int)vecMasternodeRanks.size()) return;
 
     std::vector<const CMasternode*> vSortedByAddr;
-    for (const auto& mnpair : mapMasternodes) {
-        vSortedByAddr.push_back(&mnpair.second);
+    vSortedByAddr.reserve(mnRegistry.size());
+    for (const auto& entry : mnRegistry.ByAddr()) {
+        vSortedByAddr.push_back(entry.pmn);
     }
 
-    sort(vSortedByAddr.begin(), vSortedByAddr.end(), CompareByAddr());
-
     it = vecMasternodeRanks.begin() + nOffset;
     while(it != vecMasternodeRanks.end()) {
         if(it->second.IsPoSeVerified() || it->second.IsPoSeBanned()) {
@@ -1034,23 +1070,22 @@ void CMasternodeMan::DoFullVerificationStep(CConnman& connman)
 
 void CMasternodeMan::CheckSameAddr(bool fApplyNewRules)
 {
-    if(!masternodeSync.IsSynced() || mapMasternodes.empty()) return;
+    if(!masternodeSync.IsSynced() || mnRegistry.empty()) return;
 
-    std::vector<CMasternode*> vBan;
-    std::vector<CMasternode*> vSortedByAddr;
+    std::vector<COutPoint> vBan;
+    std::vector<const CMasternode*> vSortedByAddr;
 
     {
         LOCK(cs);
 
-        CMasternode* pprevMasternode = nullptr;
-        CMasternode* pverifiedMasternode = nullptr;
+        const CMasternode* pprevMasternode = nullptr;
+        const CMasternode* pverifiedMasternode = nullptr;
 
-        for (auto& mnpair : mapMasternodes) {
-            vSortedByAddr.push_back(&mnpair.second);
+        vSortedByAddr.reserve(mnRegistry.size());
+        for (const auto& entry : mnRegistry.ByAddr()) {
+            vSortedByAddr.push_back(entry.pmn);
         }
 
-        sort(vSortedByAddr.begin(), vSortedByAddr.end(), CompareByAddr());
-
         if(fApplyNewRules)
         {
             for (const auto& pmn : vSortedByAddr) {
@@ -1064,7 +1099,7 @@ void CMasternodeMan::CheckSameAddr(bool fApplyNewRules)
                 // ban all nodes with the same IP that are (pre)enabled
                 if(pmn->addr == pprevMasternode->addr) 
                 {
-                    vBan.push_back(pmn);
+                    vBan.push_back(pmn->outpoint);
                 }
                 else
                 {
@@ -1087,10 +1122,10 @@ void CMasternodeMan::CheckSameAddr(bool fApplyNewRules)
                 if(pmn->addr == pprevMasternode->addr) {
                     if(pverifiedMasternode) {
                         // another masternode with the same ip is verified, ban this one
-                        vBan.push_back(pmn);
+                        vBan.push_back(pmn->outpoint);
                     } else if(pmn->IsPoSeVerified()) {
                         // this masternode with the same ip is verified, ban previous one
-                        vBan.push_back(pprevMasternode);
+                        vBan.push_back(pprevMasternode->outpoint);
                         // and keep a reference to be able to ban following masternodes with the same ip
                         pverifiedMasternode = pmn;
                     }
@@ -1103,8 +1138,11 @@ void CMasternodeMan::CheckSameAddr(bool fApplyNewRules)
     }
 
     // ban duplicates
-    for (auto& pmn : vBan) {
-        LogPrintf("CMasternodeMan::CheckSameAddr -- increasing PoSe ban score for masternode %s\n", pmn->outpoint.ToStringShort());
+    LOCK(cs);
+    for (const auto& outpoint : vBan) {
+        CMasternode* pmn = mnRegistry.Find(outpoint);
+        if (!pmn) continue;
+        LogPrintf("CMasternodeMan::CheckSameAddr -- increasing PoSe ban score for masternode %s\n", outpoint.ToStringShort());
         pmn->IncreasePoSeBanScore();
     }
 }
@@ -1267,66 +1305,65 @@ void CMasternodeMan::ProcessVerifyReply(CNode* pnode, CMasternodeVerification& m
         uint256 hash1 = mnv.GetSignatureHash1(blockHash);
         std::string strMessage1 = strprintf("%s%d%s", pnode->addr.ToString(), mnv.nonce, blockHash.ToString());
 
-        for (auto& mnpair : mapMasternodes) {
-            if(CAddress(mnpair.second.addr, NODE_NETWORK) == pnode->addr) {
-                bool fFound = false;
-                if (sporkManager.IsSporkActive(SPORK_4_NEW_SIGS)) {
-                    fFound = CHashSigner::VerifyHash(hash1, mnpair.second.pubKeyMasternode, mnv.vchSig1, strError);
-                    // we don't care about mnv with signature in old format
-                } else {
-                    fFound = CMessageSigner::VerifyMessage(mnpair.second.pubKeyMasternode, mnv.vchSig1, strMessage1, strError);
+        for (const auto& outpoint : mnRegistry.GetOutpointsByAddr(pnode->addr)) {
+            CMasternode* pmn = mnRegistry.Find(outpoint);
+            bool fFound = false;
+            if (sporkManager.IsSporkActive(SPORK_4_NEW_SIGS)) {
+                fFound = CHashSigner::VerifyHash(hash1, pmn->pubKeyMasternode, mnv.vchSig1, strError);
+                // we don't care about mnv with signature in old format
+            } else {
+                fFound = CMessageSigner::VerifyMessage(pmn->pubKeyMasternode, mnv.vchSig1, strMessage1, strError);
+            }
+            if (fFound) {
+                // found it!
+                prealMasternode = pmn;
+                if(!pmn->IsPoSeVerified()) {
+                    pmn->DecreasePoSeBanScore();
                 }
-                if (fFound) {
-                    // found it!
-                    prealMasternode = &mnpair.second;
-                    if(!mnpair.second.IsPoSeVerified()) {
-                        mnpair.second.DecreasePoSeBanScore();
-                    }
-                    netfulfilledman.AddFulfilledRequest(pnode->addr, strprintf("%s", NetMsgType::MNVERIFY)+"-done");
-
-                    // we can only broadcast it if we are an activated masternode
-                    if(activeMasternode.outpoint.IsNull()) continue;
-                    // update ...
-                    mnv.addr = mnpair.second.addr;
-                    mnv.masternodeOutpoint1 = mnpair.second.outpoint;
-                    mnv.masternodeOutpoint2 = activeMasternode.outpoint;
-                    // ... and sign it
-                    std::string strError;
-
-                    if (sporkManager.IsSporkActive(SPORK_4_NEW_SIGS)) {
-                        uint256 hash2 = mnv.GetSignatureHash2(blockHash);
-
-                        if(!CHashSigner::SignHash(hash2, activeMasternode.keyMasternode, mnv.vchSig2)) {
-                            LogPrintf("MasternodeMan::ProcessVerifyReply -- SignHash() failed\n");
-                            return;
-                        }
+                netfulfilledman.AddFulfilledRequest(pnode->addr, strprintf("%s", NetMsgType::MNVERIFY)+"-done");
 
-                        if(!CHashSigner::VerifyHash(hash2, activeMasternode.pubKeyMasternode, mnv.vchSig2, strError)) {
-                            LogPrintf("MasternodeMan::ProcessVerifyReply -- VerifyHash() failed, error: %s\n", strError);
-                            return;
-                        }
-                    } else {
-                        std::string strMessage2 = strprintf("%s%d%s%s%s", mnv.addr.ToString(), mnv.nonce, blockHash.ToString(),
-                                                mnv.masternodeOutpoint1.ToStringShort(), mnv.masternodeOutpoint2.ToStringShort());
+                // we can only broadcast it if we are an activated masternode
+                if(activeMasternode.outpoint.IsNull()) continue;
+                // update ...
+                mnv.addr = pmn->addr;
+                mnv.masternodeOutpoint1 = pmn->outpoint;
+                mnv.masternodeOutpoint2 = activeMasternode.outpoint;
+                // ... and sign it
+                std::string strError;
 
-                        if(!CMessageSigner::SignMessage(strMessage2, mnv.vchSig2, activeMasternode.keyMasternode)) {
-                            LogPrintf("MasternodeMan::ProcessVerifyReply -- SignMessage() failed\n");
-                            return;
-                        }
+                if (sporkManager.IsSporkActive(SPORK_4_NEW_SIGS)) {
+                    uint256 hash2 = mnv.GetSignatureHash2(blockHash);
 
-                        if(!CMessageSigner::VerifyMessage(activeMasternode.pubKeyMasternode, mnv.vchSig2, strMessage2, strError)) {
-                            LogPrintf("MasternodeMan::ProcessVerifyReply -- VerifyMessage() failed, error: %s\n", strError);
-                            return;
-                        }
+                    if(!CHashSigner::SignHash(hash2, activeMasternode.keyMasternode, mnv.vchSig2)) {
+                        LogPrintf("MasternodeMan::ProcessVerifyReply -- SignHash() failed\n");
+                        return;
                     }
 
-                    mWeAskedForVerification[pnode->addr] = mnv;
-                    mapSeenMasternodeVerification.insert(std::make_pair(mnv.GetHash(), mnv));
-                    mnv.Relay();
-
+                    if(!CHashSigner::VerifyHash(hash2, activeMasternode.pubKeyMasternode, mnv.vchSig2, strError)) {
+                        LogPrintf("MasternodeMan::ProcessVerifyReply -- VerifyHash() failed, error: %s\n", strError);
+                        return;
+                    }
                 } else {
-                    vpMasternodesToBan.push_back(&mnpair.second);
+                    std::string strMessage2 = strprintf("%s%d%s%s%s", mnv.addr.ToString(), mnv.nonce, blockHash.ToString(),
+                                            mnv.masternodeOutpoint1.ToStringShort(), mnv.masternodeOutpoint2.ToStringShort());
+
+                    if(!CMessageSigner::SignMessage(strMessage2, mnv.vchSig2, activeMasternode.keyMasternode)) {
+                        LogPrintf("MasternodeMan::ProcessVerifyReply -- SignMessage() failed\n");
+                        return;
+                    }
+
+                    if(!CMessageSigner::VerifyMessage(activeMasternode.pubKeyMasternode, mnv.vchSig2, strMessage2, strError)) {
+                        LogPrintf("MasternodeMan::ProcessVerifyReply -- VerifyMessage() failed, error: %s\n", strError);
+                        return;
+                    }
                 }
+
+                mWeAskedForVerification[pnode->addr] = mnv;
+                mapSeenMasternodeVerification.insert(std::make_pair(mnv.GetHash(), mnv));
+                mnv.Relay();
+
+            } else {
+                vpMasternodesToBan.push_back(pmn);
             }
         }
         // no real masternode found?...
@@ -1459,12 +1496,13 @@ void CMasternodeMan::ProcessVerifyBroadcast(CNode* pnode, const CMasternodeVerif
 
         // increase ban score for everyone else with the same addr
         int nCount = 0;
-        for (auto& mnpair : mapMasternodes) {
-            if(mnpair.second.addr != mnv.addr || mnpair.first == mnv.masternodeOutpoint1) continue;
-            mnpair.second.IncreasePoSeBanScore();
+        for (const auto& outpoint : mnRegistry.GetOutpointsByAddr(mnv.addr)) {
+            if(outpoint == mnv.masternodeOutpoint1) continue;
+            CMasternode* pmn = mnRegistry.Find(outpoint);
+            pmn->IncreasePoSeBanScore();
             nCount++;
             LogPrint(BCLog::MASTERNODE, "CMasternodeMan::ProcessVerifyBroadcast -- increased PoSe ban score for %s addr %s, new score %d\n",
-                        mnpair.first.ToStringShort(), mnpair.second.addr.ToString(), mnpair.second.nPoSeBanScore);
+                        outpoint.ToStringShort(), pmn->addr.ToString(), pmn->nPoSeBanScore);
         }
         if(nCount)
             LogPrintf("CMasternodeMan::ProcessVerifyBroadcast -- PoSe score increased for %d fake masternodes, addr %s\n",
@@ -1476,7 +1514,7 @@ std::string CMasternodeMan::ToString() const
 {
     std::ostringstream info;
 
-    info << "Masternodes: " << (int)mapMasternodes.size() <<
+    info << "Masternodes: " << (int)mnRegistry.size() <<
             ", peers who asked us for Masternode list: " << (int)mAskedUsForMasternodeList.size() <<
             ", peers we asked for Masternode list: " << (int)mWeAskedForMasternodeList.size() <<
             ", entries in Masternode list we asked for: " << (int)mWeAskedForMasternodeListEntry.size();
@@ -1579,10 +1617,10 @@ bool CMasternodeMan::CheckMnbAndUpdateMasternodeList(CNode* pfrom, CMasternodeBr
 
 void CMasternodeMan::UpdateLastPaid(const CBlockIndex* pindex)
 {
-    // Need LOCK2 here to ensure consistent locking order because 'mnpair.second.UpdateLastPaid' calls ReadBlockFromDisk which locks cs_main
+    // Need LOCK2 here to ensure consistent locking order because 'mn.UpdateLastPaid' calls ReadBlockFromDisk which locks cs_main
     LOCK2(cs_main, cs);
 
-    if(fLiteMode || !masternodeSync.IsWinnersListSynced() || mapMasternodes.empty()) return;
+    if(fLiteMode || !masternodeSync.IsWinnersListSynced() || mnRegistry.empty()) return;
 
     static int nLastRunBlockHeight = 0;
     // Scan at least LAST_PAID_SCAN_BLOCKS but no more than mnpayments.GetStorageLimit()
@@ -1592,9 +1630,9 @@ void CMasternodeMan::UpdateLastPaid(const CBlockIndex* pindex)
     LogPrint(BCLog::MASTERNODE, "CMasternodeMan::UpdateLastPaid -- nCachedBlockHeight=%d, nLastRunBlockHeight=%d, nMaxBlocksToScanBack=%d\n",
                             nCachedBlockHeight, nLastRunBlockHeight, nMaxBlocksToScanBack);
 
-    for (auto& mnpair : mapMasternodes) {
-        mnpair.second.UpdateLastPaid(pindex, nMaxBlocksToScanBack);
-    }
+    mnRegistry.ForEach([&](CMasternode& mn) {
+        mn.UpdateLastPaid(pindex, nMaxBlocksToScanBack);
+    });
 
     nLastRunBlockHeight = nCachedBlockHeight;
 }
@@ -1602,11 +1640,15 @@ void CMasternodeMan::UpdateLastPaid(const CBlockIndex* pindex)
 void CMasternodeMan::CheckMasternode(const CPubKey& pubKeyMasternode, bool fForce)
 {
     LOCK2(cs_main, cs);
-    for (auto& mnpair : mapMasternodes) {
-        if (mnpair.second.pubKeyMasternode == pubKeyMasternode) {
-            mnpair.second.Check(fForce);
-            return;
+    COutPoint outpoint;
+    mnRegistry.ForEach([&](const CMasternode& mn) {
+        if (outpoint.IsNull() && mn.pubKeyMasternode == pubKeyMasternode) {
+            outpoint = mn.outpoint;
         }
+    });
+    CMasternode* pmn = outpoint.IsNull() ? nullptr : mnRegistry.Find(outpoint);
+    if (pmn) {
+        pmn->Check(fForce);
     }
 }
 
@@ -1658,11 +1700,11 @@ void CMasternodeMan::WarnMasternodeDaemonUpdates()
 
     int nUpdatedMasternodes{0};
 
-    for (const auto& mnpair : mapMasternodes) {
-        if (mnpair.second.lastPing.nDaemonVersion > CLIENT_VERSION) {
+    mnRegistry.ForEach([&](const CMasternode& mn) {
+        if (mn.lastPing.nDaemonVersion > CLIENT_VERSION) {
             ++nUpdatedMasternodes;
         }
-    }
+    });
 
     // Warn only when at least half of known masternodes already updated
     if (nUpdatedMasternodes < size() / 2)
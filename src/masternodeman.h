@@ -5,7 +5,9 @@
 #ifndef MASTERNODEMAN_H
 #define MASTERNODEMAN_H
 
+#include <flat-database.h>
 #include <masternode.h>
+#include <masternode-registry.h>
 #include <sync.h>
 
 class CMasternodeMan;
@@ -39,6 +41,8 @@ private:
     static const int MNB_RECOVERY_WAIT_SECONDS      = 60;
     static const int MNB_RECOVERY_RETRY_SECONDS     = 3 * 60 * 60;
 
+    static const size_t MAX_RANK_CACHE_ENTRIES      = 16;
+
 
     // critical section to protect the inner data structures
     mutable CCriticalSection cs;
@@ -46,8 +50,8 @@ private:
     // Keep track of current block height
     int nCachedBlockHeight;
 
-    // map to hold all MNs
-    std::map<COutPoint, CMasternode> mapMasternodes;
+    // registry of all MNs, indexed by last paid block, protocol version, state and address
+    CMasternodeRegistry mnRegistry;
     // who's asked for the Masternode list and the last time
     std::map<CService, int64_t> mAskedUsForMasternodeList;
     // who we asked for the Masternode list and the last time
@@ -66,17 +70,42 @@ private:
     std::map<CService, std::pair<int64_t, CMasternodeVerification> > mapPendingMNV;
     CCriticalSection cs_mapPendingMNV;
 
+    // sorted scores per (block hash, min protocol), most recently used first
+    struct rank_cache_entry_t
+    {
+        score_pair_vec_t vecScores; // best score first
+        std::vector<std::pair<COutPoint, int> > vecRanks; // ranks sorted by outpoint
+    };
+    typedef std::pair<uint256, int> rank_cache_key_t;
+    typedef std::list<std::pair<rank_cache_key_t, rank_cache_entry_t> > rank_cache_list_t;
+    rank_cache_list_t listRankCache;
+    std::map<rank_cache_key_t, rank_cache_list_t::iterator> mapRankCache;
+    // registry generation the cached scores belong to
+    uint64_t nRankCacheGeneration;
+
     /// Set when masternodes are added, cleared when CGovernanceManager is notified
     bool fMasternodesAdded;
 
     /// Set when masternodes are removed, cleared when CGovernanceManager is notified
     bool fMasternodesRemoved;
 
+    // announces and pings waiting for their signatures to be verified in a batch
+    CPendingSigMessages pendingMessages;
+
+    // changes of the other persisted maps since mncache.dat was last dumped or loaded
+    CFlatDBMapChanges<CService, int64_t> changesAskedUsForMasternodeList;
+    CFlatDBMapChanges<CService, int64_t> changesWeAskedForMasternodeList;
+    CFlatDBMapChanges<COutPoint, std::map<CService, int64_t> > changesWeAskedForMasternodeListEntry;
+    CFlatDBMapChanges<uint256, std::pair<int64_t, std::set<CService> > > changesMnbRecoveryRequests;
+    CFlatDBMapChanges<uint256, std::vector<CMasternodeBroadcast> > changesMnbRecoveryGoodReplies;
+    CFlatDBMapChanges<uint256, std::pair<int64_t, CMasternodeBroadcast> > changesSeenMasternodeBroadcast;
+    CFlatDBMapChanges<uint256, CMasternodePing> changesSeenMasternodePing;
+
     friend class CMasternodeSync;
     /// Find an entry
     CMasternode* Find(const COutPoint& outpoint);
 
-    bool GetMasternodeScores(const uint256& nBlockHash, score_pair_vec_t& vecMasternodeScoresRet, int nMinProtocol = 0);
+    const rank_cache_entry_t* GetMasternodeScores(const uint256& nBlockHash, int nMinProtocol = 0);
 
     void SyncSingle(CNode* pnode, const COutPoint& outpoint, CConnman& connman);
     void SyncAll(CNode* pnode, CConnman& connman);
@@ -106,7 +135,7 @@ public:
             READWRITE(strVersion);
         }
 
-        READWRITE(mapMasternodes);
+        READWRITE(mnRegistry);
         READWRITE(mAskedUsForMasternodeList);
         READWRITE(mWeAskedForMasternodeList);
         READWRITE(mWeAskedForMasternodeListEntry);
@@ -120,6 +149,67 @@ public:
         }
     }
 
+    /// Whether the entries changed since the last ClearDelta() are known, see CFlatDBLog.
+    bool CanSerializeDelta() const
+    {
+        LOCK(cs);
+        return mnRegistry.HasChangedEntries() &&
+               changesAskedUsForMasternodeList.HasChangedEntries() &&
+               changesWeAskedForMasternodeList.HasChangedEntries() &&
+               changesWeAskedForMasternodeListEntry.HasChangedEntries() &&
+               changesMnbRecoveryRequests.HasChangedEntries() &&
+               changesMnbRecoveryGoodReplies.HasChangedEntries() &&
+               changesSeenMasternodeBroadcast.HasChangedEntries() &&
+               changesSeenMasternodePing.HasChangedEntries();
+    }
+
+    /// Write the entries of the persisted maps changed or erased since the last ClearDelta().
+    template <typename Stream>
+    void SerializeDelta(Stream& s) const
+    {
+        LOCK(cs);
+        s << SERIALIZATION_VERSION_STRING;
+        mnRegistry.SerializeChanged(s);
+        changesAskedUsForMasternodeList.SerializeChanged(s, mAskedUsForMasternodeList);
+        changesWeAskedForMasternodeList.SerializeChanged(s, mWeAskedForMasternodeList);
+        changesWeAskedForMasternodeListEntry.SerializeChanged(s, mWeAskedForMasternodeListEntry);
+        changesMnbRecoveryRequests.SerializeChanged(s, mMnbRecoveryRequests);
+        changesMnbRecoveryGoodReplies.SerializeChanged(s, mMnbRecoveryGoodReplies);
+        changesSeenMasternodeBroadcast.SerializeChanged(s, mapSeenMasternodeBroadcast);
+        changesSeenMasternodePing.SerializeChanged(s, mapSeenMasternodePing);
+    }
+
+    template <typename Stream>
+    void UnserializeDelta(Stream& s)
+    {
+        LOCK(cs);
+        std::string strVersion;
+        s >> strVersion;
+        if (strVersion != SERIALIZATION_VERSION_STRING)
+            throw std::ios_base::failure("CMasternodeMan::UnserializeDelta(): version mismatch");
+        mnRegistry.UnserializeChanged(s);
+        changesAskedUsForMasternodeList.UnserializeChanged(s, mAskedUsForMasternodeList);
+        changesWeAskedForMasternodeList.UnserializeChanged(s, mWeAskedForMasternodeList);
+        changesWeAskedForMasternodeListEntry.UnserializeChanged(s, mWeAskedForMasternodeListEntry);
+        changesMnbRecoveryRequests.UnserializeChanged(s, mMnbRecoveryRequests);
+        changesMnbRecoveryGoodReplies.UnserializeChanged(s, mMnbRecoveryGoodReplies);
+        changesSeenMasternodeBroadcast.UnserializeChanged(s, mapSeenMasternodeBroadcast);
+        changesSeenMasternodePing.UnserializeChanged(s, mapSeenMasternodePing);
+    }
+
+    void ClearDelta()
+    {
+        LOCK(cs);
+        mnRegistry.ClearChanged();
+        changesAskedUsForMasternodeList.ClearChanged(mAskedUsForMasternodeList);
+        changesWeAskedForMasternodeList.ClearChanged(mWeAskedForMasternodeList);
+        changesWeAskedForMasternodeListEntry.ClearChanged(mWeAskedForMasternodeListEntry);
+        changesMnbRecoveryRequests.ClearChanged(mMnbRecoveryRequests);
+        changesMnbRecoveryGoodReplies.ClearChanged(mMnbRecoveryGoodReplies);
+        changesSeenMasternodeBroadcast.ClearChanged(mapSeenMasternodeBroadcast);
+        changesSeenMasternodePing.ClearChanged(mapSeenMasternodePing);
+    }
+
     CMasternodeMan();
 
     /// Add an entry
@@ -170,7 +260,7 @@ public:
     /// Find a random entry
     masternode_info_t FindRandomNotInVec(const std::vector<COutPoint> &vecToExclude, int nProtocolVersion = -1);
 
-    std::map<COutPoint, CMasternode> GetFullMasternodeMap() { return mapMasternodes; }
+    std::map<COutPoint, CMasternode> GetFullMasternodeMap();
 
     bool GetMasternodeRanks(rank_pair_vec_t& vecMasternodeRanksRet, int nBlockHeight = -1, int nMinProtocol = 0);
     bool GetMasternodeRank(const COutPoint &outpoint, int& nRankRet, int nBlockHeight = -1, int nMinProtocol = 0);
@@ -180,6 +270,8 @@ public:
     void ProcessPendingMnbRequests(CConnman& connman);
 
     void ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStream& vRecv, CConnman& connman);
+    /// Verify the signatures of the queued announces and pings in a batch and finish them
+    void ProcessPendingMessages(CConnman& connman) { pendingMessages.Process(connman); }
 
     void DoFullVerificationStep(CConnman& connman);
     void CheckSameAddr(bool fApplyNewRules);
@@ -190,7 +282,7 @@ public:
     void ProcessVerifyBroadcast(CNode* pnode, const CMasternodeVerification& mnv);
 
     /// Return the number of (unique) Masternodes
-    int size() { return mapMasternodes.size(); }
+    int size() { return mnRegistry.size(); }
 
     std::string ToString() const;
 
@@ -3,12 +3,91 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <base58.h>
+#include <checkqueue.h>
+#include <cuckoocache.h>
 #include <hash.h>
+#include <random.h>
+#include <script/sigcache.h>
 #include <validation.h> // For strMessageMagic
 #include <messagesigner.h>
+#include <net.h>
 #include <tinyformat.h>
+#include <util.h>
 #include <utilstrencodings.h>
 
+#include <boost/thread.hpp>
+
+namespace {
+/**
+ * Cache of valid masternode message signatures, so that signatures seen again,
+ * e.g. the ping inside an announce or a re-relayed vote, are not recovered twice.
+ */
+class CHashSigCache
+{
+private:
+    //! Entries are SHA256(nonce || hash || key id || signature)
+    uint256 nonce;
+    typedef CuckooCache::cache<uint256, SignatureCacheHasher> map_type;
+    map_type setValid;
+    boost::shared_mutex cs_hashsigcache;
+    size_t nCapacity;
+
+public:
+    CHashSigCache() : nCapacity(0)
+    {
+        GetRandBytes(nonce.begin(), 32);
+    }
+
+    void ComputeEntry(uint256& entry, const uint256& hash, const CKeyID& keyID, const std::vector<unsigned char>& vchSig) const
+    {
+        CSHA256().Write(nonce.begin(), 32).Write(hash.begin(), 32).Write(keyID.begin(), keyID.size()).Write(vchSig.data(), vchSig.size()).Finalize(entry.begin());
+    }
+
+    bool Get(const uint256& entry)
+    {
+        boost::shared_lock<boost::shared_mutex> lock(cs_hashsigcache);
+        // Not set up by InitHashSigCache, e.g. in the benchmarks
+        if (nCapacity == 0)
+            return false;
+        return setValid.contains(entry, false);
+    }
+
+    void Set(uint256& entry)
+    {
+        boost::unique_lock<boost::shared_mutex> lock(cs_hashsigcache);
+        if (nCapacity == 0)
+            return;
+        setValid.insert(entry);
+    }
+
+    uint32_t setup_bytes(size_t n)
+    {
+        boost::unique_lock<boost::shared_mutex> lock(cs_hashsigcache);
+        nCapacity = setValid.setup_bytes(n);
+        return nCapacity;
+    }
+};
+
+static CHashSigCache hashSigCache;
+static CCheckQueue<CHashSigCheck> hashsigcheckqueue(16);
+//! Results taken by VerifyHash on this thread, see CHashSigResultsScope
+static thread_local const hashsig_results_t* pmapHashSigResults = nullptr;
+} // namespace
+
+void InitHashSigCache()
+{
+    size_t nMaxCacheSize = std::min(std::max((int64_t)0, gArgs.GetArg("-maxmnsigcachesize", DEFAULT_MAX_HASH_SIG_CACHE_SIZE)), MAX_MAX_HASH_SIG_CACHE_SIZE) * ((size_t) 1 << 20);
+    size_t nElems = hashSigCache.setup_bytes(nMaxCacheSize);
+    LogPrintf("Using %zu MiB out of %zu requested for masternode message signature cache, able to store %zu elements\n",
+            (nElems*sizeof(uint256)) >>20, nMaxCacheSize>>20, nElems);
+}
+
+void ThreadHashSigCheck()
+{
+    RenameThread("globaltoken-sigch");
+    hashsigcheckqueue.Thread();
+}
+
 bool CMessageSigner::GetKeysFromSecret(const std::string& strSecret, CKey& keyRet, CPubKey& pubkeyRet)
 {
     CBitcoinSecret vchSecret;
@@ -21,13 +100,18 @@ bool CMessageSigner::GetKeysFromSecret(const std::string& strSecret, CKey& keyRe
     return true;
 }
 
-bool CMessageSigner::SignMessage(const std::string& strMessage, std::vector<unsigned char>& vchSigRet, const CKey& key)
+uint256 CMessageSigner::GetMessageHash(const std::string& strMessage)
 {
     CHashWriter ss(SER_GETHASH, 0);
     ss << strMessageMagic;
     ss << strMessage;
 
-    return CHashSigner::SignHash(ss.GetHash(), key, vchSigRet);
+    return ss.GetHash();
+}
+
+bool CMessageSigner::SignMessage(const std::string& strMessage, std::vector<unsigned char>& vchSigRet, const CKey& key)
+{
+    return CHashSigner::SignHash(GetMessageHash(strMessage), key, vchSigRet);
 }
 
 bool CMessageSigner::VerifyMessage(const CPubKey& pubkey, const std::vector<unsigned char>& vchSig, const std::string& strMessage, std::string& strErrorRet)
@@ -37,11 +121,13 @@ bool CMessageSigner::VerifyMessage(const CPubKey& pubkey, const std::vector<unsi
 
 bool CMessageSigner::VerifyMessage(const CKeyID& keyID, const std::vector<unsigned char>& vchSig, const std::string& strMessage, std::string& strErrorRet)
 {
-    CHashWriter ss(SER_GETHASH, 0);
-    ss << strMessageMagic;
-    ss << strMessage;
+    return CHashSigner::VerifyHash(GetMessageHash(strMessage), keyID, vchSig, strErrorRet);
+}
 
-    return CHashSigner::VerifyHash(ss.GetHash(), keyID, vchSig, strErrorRet);
+bool CHashSigCheck::operator()()
+{
+    presult->fValid = CHashSigner::VerifyHash(hash, keyID, vchSig, presult->strError);
+    return true;
 }
 
 bool CHashSigner::SignHash(const uint256& hash, const CKey& key, std::vector<unsigned char>& vchSigRet)
@@ -56,6 +142,19 @@ bool CHashSigner::VerifyHash(const uint256& hash, const CPubKey& pubkey, const s
 
 bool CHashSigner::VerifyHash(const uint256& hash, const CKeyID& keyID, const std::vector<unsigned char>& vchSig, std::string& strErrorRet)
 {
+    uint256 entry;
+    hashSigCache.ComputeEntry(entry, hash, keyID, vchSig);
+    if (hashSigCache.Get(entry))
+        return true;
+
+    if (pmapHashSigResults != nullptr) {
+        auto it = pmapHashSigResults->find(entry);
+        if (it != pmapHashSigResults->end()) {
+            strErrorRet = it->second.strError;
+            return it->second.fValid;
+        }
+    }
+
     CPubKey pubkeyFromSig;
     if(!pubkeyFromSig.RecoverCompact(hash, vchSig)) {
         strErrorRet = "Error recovering public key.";
@@ -69,5 +168,77 @@ bool CHashSigner::VerifyHash(const uint256& hash, const CKeyID& keyID, const std
         return false;
     }
 
+    hashSigCache.Set(entry);
     return true;
 }
+
+void CHashSigner::VerifyHashes(std::vector<CHashSigCheck>& vChecks, hashsig_results_t& mapResultsRet)
+{
+    std::vector<CHashSigCheck> vChecksToRun;
+    for (CHashSigCheck& check : vChecks) {
+        uint256 entry;
+        hashSigCache.ComputeEntry(entry, check.hash, check.keyID, check.vchSig);
+        auto ret = mapResultsRet.emplace(entry, CHashSigResult{true, ""});
+        // signatures seen before in the cache or in this batch are not verified again
+        if (!ret.second || hashSigCache.Get(entry))
+            continue;
+        check.presult = &ret.first->second;
+        vChecksToRun.emplace_back();
+        vChecksToRun.back().swap(check);
+    }
+    if (vChecksToRun.empty())
+        return;
+
+    // without signature check threads, Wait() verifies the batch on this thread
+    CCheckQueueControl<CHashSigCheck> control(&hashsigcheckqueue);
+    control.Add(vChecksToRun);
+    control.Wait();
+}
+
+CHashSigResultsScope::CHashSigResultsScope(const hashsig_results_t& mapResults) : pprev(pmapHashSigResults)
+{
+    pmapHashSigResults = &mapResults;
+}
+
+CHashSigResultsScope::~CHashSigResultsScope()
+{
+    pmapHashSigResults = pprev;
+}
+
+bool CPendingSigMessages::Add(CNode* pfrom, std::vector<CHashSigCheck>& vChecks, finish_t finish)
+{
+    LOCK(cs);
+    if (vecMessages.empty())
+        nTimeFirst = GetTimeMillis();
+    vecMessages.emplace_back(pfrom->AddRef(), std::move(finish));
+    for (CHashSigCheck& check : vChecks) {
+        vecChecks.emplace_back();
+        vecChecks.back().swap(check);
+    }
+    return vecMessages.size() >= MAX_PENDING_MESSAGES || GetTimeMillis() - nTimeFirst >= MAX_PENDING_MILLIS;
+}
+
+void CPendingSigMessages::Process(CConnman& connman)
+{
+    LOCK(cs_process);
+
+    std::vector<std::pair<CNode*, finish_t> > vecMessagesBatch;
+    std::vector<CHashSigCheck> vecChecksBatch;
+    {
+        LOCK(cs);
+        vecMessagesBatch.swap(vecMessages);
+        vecChecksBatch.swap(vecChecks);
+        nTimeFirst = 0;
+    }
+    if (vecMessagesBatch.empty())
+        return;
+
+    hashsig_results_t mapResults;
+    CHashSigner::VerifyHashes(vecChecksBatch, mapResults);
+
+    CHashSigResultsScope scope(mapResults);
+    for (auto& message : vecMessagesBatch) {
+        message.second(message.first, connman);
+        message.first->Release();
+    }
+}
@@ -6,6 +6,25 @@
 #define MESSAGESIGNER_H
 
 #include <key.h>
+#include <sync.h>
+
+#include <functional>
+#include <map>
+#include <vector>
+
+class CConnman;
+class CNode;
+
+/** Default for -maxmnsigcachesize, the size of the verified masternode message signature cache in MiB */
+static const unsigned int DEFAULT_MAX_HASH_SIG_CACHE_SIZE = 2;
+/** Maximum -maxmnsigcachesize */
+static const int64_t MAX_MAX_HASH_SIG_CACHE_SIZE = 256;
+
+/** To be called once in AppInitMain/BasicTestingSetup to size the verified signature cache. */
+void InitHashSigCache();
+
+/** Run a thread verifying batches of signatures queued by CHashSigner::VerifyHashes */
+void ThreadHashSigCheck();
 
 /** Helper class for signing messages and checking their signatures
  */
@@ -14,6 +33,8 @@ class CMessageSigner
 public:
     /// Set the private/public key values, returns true if successful
     static bool GetKeysFromSecret(const std::string& strSecret, CKey& keyRet, CPubKey& pubkeyRet);
+    /// Get the hash that is signed for the message
+    static uint256 GetMessageHash(const std::string& strMessage);
     /// Sign the message, returns true if successful
     static bool SignMessage(const std::string& strMessage, std::vector<unsigned char>& vchSigRet, const CKey& key);
     /// Verify the message signature, returns true if succcessful
@@ -22,6 +43,45 @@ public:
     static bool VerifyMessage(const CKeyID& keyID, const std::vector<unsigned char>& vchSig, const std::string& strMessage, std::string& strErrorRet);
 };
 
+/** Outcome of a signature verified by CHashSigner::VerifyHashes */
+struct CHashSigResult
+{
+    bool fValid;
+    std::string strError;
+};
+
+/** Results of a batch of signatures, by their entry in the verified signature cache */
+typedef std::map<uint256, CHashSigResult> hashsig_results_t;
+
+/** Closure verifying one hash signature, so that signatures can be verified on a CCheckQueue worker pool
+ */
+class CHashSigCheck
+{
+private:
+    uint256 hash;
+    CKeyID keyID;
+    std::vector<unsigned char> vchSig;
+    CHashSigResult* presult;
+
+    friend class CHashSigner;
+
+public:
+    CHashSigCheck() : presult(nullptr) {}
+    CHashSigCheck(const uint256& hashIn, const CKeyID& keyIDIn, const std::vector<unsigned char>& vchSigIn) :
+        hash(hashIn), keyID(keyIDIn), vchSig(vchSigIn), presult(nullptr) {}
+
+    /// Verify the signature and store its result. Always returns true, so that
+    /// one invalid signature does not stop the others of the batch.
+    bool operator()();
+
+    void swap(CHashSigCheck& check) {
+        std::swap(hash, check.hash);
+        std::swap(keyID, check.keyID);
+        vchSig.swap(check.vchSig);
+        std::swap(presult, check.presult);
+    }
+};
+
 /** Helper class for signing hashes and checking their signatures
  */
 class CHashSigner
@@ -33,6 +93,61 @@ public:
     static bool VerifyHash(const uint256& hash, const CPubKey& pubkey, const std::vector<unsigned char>& vchSig, std::string& strErrorRet);
     /// Verify the hash signature, returns true if succcessful
     static bool VerifyHash(const uint256& hash, const CKeyID& keyID, const std::vector<unsigned char>& vchSig, std::string& strErrorRet);
+    /// Verify a batch of hash signatures on the signature check threads. Signatures in the
+    /// verified signature cache are not verified again, valid ones are added to it.
+    static void VerifyHashes(std::vector<CHashSigCheck>& vChecks, hashsig_results_t& mapResultsRet);
+};
+
+/**
+ * While alive, CHashSigner::VerifyHash on the thread that created it takes the
+ * results of a batch verified by CHashSigner::VerifyHashes for the signatures
+ * of the batch, instead of verifying them a second time.
+ */
+class CHashSigResultsScope
+{
+private:
+    const hashsig_results_t* pprev;
+
+public:
+    explicit CHashSigResultsScope(const hashsig_results_t& mapResults);
+    ~CHashSigResultsScope();
+};
+
+/**
+ * Received messages waiting for their signatures to be verified in a batch.
+ *
+ * Handlers queue a message with the signature checks it needs and the rest of
+ * its handling. Process() verifies the signatures of all queued messages in
+ * one batch, then finishes the messages in the order they arrived, within a
+ * CHashSigResultsScope, so their signature checks find the results. The node
+ * a message came from is referenced until the message is finished.
+ */
+class CPendingSigMessages
+{
+public:
+    typedef std::function<void(CNode* pfrom, CConnman& connman)> finish_t;
+
+private:
+    /** Number of queued messages that makes Add() ask for a batch */
+    static const size_t MAX_PENDING_MESSAGES = 64;
+    /** Milliseconds after which queued messages make Add() ask for a batch */
+    static const int64_t MAX_PENDING_MILLIS = 100;
+
+    CCriticalSection cs;
+    std::vector<std::pair<CNode*, finish_t> > vecMessages;
+    std::vector<CHashSigCheck> vecChecks;
+    //! When the oldest queued message arrived, 0 if none is queued
+    int64_t nTimeFirst;
+    //! Held while a batch is finished, so messages are finished in the order they arrived
+    CCriticalSection cs_process;
+
+public:
+    CPendingSigMessages() : nTimeFirst(0) {}
+
+    /// Queue a message whose signatures are checked by vChecks, returns whether a batch is due
+    bool Add(CNode* pfrom, std::vector<CHashSigCheck>& vChecks, finish_t finish);
+    /// Verify the signatures of the queued messages and finish them
+    void Process(CConnman& connman);
 };
 
 #endif
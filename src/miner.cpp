@@ -14,6 +14,7 @@
 #include <consensus/tx_verify.h>
 #include <consensus/merkle.h>
 #include <consensus/validation.h>
+#include <crypto/common.h>
 #include <globaltoken/hardfork.h>
 #include <hash.h>
 #include <validation.h>
@@ -21,8 +22,10 @@
 #include <policy/feerate.h>
 #include <policy/policy.h>
 #include <pow.h>
+#include <primitives/mining_block.h>
 #include <primitives/transaction.h>
 #include <script/standard.h>
+#include <streams.h>
 #include <timedata.h>
 #include <util.h>
 #include <utilmoneystr.h>
@@ -64,6 +67,43 @@ int64_t UpdateTime(CBlockHeader* pblock, const Consensus::Params& consensusParam
     return nNewTime - nOldTime;
 }
 
+bool IsAlgoMineable(uint8_t algo, int64_t nTime, const Consensus::Params& consensusParams)
+{
+    return consensusParams.Hardfork2.IsActivated((uint32_t)nTime) || IsAlgoAllowedBeforeHF2(algo);
+}
+
+void FillBlockHeader(CBlock* pblock, const CBlockIndex* pindexPrev, uint8_t algo, const CChainParams& chainparams)
+{
+    const Consensus::Params& consensusParams = chainparams.GetConsensus();
+    const int32_t nChainId = consensusParams.nAuxpowChainId;
+
+    pblock->SetBaseVersion(ComputeBlockVersion(pindexPrev, consensusParams), nChainId);
+
+    // -regtest only: allow overriding block.nVersion with
+    // -blockversion=N to test forking scenarios
+    if (chainparams.MineBlocksOnDemand())
+        pblock->SetBaseVersion(gArgs.GetArg("-blockversion", pblock->GetBaseVersion(nChainId)), nChainId);
+
+    pblock->SetAlgo(algo);
+
+    arith_uint256 nonce;
+    if (consensusParams.Hardfork1.IsActivated(pblock->nTime) && IsEquihashBasedAlgo(algo)) {
+        // Randomise nonce for new block format.
+        nonce = UintToArith256(GetRandHash());
+        // Clear the top and bottom 16 bits (for local use as thread flags and counters)
+        nonce <<= 32;
+        nonce >>= 16;
+    }
+
+    pblock->hashPrevBlock  = pindexPrev->GetBlockHash();
+    pblock->hashReserved   = uint256();
+    UpdateTime(pblock, consensusParams, pindexPrev, algo);
+    pblock->nBits          = GetNextWorkRequired(pindexPrev, pblock, consensusParams, algo);
+    pblock->nNonce         = 0;
+    pblock->nBigNonce      = ArithToUint256(nonce);
+    pblock->nSolution.clear();
+}
+
 BlockAssembler::Options::Options() {
     blockMinFeeRate = CFeeRate(DEFAULT_BLOCK_MIN_TX_FEE);
     nBlockMaxWeight = DEFAULT_BLOCK_MAX_WEIGHT;
@@ -110,7 +150,7 @@ void BlockAssembler::resetBlock()
     nFees = 0;
 }
 
-std::unique_ptr<CBlockTemplate> BlockAssembler::CreateNewBlock(const CScript& scriptPubKeyIn, uint8_t algo, bool fMineWitnessTx)
+std::unique_ptr<CBlockTemplate> BlockAssembler::CreateNewBlock(const CScript& scriptPubKeyIn, uint8_t algo, bool fMineWitnessTx, CNextBlockCandidates* pcandidates)
 {
     int64_t nTimeStart = GetTimeMicros();
 
@@ -134,7 +174,7 @@ std::unique_ptr<CBlockTemplate> BlockAssembler::CreateNewBlock(const CScript& sc
     
     int64_t currenttime = GetAdjustedTime();
     
-    if (!chainparams.GetConsensus().Hardfork2.IsActivated((uint32_t)currenttime) && !IsAlgoAllowedBeforeHF2(algo)) {
+    if (!IsAlgoMineable(algo, currenttime, chainparams.GetConsensus())) {
         error("Mining algorithm %s is not active yet. It will be activated with hardfork 2, at Unix-Timestamp: %" PRIu32 " // Current time: %" PRIu32, GetAlgoName(algo), chainparams.GetConsensus().Hardfork2.GetActivationTime(), currenttime);
         return nullptr;
     }
@@ -144,17 +184,6 @@ std::unique_ptr<CBlockTemplate> BlockAssembler::CreateNewBlock(const CScript& sc
         LogPrintf("%s", GetCoinbaseFeeString(DIVIDEDPAYMENTS_BLOCK_WARNING));
         // Continue and cancel block mining at getblocktemplate / generateblocks
     }
-    const int32_t nChainId = chainparams.GetConsensus().nAuxpowChainId;
-    
-    pblock->SetBaseVersion(ComputeBlockVersion(pindexPrev, chainparams.GetConsensus()), nChainId);
-	
-    // -regtest only: allow overriding block.nVersion with
-    // -blockversion=N to test forking scenarios
-    if (chainparams.MineBlocksOnDemand())
-        pblock->SetBaseVersion(gArgs.GetArg("-blockversion", pblock->GetBaseVersion(nChainId)), nChainId);
-    
-    pblock->SetAlgo(algo);
-
     pblock->nTime = currenttime;
     const int64_t nMedianTimePast = pindexPrev->GetMedianTimePast();
 
@@ -172,7 +201,10 @@ std::unique_ptr<CBlockTemplate> BlockAssembler::CreateNewBlock(const CScript& sc
 
     int nPackagesSelected = 0;
     int nDescendantsUpdated = 0;
-    addPackageTxs(nPackagesSelected, nDescendantsUpdated);
+    if (pcandidates)
+        addCandidateTxs(*pcandidates, pindexPrev, nPackagesSelected, nDescendantsUpdated);
+    else
+        addPackageTxs(nPackagesSelected, nDescendantsUpdated);
 
     int64_t nTime1 = GetTimeMicros();
 
@@ -210,29 +242,19 @@ std::unique_ptr<CBlockTemplate> BlockAssembler::CreateNewBlock(const CScript& sc
 
     LogPrintf("CreateNewBlock(): block weight: %u txs: %u fees: %ld sigops %d\n", GetBlockWeight(*pblock), nBlockTx, nFees, nBlockSigOpsCost);
 
-   arith_uint256 nonce;
-   if (chainparams.GetConsensus().Hardfork1.IsActivated(pblock->nTime) && (IsEquihashBasedAlgo(algo))) {
-	 // Randomise nonce for new block format.
-	 nonce = UintToArith256(GetRandHash());
-	 // Clear the top and bottom 16 bits (for local use as thread flags and counters)
-	 nonce <<= 32;
-	 nonce >>= 16;
-    }
-	
     // Fill in header
-    pblock->hashPrevBlock  = pindexPrev->GetBlockHash();
-    pblock->hashReserved   = uint256();
-    UpdateTime(pblock, chainparams.GetConsensus(), pindexPrev, algo);
-    pblock->nBits          = GetNextWorkRequired(pindexPrev, pblock, chainparams.GetConsensus(), algo);
-    pblock->nNonce         = 0;
-    pblock->nBigNonce      = ArithToUint256(nonce);
-    pblock->nSolution.clear();
+    FillBlockHeader(pblock, pindexPrev, algo, chainparams);
     pblocktemplate->vTxSigOpsCost[0] = WITNESS_SCALE_FACTOR * GetLegacySigOpCount(*pblock->vtx[0]);
 
     CValidationState state;
     if (!TestBlockValidity(state, chainparams, *pblock, pindexPrev, false, false)) {
         throw std::runtime_error(strprintf("%s: TestBlockValidity failed: %s", __func__, FormatStateMessage(state)));
     }
+    if (pcandidates) {
+        // The selection is only carried over once the block it made is known to be valid
+        LOCK(pcandidates->cs);
+        pcandidates->fValid = true;
+    }
     int64_t nTime2 = GetTimeMicros();
 
     LogPrint(BCLog::BENCH, "CreateNewBlock() packages: %.2fms (%d packages, %d updated descendants), validity: %.2fms (total %.2fms)\n", 0.001 * (nTime1 - nTimeStart), nPackagesSelected, nDescendantsUpdated, 0.001 * (nTime2 - nTime1), 0.001 * (nTime2 - nTimeStart));
@@ -360,7 +382,7 @@ void BlockAssembler::SortForBlock(const CTxMemPool::setEntries& package, CTxMemP
 // Each time through the loop, we compare the best transaction in
 // mapModifiedTxs with the next transaction in the mempool to decide what
 // transaction package to work on next.
-void BlockAssembler::addPackageTxs(int &nPackagesSelected, int &nDescendantsUpdated)
+void BlockAssembler::addPackageTxs(int &nPackagesSelected, int &nDescendantsUpdated, CNextBlockCandidates* pcandidates)
 {
     // mapModifiedTx will store sorted packages after they are modified
     // because some of their txs are already in the block
@@ -483,6 +505,9 @@ void BlockAssembler::addPackageTxs(int &nPackagesSelected, int &nDescendantsUpda
             mapModifiedTx.erase(sortedEntries[i]);
         }
 
+        if (pcandidates)
+            pcandidates->AddPackage(sortedEntries, packageFees, packageSize, packageSigOpsCost);
+
         ++nPackagesSelected;
 
         // Update transactions that depend on each of these
@@ -490,6 +515,338 @@ void BlockAssembler::addPackageTxs(int &nPackagesSelected, int &nDescendantsUpda
     }
 }
 
+void BlockAssembler::addCandidateTxs(CNextBlockCandidates& candidates, const CBlockIndex* pindexPrev, int &nPackagesSelected, int &nDescendantsUpdated)
+{
+    assert(&candidates.pool == &mempool);
+    LOCK(candidates.cs);
+
+    if (!candidates.fValid || candidates.pindexPrev != pindexPrev || candidates.fIncludeWitness != fIncludeWitness ||
+        candidates.nBlockMaxWeight != nBlockMaxWeight || candidates.blockMinFeeRate != blockMinFeeRate ||
+        candidates.nTransactionsUpdated != mempool.GetTransactionsUpdated()) {
+        // Select from the whole mempool
+        candidates.Clear();
+        addPackageTxs(nPackagesSelected, nDescendantsUpdated, &candidates);
+    } else {
+        // Account for the packages selected before, the block is laid out once the selection is final
+        const size_t nPackagesCarried = candidates.vPackages.size();
+        int nPackagesEvicted = 0;
+        for (const CNextBlockCandidates::Package& package : candidates.vPackages) {
+            for (CTxMemPool::txiter it : package.entries) {
+                nBlockWeight += it->GetTxWeight();
+                nBlockSigOpsCost += it->GetSigOpCost();
+                inBlock.insert(it);
+            }
+        }
+
+        // Transactions that entered the mempool since, best ancestor feerate first
+        std::vector<CTxMemPool::txiter> vAdded;
+        for (const uint256& hash : candidates.vAdded) {
+            CTxMemPool::txiter it = mempool.mapTx.find(hash);
+            if (it != mempool.mapTx.end())
+                vAdded.push_back(it);
+        }
+        std::sort(vAdded.begin(), vAdded.end(), [](CTxMemPool::txiter a, CTxMemPool::txiter b) {
+            return CompareTxMemPoolEntryByAncestorFee()(*a, *b);
+        });
+
+        const uint64_t nNoLimit = std::numeric_limits<uint64_t>::max();
+        std::string dummy;
+        for (CTxMemPool::txiter iter : vAdded) {
+            // Already selected with the package of a descendant
+            if (inBlock.count(iter))
+                continue;
+
+            CTxMemPool::setEntries ancestors;
+            mempool.CalculateMemPoolAncestors(*iter, ancestors, nNoLimit, nNoLimit, nNoLimit, nNoLimit, dummy, false);
+            CTxMemPool::setEntries package = ancestors;
+            onlyUnconfirmed(package);
+            package.insert(iter);
+
+            uint64_t packageSize = 0;
+            CAmount packageFees = 0;
+            int64_t packageSigOpsCost = 0;
+            for (CTxMemPool::txiter it : package) {
+                packageSize += it->GetTxSize();
+                packageFees += it->GetModifiedFee();
+                packageSigOpsCost += it->GetSigOpCost();
+            }
+            if (packageFees < blockMinFeeRate.GetFee(packageSize) || !TestPackageTransactions(package))
+                continue;
+
+            if (!TestPackage(packageSize, packageSigOpsCost)) {
+                // Make room by evicting lower feerate packages that nothing selected depends on, lowest first.
+                // The ancestors of the new package stay, it could not be added without them. The freed space
+                // is only refilled from the new transactions, so the evicted packages must pay less in total.
+                std::vector<size_t> vEvictable;
+                for (size_t i = 0; i < candidates.vPackages.size(); i++) {
+                    const CNextBlockCandidates::Package& evictable = candidates.vPackages[i];
+                    if (evictable.fEvicted || evictable.nDependents > 0 ||
+                        double(evictable.nModFees) * packageSize >= double(packageFees) * evictable.nSize)
+                        continue;
+                    bool fAncestor = false;
+                    for (CTxMemPool::txiter it : evictable.entries)
+                        fAncestor = fAncestor || ancestors.count(it);
+                    if (!fAncestor)
+                        vEvictable.push_back(i);
+                }
+                std::sort(vEvictable.begin(), vEvictable.end(), [&candidates](size_t a, size_t b) {
+                    const CNextBlockCandidates::Package& pa = candidates.vPackages[a];
+                    const CNextBlockCandidates::Package& pb = candidates.vPackages[b];
+                    return double(pa.nModFees) * pb.nSize < double(pb.nModFees) * pa.nSize;
+                });
+
+                uint64_t nWeightFreed = 0;
+                int64_t nSigOpsCostFreed = 0;
+                CAmount nFeesEvicted = 0;
+                size_t nEvict = 0;
+                while (nEvict < vEvictable.size() && nFeesEvicted < packageFees &&
+                       (nBlockWeight - nWeightFreed + WITNESS_SCALE_FACTOR * packageSize >= nBlockMaxWeight ||
+                        nBlockSigOpsCost - nSigOpsCostFreed + packageSigOpsCost >= MAX_BLOCK_SIGOPS_COST)) {
+                    for (CTxMemPool::txiter it : candidates.vPackages[vEvictable[nEvict]].entries) {
+                        nWeightFreed += it->GetTxWeight();
+                        nSigOpsCostFreed += it->GetSigOpCost();
+                    }
+                    nFeesEvicted += candidates.vPackages[vEvictable[nEvict]].nModFees;
+                    nEvict++;
+                }
+                if (nFeesEvicted >= packageFees ||
+                    nBlockWeight - nWeightFreed + WITNESS_SCALE_FACTOR * packageSize >= nBlockMaxWeight ||
+                    nBlockSigOpsCost - nSigOpsCostFreed + packageSigOpsCost >= MAX_BLOCK_SIGOPS_COST)
+                    continue;
+
+                for (size_t i = 0; i < nEvict; i++) {
+                    for (CTxMemPool::txiter it : candidates.vPackages[vEvictable[i]].entries)
+                        inBlock.erase(it);
+                    candidates.EvictPackage(vEvictable[i]);
+                    ++nPackagesEvicted;
+                }
+                nBlockWeight -= nWeightFreed;
+                nBlockSigOpsCost -= nSigOpsCostFreed;
+            }
+
+            std::vector<CTxMemPool::txiter> sortedEntries;
+            SortForBlock(package, iter, sortedEntries);
+            for (CTxMemPool::txiter it : sortedEntries) {
+                nBlockWeight += it->GetTxWeight();
+                nBlockSigOpsCost += it->GetSigOpCost();
+                inBlock.insert(it);
+            }
+            candidates.AddPackage(sortedEntries, packageFees, packageSize, packageSigOpsCost);
+            ++nPackagesSelected;
+        }
+
+        // Lay out the block from the selection
+        candidates.Compact();
+        const bool fIncludeWitnessSelected = fIncludeWitness;
+        resetBlock();
+        fIncludeWitness = fIncludeWitnessSelected;
+        for (const CNextBlockCandidates::Package& package : candidates.vPackages) {
+            for (CTxMemPool::txiter it : package.entries)
+                AddToBlock(it);
+        }
+        LogPrint(BCLog::BENCH, "CreateNewBlock() carried over %u packages, %u new transactions: %d packages selected, %d evicted\n",
+                 nPackagesCarried, vAdded.size(), nPackagesSelected, nPackagesEvicted);
+    }
+
+    // CreateNewBlock marks the selection valid once its block passed validation
+    candidates.fValid = false;
+    candidates.pindexPrev = pindexPrev;
+    candidates.fIncludeWitness = fIncludeWitness;
+    candidates.nBlockMaxWeight = nBlockMaxWeight;
+    candidates.blockMinFeeRate = blockMinFeeRate;
+    candidates.nTransactionsUpdated = mempool.GetTransactionsUpdated();
+    candidates.nPoolSize = mempool.mapTx.size();
+    candidates.vAdded.clear();
+}
+
+CNextBlockCandidates::CNextBlockCandidates(CTxMemPool& poolIn) :
+    pool(poolIn), fValid(false), pindexPrev(nullptr), fIncludeWitness(false), nBlockMaxWeight(0), nTransactionsUpdated(0), nPoolSize(0)
+{
+    pool.NotifyEntryAdded.connect(boost::bind(&CNextBlockCandidates::TransactionAddedToMempool, this, _1));
+    pool.NotifyEntryRemoved.connect(boost::bind(&CNextBlockCandidates::TransactionRemovedFromMempool, this, _1, _2));
+}
+
+CNextBlockCandidates::~CNextBlockCandidates()
+{
+    pool.NotifyEntryAdded.disconnect(boost::bind(&CNextBlockCandidates::TransactionAddedToMempool, this, _1));
+    pool.NotifyEntryRemoved.disconnect(boost::bind(&CNextBlockCandidates::TransactionRemovedFromMempool, this, _1, _2));
+}
+
+void CNextBlockCandidates::Clear()
+{
+    fValid = false;
+    vPackages.clear();
+    mapPackageIndex.clear();
+    setSelected.clear();
+    vAdded.clear();
+}
+
+void CNextBlockCandidates::AddPackage(std::vector<CTxMemPool::txiter> entries, CAmount nModFees, uint64_t nSize, int64_t nSigOpsCost)
+{
+    const size_t nIndex = vPackages.size();
+    for (CTxMemPool::txiter it : entries) {
+        for (CTxMemPool::txiter parent : pool.GetMemPoolParents(it)) {
+            auto mi = mapPackageIndex.find(parent);
+            if (mi != mapPackageIndex.end() && mi->second != nIndex)
+                vPackages[mi->second].nDependents++;
+        }
+        mapPackageIndex[it] = nIndex;
+        setSelected.insert(it->GetTx().GetHash());
+    }
+    vPackages.push_back(Package{std::move(entries), nModFees, nSize, nSigOpsCost, 0, false});
+}
+
+void CNextBlockCandidates::EvictPackage(size_t nIndex)
+{
+    Package& package = vPackages[nIndex];
+    assert(!package.fEvicted && package.nDependents == 0);
+    for (CTxMemPool::txiter it : package.entries) {
+        mapPackageIndex.erase(it);
+        setSelected.erase(it->GetTx().GetHash());
+    }
+    for (CTxMemPool::txiter it : package.entries) {
+        for (CTxMemPool::txiter parent : pool.GetMemPoolParents(it)) {
+            auto mi = mapPackageIndex.find(parent);
+            if (mi != mapPackageIndex.end())
+                vPackages[mi->second].nDependents--;
+        }
+    }
+    package.fEvicted = true;
+}
+
+void CNextBlockCandidates::Compact()
+{
+    size_t nKept = 0;
+    for (size_t i = 0; i < vPackages.size(); i++) {
+        if (vPackages[i].fEvicted)
+            continue;
+        if (nKept != i) {
+            vPackages[nKept] = std::move(vPackages[i]);
+            for (CTxMemPool::txiter it : vPackages[nKept].entries)
+                mapPackageIndex[it] = nKept;
+        }
+        nKept++;
+    }
+    vPackages.resize(nKept);
+}
+
+void CNextBlockCandidates::TransactionAddedToMempool(CTransactionRef ptx)
+{
+    LOCK(cs);
+    if (!fValid)
+        return;
+    nTransactionsUpdated++;
+    vAdded.push_back(ptx->GetHash());
+    // Past the size of the mempool selecting from all of it is no more work
+    if (vAdded.size() > nPoolSize)
+        Clear();
+}
+
+void CNextBlockCandidates::TransactionRemovedFromMempool(CTransactionRef ptx, MemPoolRemovalReason reason)
+{
+    LOCK(cs);
+    if (!fValid)
+        return;
+    nTransactionsUpdated++;
+    // The selection holds iterators into the mempool, which the removal invalidates
+    if (setSelected.count(ptx->GetHash()))
+        Clear();
+}
+
+/** Number of nonces hashed per MultiAlgoHashBatch call */
+static const uint32_t MINING_SCAN_BATCH = 16;
+
+CMiningContext::CMiningContext(const CDefaultBlockHeader& headerIn, uint8_t nAlgoIn, int nHashVersionIn) : nAlgo(nAlgoIn), nHashVersion(nHashVersionIn)
+{
+    CDataStream ss(SER_GETHASH, nHashVersion);
+    ss << headerIn;
+    assert(ss.size() == MULTIHASH_HEADER_SIZE);
+    memcpy(header, ss.data(), MULTIHASH_HEADER_SIZE);
+    midstate.Write(header, 64);
+}
+
+bool CMiningContext::ScanNonces(uint32_t nStart, uint32_t nCount, const arith_uint256& bnTarget, uint32_t& nNonceRet)
+{
+    unsigned char batch[MINING_SCAN_BATCH][MULTIHASH_HEADER_SIZE];
+    uint256 hashes[MINING_SCAN_BATCH];
+    for (uint32_t nDone = 0; nDone < nCount; ) {
+        const uint32_t n = std::min(nCount - nDone, MINING_SCAN_BATCH);
+        if (nAlgo == ALGO_SHA256D) {
+            unsigned char tail[MULTIHASH_HEADER_SIZE - 64];
+            memcpy(tail, header + 64, sizeof(tail));
+            for (uint32_t i = 0; i < n; i++) {
+                WriteLE32(tail + sizeof(tail) - 4, nStart + nDone + i);
+                CHash256(midstate).Write(tail, sizeof(tail)).Finalize(hashes[i].begin());
+            }
+        } else {
+            for (uint32_t i = 0; i < n; i++) {
+                memcpy(batch[i], header, MULTIHASH_HEADER_SIZE - 4);
+                WriteLE32(batch[i] + MULTIHASH_HEADER_SIZE - 4, nStart + nDone + i);
+            }
+            MultiAlgoHashBatch(nAlgo, batch, n, hashes, nHashVersion);
+        }
+        for (uint32_t i = 0; i < n; i++) {
+            if (UintToArith256(hashes[i]) <= bnTarget) {
+                nNonceRet = nStart + nDone + i;
+                return true;
+            }
+        }
+        nDone += n;
+    }
+    return false;
+}
+
+CBlockTemplateCache::CBlockTemplateCache(const CChainParams& params, int64_t nRefreshIntervalIn) :
+    chainparams(params), nRefreshInterval(nRefreshIntervalIn), pindexPrev(nullptr), nTransactionsUpdated(0), nStart(0), fMineWitnessTx(false), candidates(mempool)
+{
+}
+
+std::shared_ptr<CBlockTemplate> CBlockTemplateCache::Get(const CScript& scriptPubKeyIn, uint8_t algo, bool fMineWitnessTxIn)
+{
+    AssertLockHeld(cs_main);
+    assert(algo < NUM_ALGOS_IMPL);
+
+    if (pindexPrev != chainActive.Tip() || scriptPubKey != scriptPubKeyIn || fMineWitnessTx != fMineWitnessTxIn ||
+        (mempool.GetTransactionsUpdated() != nTransactionsUpdated && GetTime() - nStart > nRefreshInterval)) {
+        // Drop the old templates, so future calls select again despite any failures from here on
+        pshared.reset();
+        pindexPrev = nullptr;
+        templates.fill(nullptr);
+    }
+
+    if (templates[algo])
+        return templates[algo];
+
+    if (!pshared) {
+        const unsigned int nTransactionsUpdatedNew = mempool.GetTransactionsUpdated();
+        const CBlockIndex* pindexPrevNew = chainActive.Tip();
+        std::shared_ptr<CBlockTemplate> pblocktemplate = BlockAssembler(chainparams).CreateNewBlock(scriptPubKeyIn, algo, fMineWitnessTxIn, &candidates);
+        if (!pblocktemplate)
+            return nullptr;
+
+        // Update only after CreateNewBlock succeeded
+        pshared = pblocktemplate;
+        pindexPrev = pindexPrevNew;
+        nTransactionsUpdated = nTransactionsUpdatedNew;
+        nStart = GetTime();
+        scriptPubKey = scriptPubKeyIn;
+        fMineWitnessTx = fMineWitnessTxIn;
+        templates[algo] = pblocktemplate;
+        return pblocktemplate;
+    }
+
+    if (!IsAlgoMineable(algo, GetAdjustedTime(), chainparams.GetConsensus()))
+        return nullptr;
+
+    // The header is all that depends on the algo, the transactions were validated with the shared template
+    int64_t nTimeStart = GetTimeMicros();
+    std::shared_ptr<CBlockTemplate> pblocktemplate = std::make_shared<CBlockTemplate>(*pshared);
+    FillBlockHeader(&pblocktemplate->block, pindexPrev, algo, chainparams);
+    templates[algo] = pblocktemplate;
+    LogPrint(BCLog::BENCH, "CBlockTemplateCache: %s template from the %s one: %.2fms\n", GetAlgoName(algo), GetAlgoName(pshared->block.GetAlgo()), 0.001 * (GetTimeMicros() - nTimeStart));
+    return pblocktemplate;
+}
+
 void IncrementExtraNonce(CBlock* pblock, const CBlockIndex* pindexPrev, unsigned int& nExtraNonce)
 {
     // Update nExtraNonce
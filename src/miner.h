@@ -6,16 +6,23 @@
 #ifndef BITCOIN_MINER_H
 #define BITCOIN_MINER_H
 
+#include <arith_uint256.h>
+#include <globaltoken/multihasher.h>
+#include <hash.h>
 #include <primitives/block.h>
 #include <txmempool.h>
 
 #include <stdint.h>
+#include <array>
+#include <map>
 #include <memory>
+#include <set>
 #include <boost/multi_index_container.hpp>
 #include <boost/multi_index/ordered_index.hpp>
 
 class CBlockIndex;
 class CChainParams;
+class CDefaultBlockHeader;
 class CScript;
 
 namespace Consensus { struct Params; };
@@ -119,6 +126,67 @@ struct update_for_parent_inclusion
     CTxMemPool::txiter iter;
 };
 
+/**
+ * The transaction packages selected for the next block, kept in step with the
+ * mempool between block templates. A template refresh carries the selection
+ * over and only selects the packages of the transactions that entered the
+ * mempool since, evicting lower feerate packages to make room for them. It
+ * starts over from the whole mempool on a new tip, when a selected transaction
+ * left the mempool, or when the mempool changed in a way it did not notify.
+ */
+class CNextBlockCandidates
+{
+public:
+    explicit CNextBlockCandidates(CTxMemPool& poolIn);
+    ~CNextBlockCandidates();
+
+private:
+    friend class BlockAssembler;
+
+    struct Package
+    {
+        //! The transactions of the package, in a valid order
+        std::vector<CTxMemPool::txiter> entries;
+        CAmount nModFees;
+        uint64_t nSize;
+        int64_t nSigOpsCost;
+        //! Packages selected after this one that spend its outputs
+        int nDependents;
+        bool fEvicted;
+    };
+
+    CTxMemPool& pool;
+    CCriticalSection cs;
+
+    //! Whether the selection can be carried over, and what it was made for
+    bool fValid;
+    const CBlockIndex* pindexPrev;
+    bool fIncludeWitness;
+    unsigned int nBlockMaxWeight;
+    CFeeRate blockMinFeeRate;
+    //! Mempool update counter, counting the notifications since the selection
+    unsigned int nTransactionsUpdated;
+    size_t nPoolSize;
+
+    //! The selection, in block order
+    std::vector<Package> vPackages;
+    std::map<CTxMemPool::txiter, size_t, CTxMemPool::CompareIteratorByHash> mapPackageIndex;
+    std::set<uint256> setSelected;
+    //! Transactions that entered the mempool since the selection
+    std::vector<uint256> vAdded;
+
+    void Clear();
+    /** Append a package to the selection. Requires pool.cs. */
+    void AddPackage(std::vector<CTxMemPool::txiter> entries, CAmount nModFees, uint64_t nSize, int64_t nSigOpsCost);
+    /** Take a package out of the selection, nothing selected may depend on it. Requires pool.cs. */
+    void EvictPackage(size_t nIndex);
+    /** Drop the evicted packages from the selection */
+    void Compact();
+
+    void TransactionAddedToMempool(CTransactionRef ptx);
+    void TransactionRemovedFromMempool(CTransactionRef ptx, MemPoolRemovalReason reason);
+};
+
 /** Generate a new block, without valid proof-of-work */
 class BlockAssembler
 {
@@ -155,8 +223,12 @@ public:
     explicit BlockAssembler(const CChainParams& params);
     BlockAssembler(const CChainParams& params, const Options& options);
 
-    /** Construct a new block template with coinbase to scriptPubKeyIn */
-    std::unique_ptr<CBlockTemplate> CreateNewBlock(const CScript& scriptPubKeyIn, uint8_t algo, bool fMineWitnessTx=true);
+    /**
+     * Construct a new block template with coinbase to scriptPubKeyIn. With
+     * pcandidates, its transactions are selected incrementally on top of the
+     * ones selected for the template before.
+     */
+    std::unique_ptr<CBlockTemplate> CreateNewBlock(const CScript& scriptPubKeyIn, uint8_t algo, bool fMineWitnessTx=true, CNextBlockCandidates* pcandidates=nullptr);
 
 private:
     // utility functions
@@ -169,7 +241,12 @@ private:
     /** Add transactions based on feerate including unconfirmed ancestors
       * Increments nPackagesSelected / nDescendantsUpdated with corresponding
       * statistics from the package selection (for logging statistics). */
-    void addPackageTxs(int &nPackagesSelected, int &nDescendantsUpdated);
+    void addPackageTxs(int &nPackagesSelected, int &nDescendantsUpdated, CNextBlockCandidates* pcandidates = nullptr);
+    /** Add the transactions selected before to the block, then the packages
+      * of the transactions that entered the mempool since. Falls back to
+      * addPackageTxs when the selection cannot be carried over. Increments
+      * nPackagesSelected / nDescendantsUpdated like addPackageTxs. */
+    void addCandidateTxs(CNextBlockCandidates& candidates, const CBlockIndex* pindexPrev, int &nPackagesSelected, int &nDescendantsUpdated);
 
     // helper functions for addPackageTxs()
     /** Remove confirmed (inBlock) entries from given set */
@@ -192,6 +269,78 @@ private:
     int UpdatePackagesForAdded(const CTxMemPool::setEntries& alreadyAdded, indexed_modified_transaction_set &mapModifiedTx);
 };
 
+/**
+ * Nonce search over a block header that is not equihash based. The header is
+ * serialized once and only the nonce is rewritten for every attempt. SHA256d
+ * resumes from the state after the first 64 bytes, the other algos hash a
+ * batch of nonces per MultiAlgoHashBatch call.
+ */
+class CMiningContext
+{
+private:
+    const uint8_t nAlgo;
+    const int nHashVersion;
+    unsigned char header[MULTIHASH_HEADER_SIZE];
+    //! SHA256d state after the first 64 bytes of the header
+    CHash256 midstate;
+
+public:
+    CMiningContext(const CDefaultBlockHeader& headerIn, uint8_t nAlgoIn, int nHashVersionIn);
+
+    /**
+     * Hash the nonces nStart to nStart + nCount - 1 in order. Returns true and
+     * the first nonce whose hash does not exceed bnTarget in nNonceRet, false
+     * if there is none.
+     */
+    bool ScanNonces(uint32_t nStart, uint32_t nCount, const arith_uint256& bnTarget, uint32_t& nNonceRet);
+};
+
+/**
+ * Block templates of all algos on the current tip, for miners that ask for
+ * several algos in turn. The transactions and the coinbase of a template do
+ * not depend on its algo, so they are selected once for all algos and every
+ * algo gets a copy with its own header.
+ */
+class CBlockTemplateCache
+{
+private:
+    const CChainParams& chainparams;
+    //! Seconds before transactions that entered the mempool are selected
+    const int64_t nRefreshInterval;
+
+    //! The template the transactions were selected for, and what for
+    std::shared_ptr<const CBlockTemplate> pshared;
+    const CBlockIndex* pindexPrev;
+    unsigned int nTransactionsUpdated;
+    int64_t nStart;
+    CScript scriptPubKey;
+    bool fMineWitnessTx;
+
+    //! Transactions selected for the templates, updated between refreshes
+    CNextBlockCandidates candidates;
+
+    //! Templates handed out, by algo
+    std::array<std::shared_ptr<CBlockTemplate>, NUM_ALGOS_IMPL> templates;
+
+public:
+    CBlockTemplateCache(const CChainParams& params, int64_t nRefreshIntervalIn);
+
+    /**
+     * Template for algo on the current tip. The same template is returned
+     * until the tip, the coinbase script or the witness support change, or
+     * the mempool has changed and the refresh interval passed. Returns
+     * nullptr if algo cannot be mined yet. Requires cs_main.
+     */
+    std::shared_ptr<CBlockTemplate> Get(const CScript& scriptPubKeyIn, uint8_t algo, bool fMineWitnessTxIn);
+
+    /** Mempool update counter when the transactions were selected */
+    unsigned int GetTransactionsUpdated() const { return nTransactionsUpdated; }
+};
+
+/** Whether blocks of algo may be mined at nTime */
+bool IsAlgoMineable(uint8_t algo, int64_t nTime, const Consensus::Params& consensusParams);
+/** Fill in the header of a block of algo on top of pindexPrev: version, time, bits and nonce */
+void FillBlockHeader(CBlock* pblock, const CBlockIndex* pindexPrev, uint8_t algo, const CChainParams& chainparams);
 /** Modify the extranonce in a block */
 void IncrementExtraNonce(CBlock* pblock, const CBlockIndex* pindexPrev, unsigned int& nExtraNonce);
 int64_t UpdateTime(CBlockHeader* pblock, const Consensus::Params& consensusParams, const CBlockIndex* pindexPrev, uint8_t algo);
@@ -0,0 +1,219 @@
+// Copyright (c) 2026 The Globaltoken Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <payeeindex.h>
+
+#include <chain.h>
+#include <chainparams.h>
+#include <crypto/common.h>
+#include <primitives/block.h>
+#include <util.h>
+#include <validation.h>
+
+static const char DB_PAYMENT = 'p';
+static const char DB_BEST_BLOCK = 'B';
+static const char DB_FIRST_HEIGHT = 'F';
+
+std::unique_ptr<CPayeeIndex> ppayeeindex;
+
+namespace {
+
+/** Database key of a payment, heights are stored inverted and big endian so the newest payment sorts first */
+struct PaymentKey
+{
+    CScript script;
+    int nHeight;
+
+    PaymentKey() : nHeight(0) {}
+    PaymentKey(const CScript& scriptIn, int nHeightIn) : script(scriptIn), nHeight(nHeightIn) {}
+
+    template <typename Stream>
+    void Serialize(Stream& s) const
+    {
+        unsigned char buf[4];
+        WriteBE32(buf, ~(uint32_t)nHeight);
+        s << DB_PAYMENT << script;
+        s.write((const char*)buf, sizeof(buf));
+    }
+
+    template <typename Stream>
+    void Unserialize(Stream& s)
+    {
+        char prefix;
+        unsigned char buf[4];
+        s >> prefix >> script;
+        s.read((char*)buf, sizeof(buf));
+        nHeight = ~ReadBE32(buf);
+        if (prefix != DB_PAYMENT)
+            throw std::ios_base::failure("not a payment key");
+    }
+};
+
+} // namespace
+
+CPayeeIndex::CPayeeIndex(size_t nCacheSize, bool fMemory, bool fWipe) :
+    db(GetDataDir() / "payeeindex", nCacheSize, fMemory, fWipe),
+    pindexBest(nullptr),
+    nFirstHeight(0),
+    fSynced(false)
+{
+    if (!db.Read(DB_BEST_BLOCK, hashBestLoaded) || !db.Read(DB_FIRST_HEIGHT, nFirstHeight))
+        hashBestLoaded.SetNull();
+}
+
+void CPayeeIndex::WriteBlock(CDBBatch& batch, const CBlock& block, int nHeight)
+{
+    if (block.vtx.empty())
+        return;
+    const CTransaction& txCoinbase = *block.vtx[0];
+    CAmount nMasternodePayment = GetMasternodePayment(nHeight, txCoinbase.GetValueOut());
+    if (nMasternodePayment <= 0)
+        return;
+    const uint256 hash = block.GetHash();
+    for (const auto& txout : txCoinbase.vout) {
+        if (txout.nValue == nMasternodePayment)
+            batch.Write(PaymentKey(txout.scriptPubKey, nHeight), std::make_pair(txout.nValue, hash));
+    }
+}
+
+void CPayeeIndex::EraseBlock(CDBBatch& batch, const CBlock& block, int nHeight)
+{
+    if (block.vtx.empty())
+        return;
+    const CTransaction& txCoinbase = *block.vtx[0];
+    CAmount nMasternodePayment = GetMasternodePayment(nHeight, txCoinbase.GetValueOut());
+    for (const auto& txout : txCoinbase.vout) {
+        if (txout.nValue == nMasternodePayment)
+            batch.Erase(PaymentKey(txout.scriptPubKey, nHeight));
+    }
+}
+
+void CPayeeIndex::WriteBest(CDBBatch& batch)
+{
+    if (pindexBest == nullptr) {
+        batch.Erase(DB_BEST_BLOCK);
+        return;
+    }
+    batch.Write(DB_BEST_BLOCK, pindexBest->GetBlockHash());
+    batch.Write(DB_FIRST_HEIGHT, nFirstHeight);
+}
+
+void CPayeeIndex::Sync()
+{
+    SyncWithValidationInterfaceQueue();
+
+    LOCK2(cs_main, cs);
+    fSynced = true;
+    const CBlockIndex* pindexTip = chainActive.Tip();
+    if (pindexTip == nullptr)
+        return;
+
+    if (!hashBestLoaded.IsNull()) {
+        BlockMap::const_iterator it = mapBlockIndex.find(hashBestLoaded);
+        if (it != mapBlockIndex.end())
+            pindexBest = it->second;
+    }
+
+    // Entries of blocks that are no longer in the active chain are left in place,
+    // queries skip them as their block hash does not match.
+    const CBlockIndex* pindexFork = pindexBest ? chainActive.FindFork(pindexBest) : nullptr;
+    int nStart;
+    if (pindexFork && pindexTip->nHeight - pindexFork->nHeight <= PAYEE_INDEX_SYNC_BLOCKS) {
+        nStart = pindexFork->nHeight + 1;
+    } else {
+        nStart = std::max(0, pindexTip->nHeight - PAYEE_INDEX_SYNC_BLOCKS + 1);
+        nFirstHeight = nStart;
+    }
+
+    if (nStart <= pindexTip->nHeight)
+        LogPrintf("%s: indexing masternode payments from height %d to %d\n", __func__, nStart, pindexTip->nHeight);
+    CDBBatch batch(db);
+    for (int nHeight = nStart; nHeight <= pindexTip->nHeight; nHeight++) {
+        const CBlockIndex* pindex = chainActive[nHeight];
+        CBlock block;
+        if (!ReadBlockFromDisk(block, pindex, Params().GetConsensus())) {
+            // Pruned or missing, start the covered range after it
+            nFirstHeight = nHeight + 1;
+            continue;
+        }
+        WriteBlock(batch, block, nHeight);
+    }
+    pindexBest = pindexTip;
+    WriteBest(batch);
+    db.WriteBatch(batch);
+}
+
+void CPayeeIndex::ConnectBlock(const CBlock& block, const CBlockIndex* pindex)
+{
+    LOCK(cs);
+    // Blocks connected before Sync are indexed by it
+    if (!fSynced)
+        return;
+
+    if (pindexBest == nullptr || pindex->pprev != pindexBest) {
+        // Already indexed, e.g. queued before Sync
+        if (pindexBest != nullptr && pindexBest->GetAncestor(pindex->nHeight) == pindex)
+            return;
+        // Not connected to the indexed range, start a new one
+        nFirstHeight = pindex->nHeight;
+    }
+
+    CDBBatch batch(db);
+    WriteBlock(batch, block, pindex->nHeight);
+    pindexBest = pindex;
+    WriteBest(batch);
+    db.WriteBatch(batch);
+}
+
+void CPayeeIndex::DisconnectBlock(const CBlock& block)
+{
+    LOCK(cs);
+    if (!fSynced || pindexBest == nullptr || pindexBest->GetBlockHash() != block.GetHash())
+        return;
+
+    CDBBatch batch(db);
+    EraseBlock(batch, block, pindexBest->nHeight);
+    pindexBest = pindexBest->pprev;
+    if (pindexBest != nullptr && pindexBest->nHeight < nFirstHeight)
+        pindexBest = nullptr;
+    WriteBest(batch);
+    db.WriteBatch(batch);
+}
+
+bool CPayeeIndex::GetPayments(const CScript& scriptPayee, const CBlockIndex* pindex, int nMinHeight, std::vector<CPayeePayment>& vPaymentsRet) const
+{
+    vPaymentsRet.clear();
+
+    LOCK(cs);
+    if (pindex == nullptr || pindexBest == nullptr || nMinHeight + 1 < nFirstHeight)
+        return false;
+    if (pindexBest->GetAncestor(pindex->nHeight) != pindex)
+        return false;
+
+    std::unique_ptr<CDBIterator> pcursor(db.NewIterator());
+    pcursor->Seek(PaymentKey(scriptPayee, pindex->nHeight));
+    for (; pcursor->Valid(); pcursor->Next()) {
+        PaymentKey key;
+        if (!pcursor->GetKey(key) || key.script != scriptPayee || key.nHeight <= nMinHeight)
+            break;
+        std::pair<CAmount, uint256> value;
+        if (!pcursor->GetValue(value))
+            return error("%s: failed to read payment", __func__);
+        const CBlockIndex* pindexPayment = pindex->GetAncestor(key.nHeight);
+        if (pindexPayment == nullptr || pindexPayment->GetBlockHash() != value.second)
+            continue;
+        vPaymentsRet.push_back(CPayeePayment{key.nHeight, value.first, value.second});
+    }
+    return true;
+}
+
+void CPayeeIndex::BlockConnected(const std::shared_ptr<const CBlock>& pblock, const CBlockIndex *pindex, const std::vector<CTransactionRef>& vtxConflicted)
+{
+    ConnectBlock(*pblock, pindex);
+}
+
+void CPayeeIndex::BlockDisconnected(const std::shared_ptr<const CBlock>& pblock)
+{
+    DisconnectBlock(*pblock);
+}
@@ -0,0 +1,89 @@
+// Copyright (c) 2026 The Globaltoken Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_PAYEEINDEX_H
+#define BITCOIN_PAYEEINDEX_H
+
+#include <amount.h>
+#include <dbwrapper.h>
+#include <script/script.h>
+#include <sync.h>
+#include <uint256.h>
+#include <validationinterface.h>
+
+#include <memory>
+#include <vector>
+
+class CBlock;
+class CBlockIndex;
+
+//! Database cache of the payee index (MiB)
+static const int64_t DEFAULT_PAYEE_INDEX_CACHE = 2;
+//! Number of blocks indexed on startup when the index is too far behind the tip to catch up
+static const int PAYEE_INDEX_SYNC_BLOCKS = 5000;
+
+/** A masternode payment found in the coinbase of a block */
+struct CPayeePayment
+{
+    int nHeight;
+    CAmount nAmount;
+    uint256 hashBlock;
+};
+
+/**
+ * Index of the masternode payments in the coinbase of the active chain, keyed
+ * by payee script and height, newest first.
+ *
+ * Only coinbase outputs that pay exactly GetMasternodePayment() are indexed.
+ * The index follows the validation interface queue and covers a contiguous
+ * range of heights up to its best block; queries for blocks outside that
+ * range fail, and callers fall back to reading the blocks from disk.
+ */
+class CPayeeIndex : public CValidationInterface
+{
+private:
+    mutable CCriticalSection cs;
+    mutable CDBWrapper db;
+    //! Last block indexed, its ancestors down to nFirstHeight are indexed as well
+    const CBlockIndex* pindexBest;
+    int nFirstHeight;
+    //! Best block hash read from disk, resolved by Sync
+    uint256 hashBestLoaded;
+    bool fSynced;
+
+    void WriteBlock(CDBBatch& batch, const CBlock& block, int nHeight);
+    void EraseBlock(CDBBatch& batch, const CBlock& block, int nHeight);
+    void WriteBest(CDBBatch& batch);
+
+public:
+    CPayeeIndex(size_t nCacheSize, bool fMemory = false, bool fWipe = false);
+
+    /**
+     * Resolve the best block stored on disk and index the blocks of the active
+     * chain after it, at most PAYEE_INDEX_SYNC_BLOCKS. Blocks connected before
+     * this is called are picked up here.
+     */
+    void Sync();
+
+    /** Index a block connected on top of the best block. */
+    void ConnectBlock(const CBlock& block, const CBlockIndex* pindex);
+    /** Remove a block disconnected from the tip of the index. */
+    void DisconnectBlock(const CBlock& block);
+
+    /**
+     * Collect the payments to scriptPayee in the blocks after nMinHeight up to
+     * pindex, newest first. Returns false if the index does not cover all of
+     * these blocks.
+     */
+    bool GetPayments(const CScript& scriptPayee, const CBlockIndex* pindex, int nMinHeight, std::vector<CPayeePayment>& vPaymentsRet) const;
+
+protected:
+    // CValidationInterface
+    void BlockConnected(const std::shared_ptr<const CBlock>& pblock, const CBlockIndex *pindex, const std::vector<CTransactionRef>& vtxConflicted) override;
+    void BlockDisconnected(const std::shared_ptr<const CBlock>& pblock) override;
+};
+
+extern std::unique_ptr<CPayeeIndex> ppayeeindex;
+
+#endif // BITCOIN_PAYEEINDEX_H
@@ -13,6 +13,7 @@
 #include <chain.h>
 #include <chainparams.h>
 #include <globaltoken/hardfork.h>
+#include <globaltoken/multihasher.h>
 #include <primitives/block.h>
 #include <primitives/mining_block.h>
 #include <uint256.h>
@@ -53,7 +54,7 @@ bool IsAuxPowAllowed(const CBlockIndex* pindexLast, const CBlockHeader *pblock,
                 {
                     break;
                 }
-                pIndexLastAlgo = GetLastBlockIndexForAlgo(pIndexLastAlgo->pprev, algo, params);
+                pIndexLastAlgo = GetPrevBlockIndexForAlgo(pIndexLastAlgo, params);
                 
                 if(pIndexLastAlgo == nullptr)
                     return false;
@@ -320,7 +321,40 @@ unsigned int CalculateNextWorkRequired(const CBlockIndex* pindexLast, int64_t nF
     return bnNew.GetCompact();
 }
 
-bool CheckEquihashSolution(const CEquihashBlockHeader *pblock, const CChainParams& params, uint8_t nAlgo, const std::string stateString)
+namespace {
+/** Serializes straight into an equihash BLAKE2b state, like CHashWriter does for SHA256d. */
+class CEquihashStateWriter
+{
+private:
+    crypto_generichash_blake2b_state& state;
+
+    const int nType;
+    const int nVersion;
+public:
+
+    CEquihashStateWriter(crypto_generichash_blake2b_state& stateIn, int nTypeIn, int nVersionIn) : state(stateIn), nType(nTypeIn), nVersion(nVersionIn) {}
+
+    int GetType() const { return nType; }
+    int GetVersion() const { return nVersion; }
+
+    void write(const char *pch, size_t size) {
+        crypto_generichash_blake2b_update(&state, (const unsigned char*)pch, size);
+    }
+
+    template<typename T>
+    CEquihashStateWriter& operator<<(const T& obj) {
+        // Serialize to this stream
+        ::Serialize(*this, obj);
+        return (*this);
+    }
+};
+
+/**
+ * Verify the solution of a CEquihashBlockHeader or CBlockHeader in place, without
+ * copying the header and its solution to build I||V.
+ */
+template<typename Header>
+bool CheckEquihashHeaderSolution(const Header& header, const uint256& nonce, const CChainParams& params, uint8_t nAlgo, const std::string& stateString)
 {
     unsigned int n = params.GetEquihashAlgoN(nAlgo);
     unsigned int k = params.GetEquihashAlgoK(nAlgo);
@@ -329,42 +363,44 @@ bool CheckEquihashSolution(const CEquihashBlockHeader *pblock, const CChainParam
     crypto_generichash_blake2b_state state;
     EhInitialiseState(n, k, state, stateString);
 
-    // I = the block header minus nonce and solution.
-    CEquihashInput I{*pblock};
-    // I||V
-    CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
-    ss << I;
-    ss << pblock->nNonce;
-
-    // H(I||V||...
-    crypto_generichash_blake2b_update(&state, (unsigned char*)&ss[0], ss.size());
+    // H(I||V||... with I = the block header minus nonce and solution, in the
+    // field order of CEquihashInput
+    CEquihashStateWriter ss(state, SER_NETWORK, PROTOCOL_VERSION);
+    ss << header.nVersion << header.hashPrevBlock << header.hashMerkleRoot << header.hashReserved << header.nTime << header.nBits;
+    ss << nonce;
 
     bool isValid;
-    EhIsValidSolution(n, k, state, pblock->nSolution, isValid);
-    if (!isValid)
-        return false;
+    EhIsValidSolution(n, k, state, header.nSolution, isValid);
+    return isValid;
+}
+} // namespace
 
-    return true;
+bool CheckEquihashSolution(const CEquihashBlockHeader *pblock, const CChainParams& params, uint8_t nAlgo, const std::string stateString)
+{
+    return CheckEquihashHeaderSolution(*pblock, pblock->nNonce, params, nAlgo, stateString);
 }
 
 bool CheckEquihashSolution(const CBlockHeader *pblock, const CChainParams& params)
 {
     uint8_t nAlgo = pblock->GetAlgo();
-    CEquihashBlockHeader pequihashblock;
-    pequihashblock = pblock->GetEquihashBlockHeader();
-    return CheckEquihashSolution(&pequihashblock, params, nAlgo, GetEquihashBasedDefaultPersonalize(nAlgo));
+    return CheckEquihashHeaderSolution(*pblock, pblock->nBigNonce, params, nAlgo, GetEquihashBasedDefaultPersonalize(nAlgo));
 }
 
-bool CheckProofOfWork(uint256 hash, unsigned int nBits, const Consensus::Params& params, const uint8_t algo)
+bool GetProofOfWorkTarget(unsigned int nBits, const Consensus::Params& params, const uint8_t algo, arith_uint256& bnTarget)
 {
     bool fNegative;
     bool fOverflow;
-    arith_uint256 bnTarget;
 
     bnTarget.SetCompact(nBits, &fNegative, &fOverflow);
 
     // Check range
-    if (fNegative || bnTarget == 0 || fOverflow || bnTarget > params.aPOWAlgos[algo].GetArithPowLimit())
+    return !(fNegative || bnTarget == 0 || fOverflow || bnTarget > params.aPOWAlgos[algo].GetArithPowLimit());
+}
+
+bool CheckProofOfWork(uint256 hash, unsigned int nBits, const Consensus::Params& params, const uint8_t algo)
+{
+    arith_uint256 bnTarget;
+    if (!GetProofOfWorkTarget(nBits, params, algo, bnTarget))
         return false;
 
     // Check proof of work matches claimed amount
@@ -380,7 +416,77 @@ bool CheckProofOfWork(const CBlockHeader& block, const Consensus::Params& params
     return CheckProofOfWork(block, params, equihashvalidator);
 }
 
+void CPowCheck::Add(const CBlockHeader& header, PowCheckResult* pResult)
+{
+    assert(vHeaders.empty() || header.GetAlgo() == vHeaders[0].GetAlgo());
+    vHeaders.push_back(header);
+    vResults.push_back(pResult);
+}
+
+bool CPowCheck::operator()()
+{
+    if (vHeaders.empty())
+        return true;
+    const uint8_t nAlgo = vHeaders[0].GetAlgo();
+
+    // Hash the headers checked by their own PoW hash, one batch per hash version
+    std::vector<uint256> vHashes(vHeaders.size());
+    std::vector<bool> vHashed(vHeaders.size(), false);
+    std::map<int, std::vector<size_t> > mapByVersion;
+    for (size_t i = 0; i < vHeaders.size(); i++) {
+        if (!vHeaders[i].auxpow && !IsEquihashBasedAlgo(nAlgo))
+            mapByVersion[LoadMultiHasherVersionFlags(params->Hardfork3.IsActivated(vHeaders[i].nTime))].push_back(i);
+    }
+    for (const auto& version : mapByVersion) {
+        const std::vector<size_t>& vIndex = version.second;
+        std::vector<const CPureBlockHeader*> vBatch;
+        std::vector<uint256> vOut(vIndex.size());
+        for (size_t i : vIndex)
+            vBatch.push_back(&vHeaders[i]);
+        MultiAlgoHashBatch(nAlgo, vBatch.data(), vBatch.size(), vOut.data(), version.first);
+        for (size_t j = 0; j < vIndex.size(); j++) {
+            vHashes[vIndex[j]] = vOut[j];
+            vHashed[vIndex[j]] = true;
+        }
+    }
+
+    bool fAllOk = true;
+    for (size_t i = 0; i < vHeaders.size(); i++) {
+        bool ehsolutionvalid;
+        const bool fOk = CheckProofOfWork(vHeaders[i], *params, ehsolutionvalid, vHashed[i] ? &vHashes[i] : nullptr);
+        if (vResults[i])
+            *vResults[i] = fOk ? POW_CHECK_VALID : ehsolutionvalid ? POW_CHECK_INVALID : POW_CHECK_INVALID_SOLUTION;
+        fAllOk &= fOk;
+    }
+    return fAllOk;
+}
+
+void CPowCheckGrouper::Add(const CBlockHeader& header, std::vector<CPowCheck>& vChecks, PowCheckResult* pResult)
+{
+    CPowCheck& check = mapGroups.emplace(header.GetAlgo(), CPowCheck(params)).first->second;
+    check.Add(header, pResult);
+    if (check.size() >= POW_CHECK_GROUP_SIZE) {
+        vChecks.emplace_back();
+        vChecks.back().swap(check);
+        mapGroups.erase(header.GetAlgo());
+    }
+}
+
+void CPowCheckGrouper::Flush(std::vector<CPowCheck>& vChecks)
+{
+    for (auto& group : mapGroups) {
+        vChecks.emplace_back();
+        vChecks.back().swap(group.second);
+    }
+    mapGroups.clear();
+}
+
 bool CheckProofOfWork(const CBlockHeader& block, const Consensus::Params& params, bool &ehsolutionvalid)
+{
+    return CheckProofOfWork(block, params, ehsolutionvalid, nullptr);
+}
+
+bool CheckProofOfWork(const CBlockHeader& block, const Consensus::Params& params, bool &ehsolutionvalid, const uint256* phashPoW)
 {
     bool hardfork    = params.Hardfork1.IsActivated(block.nTime);
     bool hardfork2   = params.Hardfork2.IsActivated(block.nTime);
@@ -435,8 +541,9 @@ bool CheckProofOfWork(const CBlockHeader& block, const Consensus::Params& params
             else
             {
                 // Check the header
-                if (!CheckProofOfWork(block.GetPoWHash(SER_GETHASH, powHashFlags), block.nBits, params, nAlgo))
-                    return error("%s : non-AUX proof of work failed - hash=%s, algo=%d (%s), nVersion=%d, PoWHash=%s", __func__, block.GetHash().ToString(), nAlgo, GetAlgoName(nAlgo), block.nVersion, block.GetPoWHash(SER_GETHASH, powHashFlags).ToString());
+                const uint256 hashPoW = phashPoW ? *phashPoW : block.GetPoWHash(SER_GETHASH, powHashFlags);
+                if (!CheckProofOfWork(hashPoW, block.nBits, params, nAlgo))
+                    return error("%s : non-AUX proof of work failed - hash=%s, algo=%d (%s), nVersion=%d, PoWHash=%s", __func__, block.GetHash().ToString(), nAlgo, GetAlgoName(nAlgo), block.nVersion, hashPoW.ToString());
             }
         }
         else
@@ -444,8 +551,9 @@ bool CheckProofOfWork(const CBlockHeader& block, const Consensus::Params& params
             if(nAlgo == ALGO_SHA256D)
             {
                 // Check the header
-                if (!CheckProofOfWork(block.GetPoWHash(SER_GETHASH, powHashFlags), block.nBits, params, ALGO_SHA256D))
-                    return error("%s : non-AUX proof of work failed - hash=%s, algo=%d (%s), nVersion=%d, PoWHash=%s", __func__, block.GetHash().ToString(), nAlgo, GetAlgoName(nAlgo), block.nVersion, block.GetPoWHash(SER_GETHASH, powHashFlags).ToString());
+                const uint256 hashPoW = phashPoW ? *phashPoW : block.GetPoWHash(SER_GETHASH, powHashFlags);
+                if (!CheckProofOfWork(hashPoW, block.nBits, params, ALGO_SHA256D))
+                    return error("%s : non-AUX proof of work failed - hash=%s, algo=%d (%s), nVersion=%d, PoWHash=%s", __func__, block.GetHash().ToString(), nAlgo, GetAlgoName(nAlgo), block.nVersion, hashPoW.ToString());
             }
             else
             {
@@ -533,8 +641,24 @@ bool CheckProofOfWork(const CBlockHeader& block, const Consensus::Params& params
     return true;
 }
 
+bool IsAlgoPathAllowed(const CBlockIndex* pindex, const CBlockIndex* pindexFound, const uint8_t algo)
+{
+    if (algo != ALGO_SHA256D && pindex->nLastPreHF1Height >= pindexFound->nHeight)
+        return false;
+    if (!IsAlgoAllowedBeforeHF2(algo) && pindex->nLastPreHF2Height >= pindexFound->nHeight)
+        return false;
+    return true;
+}
+
 const CBlockIndex* GetLastBlockIndexForAlgo(const CBlockIndex* pindex, const uint8_t algo, const Consensus::Params& params)
 {
+    if (pindex && pindex->fAlgoSkipBuilt && algo < NUM_ALGOS_IMPL) {
+        const CBlockIndex* pindexFound = pindex->GetLastAncestorForAlgo(algo);
+        if (!pindexFound || !IsAlgoPathAllowed(pindex, pindexFound, algo))
+            return nullptr;
+        return pindexFound;
+    }
+
 	for (;;)
 	{
 		if (!pindex)
@@ -550,6 +674,18 @@ const CBlockIndex* GetLastBlockIndexForAlgo(const CBlockIndex* pindex, const uin
 	return nullptr;
 }
 
+const CBlockIndex* GetPrevBlockIndexForAlgo(const CBlockIndex* pindexAlgo, const Consensus::Params& params)
+{
+    const CBlockIndex* pindex = pindexAlgo->pprev;
+    if (!pindex)
+        return nullptr;
+    if (!pindexAlgo->fAlgoSkipBuilt || !pindex->fAlgoSkipBuilt)
+        return GetLastBlockIndexForAlgo(pindex, pindexAlgo->GetAlgo(), params);
+    if (!pindexAlgo->pprevAlgo || !IsAlgoPathAllowed(pindex, pindexAlgo->pprevAlgo, pindexAlgo->GetAlgo()))
+        return nullptr;
+    return pindexAlgo->pprevAlgo;
+}
+
 const CBlockIndex* GetNextBlockIndexForAlgo(const CBlockIndex* pindex, const uint8_t algo)
 {
     AssertLockHeld(cs_main);
@@ -573,7 +709,7 @@ int CalculateDiffRetargetingBlock(const CBlockIndex* pindex, int retargettype, c
     const CBlockIndex* pindexLastAlgo;
     if(pindexAlgo != nullptr)
         if(pindexAlgo->pprev)
-            pindexLastAlgo = GetLastBlockIndexForAlgo(pindexAlgo->pprev, algo, params);
+            pindexLastAlgo = GetPrevBlockIndexForAlgo(pindexAlgo, params);
         else
             pindexLastAlgo = nullptr;
     else
@@ -592,7 +728,7 @@ int CalculateDiffRetargetingBlock(const CBlockIndex* pindex, int retargettype, c
 				return pindexAlgo->nHeight;	
 		
 			pindexAlgo = pindexLastAlgo;
-			pindexLastAlgo = GetLastBlockIndexForAlgo(pindexAlgo->pprev, algo, params);
+			pindexLastAlgo = GetPrevBlockIndexForAlgo(pindexAlgo, params);
 		}
 		return -3;
 	}
@@ -656,7 +792,7 @@ int CalculateDiffRetargetingBlock(const CBlockIndex* pindex, int retargettype, c
                     }
 				}
 				pindexAlgo = pindexLastAlgo;
-                pindexLastAlgo = GetLastBlockIndexForAlgo(pindexAlgo->pprev, algo, params);
+                pindexLastAlgo = GetPrevBlockIndexForAlgo(pindexAlgo, params);
 	    }
 	    return -3;
     }
@@ -8,8 +8,11 @@
 #define BITCOIN_POW_H
 
 #include <consensus/params.h>
+#include <primitives/block.h>
 
+#include <map>
 #include <stdint.h>
+#include <vector>
 
 enum {
     RETARGETING_LAST = 0,
@@ -35,7 +38,13 @@ bool CheckEquihashSolution(const CBlockHeader *pblock, const CChainParams&);
 
 /** Check whether a block hash satisfies the proof-of-work requirement specified by nBits */
 bool CheckProofOfWork(uint256 hash, unsigned int nBits, const Consensus::Params&, const uint8_t algo);
+/** Decode the target of nBits, false if it is out of range for the algo and no hash can satisfy it */
+bool GetProofOfWorkTarget(unsigned int nBits, const Consensus::Params&, const uint8_t algo, arith_uint256& bnTarget);
 const CBlockIndex* GetLastBlockIndexForAlgo(const CBlockIndex* pindex, const uint8_t algo, const Consensus::Params&);
+/** Hardfork rules of GetLastBlockIndexForAlgo: the walk from pindex down to pindexFound must not pass a block mined before the hardforks that allowed the algo */
+bool IsAlgoPathAllowed(const CBlockIndex* pindex, const CBlockIndex* pindexFound, const uint8_t algo);
+/** Same as GetLastBlockIndexForAlgo(pindexAlgo->pprev, pindexAlgo->GetAlgo(), params), using the per-algo predecessor link */
+const CBlockIndex* GetPrevBlockIndexForAlgo(const CBlockIndex* pindexAlgo, const Consensus::Params&);
 const CBlockIndex* GetNextBlockIndexForAlgo(const CBlockIndex* pindex, const uint8_t algo);
 
 /**
@@ -48,6 +57,66 @@ const CBlockIndex* GetNextBlockIndexForAlgo(const CBlockIndex* pindex, const uin
 bool CheckProofOfWork(const CBlockHeader& block, const Consensus::Params& params);
 bool CheckProofOfWork(const CBlockHeader& block, const Consensus::Params& params, bool &ehsolutionvalid);
 
+/** Like CheckProofOfWork, with the PoW hash of block computed beforehand if phashPoW is given. */
+bool CheckProofOfWork(const CBlockHeader& block, const Consensus::Params& params, bool &ehsolutionvalid, const uint256* phashPoW);
+
+/** Result of the check of one header on the proof-of-work check queue */
+enum PowCheckResult : unsigned char {
+    POW_CHECK_PENDING,          //!< not checked, the queue stopped after another check failed
+    POW_CHECK_VALID,
+    POW_CHECK_INVALID,
+    POW_CHECK_INVALID_SOLUTION, //!< the equihash solution is invalid
+};
+
+/** Maximum number of headers checked by one CPowCheck */
+static const size_t POW_CHECK_GROUP_SIZE = 16;
+
+/**
+ * Closure representing the context-free proof-of-work check of a group of block
+ * headers of the same algo, so that headers can be verified on a CCheckQueue
+ * worker pool. The headers without auxpow are hashed together with
+ * MultiAlgoHashBatch, which runs the X-family chains side by side.
+ */
+class CPowCheck
+{
+private:
+    std::vector<CBlockHeader> vHeaders;
+    std::vector<PowCheckResult*> vResults;
+    const Consensus::Params *params;
+
+public:
+    CPowCheck(): params(nullptr) {}
+    explicit CPowCheck(const Consensus::Params& paramsIn) : params(&paramsIn) {}
+
+    /** Add a header of the algo of the group, its result is stored in *pResult if given */
+    void Add(const CBlockHeader& header, PowCheckResult* pResult = nullptr);
+    size_t size() const { return vHeaders.size(); }
+
+    bool operator()();
+
+    void swap(CPowCheck &check) {
+        vHeaders.swap(check.vHeaders);
+        vResults.swap(check.vResults);
+        std::swap(params, check.params);
+    }
+};
+
+/** Sorts headers by algo into CPowChecks of up to POW_CHECK_GROUP_SIZE headers */
+class CPowCheckGrouper
+{
+private:
+    const Consensus::Params& params;
+    std::map<uint8_t, CPowCheck> mapGroups;
+
+public:
+    explicit CPowCheckGrouper(const Consensus::Params& paramsIn) : params(paramsIn) {}
+
+    /** Add a header, its group is moved to vChecks once it is full */
+    void Add(const CBlockHeader& header, std::vector<CPowCheck>& vChecks, PowCheckResult* pResult = nullptr);
+    /** Move the groups that are not full yet to vChecks */
+    void Flush(std::vector<CPowCheck>& vChecks);
+};
+
 /** Calculations */
 int CalculateDiffRetargetingBlock(const CBlockIndex* pindex, int retargettype, const uint8_t algo, const Consensus::Params&);
 
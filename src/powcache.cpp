@@ -0,0 +1,132 @@
+// Copyright (c) 2026 The Globaltoken Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <powcache.h>
+
+#include <cuckoocache.h>
+#include <hash.h>
+#include <pow.h>
+#include <primitives/block.h>
+#include <random.h>
+#include <script/sigcache.h>
+#include <uint256.h>
+#include <util.h>
+
+#include <atomic>
+
+#include <boost/thread.hpp>
+
+namespace {
+/**
+ * Cache of headers whose proof-of-work passed, to avoid hashing the same header
+ * again when its block arrives, is submitted or is read back from disk.
+ */
+class CPowCache
+{
+private:
+    //! Entries are SHA256d(nonce || serialized header including auxpow)
+    uint256 nonce;
+    typedef CuckooCache::cache<uint256, SignatureCacheHasher> map_type;
+    map_type setValid;
+    boost::shared_mutex cs_powcache;
+    size_t nCapacity;
+    std::atomic<uint64_t> nHits;
+    std::atomic<uint64_t> nMisses;
+    std::atomic<uint64_t> nInserts;
+
+public:
+    CPowCache() : nCapacity(0), nHits(0), nMisses(0), nInserts(0)
+    {
+        GetRandBytes(nonce.begin(), 32);
+    }
+
+    uint256 ComputeEntry(const CBlockHeader& block) const
+    {
+        CHashWriter ss(SER_GETHASH, PROTOCOL_VERSION);
+        ss << nonce << block;
+        return ss.GetHash();
+    }
+
+    bool Get(const uint256& entry)
+    {
+        boost::shared_lock<boost::shared_mutex> lock(cs_powcache);
+        // Not set up by InitPowCache, e.g. in the benchmarks
+        if (nCapacity == 0)
+            return false;
+        const bool fFound = setValid.contains(entry, false);
+        ++(fFound ? nHits : nMisses);
+        return fFound;
+    }
+
+    void Set(uint256& entry)
+    {
+        boost::unique_lock<boost::shared_mutex> lock(cs_powcache);
+        if (nCapacity == 0)
+            return;
+        setValid.insert(entry);
+        ++nInserts;
+    }
+
+    uint32_t setup_bytes(size_t n)
+    {
+        boost::unique_lock<boost::shared_mutex> lock(cs_powcache);
+        nCapacity = setValid.setup_bytes(n);
+        return nCapacity;
+    }
+
+    PowCacheStats GetStats()
+    {
+        PowCacheStats stats;
+        {
+            boost::shared_lock<boost::shared_mutex> lock(cs_powcache);
+            stats.nCapacity = nCapacity;
+        }
+        stats.nBytes = stats.nCapacity * sizeof(uint256);
+        stats.nHits = nHits;
+        stats.nMisses = nMisses;
+        stats.nInserts = nInserts;
+        return stats;
+    }
+};
+
+static CPowCache powCache;
+} // namespace
+
+void InitPowCache()
+{
+    size_t nMaxCacheSize = std::min(std::max((int64_t)0, gArgs.GetArg("-maxpowcachesize", DEFAULT_MAX_POW_CACHE_SIZE)), MAX_MAX_POW_CACHE_SIZE) * ((size_t) 1 << 20);
+    size_t nElems = powCache.setup_bytes(nMaxCacheSize);
+    LogPrintf("Using %zu MiB out of %zu requested for proof-of-work cache, able to store %zu elements\n",
+            (nElems*sizeof(uint256)) >>20, nMaxCacheSize>>20, nElems);
+}
+
+bool CheckProofOfWorkCached(const CBlockHeader& block, const Consensus::Params& params, bool& ehsolutionvalid)
+{
+    uint256 entry = powCache.ComputeEntry(block);
+    if (powCache.Get(entry)) {
+        ehsolutionvalid = true;
+        return true;
+    }
+    if (!CheckProofOfWork(block, params, ehsolutionvalid))
+        return false;
+    powCache.Set(entry);
+    return true;
+}
+
+bool CheckProofOfWorkCached(const CBlockHeader& block, const Consensus::Params& params)
+{
+    bool ehsolutionvalid;
+    return CheckProofOfWorkCached(block, params, ehsolutionvalid);
+}
+
+void AddPowCacheEntry(const CBlockHeader& block)
+{
+    uint256 entry = powCache.ComputeEntry(block);
+    powCache.Set(entry);
+}
+
+PowCacheStats GetPowCacheStats()
+{
+    return powCache.GetStats();
+}
@@ -0,0 +1,48 @@
+// Copyright (c) 2026 The Globaltoken Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_POWCACHE_H
+#define BITCOIN_POWCACHE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+class CBlockHeader;
+
+namespace Consensus { struct Params; }
+
+/** Default for -maxpowcachesize, the size of the verified proof-of-work cache in MiB */
+static const unsigned int DEFAULT_MAX_POW_CACHE_SIZE = 4;
+/** Maximum -maxpowcachesize */
+static const int64_t MAX_MAX_POW_CACHE_SIZE = 1024;
+
+struct PowCacheStats
+{
+    //! Number of entries the cache can hold
+    size_t nCapacity;
+    //! Bytes allocated for the entries
+    size_t nBytes;
+    uint64_t nHits;
+    uint64_t nMisses;
+    uint64_t nInserts;
+};
+
+/** To be called once in AppInitMain/BasicTestingSetup to size the verified proof-of-work cache. */
+void InitPowCache();
+
+/**
+ * CheckProofOfWork for headers whose proof-of-work may have been verified before,
+ * e.g. when the header was accepted and its full block arrives later. Headers that
+ * pass are remembered, keyed by a salted hash of the header including its auxpow,
+ * so they are not hashed again.
+ */
+bool CheckProofOfWorkCached(const CBlockHeader& block, const Consensus::Params& params, bool& ehsolutionvalid);
+bool CheckProofOfWorkCached(const CBlockHeader& block, const Consensus::Params& params);
+
+/** Remember a header whose proof-of-work was verified without CheckProofOfWorkCached. */
+void AddPowCacheEntry(const CBlockHeader& block);
+
+PowCacheStats GetPowCacheStats();
+
+#endif // BITCOIN_POWCACHE_H
@@ -158,8 +158,12 @@ static bool rest_headers(HTTPRequest* req,
     }
 
     CDataStream ssHeader(SER_NETWORK, PROTOCOL_VERSION);
-    for (const CBlockIndex *pindex : headers) {
-        ssHeader << pindex->GetBlockHeader(Params().GetConsensus());
+    try {
+        for (const CBlockIndex *pindex : headers) {
+            ssHeader << pindex->GetBlockHeader(Params().GetConsensus());
+        }
+    } catch (const std::runtime_error& e) {
+        return RESTERR(req, HTTP_INTERNAL_SERVER_ERROR, e.what());
     }
 
     switch (rf) {
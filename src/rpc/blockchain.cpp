@@ -6,6 +6,7 @@
 #include <rpc/blockchain.h>
 
 #include <amount.h>
+#include <auxpowcache.h>
 #include <chain.h>
 #include <chainparams.h>
 #include <checkpoints.h>
@@ -17,6 +18,7 @@
 #include <core_io.h>
 #include <policy/feerate.h>
 #include <policy/policy.h>
+#include <powcache.h>
 #include <primitives/transaction.h>
 #include <rpc/server.h>
 #include <streams.h>
@@ -76,6 +78,11 @@ double GetDifficulty(const CChain& chain, const CBlockIndex* blockindex, uint8_t
     else
     nBits = blockindex->nBits;
 
+    return GetDifficultyFromBits(nBits);
+}
+
+double GetDifficultyFromBits(unsigned int nBits)
+{
     int nShift = (nBits >> 24) & 0xff;
     double dDiff =
         (double)0x0000ffff / (double)(nBits & 0x00ffffff);
@@ -186,7 +193,7 @@ UniValue blockheaderToJSON(const CBlockIndex* blockindex)
     CBlockHeader header = blockindex->GetBlockHeader(Params().GetConsensus());
     bool isauxpow = header.auxpow && (header.auxpow != nullptr);
 	const CBlockIndex *pnext = chainActive.Next(blockindex);
-	const CBlockIndex* plastAlgo = GetLastBlockIndexForAlgo(blockindex->pprev, algo, Params().GetConsensus());
+	const CBlockIndex* plastAlgo = GetPrevBlockIndexForAlgo(blockindex, Params().GetConsensus());
 	const CBlockIndex* pnextAlgo = GetNextBlockIndexForAlgo(pnext, algo);
     result.pushKV("hash", blockindex->GetBlockHash().GetHex());
 	result.pushKV("algo", GetAlgoName(algo));
@@ -206,11 +213,13 @@ UniValue blockheaderToJSON(const CBlockIndex* blockindex)
     result.pushKV("time", (int64_t)blockindex->nTime);
     result.pushKV("mediantime", (int64_t)blockindex->GetMedianTimePast());
     if(IsEquihashBasedAlgo(algo))
-        result.pushKV("nonce", blockindex->nBigNonce.GetHex());
+    {
+        result.pushKV("nonce", header.nBigNonce.GetHex());
+        if(!isauxpow)
+            result.pushKV("solution", HexStr(header.nSolution));
+    }
     else
         result.pushKV("nonce", (uint64_t)blockindex->nNonce);
-    if(!isauxpow && IsEquihashBasedAlgo(algo))
-        result.pushKV("solution", HexStr(blockindex->nSolution));
     result.pushKV("bits", strprintf("%08x", blockindex->nBits));
     result.pushKV("difficulty", GetDifficulty(blockindex, algo));
     result.pushKV("chainwork", blockindex->nChainWork.GetHex());
@@ -233,7 +242,7 @@ UniValue blockToJSON(const CBlock& block, const CBlockIndex* blockindex, bool tx
 	uint8_t algo = block.GetAlgo();
     bool isauxpow = block.auxpow && (block.auxpow != nullptr);
 	const CBlockIndex *pnext = chainActive.Next(blockindex);
-	const CBlockIndex* plastAlgo = GetLastBlockIndexForAlgo(blockindex->pprev, algo, Params().GetConsensus());
+	const CBlockIndex* plastAlgo = GetPrevBlockIndexForAlgo(blockindex, Params().GetConsensus());
 	const CBlockIndex* pnextAlgo = GetNextBlockIndexForAlgo(pnext, algo);
     result.pushKV("hash", blockindex->GetBlockHash().GetHex());
     int confirmations = -1;
@@ -272,7 +281,7 @@ UniValue blockToJSON(const CBlock& block, const CBlockIndex* blockindex, bool tx
     else
         result.pushKV("nonce", (uint64_t)block.nNonce);
     if(!isauxpow && IsEquihashBasedAlgo(algo))
-        result.pushKV("solution", HexStr(blockindex->nSolution));
+        result.pushKV("solution", HexStr(block.nSolution));
     result.pushKV("bits", strprintf("%08x", block.nBits));
     result.pushKV("difficulty", GetDifficulty(blockindex, algo));
     result.pushKV("chainwork", blockindex->nChainWork.GetHex());
@@ -1576,6 +1585,64 @@ UniValue getmempoolinfo(const JSONRPCRequest& request)
     return mempoolInfoToJSON();
 }
 
+UniValue getauxpowcacheinfo(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() != 0)
+        throw std::runtime_error(
+            "getauxpowcacheinfo\n"
+            "\nReturns details on the in-memory cache of merge-mined block headers.\n"
+            "\nResult:\n"
+            "{\n"
+            "  \"size\": xxxxx,               (numeric) Number of cached auxpows\n"
+            "  \"usage\": xxxxx,              (numeric) Total memory usage of the cache\n"
+            "  \"maxusage\": xxxxx,           (numeric) Maximum memory usage of the cache (-auxpowcache)\n"
+            "  \"hits\": xxxxx,               (numeric) Number of header lookups served from the cache\n"
+            "  \"misses\": xxxxx              (numeric) Number of header lookups that had to read from disk\n"
+            "}\n"
+            "\nExamples:\n"
+            + HelpExampleCli("getauxpowcacheinfo", "")
+            + HelpExampleRpc("getauxpowcacheinfo", "")
+        );
+
+    AuxPowCacheStats stats = auxpowcache.GetStats();
+    UniValue ret(UniValue::VOBJ);
+    ret.pushKV("size", (int64_t) stats.nEntries);
+    ret.pushKV("usage", (int64_t) stats.nUsage);
+    ret.pushKV("maxusage", (int64_t) stats.nMaxUsage);
+    ret.pushKV("hits", (int64_t) stats.nHits);
+    ret.pushKV("misses", (int64_t) stats.nMisses);
+    return ret;
+}
+
+UniValue getpowcacheinfo(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() != 0)
+        throw std::runtime_error(
+            "getpowcacheinfo\n"
+            "\nReturns details on the cache of block headers whose proof-of-work was already verified.\n"
+            "\nResult:\n"
+            "{\n"
+            "  \"maxsize\": xxxxx,            (numeric) Number of headers the cache can hold\n"
+            "  \"usage\": xxxxx,              (numeric) Total memory usage of the cache (-maxpowcachesize)\n"
+            "  \"hits\": xxxxx,               (numeric) Number of proof-of-work checks served from the cache\n"
+            "  \"misses\": xxxxx,             (numeric) Number of proof-of-work checks that had to hash the header\n"
+            "  \"inserts\": xxxxx             (numeric) Number of headers added to the cache\n"
+            "}\n"
+            "\nExamples:\n"
+            + HelpExampleCli("getpowcacheinfo", "")
+            + HelpExampleRpc("getpowcacheinfo", "")
+        );
+
+    PowCacheStats stats = GetPowCacheStats();
+    UniValue ret(UniValue::VOBJ);
+    ret.pushKV("maxsize", (int64_t) stats.nCapacity);
+    ret.pushKV("usage", (int64_t) stats.nBytes);
+    ret.pushKV("hits", (int64_t) stats.nHits);
+    ret.pushKV("misses", (int64_t) stats.nMisses);
+    ret.pushKV("inserts", (int64_t) stats.nInserts);
+    return ret;
+}
+
 UniValue preciousblock(const JSONRPCRequest& request)
 {
     if (request.fHelp || request.params.size() != 1)
@@ -1786,6 +1853,8 @@ UniValue savemempool(const JSONRPCRequest& request)
 static const CRPCCommand commands[] =
 { //  category              name                      actor (function)         argNames
   //  --------------------- ------------------------  -----------------------  ----------
+    { "blockchain",         "getauxpowcacheinfo",     &getauxpowcacheinfo,     {} },
+    { "blockchain",         "getpowcacheinfo",        &getpowcacheinfo,        {} },
     { "blockchain",         "getblockchaininfo",      &getblockchaininfo,      {} },
     { "blockchain",         "getchaintxstats",        &getchaintxstats,        {"nblocks", "blockhash"} },
     { "blockchain",         "getbestblockhash",       &getbestblockhash,       {} },
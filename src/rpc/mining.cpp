@@ -10,6 +10,7 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <base58.h>
+#include <algostats.h>
 #include <amount.h>
 #include <chain.h>
 #include <chainparams.h>
@@ -57,7 +58,31 @@ unsigned int ParseConfirmTarget(const UniValue& value)
  * or from the last difficulty change if 'lookup' is nonpositive.
  * If 'height' is nonnegative, compute the estimate at the time when a given block was found.
  */
+static int GetNetworkHashPSLookup(const CBlockIndex* pb, int lookup)
+{
+    // If lookup is -1, then use blocks since last difficulty change. (if fork activated, 11 blocks)
+    if (lookup <= 0)
+        lookup = pb->nHeight % Params().GetConsensus().DifficultyAdjustmentInterval() + 1;
+
+    // If lookup is larger than chain, then set it to chain length.
+    if (lookup > pb->nHeight)
+        lookup = pb->nHeight;
+
+    return lookup;
+}
+
 UniValue GetNetworkHashPS(uint8_t nAlgo, int lookup, int height) {
+    // Estimates at the tip are answered by the algo statistics tracker, without cs_main.
+    if (height < 0) {
+        const CBlockIndex* pb = algostatstracker.GetTip();
+        double dHashPS;
+        if (pb != nullptr && !pb->nHeight)
+            return 0;
+        if (pb != nullptr && algostatstracker.GetNetworkHashPS(nAlgo, GetNetworkHashPSLookup(pb, lookup), pb, dHashPS))
+            return dHashPS;
+    }
+
+    LOCK(cs_main);
     CBlockIndex *pb = chainActive.Tip();
 
     if (height >= 0 && height < chainActive.Height())
@@ -66,15 +91,7 @@ UniValue GetNetworkHashPS(uint8_t nAlgo, int lookup, int height) {
     if (pb == nullptr || !pb->nHeight)
         return 0;
 
-    // If lookup is -1, then use blocks since last difficulty change. (if fork activated, 11 blocks)
-    if (lookup <= 0)
-        lookup = pb->nHeight % Params().GetConsensus().DifficultyAdjustmentInterval() + 1;
-
-    // If lookup is larger than chain, then set it to chain length.
-    if (lookup > pb->nHeight)
-        lookup = pb->nHeight;
-
-    return CalculateAlgoHashrate(*pb, nAlgo, lookup, Params().GetConsensus());
+    return CalculateAlgoHashrate(*pb, nAlgo, GetNetworkHashPSLookup(pb, lookup), Params().GetConsensus());
 }
 
 UniValue GetUniValueForTreasury(const CAmount blockReward, const uint32_t nTime, int nHeight, const bool skipActivationCheck)
@@ -187,7 +204,8 @@ UniValue getnetworkhashps(const JSONRPCRequest& request)
             + HelpExampleRpc("getnetworkhashps", "")
         , GetAlgoRangeString()));
 
-    LOCK(cs_main);
+    // Let the algo statistics catch up with the blocks connected so far.
+    SyncWithValidationInterfaceQueue();
     
     uint8_t algo = currentAlgo;
     bool fAlgoFound = true;
@@ -201,6 +219,29 @@ UniValue getnetworkhashps(const JSONRPCRequest& request)
     return GetNetworkHashPS(algo, !request.params[0].isNull() ? request.params[0].get_int() : 24, !request.params[1].isNull() ? request.params[1].get_int() : -1);
 }
 
+/**
+ * Try the nonces of a header that is not equihash based from its current nonce
+ * until one satisfies nBits, nInnerLoopCount is reached or the tries run out.
+ * The nonce that satisfied nBits does not count as a try.
+ */
+static void ScanDefaultBlockNonces(CDefaultBlockHeader& header, uint8_t nAlgo, uint32_t nInnerLoopCount, uint64_t& nMaxTries)
+{
+    if (header.nNonce >= nInnerLoopCount)
+        return;
+    const Consensus::Params& consensusParams = Params().GetConsensus();
+    const uint32_t nCount = std::min<uint64_t>(nMaxTries, nInnerLoopCount - header.nNonce);
+    CMiningContext context(header, nAlgo, LoadMultiHasherVersionFlags(consensusParams.Hardfork3.IsActivated(header.nTime)));
+    arith_uint256 bnTarget;
+    uint32_t nNonceFound;
+    if (GetProofOfWorkTarget(header.nBits, consensusParams, nAlgo, bnTarget) && context.ScanNonces(header.nNonce, nCount, bnTarget, nNonceFound)) {
+        nMaxTries -= nNonceFound - header.nNonce;
+        header.nNonce = nNonceFound;
+    } else {
+        nMaxTries -= nCount;
+        header.nNonce += nCount;
+    }
+}
+
 UniValue generateBlocks(std::shared_ptr<CReserveScript> coinbaseScript, int nGenerate, uint64_t nMaxTries, bool keepScript, uint8_t nAlgo)
 {
 	static const int nInnerLoopGlobalTokenMask = 0x1FFFF;
@@ -328,10 +369,7 @@ UniValue generateBlocks(std::shared_ptr<CReserveScript> coinbaseScript, int nGen
                 CDefaultBlockHeader defaultblockheader = pblock->GetDefaultBlockHeader();
 				nInnerLoopMask = nInnerLoopGlobalTokenMask;
 				nInnerLoopCount = nInnerLoopGlobalTokenCount;
-				while (nMaxTries > 0 && defaultblockheader.nNonce < nInnerLoopCount && !CheckProofOfWork(defaultblockheader.GetPoWHash(nAlgo, SER_GETHASH, LoadMultiHasherVersionFlags(Params().GetConsensus().Hardfork3.IsActivated(defaultblockheader.nTime))), defaultblockheader.nBits, Params().GetConsensus(), nAlgo)) {
-					++defaultblockheader.nNonce;
-					--nMaxTries;
-				}
+				ScanDefaultBlockNonces(defaultblockheader, nAlgo, nInnerLoopCount, nMaxTries);
                 
                 // If Block is found convert CDefaultBlockHeader calculated stuff to pblock
                 
@@ -343,10 +381,7 @@ UniValue generateBlocks(std::shared_ptr<CReserveScript> coinbaseScript, int nGen
             CDefaultBlockHeader defaultblockheader = pblock->GetDefaultBlockHeader();
 			nInnerLoopMask = nInnerLoopGlobalTokenMask;
 			nInnerLoopCount = nInnerLoopGlobalTokenCount;
-			while (nMaxTries > 0 && defaultblockheader.nNonce < nInnerLoopCount && !CheckProofOfWork(defaultblockheader.GetPoWHash(ALGO_SHA256D, SER_GETHASH, LoadMultiHasherVersionFlags(Params().GetConsensus().Hardfork3.IsActivated(defaultblockheader.nTime))), defaultblockheader.nBits, Params().GetConsensus(), ALGO_SHA256D)) {
-				++defaultblockheader.nNonce;
-				--nMaxTries;
-			}
+			ScanDefaultBlockNonces(defaultblockheader, ALGO_SHA256D, nInnerLoopCount, nMaxTries);
             
             // If Block is found convert CDefaultBlockHeader calculated stuff to pblock
                 
@@ -461,6 +496,12 @@ UniValue getmininginfo(const JSONRPCRequest& request)
         );
 
 
+    // The hashrates are taken from the algo statistics before locking cs_main.
+    UniValue networkhashps = getnetworkhashps(request);
+    UniValue algohashps[NUM_ALGOS];
+    for(uint8_t i = 0; i < NUM_ALGOS; i++)
+        algohashps[i] = GetNetworkHashPS(i, 24, -1);
+
     LOCK(cs_main);
 
     UniValue obj(UniValue::VOBJ);
@@ -471,12 +512,12 @@ UniValue getmininginfo(const JSONRPCRequest& request)
 	obj.pushKV("algoid",             currentAlgo);
 	obj.pushKV("algo",               GetAlgoName(currentAlgo));
     obj.pushKV("difficulty",         (double)GetDifficulty(NULL, currentAlgo));
-    obj.pushKV("networkhashps",      getnetworkhashps(request));
+    obj.pushKV("networkhashps",      networkhashps);
     for(uint8_t i = 0; i < NUM_ALGOS; i++)
     {
         UniValue currentAlgo(UniValue::VOBJ);
         currentAlgo.pushKV("difficulty",       (double)GetDifficulty(NULL, i));
-        currentAlgo.pushKV("nethashrate",      GetNetworkHashPS(i, 24, -1));
+        currentAlgo.pushKV("nethashrate",      algohashps[i]);
         algodetails.pushKV(GetAlgoName(i), currentAlgo);
     }
 	obj.pushKV("algodetails", algodetails);
@@ -518,15 +559,23 @@ UniValue getalgoinfo(const JSONRPCRequest& request)
             + HelpExampleRpc("getalgoinfo", "")
         );
 
-    LOCK(cs_main);
+    // Per-algo statistics are kept up to date by algostatstracker, so neither
+    // cs_main nor a walk over the chain is needed here.
+    SyncWithValidationInterfaceQueue();
+    AlgoChainStats stats;
+    if (!algostatstracker.GetChainStats(stats)) {
+        algostatstracker.InitializeCurrentBlockTip();
+        if (!algostatstracker.GetChainStats(stats))
+            throw JSONRPCError(RPC_IN_WARMUP, "No blocks have been loaded yet");
+    }
 	
-    CBlockIndex* tip = chainActive.Tip();
+    const CBlockIndex* tip = stats.pindexTip;
 
     UniValue obj(UniValue::VOBJ);
     UniValue algos(UniValue::VOBJ);
 	
-    obj.pushKV("blocks",                (int)chainActive.Height());
-    obj.pushKV("headers",               pindexBestHeader ? pindexBestHeader->nHeight : -1);
+    obj.pushKV("blocks",                tip->nHeight);
+    obj.pushKV("headers",               stats.nHeaders);
     obj.pushKV("bestblockhash",         tip->GetBlockHash().GetHex());
     obj.pushKV("algos",                 NUM_ALGOS);
     obj.pushKV("lastblockalgo",         GetAlgoName(tip->GetAlgo()));
@@ -539,16 +588,19 @@ UniValue getalgoinfo(const JSONRPCRequest& request)
     for(uint8_t i = 0; i < NUM_ALGOS; i++)
     {
 	    UniValue algo_description(UniValue::VOBJ);
-        const CBlockIndex* pindexLastAlgo = GetLastBlockIndexForAlgo(tip, consensusParams.aPOWAlgos[i].GetAlgoID(), consensusParams);
+        const uint8_t algo = consensusParams.aPOWAlgos[i].GetAlgoID();
+        const AlgoStats& algostats = stats.algos[algo];
+        const CBlockIndex* pindexLastAlgo = algostats.pindexLast;
         int lastblock = (pindexLastAlgo != nullptr) ? pindexLastAlgo->nHeight : -1;
+        unsigned int nBits = (pindexLastAlgo != nullptr) ? pindexLastAlgo->nBits : consensusParams.aPOWAlgos[algo].GetArithPowLimit().GetCompact();
 	
-        algo_description.pushKV("algoid",      consensusParams.aPOWAlgos[i].GetAlgoID());
+        algo_description.pushKV("algoid",      algo);
         algo_description.pushKV("lastblock",   lastblock);
-        algo_description.pushKV("difficulty",  (double)GetDifficulty(NULL, consensusParams.aPOWAlgos[i].GetAlgoID()));
-        algo_description.pushKV("nethashrate", GetNetworkHashPS(consensusParams.aPOWAlgos[i].GetAlgoID(), 24, -1));
-        algo_description.pushKV("lastdiffret", CalculateDiffRetargetingBlock(tip, RETARGETING_LAST, consensusParams.aPOWAlgos[i].GetAlgoID(), Params().GetConsensus()));
-        algo_description.pushKV("nextdiffret", CalculateDiffRetargetingBlock(tip, RETARGETING_NEXT, consensusParams.aPOWAlgos[i].GetAlgoID(), Params().GetConsensus()));
-        algos.pushKV(GetAlgoName(consensusParams.aPOWAlgos[i].GetAlgoID()), algo_description);
+        algo_description.pushKV("difficulty",  GetDifficultyFromBits(nBits));
+        algo_description.pushKV("nethashrate", GetNetworkHashPS(algo, 24, -1));
+        algo_description.pushKV("lastdiffret", algostats.nLastDiffRet);
+        algo_description.pushKV("nextdiffret", algostats.nNextDiffRet);
+        algos.pushKV(GetAlgoName(algo), algo_description);
     }
 	
     obj.pushKV("algo_details", algos);
@@ -900,55 +952,35 @@ UniValue getblocktemplate(const JSONRPCRequest& request)
     }
 
     // Update block
-    static CBlockIndex* pindexPrev;
-    static int64_t nStart;
-    static std::unique_ptr<CBlockTemplate> pblocktemplate;
-    // Cache whether the last invocation was with segwit support, to avoid returning
+    static CBlockTemplateCache templateCache(Params(), 5);
+    CScript scriptDummy = CScript() << OP_TRUE;
+    CScript createscript = (coinbasetxn) ? coinbasetxnscript : scriptDummy;
+    // Cached per algo, keyed on segwit support as well, to avoid returning
     // a segwit-block to a non-segwit caller.
-    static bool fLastTemplateSupportsSegwit = true;
-    static uint8_t lastAlgo;
-    if (pindexPrev != chainActive.Tip() ||
-        (mempool.GetTransactionsUpdated() != nTransactionsUpdatedLast && GetTime() - nStart > 5) ||
-        fLastTemplateSupportsSegwit != fSupportsSegwit || algo != lastAlgo)
+    std::shared_ptr<CBlockTemplate> pblocktemplate = templateCache.Get(createscript, algo, fSupportsSegwit);
+    if (!pblocktemplate)
     {
-        // Clear pindexPrev so future calls make a new block, despite any failures from here on
-        pindexPrev = nullptr;
-
-        // Store the pindexBest used before CreateNewBlock, to avoid races
-        nTransactionsUpdatedLast = mempool.GetTransactionsUpdated();
-        CBlockIndex* pindexPrevNew = chainActive.Tip();
-        nStart = GetTime();
-        fLastTemplateSupportsSegwit = fSupportsSegwit;
-        lastAlgo = algo;
-
-        // Create new block
-        CScript scriptDummy = CScript() << OP_TRUE;
-        CScript createscript = (coinbasetxn) ? coinbasetxnscript : scriptDummy;
-        pblocktemplate = BlockAssembler(Params()).CreateNewBlock(createscript, algo, fSupportsSegwit);
-        if (!pblocktemplate)
+        if(Params().GetConsensus().Hardfork2.IsActivated(chainActive.Tip()->nTime))
         {
-            if(Params().GetConsensus().Hardfork2.IsActivated(pindexPrevNew->nTime))
+            throw JSONRPCError(RPC_OUT_OF_MEMORY, "Out of memory");
+        }
+        else
+        {
+            if(IsAlgoAllowedBeforeHF2(algo))
             {
                 throw JSONRPCError(RPC_OUT_OF_MEMORY, "Out of memory");
             }
             else
             {
-                if(IsAlgoAllowedBeforeHF2(algo))
-                {
-                    throw JSONRPCError(RPC_OUT_OF_MEMORY, "Out of memory");
-                }
-                else
-                {
-                    std::stringstream strstream;
-                    strstream << "You cannot mine with Algorithm " << GetAlgoName(algo) << ", because Hardfork 2 is not activated yet.";
-                    throw JSONRPCError(RPC_INVALID_PARAMS, strstream.str()); 
-                }
+                std::stringstream strstream;
+                strstream << "You cannot mine with Algorithm " << GetAlgoName(algo) << ", because Hardfork 2 is not activated yet.";
+                throw JSONRPCError(RPC_INVALID_PARAMS, strstream.str()); 
             }
         }
-
-        // Need to update only after we know CreateNewBlock succeeded
-        pindexPrev = pindexPrevNew;
     }
+    nTransactionsUpdatedLast = templateCache.GetTransactionsUpdated();
+    // The cache builds on the current tip only
+    CBlockIndex* const pindexPrev = chainActive.Tip();
     CBlock* pblock = &pblocktemplate->block; // pointer for convenience
     const Consensus::Params& consensusParams = Params().GetConsensus();
 
@@ -1458,63 +1490,59 @@ UniValue AuxMiningCreateBlock(const CScript& scriptPubKey, const uint8_t nAlgo)
 
     LOCK(cs_auxblockCache);
 
-    static unsigned nTransactionsUpdatedLast;
+    static CBlockTemplateCache templateCache(Params(), 60);
     static const CBlockIndex* pindexPrev = nullptr;
-    static uint64_t nStart;
-    static CBlock* pblock = nullptr;
     static unsigned nExtraNonce = 0;
-    static uint8_t lastAlgo;
+    // The last template of each algo and the block made from it
+    static std::array<std::shared_ptr<CBlockTemplate>, NUM_ALGOS_IMPL> algoTemplates;
+    static std::array<CBlock*, NUM_ALGOS_IMPL> algoBlocks;
 
     // Update block
+    CBlock* pblock;
     {
     LOCK(cs_main);
-    if (pindexPrev != chainActive.Tip()
-        || (mempool.GetTransactionsUpdated() != nTransactionsUpdatedLast
-            && GetTime() - nStart > 60) || nAlgo != lastAlgo)
+    if (pindexPrev != chainActive.Tip())
+    {
+        // Clear old blocks since they're obsolete now.
+        mapNewBlock.clear();
+        vNewBlockTemplate.clear();
+        algoTemplates.fill(nullptr);
+        algoBlocks.fill(nullptr);
+        pindexPrev = chainActive.Tip();
+    }
+
+    std::shared_ptr<CBlockTemplate> pblocktemplate = templateCache.Get(scriptPubKey, nAlgo, true);
+    if (!pblocktemplate)
     {
-        if (pindexPrev != chainActive.Tip())
+        if(Params().GetConsensus().Hardfork2.IsActivated(chainActive.Tip()->nTime))
         {
-            // Clear old blocks since they're obsolete now.
-            mapNewBlock.clear();
-            vNewBlockTemplate.clear();
-            pblock = nullptr;
+            throw JSONRPCError(RPC_OUT_OF_MEMORY, "Out of memory");
         }
-
-        // Create new block with nonce = 0 and extraNonce = 1
-        std::unique_ptr<CBlockTemplate> newBlock
-            = BlockAssembler(Params()).CreateNewBlock(scriptPubKey, nAlgo);
-        if (!newBlock)
+        else
         {
-            if(Params().GetConsensus().Hardfork2.IsActivated(chainActive.Tip()->nTime))
+            if(IsAlgoAllowedBeforeHF2(nAlgo))
             {
                 throw JSONRPCError(RPC_OUT_OF_MEMORY, "Out of memory");
             }
             else
             {
-                if(IsAlgoAllowedBeforeHF2(nAlgo))
-                {
-                    throw JSONRPCError(RPC_OUT_OF_MEMORY, "Out of memory");
-                }
-                else
-                {
-                    std::stringstream strstream;
-                    strstream << "You cannot mine with Algorithm " << GetAlgoName(nAlgo) << ", because Hardfork 2 is not activated yet.";
-                    throw JSONRPCError(RPC_INVALID_PARAMS, strstream.str()); 
-                }
+                std::stringstream strstream;
+                strstream << "You cannot mine with Algorithm " << GetAlgoName(nAlgo) << ", because Hardfork 2 is not activated yet.";
+                throw JSONRPCError(RPC_INVALID_PARAMS, strstream.str()); 
             }
         }
-        
-        if(Params().GetConsensus().Hardfork1.IsActivated(newBlock->block.nTime) && !gArgs.GetBoolArg("-acceptdividedcoinbase", false))
+    }
+
+    if (pblocktemplate != algoTemplates[nAlgo])
+    {
+        if(Params().GetConsensus().Hardfork1.IsActivated(pblocktemplate->block.nTime) && !gArgs.GetBoolArg("-acceptdividedcoinbase", false))
         {
             throw std::runtime_error(GetCoinbaseFeeString(DIVIDEDPAYMENTS_AUXPOW_WARNING));
         }
 
-        // Update state only when CreateNewBlock succeeded
-        nTransactionsUpdatedLast = mempool.GetTransactionsUpdated();
-        pindexPrev = chainActive.Tip();
-        nStart = GetTime();
-        lastAlgo = nAlgo;
-	    
+        // Take a copy with nonce = 0 and extraNonce = 1, the cached template is shared
+        std::unique_ptr<CBlockTemplate> newBlock(new CBlockTemplate(*pblocktemplate));
+
         // If new block is an Equihash block, set the nNonce to null, because it is randomized by default.
         if(IsEquihashBasedAlgo(nAlgo))
             newBlock->block.nBigNonce.SetNull();
@@ -1524,17 +1552,17 @@ UniValue AuxMiningCreateBlock(const CScript& scriptPubKey, const uint8_t nAlgo)
         newBlock->block.SetAuxpowVersion(true);
 
         // Save
-        pblock = &newBlock->block;
-        mapNewBlock[pblock->GetHash()] = pblock;
+        algoTemplates[nAlgo] = pblocktemplate;
+        algoBlocks[nAlgo] = &newBlock->block;
+        mapNewBlock[newBlock->block.GetHash()] = &newBlock->block;
         vNewBlockTemplate.push_back(std::move(newBlock));
     }
+    pblock = algoBlocks[nAlgo];
     }
 
-    // At this point, pblock is always initialised:  If we make it here
-    // without creating a new block above, it means that, in particular,
-    // pindexPrev == chainActive.Tip().  But for that to happen, we must
-    // already have created a pblock in a previous call, as pindexPrev is
-    // initialised only when pblock is.
+    // At this point, pblock is always initialised:  The block of an algo is
+    // made whenever the cache hands out a template it was not made from, and
+    // the blocks are only dropped together with the templates on a new tip.
     assert(pblock);
 
     arith_uint256 target;
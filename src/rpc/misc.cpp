@@ -9,7 +9,9 @@
 #include <chainparams.h>
 #include <clientversion.h>
 #include <core_io.h>
+#include <crypto/algos/scratchpad.h>
 #include <crypto/ripemd160.h>
+#include <equihashstore.h>
 #include <init.h>
 #include <validation.h>
 #include <httpserver.h>
@@ -391,6 +393,50 @@ static UniValue RPCLockedMemoryInfo()
     return obj;
 }
 
+static UniValue RPCBlockIndexMemoryInfo()
+{
+    size_t nEntries;
+    {
+        LOCK(cs_main);
+        nEntries = mapBlockIndex.size();
+    }
+    EquihashStoreStats stats = equihashstore.GetStats();
+    // Every entry used to carry the equihash fields, those of equihash blocks with their solution
+    int64_t nSaved = int64_t(nEntries - std::min<uint64_t>(nEntries, stats.nOffloaded)) * sizeof(CEquihashFields) +
+                     int64_t(stats.nOffloadedBytes) - int64_t(stats.nUsage);
+
+    UniValue equihash(UniValue::VOBJ);
+    equihash.pushKV("offloaded", stats.nOffloaded);
+    equihash.pushKV("offloaded_bytes", stats.nOffloadedBytes);
+    equihash.pushKV("pending", uint64_t(stats.nPending));
+    equihash.pushKV("cached", uint64_t(stats.nCached));
+    equihash.pushKV("usage", uint64_t(stats.nUsage));
+    equihash.pushKV("maxusage", uint64_t(stats.nMaxUsage));
+    equihash.pushKV("hits", stats.nHits);
+    equihash.pushKV("reads", stats.nReads);
+
+    UniValue obj(UniValue::VOBJ);
+    obj.pushKV("entries", uint64_t(nEntries));
+    obj.pushKV("entry_size", uint64_t(sizeof(CBlockIndex)));
+    obj.pushKV("saved", std::max<int64_t>(nSaved, 0));
+    obj.pushKV("equihash", equihash);
+    return obj;
+}
+
+static UniValue RPCPowScratchpadMemoryInfo()
+{
+    PowScratchpadStats stats = PowScratchpadGetStats();
+    UniValue obj(UniValue::VOBJ);
+    obj.pushKV("size", uint64_t(stats.nSize));
+    obj.pushKV("hugepages", stats.fHugePages);
+    obj.pushKV("arenas", uint64_t(stats.nArenas));
+    obj.pushKV("reserved", uint64_t(stats.nReserved));
+    obj.pushKV("hugepages_reserved", uint64_t(stats.nHugePagesReserved));
+    obj.pushKV("allocations", stats.nAllocations);
+    obj.pushKV("fallbacks", stats.nFallbacks);
+    return obj;
+}
+
 #ifdef HAVE_MALLOC_INFO
 static std::string RPCMallocInfo()
 {
@@ -432,6 +478,30 @@ UniValue getmemoryinfo(const JSONRPCRequest& request)
             "    \"locked\": xxxxxx,       (numeric) Amount of bytes that succeeded locking. If this number is smaller than total, locking pages failed at some point and key data could be swapped to disk.\n"
             "    \"chunks_used\": xxxxx,   (numeric) Number allocated chunks\n"
             "    \"chunks_free\": xxxxx,   (numeric) Number unused chunks\n"
+            "  },\n"
+            "  \"blockindex\": {           (json object) Information about the block index\n"
+            "    \"entries\": xxxxx,       (numeric) Number of block index entries\n"
+            "    \"entry_size\": xxx,      (numeric) Size of one entry in bytes\n"
+            "    \"saved\": xxxxx,         (numeric) Bytes saved by keeping the equihash fields out of the entries\n"
+            "    \"equihash\": {           (json object) Side table of the equihash fields\n"
+            "      \"offloaded\": xxxxx,   (numeric) Number of entries whose fields are only on disk\n"
+            "      \"offloaded_bytes\": xx,(numeric) Bytes these fields would take up in memory\n"
+            "      \"pending\": xxxxx,     (numeric) Number of entries not yet written to disk\n"
+            "      \"cached\": xxxxx,      (numeric) Number of entries cached after being read back\n"
+            "      \"usage\": xxxxx,       (numeric) Bytes used by pending and cached entries\n"
+            "      \"maxusage\": xxxxx,    (numeric) Maximum bytes used by cached entries\n"
+            "      \"hits\": xxxxx,        (numeric) Number of lookups served by the cache\n"
+            "      \"reads\": xxxxx        (numeric) Number of lookups read from disk\n"
+            "    }\n"
+            "  },\n"
+            "  \"powscratchpad\": {        (json object) Working memory of the memory-hard proof-of-work hashes\n"
+            "    \"size\": xxxxx,          (numeric) Bytes a hashing thread allocates its scratchpad with\n"
+            "    \"hugepages\": true|false, (boolean) Whether scratchpads are backed by huge pages (-powhugepages)\n"
+            "    \"arenas\": xxxxx,        (numeric) Number of threads holding a scratchpad\n"
+            "    \"reserved\": xxxxx,      (numeric) Bytes held by all scratchpads\n"
+            "    \"hugepages_reserved\": xx,(numeric) Bytes of these held in explicitly reserved huge pages\n"
+            "    \"allocations\": xxxxx,   (numeric) Number of scratchpad allocations, including regrowths\n"
+            "    \"fallbacks\": xxxxx      (numeric) Number of hashes whose kernel allocated memory besides its scratchpad\n"
             "  }\n"
             "}\n"
             "\nResult (mode \"mallocinfo\"):\n"
@@ -445,6 +515,8 @@ UniValue getmemoryinfo(const JSONRPCRequest& request)
     if (mode == "stats") {
         UniValue obj(UniValue::VOBJ);
         obj.pushKV("locked", RPCLockedMemoryInfo());
+        obj.pushKV("blockindex", RPCBlockIndexMemoryInfo());
+        obj.pushKV("powscratchpad", RPCPowScratchpadMemoryInfo());
         return obj;
     } else if (mode == "mallocinfo") {
 #ifdef HAVE_MALLOC_INFO
@@ -59,19 +59,29 @@ void CSporkManager::ProcessSpork(CNode* pfrom, const std::string& strCommand, CD
             LogPrintf("%s new\n", strLogMsg);
         }
 
-        if(!spork.CheckSignature(sporkPubKeyID)) {
-            LOCK(cs_main);
-            LogPrintf("CSporkManager::ProcessSpork -- ERROR: invalid signature\n");
-            Misbehaving(pfrom->GetId(), 100);
-            return;
-        }
+        std::vector<CHashSigCheck> vChecks;
+        vChecks.push_back(spork.GetSignatureCheck(sporkPubKeyID));
 
-        mapSporks[hash] = spork;
-        mapSporksActive[spork.nSporkID] = spork;
-        spork.Relay(connman);
+        bool fBatchDue = pendingMessages.Add(pfrom, vChecks, [this, spork, hash](CNode* pnode, CConnman& connmanIn) mutable {
+            // a newer spork may have been finished while this one was queued
+            if(mapSporksActive.count(spork.nSporkID) && mapSporksActive[spork.nSporkID].nTimeSigned >= spork.nTimeSigned) return;
+
+            if(!spork.CheckSignature(sporkPubKeyID)) {
+                LOCK(cs_main);
+                LogPrintf("CSporkManager::ProcessSpork -- ERROR: invalid signature\n");
+                Misbehaving(pnode->GetId(), 100);
+                return;
+            }
+
+            mapSporks[hash] = spork;
+            mapSporksActive[spork.nSporkID] = spork;
+            spork.Relay(connmanIn);
 
-        //does a task if needed
-        ExecuteSpork(spork.nSporkID, spork.nValue);
+            //does a task if needed
+            ExecuteSpork(spork.nSporkID, spork.nValue);
+        });
+        if (fBatchDue)
+            ProcessPendingMessages(connman);
 
     } else if (strCommand == NetMsgType::GETSPORKS) {
 
@@ -260,6 +270,11 @@ uint256 CSporkMessage::GetSignatureHash() const
     return GetHash();
 }
 
+std::string CSporkMessage::GetSignatureMessage() const
+{
+    return boost::lexical_cast<std::string>(nSporkID) + boost::lexical_cast<std::string>(nValue) + boost::lexical_cast<std::string>(nTimeSigned);
+}
+
 bool CSporkMessage::Sign(const CKey& key)
 {
     if (!key.IsValid()) {
@@ -283,7 +298,7 @@ bool CSporkMessage::Sign(const CKey& key)
             return false;
         }
     } else {
-        std::string strMessage = boost::lexical_cast<std::string>(nSporkID) + boost::lexical_cast<std::string>(nValue) + boost::lexical_cast<std::string>(nTimeSigned);
+        std::string strMessage = GetSignatureMessage();
 
         if(!CMessageSigner::SignMessage(strMessage, vchSig, key)) {
             LogPrintf("CSporkMessage::Sign -- SignMessage() failed\n");
@@ -313,7 +328,7 @@ bool CSporkMessage::CheckSignature(const CKeyID& pubKeyId) const
             return false;
         }
     } else {
-        std::string strMessage = boost::lexical_cast<std::string>(nSporkID) + boost::lexical_cast<std::string>(nValue) + boost::lexical_cast<std::string>(nTimeSigned);
+        std::string strMessage = GetSignatureMessage();
 
         if (!CMessageSigner::VerifyMessage(pubKeyId, vchSig, strMessage, strError)){
             // Note: unlike for other messages we have to check for new format even with SPORK_4_NEW_SIGS
@@ -330,6 +345,14 @@ bool CSporkMessage::CheckSignature(const CKeyID& pubKeyId) const
     return true;
 }
 
+CHashSigCheck CSporkMessage::GetSignatureCheck(const CKeyID& pubKeyId) const
+{
+    if (sporkManager.IsSporkActive(SPORK_4_NEW_SIGS))
+        return CHashSigCheck(GetSignatureHash(), pubKeyId, vchSig);
+
+    return CHashSigCheck(CMessageSigner::GetMessageHash(GetSignatureMessage()), pubKeyId, vchSig);
+}
+
 void CSporkMessage::Relay(CConnman& connman)
 {
     CInv inv(MSG_SPORK, GetHash());
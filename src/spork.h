@@ -10,6 +10,7 @@
 #include <net.h>
 #include <utilstrencodings.h>
 #include <key.h>
+#include <messagesigner.h>
 
 class CSporkMessage;
 class CSporkManager;
@@ -75,9 +76,13 @@ public:
 
     uint256 GetHash() const;
     uint256 GetSignatureHash() const;
+    /// The message signed before SPORK_4_NEW_SIGS
+    std::string GetSignatureMessage() const;
 
     bool Sign(const CKey& key);
     bool CheckSignature(const CKeyID& pubKeyId) const;
+    /// The check CheckSignature starts with, to verify ahead of it in a batch
+    CHashSigCheck GetSignatureCheck(const CKeyID& pubKeyId) const;
     void Relay(CConnman& connman);
 };
 
@@ -91,11 +96,16 @@ private:
     CKeyID sporkPubKeyID;
     CKey sporkPrivKey;
 
+    // sporks waiting for their signatures to be verified in a batch
+    CPendingSigMessages pendingMessages;
+
 public:
 
     CSporkManager() {}
 
     void ProcessSpork(CNode* pfrom, const std::string& strCommand, CDataStream& vRecv, CConnman& connman);
+    /// Verify the signatures of the queued sporks in a batch and finish them
+    void ProcessPendingMessages(CConnman& connman) { pendingMessages.Process(connman); }
     void ExecuteSpork(int nSporkID, int nValue);
     bool UpdateSpork(int nSporkID, int64_t nValue, CConnman& connman);
 
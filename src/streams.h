@@ -680,6 +680,21 @@ public:
         return true;
     }
 
+    // move the reading position forward to nPos, reading ahead through the
+    // buffer for short distances and seeking the source file otherwise
+    bool SkipTo(uint64_t nPos) {
+        if (nPos < nReadPos)
+            return SetPos(nPos);
+        if (nPos > nSrcPos + vchBuf.size())
+            return Seek(nPos);
+        while (nSrcPos < nPos) {
+            nReadPos = nSrcPos;
+            Fill();
+        }
+        nReadPos = nPos;
+        return true;
+    }
+
     // prevent reading beyond a certain position
     // no argument removes the limit
     bool SetLimit(uint64_t nPos = (uint64_t)(-1)) {
@@ -0,0 +1,125 @@
+// Copyright (c) 2026 The Globaltoken Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <algostats.h>
+#include <chain.h>
+#include <chainparams.h>
+#include <pow.h>
+#include <primitives/block.h>
+
+#include <test/test_bitcoin.h>
+
+#include <list>
+#include <map>
+#include <memory>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(algostats_tests, BasicTestingSetup)
+
+namespace {
+class TestAlgoStatsTracker : public CAlgoStatsTracker
+{
+public:
+    void Connect(const CBlockIndex* pindex)
+    {
+        BlockConnected(nullptr, pindex, std::vector<CTransactionRef>());
+    }
+    void Disconnect(const std::shared_ptr<const CBlock>& pblock)
+    {
+        BlockDisconnected(pblock);
+    }
+};
+
+struct TestChain
+{
+    std::list<CBlockIndex> indexes;
+    std::list<uint256> hashes;
+    std::map<const CBlockIndex*, std::shared_ptr<const CBlock> > blocks;
+
+    const CBlockIndex* Extend(const CBlockIndex* pindexPrev, const Consensus::Params& params)
+    {
+        std::shared_ptr<CBlock> pblock = std::make_shared<CBlock>();
+        pblock->nVersion = 4;
+        pblock->SetAlgo(InsecureRandRange(6));
+        pblock->nTime = params.Hardfork2.GetActivationTime() + (pindexPrev ? pindexPrev->nHeight + 1 : 0) * 60;
+        pblock->nBits = InsecureRandBool() ? 0x1e0ffff0 : 0x1e0fffff;
+        pblock->nNonce = InsecureRand32();
+        hashes.push_back(pblock->GetHash());
+
+        indexes.emplace_back(*pblock);
+        CBlockIndex* pindex = &indexes.back();
+        pindex->phashBlock = &hashes.back();
+        pindex->pprev = const_cast<CBlockIndex*>(pindexPrev);
+        pindex->nHeight = pindexPrev ? pindexPrev->nHeight + 1 : 0;
+        pindex->BuildSkip();
+        pindex->BuildAlgoSkip(params);
+        blocks[pindex] = pblock;
+        return pindex;
+    }
+};
+
+void CheckStats(const TestAlgoStatsTracker& tracker, const CBlockIndex* pindexTip, const Consensus::Params& params)
+{
+    AlgoChainStats stats;
+    BOOST_CHECK(tracker.GetChainStats(stats));
+    BOOST_CHECK(stats.pindexTip == pindexTip);
+    for (int algo = 0; algo < NUM_ALGOS_IMPL; algo++) {
+        BOOST_CHECK(stats.algos[algo].pindexLast == GetLastBlockIndexForAlgo(pindexTip, algo, params));
+        BOOST_CHECK_EQUAL(stats.algos[algo].nLastDiffRet, CalculateDiffRetargetingBlock(pindexTip, RETARGETING_LAST, algo, params));
+        BOOST_CHECK_EQUAL(stats.algos[algo].nNextDiffRet, CalculateDiffRetargetingBlock(pindexTip, RETARGETING_NEXT, algo, params));
+        for (int nLookup : {1, 24, ALGO_STATS_WINDOW}) {
+            double dHashPS;
+            BOOST_CHECK(tracker.GetNetworkHashPS(algo, nLookup, pindexTip, dHashPS));
+            BOOST_CHECK_EQUAL(dHashPS, CalculateAlgoHashrate(*pindexTip, algo, nLookup, params));
+        }
+    }
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(algostats_connect_disconnect)
+{
+    const Consensus::Params& params = Params().GetConsensus();
+    TestChain chain;
+    TestAlgoStatsTracker tracker;
+
+    AlgoChainStats stats;
+    BOOST_CHECK(!tracker.GetChainStats(stats));
+
+    const CBlockIndex* pindexTip = nullptr;
+    for (int i = 0; i < 300; i++) {
+        pindexTip = chain.Extend(pindexTip, params);
+        tracker.Connect(pindexTip);
+        if (i % 10 == 0)
+            CheckStats(tracker, pindexTip, params);
+    }
+    CheckStats(tracker, pindexTip, params);
+
+    // Reorganize: disconnect some blocks and connect a longer branch.
+    for (int i = 0; i < 20; i++) {
+        tracker.Disconnect(chain.blocks[pindexTip]);
+        pindexTip = pindexTip->pprev;
+        CheckStats(tracker, pindexTip, params);
+    }
+    for (int i = 0; i < 30; i++) {
+        pindexTip = chain.Extend(pindexTip, params);
+        tracker.Connect(pindexTip);
+        CheckStats(tracker, pindexTip, params);
+    }
+
+    // A stale notification for a block on the tracked chain is ignored,
+    // a block that does not extend the tip resets the tracker.
+    tracker.Connect(pindexTip->pprev);
+    CheckStats(tracker, pindexTip, params);
+    const CBlockIndex* pindexFork = chain.Extend(pindexTip->GetAncestor(pindexTip->nHeight - 5), params);
+    tracker.Connect(pindexFork);
+    CheckStats(tracker, pindexFork, params);
+
+    // The window does not answer lookups beyond its size.
+    double dHashPS;
+    BOOST_CHECK(!tracker.GetNetworkHashPS(ALGO_SHA256D, ALGO_STATS_WINDOW + 1, pindexFork, dHashPS));
+    BOOST_CHECK(!tracker.GetNetworkHashPS(ALGO_SHA256D, 24, pindexTip, dHashPS));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,68 @@
+// Copyright (c) 2026 The Globaltoken Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <auxpow.h>
+#include <auxpowcache.h>
+#include <primitives/transaction.h>
+#include <uint256.h>
+
+#include <test/test_bitcoin.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(auxpowcache_tests, BasicTestingSetup)
+
+static CAuxPow MakeAuxPow(int nChainIndex)
+{
+    CAuxPow auxpow(MakeTransactionRef(CMutableTransaction()));
+    auxpow.nVersion = 0;
+    auxpow.nChainIndex = nChainIndex;
+    return auxpow;
+}
+
+BOOST_AUTO_TEST_CASE(auxpowcache_get)
+{
+    CAuxPowCache cache;
+    boost::shared_ptr<CAuxPow> auxpow;
+
+    cache.Add(uint256S("01"), MakeAuxPow(1));
+    BOOST_CHECK(cache.Get(uint256S("01"), auxpow));
+    BOOST_CHECK_EQUAL(auxpow->nChainIndex, 1);
+    BOOST_CHECK(!cache.Get(uint256S("02"), auxpow));
+
+    AuxPowCacheStats stats = cache.GetStats();
+    BOOST_CHECK_EQUAL(stats.nEntries, 1U);
+    BOOST_CHECK_EQUAL(stats.nHits, 1U);
+    BOOST_CHECK_EQUAL(stats.nMisses, 1U);
+
+    cache.Clear();
+    BOOST_CHECK(!cache.Get(uint256S("01"), auxpow));
+    BOOST_CHECK_EQUAL(cache.GetStats().nUsage, 0U);
+}
+
+BOOST_AUTO_TEST_CASE(auxpowcache_evicts_least_recently_used)
+{
+    CAuxPowCache cache;
+    boost::shared_ptr<CAuxPow> auxpow;
+
+    cache.Add(uint256S("01"), MakeAuxPow(1));
+    size_t nEntryUsage = cache.GetStats().nUsage;
+    cache.SetMaxUsage(2 * nEntryUsage);
+    cache.Add(uint256S("02"), MakeAuxPow(2));
+
+    // Touch the first entry, so the second one is evicted next
+    BOOST_CHECK(cache.Get(uint256S("01"), auxpow));
+    cache.Add(uint256S("03"), MakeAuxPow(3));
+
+    BOOST_CHECK_EQUAL(cache.GetStats().nEntries, 2U);
+    BOOST_CHECK(cache.Get(uint256S("01"), auxpow));
+    BOOST_CHECK(!cache.Get(uint256S("02"), auxpow));
+    BOOST_CHECK(cache.Get(uint256S("03"), auxpow));
+    BOOST_CHECK_EQUAL(auxpow->nChainIndex, 3);
+
+    cache.SetMaxUsage(0);
+    BOOST_CHECK_EQUAL(cache.GetStats().nEntries, 0U);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
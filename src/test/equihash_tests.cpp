@@ -15,6 +15,7 @@
 
 #include <sodium.h>
 
+#include <algorithm>
 #include <sstream>
 #include <set>
 #include <vector>
@@ -95,8 +96,155 @@ void TestEquihashValidator(unsigned int n, unsigned int k, const std::string &I,
     PrintSolution(strm, soln);
     BOOST_TEST_MESSAGE(strm.str());
     bool isValid;
-    EhIsValidSolution(n, k, state, GetMinimalFromIndices(soln, cBitLen), isValid);
+    std::vector<unsigned char> minimal = GetMinimalFromIndices(soln, cBitLen);
+    EhIsValidSolution(n, k, state, minimal, isValid);
     BOOST_CHECK(isValid == expected);
+    if (n == 96 && k == 5) {
+        BOOST_CHECK(Eh96_5.IsValidSolution(state, minimal.data(), minimal.size()) == expected);
+        BOOST_CHECK(!Eh96_5.IsValidSolution(state, minimal.data(), minimal.size() - 1));
+    }
+}
+
+/**
+ * The validator from before IsValidSolution checked solutions in place: it
+ * builds the tree of rows level by level and checks the ordering and the
+ * distinctness of the indices of every merged pair of subtrees.
+ */
+template<unsigned int N, unsigned int K>
+bool ReferenceIsValidSolution(const eh_HashState& base_state, const std::vector<unsigned char>& soln)
+{
+    typedef Equihash<N,K> Eh;
+    if (soln.size() != Eh::SolutionWidth)
+        return false;
+
+    struct Row {
+        std::vector<unsigned char> hash;
+        std::vector<eh_index> indices;
+    };
+    std::vector<Row> X;
+    unsigned char tmpHash[Eh::HashOutput];
+    for (eh_index i : GetIndicesFromMinimal(soln, Eh::CollisionBitLength)) {
+        eh_HashState state = base_state;
+        eh_index lei = htole32(i / Eh::IndicesPerHashOutput);
+        crypto_generichash_blake2b_update(&state, (const unsigned char*)&lei, sizeof(eh_index));
+        crypto_generichash_blake2b_final(&state, tmpHash, Eh::HashOutput);
+        Row row;
+        row.hash.resize(Eh::HashLength);
+        ExpandArray(tmpHash + (i % Eh::IndicesPerHashOutput) * N/8, N/8,
+                    row.hash.data(), row.hash.size(), Eh::CollisionBitLength);
+        row.indices.push_back(i);
+        X.push_back(row);
+    }
+
+    while (X.size() > 1) {
+        std::vector<Row> Xc;
+        for (size_t i = 0; i < X.size(); i += 2) {
+            const Row& a = X[i];
+            const Row& b = X[i+1];
+            if (!std::equal(a.hash.begin(), a.hash.begin() + Eh::CollisionByteLength, b.hash.begin()))
+                return false;
+            if (b.indices < a.indices)
+                return false;
+            for (eh_index ia : a.indices) {
+                if (std::find(b.indices.begin(), b.indices.end(), ia) != b.indices.end())
+                    return false;
+            }
+            Row c;
+            for (size_t j = Eh::CollisionByteLength; j < a.hash.size(); j++)
+                c.hash.push_back(a.hash[j] ^ b.hash[j]);
+            c.indices = a.indices;
+            c.indices.insert(c.indices.end(), b.indices.begin(), b.indices.end());
+            Xc.push_back(c);
+        }
+        X.swap(Xc);
+    }
+    return std::all_of(X[0].hash.begin(), X[0].hash.end(), [](unsigned char c) { return c == 0; });
+}
+
+/**
+ * Check that IsValidSolution agrees with the reference validator on a valid
+ * solution and on nMutations mutations of it. Returns the number of
+ * solutions found valid.
+ */
+template<unsigned int N, unsigned int K>
+int TestValidatorMutations(Equihash<N,K>& eh, const eh_HashState& state, const std::vector<eh_index>& soln, int nMutations)
+{
+    const size_t cBitLen = eh.CollisionBitLength;
+    int nValid = 0;
+    for (int nMutation = 0; nMutation <= nMutations; nMutation++) {
+        std::vector<eh_index> indices = soln;
+        const size_t a = InsecureRandRange(indices.size());
+        const size_t b = InsecureRandRange(indices.size());
+        std::vector<unsigned char> minimal;
+        switch (nMutation % 7) {
+        case 0:
+            // Unchanged, or two indices swapped
+            if (nMutation > 0)
+                std::swap(indices[a], indices[b]);
+            break;
+        case 1:
+            // Duplicate index
+            indices[a] = indices[b];
+            break;
+        case 2: {
+            // Sibling subtrees in the wrong order
+            const size_t width = (size_t)1 << InsecureRandRange(K);
+            const size_t start = InsecureRandRange(indices.size() / (2 * width)) * 2 * width;
+            std::swap_ranges(indices.begin() + start, indices.begin() + start + width, indices.begin() + start + width);
+            break;
+        }
+        case 3:
+            // Index replaced by any other one
+            indices[a] = InsecureRandBits(cBitLen + 1);
+            break;
+        case 4:
+            // Whole subtree duplicated over its sibling
+            if (a % 2 == 0)
+                indices[a + 1] = indices[a];
+            else
+                std::copy(indices.begin(), indices.begin() + indices.size() / 2, indices.begin() + indices.size() / 2);
+            break;
+        }
+        minimal = GetMinimalFromIndices(indices, cBitLen);
+        if (nMutation % 7 == 5) {
+            // Flipped bit of the encoding
+            minimal[InsecureRandRange(minimal.size())] ^= 1 << InsecureRandBits(3);
+        } else if (nMutation % 7 == 6) {
+            // Truncated or extended encoding
+            if (InsecureRandBool())
+                minimal.pop_back();
+            else
+                minimal.push_back(InsecureRandBits(8));
+        }
+
+        const bool fValid = eh.IsValidSolution(state, minimal.data(), minimal.size());
+        const bool fReferenceValid = ReferenceIsValidSolution<N,K>(state, minimal);
+        BOOST_CHECK_EQUAL(fValid, fReferenceValid);
+        BOOST_CHECK_EQUAL(eh.IsValidSolution(state, minimal), fValid);
+        if (nMutation == 0)
+            BOOST_CHECK(fValid);
+        nValid += fValid;
+    }
+    return nValid;
+}
+
+/** Run the basic solver on the block header with the given nonce */
+std::set<std::vector<uint32_t>> SolveEquihash(unsigned int n, unsigned int k, uint32_t nNonce, crypto_generichash_blake2b_state& state) {
+    const std::string I = "block header";
+    size_t cBitLen { n/(k+1) };
+    EhInitialiseState(n, k, state, "ZcashPOW");
+    uint256 V = ArithToUint256(nNonce);
+    crypto_generichash_blake2b_update(&state, (unsigned char*)&I[0], I.size());
+    crypto_generichash_blake2b_update(&state, V.begin(), V.size());
+
+    std::set<std::vector<uint32_t>> solns;
+    std::function<bool(std::vector<unsigned char>)> validBlock =
+            [&solns, cBitLen](std::vector<unsigned char> soln) {
+        solns.insert(GetIndicesFromMinimal(soln, cBitLen));
+        return false;
+    };
+    EhBasicSolveUncancellable(n, k, state, validBlock);
+    return solns;
 }
 
 BOOST_AUTO_TEST_CASE(solver_testvectors) {
@@ -195,4 +343,31 @@ BOOST_AUTO_TEST_CASE(validator_testvectors) {
                 false);
 }
 
+BOOST_AUTO_TEST_CASE(validator_matches_reference) {
+    SeedInsecureRand(true);
+
+    // Mutations of the solutions the solver finds for (48,5)
+    int nChecked = 0, nValid = 0;
+    for (uint32_t nNonce = 0; nChecked < 5000; nNonce++) {
+        BOOST_REQUIRE(nNonce < 1000);
+        crypto_generichash_blake2b_state state;
+        for (const std::vector<uint32_t>& soln : SolveEquihash(48, 5, nNonce, state)) {
+            nValid += TestValidatorMutations(Eh48_5, state, soln, 99);
+            nChecked += 100;
+        }
+    }
+    BOOST_CHECK(nValid > 0 && nValid < nChecked);
+
+    // and for (96,5), whose collisions are two bytes long
+    nChecked = 0;
+    for (uint32_t nNonce = 0; nChecked < 1000; nNonce++) {
+        BOOST_REQUIRE(nNonce < 100);
+        crypto_generichash_blake2b_state state;
+        for (const std::vector<uint32_t>& soln : SolveEquihash(96, 5, nNonce, state)) {
+            TestValidatorMutations(Eh96_5, state, soln, 499);
+            nChecked += 500;
+        }
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,277 @@
+// Copyright (c) 2026 The Globaltoken Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <flat-database.h>
+#include <masternode-payments.h>
+#include <test/test_bitcoin.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(flatdb_tests, TestingSetup)
+
+namespace {
+struct TestCache
+{
+    std::map<int, std::string> mapEntries;
+    int nCleaned = 0;
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action) {
+        READWRITE(mapEntries);
+    }
+
+    void Clear() { mapEntries.clear(); }
+    void CheckAndRemove() { nCleaned++; }
+    std::string ToString() const { return strprintf("Entries: %d", mapEntries.size()); }
+};
+
+/** Cache that writes the entries set or erased since the last dump to the delta log */
+struct TestLogCache : public TestCache
+{
+    std::set<int> setChanged;
+    bool fAllChanged = true;
+
+    void Set(int nKey, const std::string& strValue) { mapEntries[nKey] = strValue; setChanged.insert(nKey); }
+    void Erase(int nKey) { mapEntries.erase(nKey); setChanged.insert(nKey); }
+    void Clear() { mapEntries.clear(); fAllChanged = true; }
+
+    bool CanSerializeDelta() const { return !fAllChanged; }
+
+    template <typename Stream>
+    void SerializeDelta(Stream& s) const
+    {
+        std::map<int, std::pair<bool, std::string> > mapChanged;
+        for (int nKey : setChanged) {
+            auto it = mapEntries.find(nKey);
+            mapChanged[nKey] = it == mapEntries.end() ? std::make_pair(false, std::string()) : std::make_pair(true, it->second);
+        }
+        s << mapChanged;
+    }
+
+    template <typename Stream>
+    void UnserializeDelta(Stream& s)
+    {
+        std::map<int, std::pair<bool, std::string> > mapChanged;
+        s >> mapChanged;
+        for (const auto& changed : mapChanged) {
+            if (changed.second.first)
+                mapEntries[changed.first] = changed.second.second;
+            else
+                mapEntries.erase(changed.first);
+        }
+    }
+
+    void ClearDelta() { setChanged.clear(); fAllChanged = false; }
+};
+} // namespace
+
+static void WriteFile(const std::string& strFilename, const CDataStream& ss)
+{
+    FILE* file = fopen((GetDataDir() / strFilename).string().c_str(), "wb");
+    BOOST_REQUIRE(file != nullptr);
+    fwrite(ss.data(), 1, ss.size(), file);
+    fclose(file);
+}
+
+BOOST_AUTO_TEST_CASE(flatdb_roundtrip)
+{
+    TestCache cache;
+    for (int i = 0; i < 1000; i++)
+        cache.mapEntries[i] = std::string(i % 50, 'x');
+
+    CFlatDB<TestCache> flatdb("test.dat", "magicTestCache");
+    BOOST_CHECK(flatdb.Dump(cache));
+    BOOST_CHECK(!fs::exists(GetDataDir() / "test.dat.new"));
+
+    TestCache loaded;
+    BOOST_CHECK(flatdb.Load(loaded));
+    BOOST_CHECK(loaded.mapEntries == cache.mapEntries);
+    BOOST_CHECK_EQUAL(loaded.nCleaned, 1);
+
+    // Another cache's file is not overwritten or loaded
+    CFlatDB<TestCache> flatdbOther("test.dat", "magicOtherCache");
+    BOOST_CHECK(!flatdbOther.Dump(cache));
+    BOOST_CHECK(!flatdbOther.Load(loaded));
+}
+
+BOOST_AUTO_TEST_CASE(flatdb_legacy_and_corrupt)
+{
+    TestCache cache;
+    cache.mapEntries[1] = "one";
+    cache.mapEntries[2] = "two";
+
+    // Files written before the format was versioned are still read
+    CDataStream ss(SER_DISK, CLIENT_VERSION);
+    ss << std::string("magicTestCache");
+    ss << FLATDATA(Params().MessageStart());
+    ss << cache;
+    uint256 hash = Hash(ss.begin(), ss.end());
+    ss << hash;
+    WriteFile("legacy.dat", ss);
+
+    CFlatDB<TestCache> flatdb("legacy.dat", "magicTestCache");
+    TestCache loaded;
+    BOOST_CHECK(flatdb.Load(loaded));
+    BOOST_CHECK(loaded.mapEntries == cache.mapEntries);
+
+    // A flipped bit is caught by the checksum
+    CDataStream ssCorrupt(ss);
+    ssCorrupt[ssCorrupt.size() - sizeof(uint256) - 1] ^= 1;
+    WriteFile("legacy.dat", ssCorrupt);
+    BOOST_CHECK(!flatdb.Load(loaded));
+    BOOST_CHECK(loaded.mapEntries.empty());
+
+    // Data of an unknown format with a valid checksum is recreated
+    CDataStream ssFormat(SER_DISK, CLIENT_VERSION);
+    ssFormat << std::string("magicTestCache");
+    ssFormat << FLATDATA(Params().MessageStart());
+    ssFormat << std::vector<unsigned char>(10, 0xff);
+    hash = Hash(ssFormat.begin(), ssFormat.end());
+    ssFormat << hash;
+    WriteFile("legacy.dat", ssFormat);
+    BOOST_CHECK(flatdb.Load(loaded));
+    BOOST_CHECK(loaded.mapEntries.empty());
+}
+
+BOOST_AUTO_TEST_CASE(flatdb_log)
+{
+    const fs::path pathDB = GetDataDir() / "log.dat";
+    const fs::path pathLog = GetDataDir() / "log.dat.log";
+    TestLogCache cache;
+    for (int i = 0; i < 1000; i++)
+        cache.Set(i, std::string(50, 'x'));
+
+    // The first dump writes the whole cache and an empty log
+    CFlatDBLog<TestLogCache> flatdb("log.dat", "magicTestCache");
+    BOOST_CHECK(flatdb.Dump(cache));
+    const uint64_t nDBSize = fs::file_size(pathDB);
+    const uint64_t nLogHeaderSize = fs::file_size(pathLog);
+    BOOST_CHECK(cache.CanSerializeDelta());
+
+    // Later dumps only append the changes
+    cache.Set(1000, "new");
+    cache.Erase(0);
+    BOOST_CHECK(flatdb.Dump(cache));
+    BOOST_CHECK_EQUAL(fs::file_size(pathDB), nDBSize);
+    const uint64_t nLogSize = fs::file_size(pathLog);
+    BOOST_CHECK(nLogSize > nLogHeaderSize && nLogSize < nLogHeaderSize + 100);
+    cache.Set(1, "changed");
+    BOOST_CHECK(flatdb.Dump(cache));
+
+    TestLogCache loaded;
+    BOOST_CHECK(flatdb.Load(loaded));
+    BOOST_CHECK(loaded.mapEntries == cache.mapEntries);
+    BOOST_CHECK(loaded.CanSerializeDelta());
+    BOOST_CHECK_EQUAL(loaded.nCleaned, 1);
+
+    // A record cut short is truncated, the records before it are kept
+    const uint64_t nLogComplete = fs::file_size(pathLog);
+    loaded.Set(2, "lost");
+    BOOST_CHECK(flatdb.Dump(loaded));
+    fs::resize_file(pathLog, fs::file_size(pathLog) - 1);
+    TestLogCache torn;
+    BOOST_CHECK(flatdb.Load(torn));
+    BOOST_CHECK(torn.mapEntries == cache.mapEntries);
+    BOOST_CHECK_EQUAL(fs::file_size(pathLog), nLogComplete);
+
+    // A log that does not extend the flat file is ignored and replaced
+    CFlatDB<TestLogCache> flatdbPlain("log.dat", "magicTestCache");
+    TestLogCache other;
+    other.Set(7, "other");
+    BOOST_CHECK(flatdbPlain.Dump(other));
+    TestLogCache stale;
+    BOOST_CHECK(flatdb.Load(stale));
+    BOOST_CHECK(stale.mapEntries == other.mapEntries);
+    stale.Set(8, "eight");
+    BOOST_CHECK(flatdb.Dump(stale));
+    BOOST_CHECK_EQUAL(fs::file_size(pathLog), nLogHeaderSize);
+    BOOST_CHECK(flatdb.Load(loaded));
+    BOOST_CHECK(loaded.mapEntries == stale.mapEntries);
+
+    // Once the log outgrows the flat file, it is compacted into it
+    for (int i = 0; i < 10; i++) {
+        loaded.Set(100 + i, std::string(200, 'y'));
+        BOOST_CHECK(flatdb.Dump(loaded));
+    }
+    BOOST_CHECK(fs::file_size(pathLog) < fs::file_size(pathDB) + 300);
+    TestLogCache compacted;
+    BOOST_CHECK(flatdb.Load(compacted));
+    BOOST_CHECK(compacted.mapEntries == loaded.mapEntries);
+}
+
+BOOST_AUTO_TEST_CASE(flatdb_map_changes)
+{
+    std::map<int, std::string> mapEntries;
+    for (int i = 0; i < 1000; i++)
+        mapEntries[i] = std::string(50, 'x');
+
+    CFlatDBMapChanges<int, std::string> changes;
+    BOOST_CHECK(!changes.HasChangedEntries());
+    changes.ClearChanged(mapEntries);
+    BOOST_CHECK(changes.HasChangedEntries());
+    const std::map<int, std::string> mapPersisted = mapEntries;
+
+    // Only the entries set or erased since are written
+    mapEntries[1] = "changed";
+    mapEntries[1000] = "new";
+    mapEntries.erase(0);
+    CDataStream ss(SER_DISK, CLIENT_VERSION);
+    changes.SerializeChanged(ss, mapEntries);
+    BOOST_CHECK(ss.size() < 100);
+
+    std::map<int, std::string> mapLoaded = mapPersisted;
+    CFlatDBMapChanges<int, std::string>::UnserializeChanged(ss, mapLoaded);
+    BOOST_CHECK(mapLoaded == mapEntries);
+
+    changes.ClearChanged(mapEntries);
+    CDataStream ssNone(SER_DISK, CLIENT_VERSION);
+    changes.SerializeChanged(ssNone, mapEntries);
+    CFlatDBMapChanges<int, std::string>::UnserializeChanged(ssNone, mapLoaded);
+    BOOST_CHECK(mapLoaded == mapEntries);
+    BOOST_CHECK(ssNone.empty());
+
+    changes.SetAllChanged();
+    BOOST_CHECK(!changes.HasChangedEntries());
+}
+
+BOOST_AUTO_TEST_CASE(flatdb_mnpayments_delta)
+{
+    CMasternodePayments payments;
+    for (int i = 0; i < 100; i++) {
+        CMasternodePaymentVote vote(COutPoint(InsecureRand256(), 0), 1000 + i, CScript() << OP_TRUE);
+        payments.mapMasternodePaymentVotes[vote.GetHash()] = vote;
+        payments.mapMasternodeBlocks[vote.nBlockHeight] = CMasternodeBlockPayees(vote.nBlockHeight);
+        payments.mapMasternodeBlocks[vote.nBlockHeight].AddPayee(vote);
+    }
+    BOOST_CHECK(!payments.CanSerializeDelta());
+    payments.ClearDelta();
+    BOOST_CHECK(payments.CanSerializeDelta());
+
+    CDataStream ssSnapshot(SER_DISK, CLIENT_VERSION);
+    ssSnapshot << payments;
+    CMasternodePayments loaded;
+    ssSnapshot >> loaded;
+
+    // A new vote for a known block and a block that was dropped
+    CMasternodePaymentVote vote(COutPoint(InsecureRand256(), 0), 1000, CScript() << OP_FALSE);
+    payments.mapMasternodePaymentVotes[vote.GetHash()] = vote;
+    payments.mapMasternodeBlocks[1000].AddPayee(vote);
+    payments.mapMasternodeBlocks.erase(1001);
+    CDataStream ssDelta(SER_DISK, CLIENT_VERSION);
+    payments.SerializeDelta(ssDelta);
+    BOOST_CHECK(ssDelta.size() < ssSnapshot.size() / 10);
+
+    loaded.UnserializeDelta(ssDelta);
+    CDataStream ssPayments(SER_DISK, CLIENT_VERSION), ssLoaded(SER_DISK, CLIENT_VERSION);
+    ssPayments << payments;
+    ssLoaded << loaded;
+    BOOST_CHECK(ssPayments.str() == ssLoaded.str());
+
+    payments.Clear();
+    BOOST_CHECK(!payments.CanSerializeDelta());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -2,7 +2,12 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include <crypto/algos/hashlib/multihash.h>
+#include <crypto/algos/hashlib/multihash_lanes.h>
+#include <globaltoken/multihasher.h>
 #include <hash.h>
+#include <primitives/pureheader.h>
+#include <streams.h>
 #include <utilstrencodings.h>
 #include <test/test_bitcoin.h>
 
@@ -147,4 +152,97 @@ BOOST_AUTO_TEST_CASE(siphash)
     }
 }
 
+BOOST_AUTO_TEST_CASE(multihasher_tests)
+{
+    for (uint8_t algo : {ALGO_SHA256D, ALGO_X11, ALGO_EQUIHASH}) {
+        CPureBlockHeader header;
+        header.nVersion = 4;
+        header.SetAlgo(algo);
+        header.hashPrevBlock = InsecureRand256();
+        header.hashMerkleRoot = InsecureRand256();
+        header.hashReserved = InsecureRand256();
+        header.nTime = InsecureRand32();
+        header.nBits = InsecureRand32();
+        header.nNonce = InsecureRand32();
+        header.nBigNonce = InsecureRand256();
+        header.nSolution.resize(1344);
+        for (unsigned char& c : header.nSolution)
+            c = InsecureRandBits(8);
+
+        CDataStream ss(SER_GETHASH, PROTOCOL_VERSION);
+        ss << header;
+        BOOST_CHECK_EQUAL(ss.size(), IsEquihashBasedAlgo(algo) ? 1487 : 80);
+
+        // The SHA256d based algos stream the input, the others hash the collected buffer.
+        uint256 expected = algo == ALGO_X11 ? HashX11(ss.begin(), ss.end()) : Hash(ss.begin(), ss.end());
+        BOOST_CHECK(SerializeMultiAlgoHash(header, algo) == expected);
+        BOOST_CHECK(header.GetPoWHash(SER_GETHASH, PROTOCOL_VERSION) == expected);
+    }
+
+    // Input beyond the inline buffer is hashed as a whole for the other algos too.
+    std::vector<unsigned char> vch(300);
+    for (unsigned char& c : vch)
+        c = InsecureRandBits(8);
+    uint32_t n = InsecureRand32();
+    CMultihasher hasher(SER_GETHASH, PROTOCOL_VERSION, ALGO_X11);
+    hasher << vch << n;
+    CDataStream ss(SER_GETHASH, PROTOCOL_VERSION);
+    ss << vch << n;
+    BOOST_CHECK(hasher.GetHash() == HashX11(ss.begin(), ss.end()));
+}
+
+BOOST_AUTO_TEST_CASE(multihash_lanes_tests)
+{
+    // Every lane count covers full kernel groups, padded groups and the scalar tail.
+    for (int fn = 0; fn < HASH512_NUM; fn++) {
+        for (size_t len : {0, 64, 80, 200}) {
+            for (size_t nLanes : {1, 3, 4, 6, 8, 11}) {
+                std::vector<std::vector<unsigned char> > in(nLanes, std::vector<unsigned char>(len));
+                std::vector<std::vector<unsigned char> > out(nLanes, std::vector<unsigned char>(64));
+                std::vector<const unsigned char*> pin;
+                std::vector<unsigned char*> pout;
+                for (size_t l = 0; l < nLanes; l++) {
+                    for (unsigned char& c : in[l])
+                        c = InsecureRandBits(8);
+                    pin.push_back(in[l].data());
+                    pout.push_back(out[l].data());
+                }
+                Hash512Lanes((Hash512Function)fn, pin.data(), len, pout.data(), nLanes);
+                for (size_t l = 0; l < nLanes; l++) {
+                    unsigned char expected[64];
+                    unsigned char* pexpected = expected;
+                    Hash512Lanes((Hash512Function)fn, &pin[l], len, &pexpected, 1);
+                    BOOST_CHECK(out[l] == std::vector<unsigned char>(expected, expected + 64));
+                }
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(multihasher_batch_tests)
+{
+    for (uint8_t algo : {ALGO_SHA256D, ALGO_X11, ALGO_X13, ALGO_X14, ALGO_X15, ALGO_X17, ALGO_NIST5, ALGO_QUARK, ALGO_QUBIT, ALGO_X16R, ALGO_EQUIHASH}) {
+        std::vector<CPureBlockHeader> headers(21);
+        std::vector<const CPureBlockHeader*> pheaders;
+        for (CPureBlockHeader& header : headers) {
+            header.nVersion = 4;
+            header.SetAlgo(algo);
+            header.hashPrevBlock = InsecureRand256();
+            header.hashMerkleRoot = InsecureRand256();
+            header.nTime = InsecureRand32();
+            header.nBits = InsecureRand32();
+            header.nNonce = InsecureRand32();
+            pheaders.push_back(&header);
+        }
+        // An equihash header in the middle takes the single header path.
+        headers[5].SetAlgo(ALGO_EQUIHASH);
+        headers[5].nSolution.resize(1344);
+
+        std::vector<uint256> hashes(headers.size());
+        MultiAlgoHashBatch(algo, pheaders.data(), headers.size(), hashes.data());
+        for (size_t i = 0; i < headers.size(); i++)
+            BOOST_CHECK(hashes[i] == headers[i].GetPoWHash(algo, SER_GETHASH, PROTOCOL_VERSION));
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,65 @@
+// Copyright (c) 2026 The Globaltoken Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <arith_uint256.h>
+#include <instantx.h>
+#include <test/test_bitcoin.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(instantx_tests, BasicTestingSetup)
+
+static COutPoint MakeOutPoint(int n)
+{
+    return COutPoint(ArithToUint256(arith_uint256(n + 1)), n);
+}
+
+BOOST_AUTO_TEST_CASE(lock_candidate_vote_counters)
+{
+    CMutableTransaction tx;
+    tx.vin.resize(2);
+    tx.vin[0].prevout = MakeOutPoint(0);
+    tx.vin[1].prevout = MakeOutPoint(1);
+    CTxLockCandidate txLockCandidate{CTxLockRequest(CTransaction(tx))};
+    const uint256 txHash = txLockCandidate.GetHash();
+    const int nRequired = COutPointLock::SIGNATURES_REQUIRED;
+
+    BOOST_CHECK(!txLockCandidate.IsAllOutPointsReady());
+    for (const auto& txin : tx.vin) {
+        txLockCandidate.AddOutPointLock(txin.prevout);
+    }
+
+    // Votes for unknown outpoints and repeated votes are not counted
+    BOOST_CHECK(!txLockCandidate.AddVote(CTxLockVote(txHash, MakeOutPoint(2), MakeOutPoint(100))));
+    BOOST_CHECK(txLockCandidate.AddVote(CTxLockVote(txHash, tx.vin[0].prevout, MakeOutPoint(100))));
+    BOOST_CHECK(!txLockCandidate.AddVote(CTxLockVote(txHash, tx.vin[0].prevout, MakeOutPoint(100))));
+    BOOST_CHECK_EQUAL(txLockCandidate.CountVotes(), 1);
+
+    for (int i = 1; i < nRequired; i++) {
+        BOOST_CHECK(txLockCandidate.AddVote(CTxLockVote(txHash, tx.vin[0].prevout, MakeOutPoint(100 + i))));
+    }
+    BOOST_CHECK(!txLockCandidate.IsAllOutPointsReady());
+    for (int i = 0; i < nRequired; i++) {
+        BOOST_CHECK(txLockCandidate.AddVote(CTxLockVote(txHash, tx.vin[1].prevout, MakeOutPoint(200 + i))));
+    }
+    BOOST_CHECK(txLockCandidate.IsAllOutPointsReady());
+    BOOST_CHECK_EQUAL(txLockCandidate.CountVotes(), 2 * nRequired);
+
+    // Votes on an attacked outpoint no longer count, now or later
+    txLockCandidate.MarkOutpointAsAttacked(tx.vin[1].prevout);
+    txLockCandidate.MarkOutpointAsAttacked(tx.vin[1].prevout);
+    BOOST_CHECK(!txLockCandidate.IsAllOutPointsReady());
+    BOOST_CHECK_EQUAL(txLockCandidate.CountVotes(), nRequired);
+    BOOST_CHECK(txLockCandidate.AddVote(CTxLockVote(txHash, tx.vin[1].prevout, MakeOutPoint(300))));
+    BOOST_CHECK_EQUAL(txLockCandidate.CountVotes(), nRequired);
+
+    // The counters match a recount over the outpoint locks
+    int nVotes = 0;
+    for (const auto& outpointLock : txLockCandidate.mapOutPointLocks) {
+        nVotes += outpointLock.second.CountVotes();
+    }
+    BOOST_CHECK_EQUAL(txLockCandidate.CountVotes(), nVotes);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
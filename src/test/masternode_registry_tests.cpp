@@ -0,0 +1,158 @@
+// Copyright (c) 2026 The Globaltoken Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <masternode-registry.h>
+#include <netbase.h>
+#include <streams.h>
+#include <test/test_bitcoin.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(masternode_registry_tests, BasicTestingSetup)
+
+static CMasternode MakeMasternode(uint32_t n, const std::string& strAddr, int nProtocolVersion, int nBlockLastPaid)
+{
+    CMasternode mn(LookupNumeric(strAddr.c_str(), 9999), COutPoint(uint256S("0x1234"), n), CPubKey(), CPubKey(), nProtocolVersion);
+    mn.nBlockLastPaid = nBlockLastPaid;
+    return mn;
+}
+
+static std::vector<uint32_t> LastPaidOrder(CMasternodeRegistry& registry)
+{
+    std::vector<uint32_t> vecOrder;
+    for (const auto& entry : registry.ByLastPaid()) {
+        vecOrder.push_back(entry.outpoint.n);
+    }
+    return vecOrder;
+}
+
+BOOST_AUTO_TEST_CASE(registry_indexes)
+{
+    CMasternodeRegistry registry;
+    BOOST_CHECK(registry.Add(MakeMasternode(0, "1.2.3.4", 70210, 30)));
+    BOOST_CHECK(registry.Add(MakeMasternode(1, "1.2.3.5", 70209, 10)));
+    BOOST_CHECK(registry.Add(MakeMasternode(2, "1.2.3.4", 70210, 20)));
+    BOOST_CHECK(!registry.Add(MakeMasternode(2, "1.2.3.6", 70210, 0)));
+    BOOST_CHECK_EQUAL(registry.size(), 3U);
+
+    BOOST_CHECK(LastPaidOrder(registry) == std::vector<uint32_t>({1, 2, 0}));
+    BOOST_CHECK_EQUAL(registry.Count(70209), 3);
+    BOOST_CHECK_EQUAL(registry.Count(70210), 2);
+    BOOST_CHECK_EQUAL(registry.CountEnabled(70210), 2);
+    BOOST_CHECK_EQUAL(registry.GetOutpointsByAddr(LookupNumeric("1.2.3.4", 9999)).size(), 2U);
+
+    // Changes made through Find are picked up by the next query.
+    CMasternode* pmn = registry.Find(COutPoint(uint256S("0x1234"), 1));
+    BOOST_REQUIRE(pmn != nullptr);
+    pmn->nBlockLastPaid = 40;
+    pmn->nActiveState = CMasternode::MASTERNODE_EXPIRED;
+    pmn->addr = LookupNumeric("1.2.3.4", 9999);
+    BOOST_CHECK(LastPaidOrder(registry) == std::vector<uint32_t>({2, 0, 1}));
+    BOOST_CHECK_EQUAL(registry.CountEnabled(70209), 2);
+    BOOST_CHECK_EQUAL(registry.GetOutpointsByState(CMasternode::MASTERNODE_EXPIRED).size(), 1U);
+    BOOST_CHECK_EQUAL(registry.GetOutpointsByAddr(LookupNumeric("1.2.3.4", 9999)).size(), 3U);
+
+    // So are changes made while visiting all entries.
+    registry.ForEach([](CMasternode& mn) { mn.nProtocolVersion = 70211; });
+    BOOST_CHECK_EQUAL(registry.Count(70211), 3);
+
+    BOOST_CHECK(registry.Erase(COutPoint(uint256S("0x1234"), 0)));
+    BOOST_CHECK(!registry.Erase(COutPoint(uint256S("0x1234"), 0)));
+    BOOST_CHECK(LastPaidOrder(registry) == std::vector<uint32_t>({2, 1}));
+    BOOST_CHECK_EQUAL(registry.ByAddr().size(), 2U);
+    BOOST_CHECK_EQUAL(registry.Count(0), 2);
+}
+
+BOOST_AUTO_TEST_CASE(registry_generation)
+{
+    CMasternodeRegistry registry;
+    uint64_t nGeneration = registry.GetGeneration();
+    registry.Add(MakeMasternode(0, "1.2.3.4", 70210, 30));
+    BOOST_CHECK(registry.GetGeneration() != nGeneration);
+    nGeneration = registry.GetGeneration();
+
+    // Payments and state changes keep the scored set as it is.
+    CMasternode* pmn = registry.Find(COutPoint(uint256S("0x1234"), 0));
+    BOOST_REQUIRE(pmn != nullptr);
+    pmn->nBlockLastPaid = 40;
+    pmn->nActiveState = CMasternode::MASTERNODE_EXPIRED;
+    BOOST_CHECK_EQUAL(registry.GetGeneration(), nGeneration);
+
+    // Protocol updates move entries between the sets scored for a minimum protocol.
+    registry.ForEach([](CMasternode& mn) { mn.nProtocolVersion = 70211; });
+    BOOST_CHECK(registry.GetGeneration() != nGeneration);
+    nGeneration = registry.GetGeneration();
+
+    registry.Erase(COutPoint(uint256S("0x1234"), 0));
+    BOOST_CHECK(registry.GetGeneration() != nGeneration);
+}
+
+BOOST_AUTO_TEST_CASE(registry_serialization)
+{
+    CMasternodeRegistry registry;
+    registry.Add(MakeMasternode(0, "1.2.3.4", 70210, 30));
+    registry.Add(MakeMasternode(1, "1.2.3.5", 70209, 10));
+
+    // The registry is stored in the format of a std::map<COutPoint, CMasternode>
+    CDataStream ss(SER_DISK, CLIENT_VERSION);
+    ss << registry;
+    std::map<COutPoint, CMasternode> mapMasternodes;
+    CDataStream ssMap(ss);
+    ssMap >> mapMasternodes;
+    BOOST_CHECK_EQUAL(mapMasternodes.size(), 2U);
+    BOOST_CHECK_EQUAL(mapMasternodes[COutPoint(uint256S("0x1234"), 1)].nBlockLastPaid, 10);
+
+    CMasternodeRegistry loaded;
+    ss >> loaded;
+    BOOST_CHECK_EQUAL(loaded.size(), 2U);
+    BOOST_CHECK(LastPaidOrder(loaded) == std::vector<uint32_t>({1, 0}));
+    BOOST_CHECK_EQUAL(loaded.Count(70210), 1);
+}
+
+BOOST_AUTO_TEST_CASE(registry_changes)
+{
+    CMasternodeRegistry registry;
+    registry.Add(MakeMasternode(0, "1.2.3.4", 70210, 30));
+    registry.Add(MakeMasternode(1, "1.2.3.5", 70209, 10));
+    registry.Add(MakeMasternode(2, "1.2.3.6", 70209, 20));
+    BOOST_CHECK(!registry.HasChangedEntries());
+    registry.ClearChanged();
+    BOOST_CHECK(registry.HasChangedEntries());
+
+    CMasternodeRegistry copy;
+    CDataStream ss(SER_DISK, CLIENT_VERSION);
+    ss << registry;
+    ss >> copy;
+
+    // Entries handed out as mutable but left as they are, are not written
+    registry.ForEach([](CMasternode& mn) {});
+    registry.Find(COutPoint(uint256S("0x1234"), 1))->nBlockLastPaid = 50;
+    registry.Erase(COutPoint(uint256S("0x1234"), 2));
+    registry.Add(MakeMasternode(3, "1.2.3.7", 70210, 0));
+
+    CDataStream ssChanged(SER_DISK, CLIENT_VERSION);
+    registry.SerializeChanged(ssChanged);
+    CDataStream ssCheck(ssChanged);
+    std::vector<COutPoint> vecErased;
+    ssCheck >> vecErased;
+    BOOST_CHECK_EQUAL(vecErased.size(), 1U);
+    BOOST_CHECK_EQUAL(ReadCompactSize(ssCheck), 2U);
+
+    copy.UnserializeChanged(ssChanged);
+    BOOST_CHECK_EQUAL(copy.size(), 3U);
+    BOOST_CHECK(LastPaidOrder(copy) == std::vector<uint32_t>({3, 0, 1}));
+    BOOST_CHECK(copy.Get(COutPoint(uint256S("0x1234"), 2)) == nullptr);
+
+    // Nothing is left to write once the changes are persisted
+    registry.ClearChanged();
+    CDataStream ssEmpty(SER_DISK, CLIENT_VERSION);
+    registry.SerializeChanged(ssEmpty);
+    BOOST_CHECK_EQUAL(ssEmpty.size(), 2U);
+
+    // After clearing the registry, what was persisted is unknown
+    registry.Clear();
+    BOOST_CHECK(!registry.HasChangedEntries());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
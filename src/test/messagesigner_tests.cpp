@@ -0,0 +1,96 @@
+// Copyright (c) 2026 The Globaltoken Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <hash.h>
+#include <key.h>
+#include <messagesigner.h>
+#include <test/test_bitcoin.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(messagesigner_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(hash_sig_cache)
+{
+    CKey key1, key2;
+    key1.MakeNewKey(true);
+    key2.MakeNewKey(true);
+
+    std::vector<uint256> hashes;
+    std::vector<std::vector<unsigned char> > sigs;
+    for (int i = 0; i < 8; i++) {
+        hashes.push_back(Hash(BEGIN(i), END(i)));
+        sigs.emplace_back();
+        BOOST_REQUIRE(CHashSigner::SignHash(hashes.back(), i % 2 ? key2 : key1, sigs.back()));
+    }
+
+    // Half of the signatures claim the wrong key, those keep failing once the others are cached.
+    std::string strError;
+    for (int nRound = 0; nRound < 2; nRound++) {
+        for (int i = 0; i < 8; i++) {
+            BOOST_CHECK_EQUAL(CHashSigner::VerifyHash(hashes[i], key1.GetPubKey(), sigs[i], strError), i % 2 == 0);
+            BOOST_CHECK(CHashSigner::VerifyHash(hashes[i], i % 2 ? key2.GetPubKey() : key1.GetPubKey(), sigs[i], strError));
+        }
+    }
+
+    // A cached signature does not validate another hash.
+    BOOST_CHECK(!CHashSigner::VerifyHash(hashes[1], key1.GetPubKey(), sigs[0], strError));
+
+    // Messages are verified through the same cache.
+    std::vector<unsigned char> vchSig;
+    BOOST_REQUIRE(CMessageSigner::SignMessage("message", vchSig, key1));
+    BOOST_CHECK(CHashSigner::VerifyHash(CMessageSigner::GetMessageHash("message"), key1.GetPubKey(), vchSig, strError));
+    BOOST_CHECK(CMessageSigner::VerifyMessage(key1.GetPubKey(), vchSig, "message", strError));
+    BOOST_CHECK(!CMessageSigner::VerifyMessage(key1.GetPubKey(), vchSig, "other message", strError));
+}
+
+BOOST_AUTO_TEST_CASE(hash_sig_batch)
+{
+    CKey key1, key2;
+    key1.MakeNewKey(true);
+    key2.MakeNewKey(true);
+
+    std::vector<uint256> hashes;
+    std::vector<std::vector<unsigned char> > sigs;
+    std::vector<CHashSigCheck> vChecks;
+    for (int i = 0; i < 8; i++) {
+        int n = 100 + i;
+        hashes.push_back(Hash(BEGIN(n), END(n)));
+        sigs.emplace_back();
+        BOOST_REQUIRE(CHashSigner::SignHash(hashes.back(), i % 2 ? key2 : key1, sigs.back()));
+        // Half of the signatures claim the wrong key.
+        vChecks.emplace_back(hashes.back(), key1.GetPubKey().GetID(), sigs.back());
+    }
+    // A signature queued twice is verified once.
+    vChecks.emplace_back(hashes[0], key1.GetPubKey().GetID(), sigs[0]);
+
+    hashsig_results_t mapResults;
+    CHashSigner::VerifyHashes(vChecks, mapResults);
+    BOOST_CHECK_EQUAL(mapResults.size(), 8U);
+    int nValid = 0;
+    for (const auto& result : mapResults) {
+        if (result.second.fValid) {
+            nValid++;
+        } else {
+            BOOST_CHECK(!result.second.strError.empty());
+        }
+    }
+    BOOST_CHECK_EQUAL(nValid, 4);
+
+    // Messages finished after the batch take its results.
+    std::string strError;
+    {
+        CHashSigResultsScope scope(mapResults);
+        for (int i = 0; i < 8; i++) {
+            BOOST_CHECK_EQUAL(CHashSigner::VerifyHash(hashes[i], key1.GetPubKey(), sigs[i], strError), i % 2 == 0);
+        }
+    }
+
+    // Signatures outside of the batch are still verified.
+    for (int i = 1; i < 8; i += 2) {
+        BOOST_CHECK(CHashSigner::VerifyHash(hashes[i], key2.GetPubKey(), sigs[i], strError));
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -11,7 +11,9 @@
 #include <validation.h>
 #include <miner.h>
 #include <policy/policy.h>
+#include <primitives/mining_block.h>
 #include <pubkey.h>
+#include <script/interpreter.h>
 #include <script/standard.h>
 #include <txmempool.h>
 #include <uint256.h>
@@ -520,4 +522,205 @@ BOOST_AUTO_TEST_CASE(CreateNewBlock_validity)
     fCheckpointsEnabled = true;
 }
 
+BOOST_AUTO_TEST_CASE(BlockTemplateCache_algos)
+{
+    const auto chainParams = CreateChainParams(CBaseChainParams::MAIN);
+    const CChainParams& chainparams = *chainParams;
+    const CScript scriptPubKey = CScript() << OP_TRUE;
+    LOCK(cs_main);
+    SetMockTime(GetTime());
+    CBlockTemplateCache cache(chainparams, 5);
+
+    std::shared_ptr<CBlockTemplate> pshared = cache.Get(scriptPubKey, ALGO_SHA256D, true);
+    BOOST_REQUIRE(pshared);
+    BOOST_CHECK(cache.Get(scriptPubKey, ALGO_SHA256D, true) == pshared);
+
+    // Every algo gets its own header on the same transactions
+    const uint8_t algos[] = {ALGO_SCRYPT, ALGO_X11, ALGO_EQUIHASH};
+    for (uint8_t nAlgo : algos) {
+        std::shared_ptr<CBlockTemplate> pblocktemplate = cache.Get(scriptPubKey, nAlgo, true);
+        BOOST_REQUIRE(pblocktemplate);
+        BOOST_CHECK(cache.Get(scriptPubKey, nAlgo, true) == pblocktemplate);
+        const CBlock& block = pblocktemplate->block;
+        BOOST_CHECK_EQUAL(block.GetAlgo(), nAlgo);
+        BOOST_CHECK(block.vtx == pshared->block.vtx);
+        BOOST_CHECK(block.hashPrevBlock == chainActive.Tip()->GetBlockHash());
+        BOOST_CHECK_EQUAL(block.nBits, GetNextWorkRequired(chainActive.Tip(), &block, chainparams.GetConsensus(), nAlgo));
+        CValidationState state;
+        BOOST_CHECK(TestBlockValidity(state, chainparams, block, chainActive.Tip(), false, false));
+    }
+
+    // Changes to the mempool are picked up after the refresh interval
+    mempool.AddTransactionsUpdated(1);
+    BOOST_CHECK(cache.Get(scriptPubKey, ALGO_SCRYPT, true) != nullptr);
+    BOOST_CHECK(cache.Get(scriptPubKey, ALGO_SHA256D, true) == pshared);
+    SetMockTime(GetTime() + 6);
+    std::shared_ptr<CBlockTemplate> pnew = cache.Get(scriptPubKey, ALGO_SCRYPT, true);
+    BOOST_REQUIRE(pnew);
+    BOOST_CHECK(cache.Get(scriptPubKey, ALGO_SHA256D, true) != pshared);
+    BOOST_CHECK_EQUAL(cache.GetTransactionsUpdated(), mempool.GetTransactionsUpdated());
+
+    // So is another coinbase script
+    const CScript scriptOther = CScript() << OP_2;
+    std::shared_ptr<CBlockTemplate> pother = cache.Get(scriptOther, ALGO_SCRYPT, true);
+    BOOST_REQUIRE(pother);
+    BOOST_CHECK(pother != pnew);
+    BOOST_CHECK(pother->block.vtx[0]->vout[0].scriptPubKey == scriptOther);
+
+    SetMockTime(0);
+}
+
+static std::set<uint256> BlockTxids(const CBlock& block)
+{
+    std::set<uint256> txids;
+    for (size_t i = 1; i < block.vtx.size(); i++)
+        txids.insert(block.vtx[i]->GetHash());
+    return txids;
+}
+
+BOOST_FIXTURE_TEST_CASE(NextBlockCandidates_incremental, TestChain100Setup)
+{
+    const CChainParams& chainparams = Params();
+    const CScript scriptPubKey = CScript() << ToByteVector(coinbaseKey.GetPubKey()) << OP_CHECKSIG;
+
+    // Split a mature coinbase into outputs anyone can spend, without a fee the
+    // coinbase of CreateAndProcessBlock would have to pay to the treasury
+    CMutableTransaction split;
+    split.vin.resize(1);
+    split.vin[0].prevout = COutPoint(coinbaseTxns[0].GetHash(), 0);
+    for (int i = 0; i < 20; i++)
+        split.vout.emplace_back(coinbaseTxns[0].vout[0].nValue / 20, CScript() << OP_TRUE);
+    split.vout[0].nValue += coinbaseTxns[0].vout[0].nValue % 20;
+    std::vector<unsigned char> vchSig;
+    uint256 hash = SignatureHash(scriptPubKey, split, 0, SIGHASH_ALL, 0, SIGVERSION_BASE);
+    BOOST_CHECK(coinbaseKey.Sign(hash, vchSig));
+    vchSig.push_back((unsigned char)SIGHASH_ALL);
+    split.vin[0].scriptSig << vchSig;
+    CreateAndProcessBlock({split}, scriptPubKey);
+    BOOST_REQUIRE_EQUAL(chainActive.Height(), COINBASE_MATURITY + 1);
+
+    TestMemPoolEntryHelper entry;
+    auto Spend = [&](const COutPoint& prevout, CAmount nValue, CAmount nFee) {
+        CMutableTransaction tx;
+        tx.vin.resize(1);
+        tx.vin[0].prevout = prevout;
+        tx.vout.emplace_back(nValue - nFee, CScript() << OP_TRUE);
+        mempool.addUnchecked(tx.GetHash(), entry.Fee(nFee).Time(GetTime()).FromTx(tx));
+        return CTransaction(tx);
+    };
+
+    LOCK(cs_main);
+    CNextBlockCandidates candidates(mempool);
+    std::vector<CTransaction> txs;
+    for (int i = 0; i < 10; i++)
+        txs.push_back(Spend(COutPoint(split.GetHash(), i), split.vout[i].nValue, 1000 + 100 * i));
+    std::unique_ptr<CBlockTemplate> pblocktemplate = AssemblerForTest(chainparams).CreateNewBlock(scriptPubKey, ALGO_SHA256D, true, &candidates);
+    BOOST_REQUIRE(pblocktemplate);
+    BOOST_CHECK_EQUAL(pblocktemplate->block.vtx.size(), 11U);
+    const std::vector<CTransactionRef> vtxFirst = pblocktemplate->block.vtx;
+
+    // New transactions go after the ones selected before, a child pulls in its parent
+    const CTransaction txParent = Spend(COutPoint(split.GetHash(), 10), split.vout[10].nValue, 0);
+    const CTransaction txChild = Spend(COutPoint(txParent.GetHash(), 0), txParent.vout[0].nValue, 50000);
+    pblocktemplate = AssemblerForTest(chainparams).CreateNewBlock(scriptPubKey, ALGO_SHA256D, true, &candidates);
+    BOOST_REQUIRE(pblocktemplate);
+    const CBlock& block = pblocktemplate->block;
+    BOOST_REQUIRE_EQUAL(block.vtx.size(), 13U);
+    for (size_t i = 1; i < vtxFirst.size(); i++)
+        BOOST_CHECK(block.vtx[i] == vtxFirst[i]);
+    BOOST_CHECK(block.vtx[11]->GetHash() == txParent.GetHash());
+    BOOST_CHECK(block.vtx[12]->GetHash() == txChild.GetHash());
+    BOOST_CHECK_EQUAL(pblocktemplate->vTxFees[0], -(14500 + 50000));
+    BOOST_CHECK(BlockTxids(block) == BlockTxids(AssemblerForTest(chainparams).CreateNewBlock(scriptPubKey, ALGO_SHA256D)->block));
+
+    // A selected transaction that leaves the mempool starts the selection over
+    mempool.removeRecursive(txs[3]);
+    pblocktemplate = AssemblerForTest(chainparams).CreateNewBlock(scriptPubKey, ALGO_SHA256D, true, &candidates);
+    BOOST_REQUIRE(pblocktemplate);
+    BOOST_CHECK_EQUAL(pblocktemplate->block.vtx.size(), 12U);
+    BOOST_CHECK(!BlockTxids(pblocktemplate->block).count(txs[3].GetHash()));
+
+    // In a full block a new package evicts the lowest feerate ones
+    BlockAssembler::Options options;
+    options.blockMinFeeRate = blockMinFeeRate;
+    options.nBlockMaxWeight = 4000 + 4 * WITNESS_SCALE_FACTOR * GetVirtualTransactionSize(txs[0]) + 1;
+    CNextBlockCandidates candidatesFull(mempool);
+    pblocktemplate = BlockAssembler(chainparams, options).CreateNewBlock(scriptPubKey, ALGO_SHA256D, true, &candidatesFull);
+    BOOST_REQUIRE(pblocktemplate);
+    std::set<uint256> txids = BlockTxids(pblocktemplate->block);
+    BOOST_CHECK_EQUAL(txids.size(), 4U);
+    BOOST_CHECK(txids.count(txs[9].GetHash()) && txids.count(txs[8].GetHash()));
+
+    const CTransaction txBest = Spend(COutPoint(split.GetHash(), 11), split.vout[11].nValue, 100000);
+    const CTransaction txWorst = Spend(COutPoint(split.GetHash(), 12), split.vout[12].nValue, 1001);
+    pblocktemplate = BlockAssembler(chainparams, options).CreateNewBlock(scriptPubKey, ALGO_SHA256D, true, &candidatesFull);
+    BOOST_REQUIRE(pblocktemplate);
+    txids = BlockTxids(pblocktemplate->block);
+    BOOST_CHECK_EQUAL(txids.size(), 4U);
+    BOOST_CHECK(txids.count(txBest.GetHash()));
+    BOOST_CHECK(!txids.count(txWorst.GetHash()));
+    BOOST_CHECK(txids == BlockTxids(BlockAssembler(chainparams, options).CreateNewBlock(scriptPubKey, ALGO_SHA256D)->block));
+
+    // but never packages that pay more in total, even at a lower feerate
+    mempool.clear();
+    CMutableTransaction txLarge;
+    txLarge.vin.resize(1);
+    txLarge.vin[0].prevout = COutPoint(split.GetHash(), 13);
+    for (int i = 0; i < 35; i++)
+        txLarge.vout.emplace_back((split.vout[13].nValue - 20000) / 35, CScript() << OP_TRUE);
+    txLarge.vout[0].nValue += (split.vout[13].nValue - 20000) % 35;
+    mempool.addUnchecked(txLarge.GetHash(), entry.Fee(20000).Time(GetTime()).FromTx(txLarge));
+    for (int i = 14; i < 19; i++)
+        Spend(COutPoint(split.GetHash(), i), split.vout[i].nValue, 2000);
+    options.nBlockMaxWeight = 4000 + WITNESS_SCALE_FACTOR * GetVirtualTransactionSize(CTransaction(txLarge)) + 1;
+    CNextBlockCandidates candidatesLarge(mempool);
+    pblocktemplate = BlockAssembler(chainparams, options).CreateNewBlock(scriptPubKey, ALGO_SHA256D, true, &candidatesLarge);
+    BOOST_REQUIRE(pblocktemplate);
+    BOOST_CHECK(BlockTxids(pblocktemplate->block) == std::set<uint256>{txLarge.GetHash()});
+
+    const CTransaction txSmall = Spend(COutPoint(split.GetHash(), 19), split.vout[19].nValue, 6000);
+    pblocktemplate = BlockAssembler(chainparams, options).CreateNewBlock(scriptPubKey, ALGO_SHA256D, true, &candidatesLarge);
+    BOOST_REQUIRE(pblocktemplate);
+    BOOST_CHECK(BlockTxids(pblocktemplate->block) == std::set<uint256>{txLarge.GetHash()});
+    BOOST_CHECK_EQUAL(pblocktemplate->vTxFees[0], -20000);
+    std::unique_ptr<CBlockTemplate> pblocktemplateFull = BlockAssembler(chainparams, options).CreateNewBlock(scriptPubKey, ALGO_SHA256D);
+    BOOST_REQUIRE(pblocktemplateFull);
+    BOOST_CHECK(BlockTxids(pblocktemplateFull->block).count(txSmall.GetHash()));
+    BOOST_CHECK(pblocktemplate->vTxFees[0] <= pblocktemplateFull->vTxFees[0]);
+
+    mempool.clear();
+}
+
+BOOST_AUTO_TEST_CASE(MiningContext_ScanNonces)
+{
+    CDefaultBlockHeader header;
+    header.nVersion = 0x20000002;
+    header.hashPrevBlock = uint256S("0x5e6a1f7d2c30b94e8f0d6b7c1a2e3f405162738495a6b7c8d9eafb0c1d2e3f40");
+    header.hashMerkleRoot = uint256S("0x0f1e2d3c4b5a69788796a5b4c3d2e1f00112233445566778899aabbccddeeff0");
+    header.nTime = 1540000000;
+    header.nBits = 0x207fffff;
+
+    // Roughly one in sixteen hashes meets the target.
+    const arith_uint256 bnTarget = ~arith_uint256() >> 4;
+    const uint8_t algos[] = {ALGO_SHA256D, ALGO_SCRYPT, ALGO_X11, ALGO_QUARK};
+    for (uint8_t nAlgo : algos) {
+        const uint32_t nStart = 1000;
+        uint32_t nExpected = nStart;
+        header.nNonce = nExpected;
+        while (UintToArith256(header.GetPoWHash(nAlgo, SER_GETHASH, PROTOCOL_VERSION)) > bnTarget)
+            header.nNonce = ++nExpected;
+
+        header.nNonce = 0;
+        CMiningContext context(header, nAlgo, PROTOCOL_VERSION);
+        uint32_t nNonceFound = 0;
+        BOOST_CHECK(context.ScanNonces(nStart, nExpected - nStart + 40, bnTarget, nNonceFound));
+        BOOST_CHECK_EQUAL(nNonceFound, nExpected);
+        // The nonce that meets the target is the last one scanned.
+        BOOST_CHECK(context.ScanNonces(nStart, nExpected - nStart + 1, bnTarget, nNonceFound));
+        BOOST_CHECK_EQUAL(nNonceFound, nExpected);
+        BOOST_CHECK(!context.ScanNonces(nStart, nExpected - nStart, bnTarget, nNonceFound));
+        BOOST_CHECK(!context.ScanNonces(nStart, 40, arith_uint256(), nNonceFound));
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,128 @@
+// Copyright (c) 2026 The Globaltoken Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <chain.h>
+#include <payeeindex.h>
+#include <primitives/block.h>
+#include <validation.h>
+#include <test/test_bitcoin.h>
+
+#include <list>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(payeeindex_tests, TestingSetup)
+
+static const CAmount BLOCK_VALUE = 100 * COIN;
+
+static CBlock MakeBlock(const CBlockIndex* pindexPrev, int nHeight, const CScript& scriptPayee, CAmount nPayment)
+{
+    CMutableTransaction tx;
+    tx.vin.resize(1);
+    tx.vin[0].scriptSig = CScript() << nHeight << OP_0;
+    tx.vout.resize(2);
+    tx.vout[0].scriptPubKey = CScript() << OP_TRUE;
+    tx.vout[0].nValue = BLOCK_VALUE - nPayment;
+    tx.vout[1].scriptPubKey = scriptPayee;
+    tx.vout[1].nValue = nPayment;
+
+    CBlock block;
+    block.hashPrevBlock = pindexPrev->GetBlockHash();
+    block.nTime = pindexPrev->nTime + 60;
+    block.vtx.push_back(MakeTransactionRef(std::move(tx)));
+    return block;
+}
+
+/** Block index entries kept alive for the duration of a test */
+struct TestChain
+{
+    std::list<uint256> hashes;
+    std::list<CBlockIndex> indexes;
+
+    const CBlockIndex* Add(const CBlock& block, const CBlockIndex* pindexPrev)
+    {
+        hashes.push_back(block.GetHash());
+        indexes.emplace_back(block);
+        CBlockIndex& index = indexes.back();
+        index.phashBlock = &hashes.back();
+        index.pprev = const_cast<CBlockIndex*>(pindexPrev);
+        index.nHeight = pindexPrev->nHeight + 1;
+        index.BuildSkip();
+        return &index;
+    }
+};
+
+BOOST_AUTO_TEST_CASE(payeeindex_payments)
+{
+    CPayeeIndex index(1 << 20, true);
+    index.Sync();
+
+    const CBlockIndex* pindexGenesis;
+    {
+        LOCK(cs_main);
+        pindexGenesis = chainActive.Tip();
+    }
+    const int nGenesisHeight = pindexGenesis->nHeight;
+    const CScript scriptA = CScript() << OP_1;
+    const CScript scriptB = CScript() << OP_2;
+    const CAmount nPayment = GetMasternodePayment(nGenesisHeight + 1, BLOCK_VALUE);
+    BOOST_REQUIRE(nPayment > 0);
+
+    // A pays A, B pays B, then A is paid again; one output of a wrong amount is not indexed
+    TestChain chain;
+    std::vector<CBlock> blocks;
+    std::vector<const CBlockIndex*> vpindex;
+    const CBlockIndex* pindexPrev = pindexGenesis;
+    const CScript* payees[] = {&scriptA, &scriptB, &scriptA, &scriptB};
+    const CAmount amounts[] = {nPayment, nPayment, nPayment, nPayment - 1};
+    for (int i = 0; i < 4; i++) {
+        blocks.push_back(MakeBlock(pindexPrev, pindexPrev->nHeight + 1, *payees[i], amounts[i]));
+        pindexPrev = chain.Add(blocks.back(), pindexPrev);
+        vpindex.push_back(pindexPrev);
+        index.ConnectBlock(blocks.back(), pindexPrev);
+    }
+
+    std::vector<CPayeePayment> vPayments;
+    BOOST_CHECK(index.GetPayments(scriptA, vpindex[3], nGenesisHeight, vPayments));
+    BOOST_REQUIRE_EQUAL(vPayments.size(), 2U);
+    BOOST_CHECK_EQUAL(vPayments[0].nHeight, vpindex[2]->nHeight);
+    BOOST_CHECK_EQUAL(vPayments[1].nHeight, vpindex[0]->nHeight);
+    BOOST_CHECK_EQUAL(vPayments[0].nAmount, nPayment);
+    BOOST_CHECK(vPayments[0].hashBlock == vpindex[2]->GetBlockHash());
+
+    // Queries are bounded by the given block and the minimum height
+    BOOST_CHECK(index.GetPayments(scriptA, vpindex[1], nGenesisHeight, vPayments));
+    BOOST_CHECK_EQUAL(vPayments.size(), 1U);
+    BOOST_CHECK(index.GetPayments(scriptA, vpindex[3], vpindex[0]->nHeight, vPayments));
+    BOOST_CHECK_EQUAL(vPayments.size(), 1U);
+    BOOST_CHECK(index.GetPayments(scriptB, vpindex[3], nGenesisHeight, vPayments));
+    BOOST_CHECK_EQUAL(vPayments.size(), 1U);
+
+    // Disconnecting removes the payments of the block, a block on another branch is not covered
+    index.DisconnectBlock(blocks[3]);
+    index.DisconnectBlock(blocks[2]);
+    BOOST_CHECK(!index.GetPayments(scriptA, vpindex[3], nGenesisHeight, vPayments));
+    BOOST_CHECK(index.GetPayments(scriptA, vpindex[1], nGenesisHeight, vPayments));
+    BOOST_CHECK_EQUAL(vPayments.size(), 1U);
+
+    CBlock blockFork = MakeBlock(vpindex[1], vpindex[1]->nHeight + 1, scriptB, nPayment);
+    const CBlockIndex* pindexFork = chain.Add(blockFork, vpindex[1]);
+    index.ConnectBlock(blockFork, pindexFork);
+    BOOST_CHECK(index.GetPayments(scriptA, pindexFork, nGenesisHeight, vPayments));
+    BOOST_CHECK_EQUAL(vPayments.size(), 1U);
+    BOOST_CHECK(index.GetPayments(scriptB, pindexFork, nGenesisHeight, vPayments));
+    BOOST_CHECK_EQUAL(vPayments.size(), 2U);
+
+    // A block that does not extend the index starts a new covered range
+    CBlock blockOther = MakeBlock(vpindex[0], vpindex[0]->nHeight + 1, scriptA, nPayment);
+    const CBlockIndex* pindexOther = chain.Add(blockOther, vpindex[0]);
+    CBlock blockNext = MakeBlock(pindexOther, pindexOther->nHeight + 1, scriptA, nPayment);
+    const CBlockIndex* pindexNext = chain.Add(blockNext, pindexOther);
+    index.ConnectBlock(blockNext, pindexNext);
+    BOOST_CHECK(!index.GetPayments(scriptA, pindexNext, nGenesisHeight, vPayments));
+    BOOST_CHECK(index.GetPayments(scriptA, pindexNext, pindexOther->nHeight, vPayments));
+    BOOST_CHECK_EQUAL(vPayments.size(), 1U);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
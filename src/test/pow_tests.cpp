@@ -4,11 +4,15 @@
 
 #include <chain.h>
 #include <chainparams.h>
+#include <globaltoken/powalgorithm.h>
 #include <pow.h>
+#include <primitives/pureheader.h>
 #include <random.h>
 #include <util.h>
 #include <test/test_bitcoin.h>
 
+#include <algorithm>
+
 #include <boost/test/unit_test.hpp>
 
 BOOST_FIXTURE_TEST_SUITE(pow_tests, BasicTestingSetup)
@@ -83,4 +87,46 @@ BOOST_AUTO_TEST_CASE(GetBlockProofEquivalentTime_test)
     }
 }
 
+BOOST_AUTO_TEST_CASE(algo_registry)
+{
+    for (int algo = 0; algo < NUM_ALGOS_IMPL; algo++) {
+        const CAlgoInfo& info = GetAlgoInfo(algo);
+        BOOST_CHECK_EQUAL(info.nAlgo, algo);
+        BOOST_CHECK_EQUAL(GetAlgoName(algo), info.pszName);
+
+        bool fAlgoFound = false;
+        BOOST_CHECK_EQUAL(GetAlgoByName(info.pszName, NUM_ALGOS_IMPL, fAlgoFound), algo);
+        BOOST_CHECK(fAlgoFound);
+        std::string strUpper(info.pszName);
+        std::transform(strUpper.begin(), strUpper.end(), strUpper.begin(), ::toupper);
+        BOOST_CHECK_EQUAL(GetAlgoByName(strUpper, NUM_ALGOS_IMPL, fAlgoFound), algo);
+        BOOST_CHECK(fAlgoFound);
+
+        CPureBlockHeader header;
+        header.nVersion = 4;
+        header.SetAlgo(algo);
+        BOOST_CHECK_EQUAL(header.nVersion, 4 | info.nVersionBits);
+        BOOST_CHECK_EQUAL(header.GetAlgo(), algo);
+        BOOST_CHECK_EQUAL(IsEquihashBasedAlgo(algo), info.memoryClass == ALGO_MEMORY_EQUIHASH);
+    }
+
+    bool fAlgoFound = true;
+    BOOST_CHECK_EQUAL(GetAlgoByName("sha", ALGO_X11, fAlgoFound), ALGO_SHA256D);
+    BOOST_CHECK_EQUAL(GetAlgoByName("equihash144_5", ALGO_X11, fAlgoFound), ALGO_ZHASH);
+    BOOST_CHECK_EQUAL(GetAlgoByName("Phi", ALGO_X11, fAlgoFound), ALGO_PHI1612);
+    BOOST_CHECK(fAlgoFound);
+    BOOST_CHECK_EQUAL(GetAlgoByName("", ALGO_X11, fAlgoFound), ALGO_X11);
+    BOOST_CHECK(!fAlgoFound);
+    BOOST_CHECK_EQUAL(GetAlgoByName("sha256dd", ALGO_X11, fAlgoFound), ALGO_X11);
+    BOOST_CHECK(!fAlgoFound);
+    BOOST_CHECK_EQUAL(GetAlgoName(NUM_ALGOS_IMPL), "unknown");
+
+    // Legacy versions and unknown algo bits select SHA256d.
+    CPureBlockHeader header;
+    header.nVersion = 4;
+    BOOST_CHECK_EQUAL(header.GetAlgo(), ALGO_SHA256D);
+    header.nVersion = 4 | ((NUM_ALGOS_IMPL + 1) << 9);
+    BOOST_CHECK_EQUAL(header.GetAlgo(), ALGO_SHA256D);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
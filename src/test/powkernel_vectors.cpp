@@ -0,0 +1,57 @@
+// Copyright (c) 2026 The Globaltoken Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <test/powkernel_vectors.h>
+
+#include <crypto/algos/Lyra2RE/Lyra2RE.h>
+#include <crypto/algos/Lyra2RE/Lyra2Z.h>
+#include <crypto/algos/allium/allium.h>
+#include <crypto/algos/argon2/hashargon.h>
+#include <crypto/algos/scrypt/scrypt.h>
+#include <crypto/algos/yescrypt/yescrypt.h>
+#include <crypto/algos/yespower/yespower.h>
+
+namespace {
+
+struct PowKernelInput {
+    unsigned char input[80];
+    unsigned char salt[32];
+    unsigned char pepper[32];
+
+    PowKernelInput()
+    {
+        for (int i = 0; i < 80; i++)
+            input[i] = i;
+        for (int i = 0; i < 32; i++) {
+            salt[i] = 0xa0 + i;
+            pepper[i] = 0x40 + i;
+        }
+    }
+};
+
+const PowKernelInput data;
+
+} // namespace
+
+const std::vector<PowKernelVector>& GetPowKernelVectors()
+{
+    static const std::vector<PowKernelVector> vectors = {
+        // Expected value of the generic kernel, pinning the SSE2 one that x86-64 builds force
+        {"scrypt", [](unsigned char* out) { scrypt_1024_1_1_256((const char*)data.input, (char*)out); }, "bc540a1a801df96e493005c71e010e2d387607fbf0fec416fd3c2645aa1ba9d2", false},
+        {"lyra2rev2", [](unsigned char* out) { lyra2re2_hash((const char*)data.input, (char*)out); }, "2246faafca15a01a35c81a3f801fe8338942565bdb75a505517372aa0c7afdd0", false},
+        {"lyra2rev3", [](unsigned char* out) { lyra2re3_hash((const char*)data.input, (char*)out); }, "9015a1aa1cc961093e5b5d078ccc5fe527d41a19d9df6e8b12e7e6fdad8c590d", false},
+        {"lyra2z", [](unsigned char* out) { lyra2z_hash((const char*)data.input, (char*)out); }, "6b0ded5afb3b27cf0e601243ffd9b37ee65331a2d46c7add2a6a826958ab1c0b", false},
+        {"allium", [](unsigned char* out) { allium_hash((const char*)data.input, (char*)out); }, "446c01d18f906d31eb89919cc1b1db3bdd46a8e0a554582049277e728263732d", false},
+        {"yescrypt", [](unsigned char* out) { yescrypt_hash((const char*)data.input, (char*)out); }, "ae955413ae874374e49bcce4d5476fde4903b10a1402377f8ed70adf5968d9f7", true},
+        {"yescryptr8", [](unsigned char* out) { yescrypt_r8_hash((const char*)data.input, (char*)out); }, "39575e42fc80dfc7f2777de567b36604c2336cce9f0b6fa228a15c84ecd5943c", true},
+        {"yescryptr16v2", [](unsigned char* out) { yescrypt_r16v2_hash((const char*)data.input, (char*)out); }, "191b8fb9b566273d20eb6d1e58abec191d0cda4a3c9505b9823fabc4df76a6d3", true},
+        {"yescryptr24", [](unsigned char* out) { yescrypt_r24_hash((const char*)data.input, (char*)out); }, "49a5ec56653468f05776c04d6f49cd25a7824fef286eb3f638af48d9b7dd3318", true},
+        {"yescryptr32", [](unsigned char* out) { yescrypt_r32_hash((const char*)data.input, (char*)out); }, "344e7ed2f52236389f5bf63ea195e5d396f7d1f4a789a19ee8c1fde838399ab3", true},
+        {"yespower", [](unsigned char* out) { yespower_hash((const char*)data.input, (char*)out); }, "925903a9c3c9e24f710d5b46e2a5efb72b0524d00aaa75af03bae616a1e5e389", true},
+        {"argon2d", [](unsigned char* out) { Argon2dHash(data.input, 80, out, 32, data.salt, 32, data.pepper, 32); }, "562e235c6c49886fb8eed6df13ee6104fd7f9b3512f420549e91859b7f4f1bca", true},
+        {"argon2i", [](unsigned char* out) { Argon2iHash(data.input, 80, out, 32, data.salt, 32, data.pepper, 32); }, "72ef25dcc7716d7a63554a711fe2219739ac384bd7ae1d8b2623ab31c6de6435", true},
+        {"cpu23r_argon2d", [](unsigned char* out) { cpu23R_hash_argon2d(out, 32, data.input, 80, data.salt, 32, 2, 16); }, "386d424127f50afcc66b629d463584065149024c4c6b5607dc8841be9860bbd0", true},
+    };
+    return vectors;
+}
@@ -0,0 +1,26 @@
+// Copyright (c) 2026 The Globaltoken Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef GLOBALTOKEN_TEST_POWKERNEL_VECTORS_H
+#define GLOBALTOKEN_TEST_POWKERNEL_VECTORS_H
+
+#include <vector>
+
+/** A memory-hard proof-of-work kernel and its hash of the shared test input */
+struct PowKernelVector {
+    const char* name;
+    void (*hash)(unsigned char* out);
+    const char* expected;
+    /** Whether the implementation is selected at runtime by CPU tier */
+    bool fTiered;
+};
+
+/**
+ * The memory-hard kernels with the hashes they gave before they took their
+ * memory from the scratchpad and before their implementations became
+ * selectable at runtime.
+ */
+const std::vector<PowKernelVector>& GetPowKernelVectors();
+
+#endif // GLOBALTOKEN_TEST_POWKERNEL_VECTORS_H
@@ -0,0 +1,50 @@
+// Copyright (c) 2026 The Globaltoken Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#if defined(HAVE_CONFIG_H)
+#include <config/bitcoin-config.h>
+#endif
+
+#include <crypto/algos/argon2/hashargon.h>
+#include <crypto/algos/powkernels.h>
+#include <crypto/algos/yescrypt/yescrypt.h>
+#include <crypto/algos/yespower/yespower.h>
+#include <utilstrencodings.h>
+#include <test/powkernel_vectors.h>
+#include <test/test_bitcoin.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(powkernels_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(powkernels_tiers)
+{
+    // Every kernel the CPU can run gives the hashes of the baseline one
+    const int nTierMax = PowKernelTierDetect();
+    for (int nTier = POW_KERNEL_BASELINE; nTier <= nTierMax; nTier++) {
+        const std::string strSelected = std::string(yescrypt_select_kdf(nTier)) + "/" +
+            yespower_select_kernel(nTier) + "/" + argon2_select_fill_segment(nTier);
+        for (const PowKernelVector& kernel : GetPowKernelVectors()) {
+            if (!kernel.fTiered)
+                continue;
+            unsigned char out[32];
+            kernel.hash(out);
+            BOOST_CHECK_MESSAGE(HexStr(out, out + 32) == kernel.expected, kernel.name << " " << strSelected);
+        }
+    }
+
+    yescrypt_select_kdf(nTierMax);
+    yespower_select_kernel(nTierMax);
+    argon2_select_fill_segment(nTierMax);
+}
+
+BOOST_AUTO_TEST_CASE(powkernels_autodetect)
+{
+    const std::vector<std::pair<std::string, std::string> > kernels = PowKernelsAutoDetect();
+    BOOST_REQUIRE_EQUAL(kernels.size(), 4U);
+    for (const auto& kernel : kernels)
+        BOOST_CHECK(!kernel.second.empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,80 @@
+// Copyright (c) 2026 The Globaltoken Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#if defined(HAVE_CONFIG_H)
+#include <config/bitcoin-config.h>
+#endif
+
+#include <crypto/algos/scratchpad.h>
+#include <globaltoken/powalgorithm.h>
+#include <utilstrencodings.h>
+#include <test/powkernel_vectors.h>
+#include <test/test_bitcoin.h>
+
+#include <algorithm>
+#include <string.h>
+#include <thread>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(scratchpad_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(scratchpad_arena)
+{
+    // Earlier tests may have left this thread with an arena of any size
+    const PowScratchpadStats statsStart = PowScratchpadGetStats();
+    const size_t nBase = std::max(statsStart.nSize, statsStart.nReserved);
+
+    // Memory is aligned, reused for smaller requests and grown for larger ones
+    unsigned char* p = static_cast<unsigned char*>(pow_scratchpad_get(nBase + 4096));
+    BOOST_REQUIRE(p != nullptr);
+    BOOST_CHECK_EQUAL(reinterpret_cast<uintptr_t>(p) % 64, 0U);
+    memset(p, 0x5a, nBase + 4096);
+    const uint64_t nAllocations = PowScratchpadGetStats().nAllocations;
+    BOOST_CHECK(pow_scratchpad_get(1) == p);
+    BOOST_CHECK(pow_scratchpad_get(nBase + 4096) == p);
+    BOOST_CHECK_EQUAL(PowScratchpadGetStats().nAllocations, nAllocations);
+
+    p = static_cast<unsigned char*>(pow_scratchpad_get(nBase + 8192));
+    BOOST_REQUIRE(p != nullptr);
+    memset(p, 0xa5, nBase + 8192);
+    const PowScratchpadStats stats = PowScratchpadGetStats();
+    BOOST_CHECK_EQUAL(stats.nAllocations, nAllocations + 1);
+    BOOST_CHECK(stats.nReserved >= nBase + 8192);
+
+#ifdef HAVE_THREAD_LOCAL
+    // The arena of a thread is released when it exits
+    void* pThread = nullptr;
+    std::thread t([&pThread] { pThread = pow_scratchpad_get(4096); });
+    t.join();
+    BOOST_CHECK(pThread != nullptr);
+    BOOST_CHECK_EQUAL(PowScratchpadGetStats().nArenas, stats.nArenas);
+    BOOST_CHECK_EQUAL(PowScratchpadGetStats().nReserved, stats.nReserved);
+#endif
+}
+
+BOOST_AUTO_TEST_CASE(scratchpad_hashes)
+{
+    PowScratchpadInit(GetMaxAlgoScratchpadSize(), DEFAULT_POW_HUGEPAGES);
+
+    // The second round runs on the memory of the first, without any allocation,
+    // and no kernel may fall back to memory of its own in either round
+    const uint64_t nFallbacks = PowScratchpadGetStats().nFallbacks;
+    uint64_t nAllocations = 0;
+    for (int nRound = 0; nRound < 2; nRound++) {
+        if (nRound == 1)
+            nAllocations = PowScratchpadGetStats().nAllocations;
+        for (const PowKernelVector& kernel : GetPowKernelVectors()) {
+            unsigned char out[32];
+            kernel.hash(out);
+            BOOST_CHECK_MESSAGE(HexStr(out, out + 32) == kernel.expected, kernel.name);
+        }
+    }
+    BOOST_CHECK_EQUAL(PowScratchpadGetStats().nAllocations, nAllocations);
+    BOOST_CHECK_EQUAL(PowScratchpadGetStats().nFallbacks, nFallbacks);
+
+    PowScratchpadInit(0, DEFAULT_POW_HUGEPAGES);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -3,6 +3,8 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <chain.h>
+#include <chainparams.h>
+#include <pow.h>
 #include <util.h>
 #include <test/test_bitcoin.h>
 
@@ -177,4 +179,53 @@ BOOST_AUTO_TEST_CASE(findearliestatleast_edge_test)
     BOOST_CHECK(!chain.FindEarliestAtLeast(int64_t(std::numeric_limits<unsigned int>::max()) + 1));
 }
 
+BOOST_AUTO_TEST_CASE(algoskip_test)
+{
+    const Consensus::Params& params = Params().GetConsensus();
+    const int nLength = 4000;
+    const int64_t nStart = params.Hardfork1.GetActivationTime() - 200000;
+    const int64_t nSpacing = (params.Hardfork2.GetActivationTime() - nStart + 200000) / nLength;
+
+    // vBuilt gets the per-algo links, vLegacy uses the linear walks.
+    std::vector<CBlockIndex> vBuilt(nLength);
+    std::vector<CBlockIndex> vLegacy(nLength);
+    for (int i = 0; i < nLength; i++) {
+        CBlockHeader header;
+        header.nVersion = 4;
+        header.SetAlgo(InsecureRandRange(8) == 0 ? ALGO_RICKHASH : InsecureRandRange(6));
+        header.nTime = nStart + i * nSpacing + InsecureRandRange(40000) - 20000;
+        header.nBits = 0x1e0fffff - InsecureRandRange(0x10000);
+        for (std::vector<CBlockIndex>* pv : {&vBuilt, &vLegacy}) {
+            CBlockIndex& index = (*pv)[i];
+            index.nVersion = header.nVersion;
+            index.nTime = header.nTime;
+            index.nBits = header.nBits;
+            index.nHeight = i;
+            index.pprev = (i == 0) ? nullptr : &(*pv)[i - 1];
+            index.BuildSkip();
+        }
+        vBuilt[i].BuildAlgoSkip(params);
+    }
+
+    for (int i = 0; i < nLength; i++) {
+        BOOST_CHECK(vBuilt[i].fAlgoSkipBuilt);
+        BOOST_CHECK(!vLegacy[i].fAlgoSkipBuilt);
+        BOOST_CHECK_EQUAL(vBuilt[i].pAlgoTable != nullptr, i % ALGO_TABLE_INTERVAL == 0);
+        if (vBuilt[i].pprevAlgo) {
+            BOOST_CHECK(vBuilt[i].pprevAlgo->GetAlgo() == vBuilt[i].GetAlgo());
+            BOOST_CHECK(vBuilt[i].pprevAlgo->nHeight < i);
+        }
+        for (uint8_t algo : {ALGO_SHA256D, ALGO_SCRYPT, ALGO_EQUIHASH, ALGO_YESCRYPT, ALGO_RICKHASH}) {
+            const CBlockIndex* pindexBuilt = GetLastBlockIndexForAlgo(&vBuilt[i], algo, params);
+            const CBlockIndex* pindexLegacy = GetLastBlockIndexForAlgo(&vLegacy[i], algo, params);
+            BOOST_CHECK_EQUAL(pindexBuilt ? pindexBuilt->nHeight : -1, pindexLegacy ? pindexLegacy->nHeight : -1);
+        }
+        const CBlockIndex* pindexBuilt = GetPrevBlockIndexForAlgo(&vBuilt[i], params);
+        const CBlockIndex* pindexLegacy = GetPrevBlockIndexForAlgo(&vLegacy[i], params);
+        BOOST_CHECK_EQUAL(pindexBuilt ? pindexBuilt->nHeight : -1, pindexLegacy ? pindexLegacy->nHeight : -1);
+        if (i % 16 == 0)
+            BOOST_CHECK(GetBlockProof(vBuilt[i], params) == GetBlockProof(vLegacy[i], params));
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -120,4 +120,34 @@ BOOST_AUTO_TEST_CASE(streams_serializedata_xor)
             std::string(ds.begin(), ds.end()));  
 }         
 
+BOOST_AUTO_TEST_CASE(streams_buffered_file_skipto)
+{
+    FILE* file = tmpfile();
+    BOOST_REQUIRE(file != nullptr);
+    for (int i = 0; i < 256; i++)
+        fputc(i, file);
+    rewind(file);
+
+    CBufferedFile bf(file, 32, 0, SER_DISK, 0);
+    uint8_t n;
+
+    // Inside the buffer, behind the data read from the file so far
+    bf >> n;
+    BOOST_CHECK_EQUAL(n, 0);
+    BOOST_CHECK(bf.SkipTo(10));
+    bf >> n;
+    BOOST_CHECK_EQUAL(n, 10);
+
+    // Short distance ahead of the buffer: read through it
+    BOOST_CHECK(bf.SkipTo(50));
+    BOOST_CHECK_EQUAL(bf.GetPos(), 50U);
+    bf >> n;
+    BOOST_CHECK_EQUAL(n, 50);
+
+    // Long distance ahead of the buffer: seek the file
+    BOOST_CHECK(bf.SkipTo(200));
+    bf >> n;
+    BOOST_CHECK_EQUAL(n, 200);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -7,10 +7,13 @@
 #include <chainparams.h>
 #include <consensus/consensus.h>
 #include <consensus/validation.h>
+#include <crypto/algos/hashlib/multihash_lanes.h>
 #include <crypto/sha256.h>
 #include <validation.h>
+#include <messagesigner.h>
 #include <miner.h>
 #include <net_processing.h>
+#include <powcache.h>
 #include <ui_interface.h>
 #include <streams.h>
 #include <rpc/server.h>
@@ -43,12 +46,15 @@ extern void noui_connect();
 BasicTestingSetup::BasicTestingSetup(const std::string& chainName)
 {
         SHA256AutoDetect();
+        Hash512AutoDetect();
         RandomInit();
         ECC_Start();
         SetupEnvironment();
         SetupNetworking();
         InitSignatureCache();
         InitScriptExecutionCache();
+        InitPowCache();
+        InitHashSigCache();
         fPrintToDebugLog = false; // don't want to write to debug.log file
         fCheckBlockIndex = true;
         SelectParams(chainName);
@@ -0,0 +1,234 @@
+// Copyright (c) 2026 The Globaltoken Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <chainparams.h>
+#include <consensus/validation.h>
+#include <equihashstore.h>
+#include <pow.h>
+#include <powcache.h>
+#include <primitives/block.h>
+#include <txdb.h>
+#include <validation.h>
+#include <test/test_bitcoin.h>
+
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+struct RegtestingSetup : public TestingSetup {
+    RegtestingSetup() : TestingSetup(CBaseChainParams::REGTEST) {}
+};
+
+BOOST_FIXTURE_TEST_SUITE(validation_block_tests, RegtestingSetup)
+
+/** Build a regtest header whose proof-of-work passes or fails as requested */
+static CBlockHeader MakeHeader(const uint256& hashPrev, uint32_t nTime, bool fValidPow, uint32_t nBits = 0x207fffff)
+{
+    CBlockHeader header;
+    header.nVersion = 1;
+    header.hashPrevBlock = hashPrev;
+    header.nTime = nTime;
+    header.nBits = nBits;
+    while (CheckProofOfWork(header, Params().GetConsensus()) != fValidPow)
+        ++header.nNonce;
+    return header;
+}
+
+static std::vector<CBlockHeader> MakeChain(const uint256& hashPrev, uint32_t nTime, size_t nLength)
+{
+    std::vector<CBlockHeader> headers;
+    uint256 hash = hashPrev;
+    for (size_t i = 0; i < nLength; i++) {
+        headers.push_back(MakeHeader(hash, nTime + 60 * i, true));
+        hash = headers.back().GetHash();
+    }
+    return headers;
+}
+
+BOOST_AUTO_TEST_CASE(process_headers_parallel_pow)
+{
+    const CBlock& genesis = Params().GenesisBlock();
+    const uint32_t nTime = genesis.nTime + 60;
+
+    // A valid batch is accepted with its proof-of-work checked off cs_main.
+    std::vector<CBlockHeader> headers = MakeChain(genesis.GetHash(), nTime, 20);
+    CValidationState state;
+    const CBlockIndex* pindex = nullptr;
+    CBlockHeader first_invalid;
+    BOOST_CHECK(ProcessNewBlockHeaders(headers, state, Params(), &pindex, &first_invalid));
+    BOOST_CHECK(first_invalid.IsNull());
+    BOOST_REQUIRE(pindex != nullptr);
+    BOOST_CHECK(pindex->GetBlockHash() == headers.back().GetHash());
+    BOOST_CHECK_EQUAL(pindex->nHeight, 20);
+
+    // Resending known headers along with new ones skips the known ones.
+    std::vector<CBlockHeader> extended = MakeChain(headers.back().GetHash(), nTime + 60 * 20, 5);
+    extended.insert(extended.begin(), headers.begin() + 10, headers.end());
+    BOOST_CHECK(ProcessNewBlockHeaders(extended, state, Params(), &pindex, &first_invalid));
+    BOOST_CHECK_EQUAL(pindex->nHeight, 25);
+
+    // A header with bad proof-of-work rejects the batch, the headers before it are
+    // still accepted and the bad one is reported with the serial check's reason.
+    std::vector<CBlockHeader> bad = MakeChain(extended.back().GetHash(), nTime + 60 * 25, 4);
+    bad[2] = MakeHeader(bad[1].GetHash(), nTime + 60 * 27, false);
+    bad[3] = MakeHeader(bad[2].GetHash(), nTime + 60 * 28, true);
+    state = CValidationState();
+    BOOST_CHECK(!ProcessNewBlockHeaders(bad, state, Params(), &pindex, &first_invalid));
+    BOOST_CHECK(first_invalid.GetHash() == bad[2].GetHash());
+    BOOST_CHECK_EQUAL(state.GetRejectReason(), "high-hash");
+    {
+        LOCK(cs_main);
+        BOOST_CHECK(mapBlockIndex.count(bad[1].GetHash()));
+        BOOST_CHECK(!mapBlockIndex.count(bad[2].GetHash()));
+    }
+
+    // The first failure in batch order wins, even when a later header has bad proof-of-work.
+    std::vector<CBlockHeader> orphaned = {MakeHeader(uint256S("0x01"), nTime, true), MakeHeader(genesis.GetHash(), nTime, false)};
+    state = CValidationState();
+    BOOST_CHECK(!ProcessNewBlockHeaders(orphaned, state, Params(), &pindex, &first_invalid));
+    BOOST_CHECK(first_invalid.GetHash() == orphaned[0].GetHash());
+    BOOST_CHECK_EQUAL(state.GetRejectReason(), "prev-blk-not-found");
+
+    // Headers whose nBits is not the expected one are rejected by the contextual checks.
+    std::vector<CBlockHeader> easy = MakeChain(bad[1].GetHash(), nTime + 60 * 27, 3);
+    easy[1] = MakeHeader(easy[0].GetHash(), nTime + 60 * 28, true, 0x207ffffe);
+    easy[2] = MakeHeader(easy[1].GetHash(), nTime + 60 * 29, true);
+    state = CValidationState();
+    BOOST_CHECK(!ProcessNewBlockHeaders(easy, state, Params(), &pindex, &first_invalid));
+    BOOST_CHECK(first_invalid.GetHash() == easy[1].GetHash());
+    BOOST_CHECK_EQUAL(state.GetRejectReason(), "bad-diffbits");
+}
+
+BOOST_AUTO_TEST_CASE(pow_check_groups)
+{
+    const Consensus::Params& consensusParams = Params().GetConsensus();
+    const uint32_t nTime = Params().GenesisBlock().nTime + 11;
+
+    // Headers are checked in groups of one algo, each with its own result.
+    CPowCheckGrouper groups(consensusParams);
+    std::vector<CPowCheck> vChecks;
+    std::vector<PowCheckResult> vResults(POW_CHECK_GROUP_SIZE + 4, POW_CHECK_PENDING);
+    for (size_t i = 0; i < vResults.size(); i++) {
+        groups.Add(MakeHeader(uint256(), nTime + i, i % 3 != 0), vChecks, &vResults[i]);
+        BOOST_CHECK_EQUAL(vChecks.size(), i + 1 < POW_CHECK_GROUP_SIZE ? 0U : 1U);
+    }
+    groups.Flush(vChecks);
+    BOOST_REQUIRE_EQUAL(vChecks.size(), 2U);
+    BOOST_CHECK_EQUAL(vChecks[0].size(), POW_CHECK_GROUP_SIZE);
+    BOOST_CHECK_EQUAL(vChecks[1].size(), 4U);
+
+    for (CPowCheck& check : vChecks)
+        BOOST_CHECK(!check());
+    for (size_t i = 0; i < vResults.size(); i++)
+        BOOST_CHECK_EQUAL(vResults[i], i % 3 != 0 ? POW_CHECK_VALID : POW_CHECK_INVALID);
+}
+
+BOOST_AUTO_TEST_CASE(pow_cache)
+{
+    const Consensus::Params& consensusParams = Params().GetConsensus();
+    const CBlock& genesis = Params().GenesisBlock();
+    // Distinct from the headers of the other test cases, the cache outlives them
+    const uint32_t nTime = genesis.nTime + 7;
+
+    CBlockHeader valid = MakeHeader(genesis.GetHash(), nTime, true);
+    CBlockHeader invalid = MakeHeader(genesis.GetHash(), nTime, false);
+
+    // Only headers that pass are cached.
+    PowCacheStats before = GetPowCacheStats();
+    BOOST_CHECK(before.nCapacity > 0);
+    BOOST_CHECK(CheckProofOfWorkCached(valid, consensusParams));
+    BOOST_CHECK(CheckProofOfWorkCached(valid, consensusParams));
+    BOOST_CHECK(!CheckProofOfWorkCached(invalid, consensusParams));
+    BOOST_CHECK(!CheckProofOfWorkCached(invalid, consensusParams));
+    PowCacheStats after = GetPowCacheStats();
+    BOOST_CHECK_EQUAL(after.nHits - before.nHits, 1U);
+    BOOST_CHECK_EQUAL(after.nMisses - before.nMisses, 3U);
+    BOOST_CHECK_EQUAL(after.nInserts - before.nInserts, 1U);
+
+    // Headers that passed the parallel check in ProcessNewBlockHeaders are cached
+    // for their full blocks.
+    std::vector<CBlockHeader> headers = MakeChain(genesis.GetHash(), nTime + 60, 4);
+    CValidationState state;
+    BOOST_CHECK(ProcessNewBlockHeaders(headers, state, Params()));
+    before = GetPowCacheStats();
+    for (const CBlockHeader& header : headers)
+        BOOST_CHECK(CheckProofOfWorkCached(header, consensusParams));
+    after = GetPowCacheStats();
+    BOOST_CHECK_EQUAL(after.nHits - before.nHits, headers.size());
+
+    // Headers after a rejected one are not, even when their proof-of-work is fine. The
+    // first header and the rejected one passed the serial check, which caches them.
+    std::vector<CBlockHeader> rejected = MakeChain(headers.back().GetHash(), nTime + 60 * 5, 4);
+    rejected[1] = MakeHeader(rejected[0].GetHash(), nTime + 60 * 6, true, 0x207ffffe);
+    rejected[2] = MakeHeader(rejected[1].GetHash(), nTime + 60 * 7, true);
+    rejected[3] = MakeHeader(rejected[2].GetHash(), nTime + 60 * 8, true);
+    BOOST_CHECK(!ProcessNewBlockHeaders(rejected, state, Params()));
+    before = GetPowCacheStats();
+    for (const CBlockHeader& header : rejected)
+        BOOST_CHECK(CheckProofOfWorkCached(header, consensusParams));
+    after = GetPowCacheStats();
+    BOOST_CHECK_EQUAL(after.nHits - before.nHits, 2U);
+}
+
+BOOST_AUTO_TEST_CASE(equihash_store)
+{
+    const CBlock& genesis = Params().GenesisBlock();
+
+    CBlockHeader header;
+    header.nVersion = 1;
+    header.SetAlgo(ALGO_EQUIHASH);
+    header.hashPrevBlock = genesis.GetHash();
+    header.hashReserved = uint256S("0x11");
+    header.nTime = genesis.nTime + 60;
+    header.nBits = 0x207fffff;
+    header.nBigNonce = uint256S("0x22");
+    header.nSolution.assign(1344, 0x33);
+    const uint256 hash = header.GetHash();
+
+    LOCK(cs_main);
+    CBlockIndex index(header);
+    index.phashBlock = &hash;
+    index.pprev = mapBlockIndex[genesis.GetHash()];
+    index.nHeight = 1;
+
+    // Until the entry is written, the fields are served from memory.
+    CEquihashFields fields;
+    fields.hashReserved = header.hashReserved;
+    fields.nBigNonce = header.nBigNonce;
+    fields.nSolution = header.nSolution;
+    EquihashStoreStats before = equihashstore.GetStats();
+    equihashstore.AddPending(hash, fields);
+    BOOST_CHECK_EQUAL(equihashstore.GetStats().nPending, before.nPending + 1);
+    BOOST_CHECK(index.GetBlockHeader(Params().GetConsensus()).GetHash() == hash);
+
+    // Once written, they are read back from the block tree database.
+    std::vector<const CBlockIndex*> vBlocks = {&index};
+    BOOST_REQUIRE(pblocktree->WriteBatchSync({}, 0, vBlocks));
+    equihashstore.SetWritten(vBlocks);
+    EquihashStoreStats after = equihashstore.GetStats();
+    BOOST_CHECK_EQUAL(after.nPending, before.nPending);
+    BOOST_CHECK_EQUAL(after.nOffloaded, before.nOffloaded + 1);
+    BOOST_CHECK(after.nOffloadedBytes - before.nOffloadedBytes >= header.nSolution.size());
+
+    CEquihashStore store(0);
+    CEquihashFields read;
+    BOOST_CHECK(store.Get(hash, read));
+    BOOST_CHECK(read.hashReserved == header.hashReserved);
+    BOOST_CHECK(read.nBigNonce == header.nBigNonce);
+    BOOST_CHECK(read.nSolution == header.nSolution);
+    BOOST_CHECK_EQUAL(store.GetStats().nReads, 1U);
+    BOOST_CHECK(!store.Get(genesis.GetHash(), read));
+    BOOST_CHECK(index.GetBlockHeader(Params().GetConsensus()).GetHash() == hash);
+
+    // A header whose fields are missing is never rebuilt without its solution.
+    header.nBigNonce = uint256S("0x23");
+    const uint256 hashMissing = header.GetHash();
+    CBlockIndex indexMissing(header);
+    indexMissing.phashBlock = &hashMissing;
+    indexMissing.pprev = index.pprev;
+    indexMissing.nHeight = 1;
+    BOOST_CHECK_THROW(indexMissing.GetBlockHeader(Params().GetConsensus()), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -5,7 +5,10 @@
 
 #include <txdb.h>
 
+#include <arith_uint256.h>
 #include <chainparams.h>
+#include <checkqueue.h>
+#include <equihashstore.h>
 #include <globaltoken/hardfork.h>
 #include <hash.h>
 #include <random.h>
@@ -30,8 +33,10 @@ static const char DB_HEAD_BLOCKS = 'H';
 static const char DB_FLAG = 'F';
 static const char DB_REINDEX_FLAG = 'R';
 static const char DB_LAST_BLOCK = 'l';
+static const char DB_POW_WATERMARK = 'W';
 
 std::vector<uint256> vAuxpowValidation;
+PowLoadCheckMode nCheckPowOnLoad = POW_LOAD_CHECK_WATERMARK;
 
 namespace {
 
@@ -157,6 +162,14 @@ bool CBlockTreeDB::ReadBlockFileInfo(int nFile, CBlockFileInfo &info) {
     return Read(std::make_pair(DB_BLOCK_FILES, nFile), info);
 }
 
+bool CBlockTreeDB::ReadEquihashFields(const uint256 &hash, CEquihashFields &fields) {
+    CDiskBlockIndex diskindex;
+    if (!Read(std::make_pair(DB_BLOCK_INDEX, hash), diskindex) || !IsEquihashBasedAlgo(diskindex.GetAlgo()))
+        return false;
+    fields = diskindex.GetEquihashFields();
+    return true;
+}
+
 bool CBlockTreeDB::WriteReindexing(bool fReindexing) {
     if (fReindexing)
         return Write(DB_REINDEX_FLAG, '1');
@@ -262,7 +275,50 @@ bool CBlockTreeDB::ReadFlag(const std::string &name, bool &fValue) {
     return true;
 }
 
-bool CBlockTreeDB::LoadBlockIndexGuts(const Consensus::Params& consensusParams, std::function<CBlockIndex*(const uint256&)> insertBlockIndex)
+bool CBlockTreeDB::WritePowWatermark(int nHeight, const uint256 &commitment) {
+    return Write(DB_POW_WATERMARK, std::make_pair(nHeight, commitment));
+}
+
+bool CBlockTreeDB::ReadPowWatermark(int &nHeight, uint256 &commitment) {
+    std::pair<int, uint256> watermark;
+    if (!Read(DB_POW_WATERMARK, watermark))
+        return false;
+    nHeight = watermark.first;
+    commitment = watermark.second;
+    return true;
+}
+
+bool CBlockTreeDB::ErasePowWatermark() {
+    return Erase(DB_POW_WATERMARK);
+}
+
+uint256 GetPowCommitmentHash(const CBlockIndex& index)
+{
+    CHashWriter ss(SER_GETHASH, PROTOCOL_VERSION);
+    ss << index.GetBlockHash();
+    ss << (index.pprev ? index.pprev->GetBlockHash() : uint256());
+    // The block hash commits to the equihash fields, which are not kept in the index entry
+    ss << index.nHeight << index.nVersion << index.hashMerkleRoot;
+    ss << index.nTime << index.nBits << index.nNonce;
+    return ss.GetHash();
+}
+
+static bool CheckBlockIndexProofOfWork(const CBlockIndex* pindex, const CBlockHeader& header, const Consensus::Params& consensusParams)
+{
+    bool equihashvalidator;
+    bool checkresult = CheckProofOfWork(header, consensusParams, equihashvalidator);
+
+    if (IsEquihashBasedAlgo(pindex->GetAlgo()) && !equihashvalidator) {
+        return error("%s: %s solution invalid at: %s", __func__, GetAlgoName(pindex->GetAlgo()), pindex->ToString());
+    }
+
+    if (!checkresult)
+        return error("%s: CheckProofOfWork failed: %s", __func__, pindex->ToString());
+
+    return true;
+}
+
+bool CBlockTreeDB::LoadBlockIndexGuts(const Consensus::Params& consensusParams, std::function<CBlockIndex*(const uint256&)> insertBlockIndex, CCheckQueue<CPowCheck>* pqueue)
 {
     std::unique_ptr<CDBIterator> pcursor(NewIterator());
 
@@ -270,6 +326,69 @@ bool CBlockTreeDB::LoadBlockIndexGuts(const Consensus::Params& consensusParams,
     
     vAuxpowValidation.reserve(445724); // the estimated amount of auxpow blocks between hardfork 1 and hardfork 2
 
+    // Headers at or below the watermark height were verified before the last clean shutdown.
+    // Their verification is deferred and only done if the commitment over them does not match.
+    // The watermark is erased right away, so an unclean shutdown forces full verification.
+    int nWatermarkHeight = -1;
+    uint256 watermarkCommitment;
+    if (nCheckPowOnLoad == POW_LOAD_CHECK_WATERMARK && ReadPowWatermark(nWatermarkHeight, watermarkCommitment)) {
+        if (!ErasePowWatermark())
+            return error("%s: failed to erase proof-of-work watermark", __func__);
+    } else {
+        nWatermarkHeight = -1;
+    }
+    arith_uint256 commitment;
+    std::vector<const CBlockIndex*> vDeferred;
+
+    // When a check queue is given, the proof-of-work of the loaded headers is verified by its
+    // worker threads while the cursor keeps scanning. Results are collected once per window of
+    // POW_CHECK_WINDOW_SIZE headers, which bounds the memory held by queued checks.
+    std::unique_ptr<CCheckQueueControl<CPowCheck> > control;
+    CPowCheckGrouper groups(consensusParams);
+    std::vector<CPowCheck> vChecks;
+    std::vector<const CBlockIndex*> vPending;
+    if (pqueue) {
+        vChecks.reserve(POW_CHECK_BATCH_SIZE);
+        vPending.reserve(POW_CHECK_WINDOW_SIZE);
+    }
+
+    auto flushPowChecks = [&]() -> bool {
+        if (!control)
+            return true;
+        groups.Flush(vChecks);
+        control->Add(vChecks);
+        vChecks.clear();
+        bool fAllOk = control->Wait();
+        control.reset();
+        if (!fAllOk) {
+            // Workers stop early once any check failed, so rescan the window serially
+            // in cursor order to report the first failing header deterministically.
+            for (const CBlockIndex* pindex : vPending) {
+                if (!CheckBlockIndexProofOfWork(pindex, pindex->GetBlockHeader(consensusParams), consensusParams))
+                    return false;
+            }
+            return error("%s: parallel proof-of-work verification failed", __func__);
+        }
+        vPending.clear();
+        return true;
+    };
+
+    auto checkPow = [&](const CBlockIndex* pindex, const CBlockHeader& header) -> bool {
+        if (!pqueue)
+            return CheckBlockIndexProofOfWork(pindex, header, consensusParams);
+        if (!control)
+            control.reset(new CCheckQueueControl<CPowCheck>(pqueue));
+        groups.Add(header, vChecks);
+        vPending.push_back(pindex);
+        if (vChecks.size() >= POW_CHECK_BATCH_SIZE) {
+            control->Add(vChecks);
+            vChecks.clear();
+        }
+        if (vPending.size() >= POW_CHECK_WINDOW_SIZE)
+            return flushPowChecks();
+        return true;
+    };
+
     // Load mapBlockIndex
     while (pcursor->Valid()) {
         boost::this_thread::interruption_point();
@@ -286,14 +405,15 @@ bool CBlockTreeDB::LoadBlockIndexGuts(const Consensus::Params& consensusParams,
                 pindexNew->nUndoPos       = diskindex.nUndoPos;
                 pindexNew->nVersion       = diskindex.nVersion;
                 pindexNew->hashMerkleRoot = diskindex.hashMerkleRoot;
-                pindexNew->hashReserved   = diskindex.hashReserved;
                 pindexNew->nTime          = diskindex.nTime;
                 pindexNew->nBits          = diskindex.nBits;
                 pindexNew->nNonce         = diskindex.nNonce;
-                pindexNew->nBigNonce      = diskindex.nBigNonce;
-                pindexNew->nSolution      = diskindex.nSolution;
                 pindexNew->nStatus        = diskindex.nStatus;
                 pindexNew->nTx            = diskindex.nTx;
+
+                // The equihash fields stay on disk and are read back on demand
+                if (IsEquihashBasedAlgo(diskindex.GetAlgo()))
+                    equihashstore.AddOffloaded(diskindex.GetEquihashFields());
                 
                 CPureBlockVersion versionverify = pindexNew->nVersion;
 
@@ -310,16 +430,15 @@ bool CBlockTreeDB::LoadBlockIndexGuts(const Consensus::Params& consensusParams,
                     pcursor->Next();
                     continue;
                 }
-				
-                bool equihashvalidator;
-                bool checkresult = CheckProofOfWork(pindexNew->GetBlockHeader(consensusParams), consensusParams, equihashvalidator);
-                
-                if (IsEquihashBasedAlgo(pindexNew->GetAlgo()) && !equihashvalidator) {
-                    return error("%s: %s solution invalid at: %s", __func__, GetAlgoName(pindexNew->GetAlgo()), pindexNew->ToString());
-                }
 
-                if (!checkresult)
-                    return error("%s: CheckProofOfWork failed: %s", __func__, pindexNew->ToString());
+                if (nCheckPowOnLoad == POW_LOAD_CHECK_NONE) {
+                    // Proof-of-work verification disabled by -checkpowonload=0
+                } else if (pindexNew->nHeight <= nWatermarkHeight) {
+                    commitment += UintToArith256(GetPowCommitmentHash(*pindexNew));
+                    vDeferred.push_back(pindexNew);
+                } else if (!checkPow(pindexNew, diskindex.GetDiskBlockHeader())) {
+                    return false;
+                }
 
                 pcursor->Next();
             } else {
@@ -330,7 +449,20 @@ bool CBlockTreeDB::LoadBlockIndexGuts(const Consensus::Params& consensusParams,
         }
     }
 
-    return true;
+    if (nWatermarkHeight >= 0) {
+        if (ArithToUint256(commitment) == watermarkCommitment) {
+            LogPrintf("%s: skipped proof-of-work verification of %u headers up to height %d\n", __func__, vDeferred.size(), nWatermarkHeight);
+        } else {
+            LogPrintf("%s: proof-of-work watermark commitment mismatch, verifying %u headers up to height %d\n", __func__, vDeferred.size(), nWatermarkHeight);
+            for (const CBlockIndex* pindex : vDeferred) {
+                boost::this_thread::interruption_point();
+                if (!checkPow(pindex, pindex->GetBlockHeader(consensusParams)))
+                    return false;
+            }
+        }
+    }
+
+    return flushPowChecks();
 }
 
 namespace {
@@ -16,9 +16,40 @@
 #include <vector>
 
 class CBlockIndex;
+struct CEquihashFields;
 class CCoinsViewDBCursor;
+class CPowCheck;
 class uint256;
 
+template <typename T>
+class CCheckQueue;
+
+//! Number of headers whose proof-of-work is verified in parallel before the results are collected while loading the block index
+static const unsigned int POW_CHECK_WINDOW_SIZE = 4096;
+//! Number of header check groups, of up to POW_CHECK_GROUP_SIZE headers each, handed to the check queue at once
+static const unsigned int POW_CHECK_BATCH_SIZE = 4;
+
+/** Proof-of-work verification of the block index on startup (-checkpowonload) */
+enum PowLoadCheckMode {
+    //! Trust the block index and skip proof-of-work verification
+    POW_LOAD_CHECK_NONE = 0,
+    //! Skip headers covered by the watermark written at the last clean shutdown
+    POW_LOAD_CHECK_WATERMARK = 1,
+    //! Verify the proof-of-work of every header
+    POW_LOAD_CHECK_FULL = 2,
+};
+//! -checkpowonload default
+static const char* const DEFAULT_CHECKPOWONLOAD = "1";
+
+extern PowLoadCheckMode nCheckPowOnLoad;
+
+/**
+ * Hash over the proof-of-work relevant fields of a block index entry.
+ * The sum of these hashes over all entries below the watermark height
+ * commits to the set of headers whose proof-of-work was already verified.
+ */
+uint256 GetPowCommitmentHash(const CBlockIndex& index);
+
 //! No need to periodic flush if at least this much space still available.
 static constexpr int MAX_BLOCK_COINSDB_USAGE = 10;
 //! -dbcache default (MiB)
@@ -116,6 +147,7 @@ public:
 
     bool WriteBatchSync(const std::vector<std::pair<int, const CBlockFileInfo*> >& fileInfo, int nLastFile, const std::vector<const CBlockIndex*>& blockinfo);
     bool ReadBlockFileInfo(int nFile, CBlockFileInfo &info);
+    bool ReadEquihashFields(const uint256 &hash, CEquihashFields &fields);
     bool ReadLastBlockFile(int &nFile);
     bool WriteReindexing(bool fReindexing);
     bool ReadReindexing(bool &fReindexing);
@@ -123,7 +155,10 @@ public:
     bool WriteTxIndex(const std::vector<std::pair<uint256, CDiskTxPos> > &vect);
     bool WriteFlag(const std::string &name, bool fValue);
     bool ReadFlag(const std::string &name, bool &fValue);
-    bool LoadBlockIndexGuts(const Consensus::Params& consensusParams, std::function<CBlockIndex*(const uint256&)> insertBlockIndex);
+    bool WritePowWatermark(int nHeight, const uint256 &commitment);
+    bool ReadPowWatermark(int &nHeight, uint256 &commitment);
+    bool ErasePowWatermark();
+    bool LoadBlockIndexGuts(const Consensus::Params& consensusParams, std::function<CBlockIndex*(const uint256&)> insertBlockIndex, CCheckQueue<CPowCheck>* pqueue = nullptr);
 };
 
 #endif // BITCOIN_TXDB_H
@@ -8,6 +8,7 @@
 #include <validation.h>
 
 #include <arith_uint256.h>
+#include <auxpowcache.h>
 #include <chain.h>
 #include <chainparams.h>
 #include <checkpoints.h>
@@ -17,6 +18,7 @@
 #include <consensus/tx_verify.h>
 #include <consensus/validation.h>
 #include <cuckoocache.h>
+#include <equihashstore.h>
 #include <globaltoken/hardfork.h>
 #include <hash.h>
 #include <init.h>
@@ -24,6 +26,7 @@
 #include <policy/policy.h>
 #include <policy/rbf.h>
 #include <pow.h>
+#include <powcache.h>
 #include <primitives/block.h>
 #include <primitives/transaction.h>
 #include <random.h>
@@ -53,6 +56,7 @@
 #include <masternode-payments.h>
 
 #include <inttypes.h>
+#include <deque>
 #include <future>
 #include <sstream>
 
@@ -167,7 +171,7 @@ public:
 
     bool ActivateBestChain(CValidationState &state, const CChainParams& chainparams, std::shared_ptr<const CBlock> pblock);
 
-    bool AcceptBlockHeader(const CBlockHeader& block, CValidationState& state, const CChainParams& chainparams, CBlockIndex** ppindex);
+    bool AcceptBlockHeader(const CBlockHeader& block, CValidationState& state, const CChainParams& chainparams, CBlockIndex** ppindex, bool fCheckPOW = true);
     bool AcceptBlock(const std::shared_ptr<const CBlock>& pblock, CValidationState& state, const CChainParams& chainparams, CBlockIndex** ppindex, bool fRequested, const CDiskBlockPos* dbp, bool* fNewBlock);
 
     // Block (dis)connection on a given view:
@@ -1181,7 +1185,7 @@ static bool ReadBlockOrHeader(T& block, const CDiskBlockPos& pos, const Consensu
     }
     
     // Check the header
-    if (!CheckProofOfWork(block, consensusParams))
+    if (!CheckProofOfWorkCached(block, consensusParams))
         return error("ReadBlockFromDisk: Errors in block header at %s", pos.ToString());
     
     block.fAuxPowChecked = true;
@@ -1777,6 +1781,14 @@ void ThreadScriptCheck() {
     scriptcheckqueue.Thread();
 }
 
+// Each CPowCheck already covers a group of headers, so workers take one at a time
+static CCheckQueue<CPowCheck> powcheckqueue(1);
+
+void ThreadPowCheck() {
+    RenameThread("globaltoken-powch");
+    powcheckqueue.Thread();
+}
+
 // Protected by cs_main
 VersionBitsCache versionbitscache;
 
@@ -2257,6 +2269,7 @@ bool static FlushStateToDisk(const CChainParams& chainparams, CValidationState &
                 if (!pblocktree->WriteBatchSync(vFiles, nLastBlockFile, vBlocks)) {
                     return AbortNode(state, "Failed to write to block index database");
                 }
+                equihashstore.SetWritten(vBlocks);
             }
             // Finally remove any pruned files
             if (fFlushForPrune)
@@ -2302,6 +2315,32 @@ void PruneAndFlush() {
     FlushStateToDisk(chainparams, state, FLUSH_STATE_NONE);
 }
 
+bool WritePowWatermark()
+{
+    LOCK(cs_main);
+    // Headers loaded with -checkpowonload=0 were never verified, and entries that
+    // are not flushed yet would not be covered by the commitment on the next load.
+    if (nCheckPowOnLoad == POW_LOAD_CHECK_NONE || !pblocktree || !setDirtyBlockIndex.empty())
+        return false;
+
+    int nHeight = chainActive.Height();
+    if (nHeight < 0)
+        return false;
+
+    // Auxpow headers are verified separately by VerifyAuxpowBlockIndex and not covered.
+    arith_uint256 commitment;
+    for (const auto& item : mapBlockIndex) {
+        const CBlockIndex* pindex = item.second;
+        if (pindex->nHeight <= nHeight && !CPureBlockVersion(pindex->nVersion).IsAuxpow())
+            commitment += UintToArith256(GetPowCommitmentHash(*pindex));
+    }
+
+    if (!pblocktree->WritePowWatermark(nHeight, ArithToUint256(commitment)))
+        return error("%s: failed to write proof-of-work watermark", __func__);
+    LogPrintf("%s: proof-of-work verified up to height %d\n", __func__, nHeight);
+    return true;
+}
+
 static void DoWarning(const std::string& strWarning)
 {
     static bool fWarned = false;
@@ -3028,6 +3067,13 @@ CBlockIndex* CChainState::AddToBlockIndex(const CBlockHeader& block)
     pindexNew->nSequenceId = 0;
     BlockMap::iterator mi = mapBlockIndex.insert(std::make_pair(hash, pindexNew)).first;
     pindexNew->phashBlock = &((*mi).first);
+    if (IsEquihashBasedAlgo(pindexNew->GetAlgo())) {
+        CEquihashFields fields;
+        fields.hashReserved = block.hashReserved;
+        fields.nBigNonce = block.nBigNonce;
+        fields.nSolution = block.nSolution;
+        equihashstore.AddPending(hash, fields);
+    }
     BlockMap::iterator miPrev = mapBlockIndex.find(block.hashPrevBlock);
     if (miPrev != mapBlockIndex.end())
     {
@@ -3035,6 +3081,7 @@ CBlockIndex* CChainState::AddToBlockIndex(const CBlockHeader& block)
         pindexNew->nHeight = pindexNew->pprev->nHeight + 1;
         pindexNew->BuildSkip();
     }
+    pindexNew->BuildAlgoSkip(Params().GetConsensus());
     pindexNew->nTimeMax = (pindexNew->pprev ? std::max(pindexNew->pprev->nTimeMax, pindexNew->nTime) : pindexNew->nTime);
     pindexNew->nChainWork = (pindexNew->pprev ? pindexNew->pprev->nChainWork : 0) + GetBlockProof(*pindexNew);
     pindexNew->RaiseValidity(BLOCK_VALID_TREE);
@@ -3183,11 +3230,21 @@ static bool FindUndoPos(CValidationState &state, int nFile, CDiskBlockPos &pos,
     return true;
 }
 
+/** Set the state for a header whose proof-of-work failed, fSolutionValid is false if its equihash solution did */
+static bool InvalidProofOfWork(const CBlockHeader& block, CValidationState& state, bool fSolutionValid)
+{
+    uint8_t nAlgo = block.GetAlgo();
+    if (IsEquihashBasedAlgo(nAlgo) && !fSolutionValid)
+    {
+        return state.DoS(100, error("CheckBlockHeader(): %s solution invalid", GetAlgoName(nAlgo)),
+                         REJECT_INVALID, "invalid-solution");
+    }
+    return state.DoS(50, false, REJECT_INVALID, "high-hash", false, "proof of work failed");
+}
+
 static bool CheckBlockHeader(const CBlockHeader& block, CValidationState& state, const Consensus::Params& consensusParams, bool fCheckPOW = true)
 {
     bool equihashvalidator;
-    bool checkresult;
-    uint8_t nAlgo = block.GetAlgo();
     
     if(consensusParams.Hardfork2.IsActivated(block.nTime))
     {
@@ -3199,19 +3256,10 @@ static bool CheckBlockHeader(const CBlockHeader& block, CValidationState& state,
         }
     }
     
-    if (fCheckPOW)
-        checkresult = CheckProofOfWork(block, consensusParams, equihashvalidator);
-    
-    if (fCheckPOW && IsEquihashBasedAlgo(nAlgo) && !equihashvalidator) 
-    {
-        return state.DoS(100, error("CheckBlockHeader(): %s solution invalid", GetAlgoName(nAlgo)),
-                         REJECT_INVALID, "invalid-solution");
-    }
-			
     // Check proof of work matches claimed amount
     // Also check the block POW after Equihash Solution check.
-    if (fCheckPOW && !checkresult)
-        return state.DoS(50, false, REJECT_INVALID, "high-hash", false, "proof of work failed");
+    if (fCheckPOW && !CheckProofOfWorkCached(block, consensusParams, equihashvalidator))
+        return InvalidProofOfWork(block, state, equihashvalidator);
 
     return true;
 }
@@ -3514,7 +3562,7 @@ static bool ContextualCheckBlock(const CBlock& block, CValidationState& state, c
     return true;
 }
 
-bool CChainState::AcceptBlockHeader(const CBlockHeader& block, CValidationState& state, const CChainParams& chainparams, CBlockIndex** ppindex)
+bool CChainState::AcceptBlockHeader(const CBlockHeader& block, CValidationState& state, const CChainParams& chainparams, CBlockIndex** ppindex, bool fCheckPOW)
 {
     AssertLockHeld(cs_main);
     // Check for duplicate
@@ -3533,7 +3581,7 @@ bool CChainState::AcceptBlockHeader(const CBlockHeader& block, CValidationState&
             return true;
         }
 
-        if (!CheckBlockHeader(block, state, chainparams.GetConsensus()))
+        if (!CheckBlockHeader(block, state, chainparams.GetConsensus(), fCheckPOW))
             return error("%s: Consensus::CheckBlockHeader: %s, %s", __func__, hash.ToString(), FormatStateMessage(state));
 
         // Get prev block index
@@ -3562,8 +3610,12 @@ bool CChainState::AcceptBlockHeader(const CBlockHeader& block, CValidationState&
             }
         }
     }
-    if (pindex == nullptr)
+    if (pindex == nullptr) {
         pindex = AddToBlockIndex(block);
+        // Freshly accepted headers are the ones most likely to be requested by peers next
+        if (block.auxpow)
+            auxpowcache.Add(hash, *block.auxpow);
+    }
 
     if (ppindex)
         *ppindex = pindex;
@@ -3576,21 +3628,121 @@ bool CChainState::AcceptBlockHeader(const CBlockHeader& block, CValidationState&
     return true;
 }
 
+/**
+ * Run the contextual checks of the headers from nBegin on a temporary chain on top of
+ * pindexPrev, standing in for the block index entries they do not have yet. Returns the
+ * end of the run of unknown headers that passed, so no proof-of-work is computed for
+ * headers whose nBits or timestamp is not the one expected after their parent.
+ */
+static size_t CheckBlockHeadersContext(const std::vector<CBlockHeader>& headers, size_t nBegin, CBlockIndex* pindexPrev, const CChainParams& chainparams)
+{
+    AssertLockHeld(cs_main);
+    // deques keep the entries, and the hashes they point to, in place as they grow
+    std::deque<uint256> vHashes;
+    std::deque<CBlockIndex> vIndex;
+    size_t i = nBegin;
+    for (; i < headers.size(); i++) {
+        const CBlockHeader& header = headers[i];
+        vHashes.push_back(header.GetHash());
+        if (header.hashPrevBlock != pindexPrev->GetBlockHash() || mapBlockIndex.count(vHashes.back()))
+            break;
+        CValidationState state;
+        if (!ContextualCheckBlockHeader(header, state, chainparams, pindexPrev, GetAdjustedTime()))
+            break;
+
+        vIndex.emplace_back(header);
+        CBlockIndex* pindex = &vIndex.back();
+        pindex->phashBlock = &vHashes.back();
+        pindex->pprev = pindexPrev;
+        pindex->nHeight = pindexPrev->nHeight + 1;
+        pindex->BuildSkip();
+        pindex->BuildAlgoSkip(chainparams.GetConsensus());
+        pindexPrev = pindex;
+    }
+    return i;
+}
+
+/**
+ * Verify the proof-of-work of headers[nBegin, nEnd) on the proof-of-work check queue,
+ * without holding cs_main while hashing, grouped by algo. This covers the context-free
+ * part of CheckBlockHeader only: the PoW hash, equihash solution and auxpow. The result
+ * of each header is stored in vResults; once a check failed, the queue leaves the ones
+ * it did not start pending.
+ */
+static void CheckBlockHeadersProofOfWork(const std::vector<CBlockHeader>& headers, size_t nBegin, size_t nEnd, const Consensus::Params& consensusParams, std::vector<PowCheckResult>& vResults)
+{
+    CCheckQueueControl<CPowCheck> control(&powcheckqueue);
+    CPowCheckGrouper groups(consensusParams);
+    std::vector<CPowCheck> vChecks;
+    for (size_t i = nBegin; i < nEnd; i++) {
+        groups.Add(headers[i], vChecks, &vResults[i]);
+        if (vChecks.size() >= POW_CHECK_BATCH_SIZE) {
+            control.Add(vChecks);
+            vChecks.clear();
+        }
+    }
+    groups.Flush(vChecks);
+    control.Add(vChecks);
+    control.Wait();
+}
+
 // Exposed wrapper for AcceptBlockHeader
 bool ProcessNewBlockHeaders(const std::vector<CBlockHeader>& headers, CValidationState& state, const CChainParams& chainparams, const CBlockIndex** ppindex, CBlockHeader *first_invalid)
 {
     if (first_invalid != nullptr) first_invalid->SetNull();
+    // Headers up to the first one that is not known yet are accepted in full. The
+    // proof-of-work of the headers that follow it with the expected nBits and timestamp
+    // is then verified in parallel, leaving the contextual checks to cs_main. Headers
+    // the check queue left pending are checked in full, in order, as before.
+    std::vector<PowCheckResult> vResults(headers.size(), POW_CHECK_PENDING);
+    size_t nNext = 0;
+
+    // Must hold cs_main
+    auto acceptHeader = [&](const CBlockHeader& header, PowCheckResult result) -> bool {
+        if ((result == POW_CHECK_INVALID || result == POW_CHECK_INVALID_SOLUTION) && !mapBlockIndex.count(header.GetHash())) {
+            // Report the failure found on the check queue as AcceptBlockHeader would, without hashing again
+            if (CheckBlockHeader(header, state, chainparams.GetConsensus(), false))
+                InvalidProofOfWork(header, state, result != POW_CHECK_INVALID_SOLUTION);
+            error("%s: Consensus::CheckBlockHeader: %s, %s", __func__, header.GetHash().ToString(), FormatStateMessage(state));
+            if (first_invalid) *first_invalid = header;
+            return false;
+        }
+        CBlockIndex *pindex = nullptr; // Use a temp pindex instead of ppindex to avoid a const_cast
+        if (!g_chainstate.AcceptBlockHeader(header, state, chainparams, &pindex, result != POW_CHECK_VALID)) {
+            if (first_invalid) *first_invalid = header;
+            return false;
+        }
+        // The full blocks of headers accepted without CheckProofOfWorkCached are expected next
+        if (result == POW_CHECK_VALID)
+            AddPowCacheEntry(header);
+        if (ppindex) {
+            *ppindex = pindex;
+        }
+        return true;
+    };
+
+    size_t nEnd = 0;
     {
         LOCK(cs_main);
-        for (const CBlockHeader& header : headers) {
-            CBlockIndex *pindex = nullptr; // Use a temp pindex instead of ppindex to avoid a const_cast
-            if (!g_chainstate.AcceptBlockHeader(header, state, chainparams, &pindex)) {
-                if (first_invalid) *first_invalid = header;
+        while (nNext < headers.size()) {
+            const bool fKnown = mapBlockIndex.count(headers[nNext].GetHash());
+            if (!acceptHeader(headers[nNext++], POW_CHECK_PENDING))
+                return false;
+            if (!fKnown)
+                break;
+        }
+        if (nScriptCheckThreads && nNext > 0 && nNext < headers.size()) {
+            CBlockIndex* pindexLast = mapBlockIndex[headers[nNext - 1].GetHash()];
+            nEnd = CheckBlockHeadersContext(headers, nNext, pindexLast, chainparams);
+        }
+    }
+    if (nEnd > nNext)
+        CheckBlockHeadersProofOfWork(headers, nNext, nEnd, chainparams.GetConsensus(), vResults);
+    {
+        LOCK(cs_main);
+        for (; nNext < headers.size(); nNext++) {
+            if (!acceptHeader(headers[nNext], vResults[nNext]))
                 return false;
-            }
-            if (ppindex) {
-                *ppindex = pindex;
-            }
         }
     }
     NotifyHeaderTip();
@@ -3975,7 +4127,7 @@ CBlockIndex * CChainState::InsertBlockIndex(const uint256& hash)
 
 bool CChainState::LoadBlockIndex(const Consensus::Params& consensus_params, CBlockTreeDB& blocktree)
 {
-    if (!blocktree.LoadBlockIndexGuts(consensus_params, [this](const uint256& hash){ return this->InsertBlockIndex(hash); }))
+    if (!blocktree.LoadBlockIndexGuts(consensus_params, [this](const uint256& hash){ return this->InsertBlockIndex(hash); }, nScriptCheckThreads ? &powcheckqueue : nullptr))
         return false;
 
     boost::this_thread::interruption_point();
@@ -3992,6 +4144,7 @@ bool CChainState::LoadBlockIndex(const Consensus::Params& consensus_params, CBlo
     for (const std::pair<int, CBlockIndex*>& item : vSortedByHeight)
     {
         CBlockIndex* pindex = item.second;
+        pindex->BuildAlgoSkip(consensus_params);
         pindex->nChainWork = (pindex->pprev ? pindex->pprev->nChainWork : 0) + GetBlockProof(*pindex);
         pindex->nTimeMax = (pindex->pprev ? std::max(pindex->pprev->nTimeMax, pindex->nTime) : pindex->nTime);
         // We can link the chain of blocks for which we've received transactions at some point.
@@ -4113,51 +4266,127 @@ bool LoadChainTip(const CChainParams& chainparams)
 
 bool VerifyAuxpowBlockIndex(std::string &strErrMsg, const Consensus::Params& consensusParams)
 {
-    LOCK(cs_main);
-    
-    double auxPowValidationProgress = 0.0;
-
-    CBlockIndex* pAuxPowValidationCheckIndex = nullptr;
-    CBlockHeader currentBlockHeader;
-    size_t vectorsize = vAuxpowValidation.size();
-    
-    // Sort the vector by hash, so we can speed up mapBlockIndex loading time
-    sort(vAuxpowValidation.begin(), vAuxpowValidation.end());
-    
-    for(size_t i = 0; i < vectorsize; i++)
+    // Collect the block positions under cs_main, then read and verify without holding it.
+    // Sorting by position lets the headers be read sequentially from each blk*.dat file.
+    std::vector<std::pair<CDiskBlockPos, const CBlockIndex*> > vAuxpowBlocks;
     {
-        if (mapBlockIndex.count(vAuxpowValidation[i]) != 0)
+        LOCK(cs_main);
+        vAuxpowBlocks.reserve(vAuxpowValidation.size());
+        for (const uint256& hash : vAuxpowValidation)
         {
-            pAuxPowValidationCheckIndex = mapBlockIndex[vAuxpowValidation[i]];
-            
-            if(pAuxPowValidationCheckIndex == nullptr)
+            BlockMap::const_iterator mi = mapBlockIndex.find(hash);
+            if (mi == mapBlockIndex.end())
             {
-                strErrMsg = _("Error while loading Blockindex Cache!");
-                LogPrintf("Couldn't load blockindex cache ... Shutting down ...\n");
+                strErrMsg = _("Failed to check auxpow blocks! Shutting down.\nFor more details, check your debug.log file!");
+                LogPrintf("Auxpow is invalid! Blockhash = %s Reason: Could not load blockhash from mapBlockIndex ...\n", hash.GetHex());
                 return false;
             }
-            
-            auxPowValidationProgress = static_cast<double>(i) / static_cast<double>(vectorsize);
-            auxPowValidationProgress *= 100.0;
-            
-            // We don't need to check the auxpow here, because GetBlockHeader reads this auxpow block from disk, and checks the pow.
-            currentBlockHeader = pAuxPowValidationCheckIndex->GetBlockHeader(consensusParams);
-            
-            if(!currentBlockHeader.fAuxPowChecked)
+            if (mi->second == nullptr)
             {
-                strErrMsg = _("Found invalid auxpow! Shutting down.\nFor more details, check your debug.log file!");
-                LogPrintf("Auxpow is invalid! Blockhash = %s, Blockheight = %d Reason: Aux-Proof of Work validation failed ...\n", pAuxPowValidationCheckIndex->GetBlockHash().GetHex(), pAuxPowValidationCheckIndex->nHeight);
+                strErrMsg = _("Error while loading Blockindex Cache!");
+                LogPrintf("Couldn't load blockindex cache ... Shutting down ...\n");
                 return false;
             }
-            uiInterface.ShowProgressAsDouble(_("Verifying auxpow blocks..."), auxPowValidationProgress);
+            vAuxpowBlocks.push_back(std::make_pair(mi->second->GetBlockPos(), mi->second));
         }
-        else
-        {
-            strErrMsg = _("Failed to check auxpow blocks! Shutting down.\nFor more details, check your debug.log file!");
-            LogPrintf("Auxpow is invalid! Blockhash = %s, Blockheight = %d Reason: Could not load blockhash from mapBlockIndex ...\n");
-            return false;
+    }
+    std::sort(vAuxpowBlocks.begin(), vAuxpowBlocks.end(),
+        [](const std::pair<CDiskBlockPos, const CBlockIndex*>& a, const std::pair<CDiskBlockPos, const CBlockIndex*>& b) {
+            return std::make_pair(a.first.nFile, a.first.nPos) < std::make_pair(b.first.nFile, b.first.nPos);
+        });
+
+    auto invalidAuxpow = [&](const CBlockIndex* pindex) {
+        strErrMsg = _("Found invalid auxpow! Shutting down.\nFor more details, check your debug.log file!");
+        LogPrintf("Auxpow is invalid! Blockhash = %s, Blockheight = %d Reason: Aux-Proof of Work validation failed ...\n", pindex->GetBlockHash().GetHex(), pindex->nHeight);
+        return false;
+    };
+
+    // The auxpow and parent block proof-of-work are verified on the proof-of-work check
+    // queue while the next headers are read, collecting the results once per window.
+    CCheckQueue<CPowCheck>* pqueue = nScriptCheckThreads ? &powcheckqueue : nullptr;
+    std::unique_ptr<CCheckQueueControl<CPowCheck> > control;
+    CPowCheckGrouper groups(consensusParams);
+    std::vector<CPowCheck> vChecks;
+    size_t nWindowStart = 0;
+
+    auto flushPowChecks = [&](size_t nWindowEnd) -> bool {
+        if (!control)
+            return true;
+        groups.Flush(vChecks);
+        control->Add(vChecks);
+        vChecks.clear();
+        bool fAllOk = control->Wait();
+        control.reset();
+        if (!fAllOk) {
+            // Re-read the failed window one header at a time, so the first invalid
+            // auxpow in file order is reported deterministically.
+            for (size_t j = nWindowStart; j < nWindowEnd; j++) {
+                CBlockHeader header;
+                if (!ReadBlockHeaderFromDisk(header, vAuxpowBlocks[j].second, consensusParams))
+                    return invalidAuxpow(vAuxpowBlocks[j].second);
+            }
+            strErrMsg = _("Found invalid auxpow! Shutting down.\nFor more details, check your debug.log file!");
+            return error("%s: parallel auxpow verification failed", __func__);
         }
+        nWindowStart = nWindowEnd;
+        return true;
+    };
+
+    std::unique_ptr<CBufferedFile> blkdat;
+    int nCurrentFile = -1;
+    size_t vectorsize = vAuxpowBlocks.size();
+
+    for (size_t i = 0; i < vectorsize; i++)
+    {
+        boost::this_thread::interruption_point();
+        const CDiskBlockPos& pos = vAuxpowBlocks[i].first;
+        const CBlockIndex* pindex = vAuxpowBlocks[i].second;
+
+        CBlockHeader header;
+        try {
+            if (!blkdat || pos.nFile != nCurrentFile) {
+                blkdat.reset();
+                FILE* fileIn = OpenBlockFile(CDiskBlockPos(pos.nFile, 0), true);
+                if (!fileIn)
+                    return invalidAuxpow(pindex);
+                // This takes over fileIn and calls fclose() on it in the CBufferedFile destructor
+                blkdat.reset(new CBufferedFile(fileIn, 2*MAX_BLOCK_SERIALIZED_SIZE, 0, SER_DISK, CLIENT_VERSION));
+                nCurrentFile = pos.nFile;
+            }
+            if (!blkdat->SkipTo(pos.nPos))
+                return invalidAuxpow(pindex);
+            *blkdat >> header;
+        } catch (const std::exception& e) {
+            LogPrintf("%s: Deserialize or I/O error - %s at %s\n", __func__, e.what(), pos.ToString());
+            return invalidAuxpow(pindex);
+        }
+
+        if (header.GetHash() != pindex->GetBlockHash()) {
+            LogPrintf("%s: GetHash() doesn't match index for %s at %s\n", __func__, pindex->ToString(), pos.ToString());
+            return invalidAuxpow(pindex);
+        }
+
+        if (pqueue) {
+            if (!control)
+                control.reset(new CCheckQueueControl<CPowCheck>(pqueue));
+            groups.Add(header, vChecks);
+            if (vChecks.size() >= POW_CHECK_BATCH_SIZE) {
+                control->Add(vChecks);
+                vChecks.clear();
+            }
+            if (i + 1 - nWindowStart >= POW_CHECK_WINDOW_SIZE && !flushPowChecks(i + 1))
+                return false;
+        } else if (!CheckProofOfWork(header, consensusParams)) {
+            return invalidAuxpow(pindex);
+        }
+
+        if (i % 1000 == 0)
+            uiInterface.ShowProgressAsDouble(_("Verifying auxpow blocks..."), static_cast<double>(i) * 100.0 / static_cast<double>(vectorsize));
     }
+
+    if (!flushPowChecks(vectorsize))
+        return false;
+
     ClearAuxpowValidationCache();
     return true;
 }
@@ -4488,6 +4717,7 @@ void UnloadBlockIndex()
     setDirtyBlockIndex.clear();
     setDirtyFileInfo.clear();
     versionbitscache.Clear();
+    equihashstore.Clear();
     for (int b = 0; b < VERSIONBITS_NUM_BITS; b++) {
         warningcache[b].clear();
     }
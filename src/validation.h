@@ -290,6 +290,8 @@ void ClearAuxpowValidationCache();
 void UnloadBlockIndex();
 /** Run an instance of the script checking thread */
 void ThreadScriptCheck();
+/** Run an instance of the proof-of-work checking thread */
+void ThreadPowCheck();
 /** Check whether we are doing an initial block download (synchronizing from disk or network) */
 bool IsInitialBlockDownload();
 /** Retrieve a transaction (from memory pool, or from disk, if possible) */
@@ -319,6 +321,8 @@ void UnlinkPrunedFiles(const std::set<int>& setFilesToPrune);
 void FlushStateToDisk();
 /** Prune block files and flush state to disk. */
 void PruneAndFlush();
+/** Record the height up to which the block index proof-of-work is verified, so the next startup can skip it. */
+bool WritePowWatermark();
 /** Prune block files up to a given height */
 void PruneBlockFilesManual(int nManualPruneHeight);
 